@@ -24,6 +24,7 @@
 #include "vtkDMMLDynamicModelerNode.h"
 
 // DMML includes
+#include <vtkDMMLMarkupsNode.h>
 #include <vtkDMMLScene.h>
 
 // VTK includes
@@ -102,5 +103,15 @@ void vtkDMMLDynamicModelerNode::ProcessDMMLEvents(vtkObject* caller, unsigned lo
     {
     return;
     }
+  if (eventID == vtkDMMLMarkupsNode::PointStartInteractionEvent)
+    {
+    this->InvokeEvent(InputNodeStartInteractionEvent, caller);
+    return;
+    }
+  if (eventID == vtkDMMLMarkupsNode::PointEndInteractionEvent)
+    {
+    this->InvokeEvent(InputNodeEndInteractionEvent, caller);
+    return;
+    }
   this->InvokeEvent(InputNodeModifiedEvent, caller);
 }
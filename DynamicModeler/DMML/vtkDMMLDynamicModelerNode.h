@@ -63,6 +63,8 @@ public:
   enum
   {
     InputNodeModifiedEvent = 18000, // Event that is invoked when one of the input nodes have been modified
+    InputNodeStartInteractionEvent, // Event that is invoked when the user starts interacting with one of the input markups nodes
+    InputNodeEndInteractionEvent, // Event that is invoked when the user stops interacting with one of the input markups nodes
   };
 
   /// The name of the vtkCjyxDynamicModelerTool that should be used for this node
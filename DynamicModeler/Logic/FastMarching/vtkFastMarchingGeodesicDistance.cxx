@@ -295,6 +295,7 @@ void vtkFastMarchingGeodesicDistance::AddSeeds()
 int vtkFastMarchingGeodesicDistance::Compute()
 {
   this->MaximumDistance = 0;
+  this->IterationIndex = 0;
 
   this->Internals->Mesh->SetUpFastMarching();
 
@@ -306,6 +307,10 @@ int vtkFastMarchingGeodesicDistance::Compute()
           this->FastMarchingIterationEventResolution == 0)
       {
       this->InvokeEvent(vtkFastMarchingGeodesicDistance::IterationEvent);
+      if (this->GetAbortExecute())
+        {
+        break;
+        }
       }
     }
 
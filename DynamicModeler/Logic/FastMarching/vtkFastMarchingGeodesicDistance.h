@@ -123,6 +123,12 @@ public:
   virtual void SetPropagationWeights(vtkDataArray *);
   vtkGetObjectMacro( PropagationWeights, vtkDataArray );
 
+  // Description:
+  // Get the number of fast marching steps performed by the current or last
+  // execution. An IterationEvent is invoked every 100 steps. Fast marching is
+  // interrupted at the next IterationEvent if AbortExecute is set.
+  vtkGetMacro( IterationIndex, unsigned long );
+
   // Description:
   // Events invoked by the filter
   //BTX
@@ -30,17 +30,28 @@
 #include <vtkDMMLTransformNode.h>
 
 // VTK includes
-#include <vtkAppendPolyData.h>
+#include <vtkCellArray.h>
 #include <vtkCellData.h>
 #include <vtkCleanPolyData.h>
 #include <vtkCommand.h>
 #include <vtkGeneralTransform.h>
+#include <vtkIdList.h>
+#include <vtkIdTypeArray.h>
 #include <vtkIntArray.h>
 #include <vtkPointData.h>
+#include <vtkPoints.h>
 #include <vtkPolyData.h>
+#include <vtkSMPThreadLocalObject.h>
+#include <vtkSMPTools.h>
 #include <vtkSmartPointer.h>
 #include <vtkStringArray.h>
 #include <vtkTransformPolyDataFilter.h>
+#include <vtkTypeInt32Array.h>
+#include <vtkTypeInt64Array.h>
+
+// STD includes
+#include <algorithm>
+#include <set>
 
 //----------------------------------------------------------------------------
 vtkToolNewMacro(vtkCjyxDynamicModelerAppendTool);
@@ -48,6 +59,234 @@ vtkToolNewMacro(vtkCjyxDynamicModelerAppendTool);
 const char* APPEND_INPUT_MODEL_REFERENCE_ROLE = "Append.InputModel";
 const char* APPEND_OUTPUT_MODEL_REFERENCE_ROLE = "Append.OutputModel";
 
+namespace
+{
+  //----------------------------------------------------------------------------
+  /// Copy a range of points into the preallocated output points array.
+  struct CopyPointsWorker
+  {
+    vtkDataArray* Input;
+    vtkDataArray* Output;
+    vtkIdType OutputStart;
+
+    void operator()(vtkIdType beginPointId, vtkIdType endPointId)
+    {
+      for (vtkIdType pointId = beginPointId; pointId < endPointId; ++pointId)
+        {
+        this->Output->SetTuple(this->OutputStart + pointId, pointId, this->Input);
+        }
+    }
+  };
+
+  //----------------------------------------------------------------------------
+  /// Copy ids into the preallocated output array, adding a constant shift to each id.
+  template <typename ValueType>
+  struct CopyShiftedIdsWorker
+  {
+    const ValueType* Input;
+    vtkIdType* Output;
+    vtkIdType Shift;
+
+    void operator()(vtkIdType begin, vtkIdType end)
+    {
+      for (vtkIdType i = begin; i < end; ++i)
+        {
+        this->Output[i] = static_cast<vtkIdType>(this->Input[i]) + this->Shift;
+        }
+    }
+  };
+
+  //----------------------------------------------------------------------------
+  template <typename ValueType>
+  void CopyShiftedIds(const ValueType* input, vtkIdType numberOfIds, vtkIdType* output, vtkIdType shift)
+  {
+    CopyShiftedIdsWorker<ValueType> worker;
+    worker.Input = input;
+    worker.Output = output;
+    worker.Shift = shift;
+    vtkSMPTools::For(0, numberOfIds, worker);
+  }
+
+  //----------------------------------------------------------------------------
+  /// Copy the offsets and connectivity of the cells into the preallocated output arrays.
+  /// Offsets are shifted by the connectivity start, point ids are shifted by the point start of the mesh.
+  void CopyCells(vtkCellArray* cells, vtkIdType* outputOffsets, vtkIdType connectivityStart,
+    vtkIdType* outputConnectivity, vtkIdType pointStart)
+  {
+    vtkIdType numberOfCells = cells->GetNumberOfCells();
+    vtkIdType connectivitySize = cells->GetNumberOfConnectivityIds();
+    if (cells->IsStorage64Bit())
+      {
+      CopyShiftedIds(cells->GetOffsetsArray64()->GetPointer(0), numberOfCells, outputOffsets, connectivityStart);
+      CopyShiftedIds(cells->GetConnectivityArray64()->GetPointer(0), connectivitySize, outputConnectivity, pointStart);
+      }
+    else
+      {
+      CopyShiftedIds(cells->GetOffsetsArray32()->GetPointer(0), numberOfCells, outputOffsets, connectivityStart);
+      CopyShiftedIds(cells->GetConnectivityArray32()->GetPointer(0), connectivitySize, outputConnectivity, pointStart);
+      }
+  }
+
+  //----------------------------------------------------------------------------
+  const int NUMBER_OF_CELL_ARRAYS = 4;
+
+  //----------------------------------------------------------------------------
+  /// Get the cell arrays of the mesh in the order of cell ids (verts, lines, polys, strips).
+  vtkCellArray* GetCellArray(vtkPolyData* mesh, int cellArrayIndex)
+  {
+    switch (cellArrayIndex)
+      {
+      case 0: return mesh->GetVerts();
+      case 1: return mesh->GetLines();
+      case 2: return mesh->GetPolys();
+      default: return mesh->GetStrips();
+      }
+  }
+
+  //----------------------------------------------------------------------------
+  void SetCellArray(vtkPolyData* mesh, int cellArrayIndex, vtkCellArray* cells)
+  {
+    switch (cellArrayIndex)
+      {
+      case 0: mesh->SetVerts(cells); break;
+      case 1: mesh->SetLines(cells); break;
+      case 2: mesh->SetPolys(cells); break;
+      default: mesh->SetStrips(cells); break;
+      }
+  }
+
+  //----------------------------------------------------------------------------
+  /// Sort the point ids of each polygon into its preallocated range and compute a hash of the sorted ids.
+  /// Polygons that use a point more than once are marked as degenerate.
+  struct SortCellPointIdsWorker
+  {
+    vtkCellArray* Polys;
+    const vtkIdType* CellOffsets;
+    vtkIdType* SortedPointIds;
+    vtkTypeUInt64* Hashes;
+    unsigned char* Degenerate;
+    vtkSMPThreadLocalObject<vtkIdList> PointIds;
+
+    void operator()(vtkIdType beginCellId, vtkIdType endCellId)
+    {
+      vtkIdList* pointIds = this->PointIds.Local();
+      for (vtkIdType cellId = beginCellId; cellId < endCellId; ++cellId)
+        {
+        this->Polys->GetCellAtId(cellId, pointIds);
+        vtkIdType* sortedPointIds = this->SortedPointIds + this->CellOffsets[cellId];
+        vtkIdType numberOfPoints = this->CellOffsets[cellId + 1] - this->CellOffsets[cellId];
+        std::copy(pointIds->GetPointer(0), pointIds->GetPointer(0) + numberOfPoints, sortedPointIds);
+        std::sort(sortedPointIds, sortedPointIds + numberOfPoints);
+        this->Degenerate[cellId] = (numberOfPoints == 0
+          || std::adjacent_find(sortedPointIds, sortedPointIds + numberOfPoints) != sortedPointIds + numberOfPoints);
+
+        // FNV-1a hash of the sorted point ids
+        vtkTypeUInt64 hash = 14695981039346656037ULL;
+        for (vtkIdType i = 0; i < numberOfPoints; ++i)
+          {
+          hash ^= static_cast<vtkTypeUInt64>(sortedPointIds[i]);
+          hash *= 1099511628211ULL;
+          }
+        this->Hashes[cellId] = hash;
+        }
+    }
+  };
+
+  //----------------------------------------------------------------------------
+  /// Sorted point ids of the polygons. Two polygons are duplicates if their sorted point ids are equal.
+  struct CellKeys
+  {
+    const vtkIdType* CellOffsets;
+    const vtkIdType* SortedPointIds;
+    const vtkTypeUInt64* Hashes;
+
+    /// Compare polygons by hash, then by number of points, then by sorted point ids
+    /// (only reached for equal hashes), then by cell id.
+    bool Less(vtkIdType cellId1, vtkIdType cellId2) const
+    {
+      if (this->Hashes[cellId1] != this->Hashes[cellId2])
+        {
+        return this->Hashes[cellId1] < this->Hashes[cellId2];
+        }
+      vtkIdType size1 = this->CellOffsets[cellId1 + 1] - this->CellOffsets[cellId1];
+      vtkIdType size2 = this->CellOffsets[cellId2 + 1] - this->CellOffsets[cellId2];
+      if (size1 != size2)
+        {
+        return size1 < size2;
+        }
+      const vtkIdType* pointIds1 = this->SortedPointIds + this->CellOffsets[cellId1];
+      const vtkIdType* pointIds2 = this->SortedPointIds + this->CellOffsets[cellId2];
+      for (vtkIdType i = 0; i < size1; ++i)
+        {
+        if (pointIds1[i] != pointIds2[i])
+          {
+          return pointIds1[i] < pointIds2[i];
+          }
+        }
+      return cellId1 < cellId2;
+    }
+
+    bool IsSameCell(vtkIdType cellId1, vtkIdType cellId2) const
+    {
+      vtkIdType size1 = this->CellOffsets[cellId1 + 1] - this->CellOffsets[cellId1];
+      vtkIdType size2 = this->CellOffsets[cellId2 + 1] - this->CellOffsets[cellId2];
+      return this->Hashes[cellId1] == this->Hashes[cellId2] && size1 == size2
+        && std::equal(this->SortedPointIds + this->CellOffsets[cellId1], this->SortedPointIds + this->CellOffsets[cellId1] + size1,
+          this->SortedPointIds + this->CellOffsets[cellId2]);
+    }
+  };
+
+  //----------------------------------------------------------------------------
+  struct CellKeyLess
+  {
+    const CellKeys* Keys;
+    bool operator()(vtkIdType cellId1, vtkIdType cellId2) const
+    {
+      return this->Keys->Less(cellId1, cellId2);
+    }
+  };
+
+  //----------------------------------------------------------------------------
+  /// Keep the first polygon of each run of duplicate polygons in the sorted cell id list.
+  struct MarkUniqueCellsWorker
+  {
+    const CellKeys* Keys;
+    const vtkIdType* OrderedCellIds;
+    unsigned char* Keep;
+
+    void operator()(vtkIdType begin, vtkIdType end)
+    {
+      for (vtkIdType i = begin; i < end; ++i)
+        {
+        vtkIdType cellId = this->OrderedCellIds[i];
+        this->Keep[cellId] = (i == 0 || !this->Keys->IsSameCell(this->OrderedCellIds[i - 1], cellId));
+        }
+    }
+  };
+
+  //----------------------------------------------------------------------------
+  /// Copy the point ids of the kept polygons into the preallocated output connectivity array.
+  struct CopyKeptCellsWorker
+  {
+    vtkCellArray* Polys;
+    const vtkIdType* KeptCellIds;
+    const vtkIdType* OutputOffsets;
+    vtkIdType* OutputConnectivity;
+    vtkSMPThreadLocalObject<vtkIdList> PointIds;
+
+    void operator()(vtkIdType beginKeptCellIndex, vtkIdType endKeptCellIndex)
+    {
+      vtkIdList* pointIds = this->PointIds.Local();
+      for (vtkIdType keptCellIndex = beginKeptCellIndex; keptCellIndex < endKeptCellIndex; ++keptCellIndex)
+        {
+        this->Polys->GetCellAtId(this->KeptCellIds[keptCellIndex], pointIds);
+        std::copy(pointIds->GetPointer(0), pointIds->GetPointer(0) + pointIds->GetNumberOfIds(),
+          this->OutputConnectivity + this->OutputOffsets[keptCellIndex]);
+        }
+    }
+  };
+}
+
 //----------------------------------------------------------------------------
 vtkCjyxDynamicModelerAppendTool::vtkCjyxDynamicModelerAppendTool()
 {
@@ -82,15 +321,15 @@ vtkCjyxDynamicModelerAppendTool::vtkCjyxDynamicModelerAppendTool()
     );
   this->OutputNodeInfo.push_back(outputModel);
 
-  this->AppendFilter = vtkSmartPointer<vtkAppendPolyData>::New();
-
   this->CleanFilter = vtkSmartPointer<vtkCleanPolyData>::New();
-  this->CleanFilter->SetInputConnection(this->AppendFilter->GetOutputPort());
 
   this->OutputWorldToModelTransform = vtkSmartPointer<vtkGeneralTransform>::New();
   this->OutputWorldToModelTransformFilter = vtkSmartPointer<vtkTransformPolyDataFilter>::New();
   this->OutputWorldToModelTransformFilter->SetInputConnection(this->CleanFilter->GetOutputPort());
   this->OutputWorldToModelTransformFilter->SetTransform(this->OutputWorldToModelTransform);
+
+  this->AddProgressObserver(this->CleanFilter, "Clean");
+  this->AddProgressObserver(this->OutputWorldToModelTransformFilter, "Output transform");
 }
 
 //----------------------------------------------------------------------------
@@ -126,131 +365,355 @@ bool vtkCjyxDynamicModelerAppendTool::RunInternal(vtkDMMLDynamicModelerNode* sur
     return true;
     }
 
-  this->AppendFilter->RemoveAllInputs();
+  // Only the inputs that changed are transformed again and the meshes are only concatenated
+  // (and cleaned) again if any of them changed.
+  bool inputMeshesChanged = false;
+    {
+    ProfileStageTimer timer(this, "Input transform");
+    inputMeshesChanged = this->UpdateInputMeshCache(surfaceEditorNode);
+    }
+  if (inputMeshesChanged || !this->AppendedMesh)
+    {
+    ProfileStageTimer timer(this, "Append");
+    this->AppendedMesh = vtkSmartPointer<vtkPolyData>::New();
+    vtkCjyxDynamicModelerAppendTool::AppendMeshes(this->AppendedWorldMeshes, this->AppendedMesh);
+    this->CleanFilter->SetInputData(this->AppendedMesh);
+    }
+
+  this->UpdateTransformBetweenNodes(nullptr, outputModelNode, this->OutputWorldToModelTransform);
+  this->OutputWorldToModelTransformFilter->Update();
+
+  vtkNew<vtkPolyData> outputPolyData;
+    {
+    ProfileStageTimer timer(this, "Remove duplicates");
+    this->RemoveDuplicateCells(this->OutputWorldToModelTransformFilter->GetOutput(), outputPolyData);
+    }
+
+  vtkCjyxDynamicModelerTool::SetOutputMesh(outputModelNode, outputPolyData);
+
+  return true;
+}
+
+//----------------------------------------------------------------------------
+bool vtkCjyxDynamicModelerAppendTool::UpdateInputMeshCache(vtkDMMLDynamicModelerNode* surfaceEditorNode)
+{
+  std::vector<vtkSmartPointer<vtkPolyData>> worldMeshes;
+  std::set<std::string> inputModelNodeIDs;
+  int numberOfInputNodes = surfaceEditorNode->GetNumberOfNodeReferences(APPEND_INPUT_MODEL_REFERENCE_ROLE);
   for (int i = 0; i < numberOfInputNodes; ++i)
     {
     vtkDMMLNode* inputNode = surfaceEditorNode->GetNthNodeReference(APPEND_INPUT_MODEL_REFERENCE_ROLE, i);
     vtkDMMLModelNode* modelNode = vtkDMMLModelNode::SafeDownCast(inputNode);
-    if (!modelNode)
+    if (!modelNode || !modelNode->GetID())
       {
       continue;
       }
+    inputModelNodeIDs.insert(modelNode->GetID());
 
-    vtkNew<vtkGeneralTransform> modelToWorldTransform;
-    if (modelNode->GetParentTransformNode())
+    InputMeshCacheEntry& cacheEntry = this->InputMeshCache[modelNode->GetID()];
+    if (!cacheEntry.ModelToWorldTransform)
       {
-      modelNode->GetParentTransformNode()->GetTransformToWorld(modelToWorldTransform);
+      cacheEntry.ModelToWorldTransform = vtkSmartPointer<vtkGeneralTransform>::New();
       }
-
-    vtkNew<vtkTransformPolyDataFilter> modelToWorldTransformFilter;
-    modelToWorldTransformFilter->SetInputData(modelNode->GetPolyData());
-    modelToWorldTransformFilter->SetTransform(modelToWorldTransform);
-    this->AppendFilter->AddInputConnection(modelToWorldTransformFilter->GetOutputPort());
+    bool identityTransform = this->UpdateTransformBetweenNodes(modelNode, nullptr, cacheEntry.ModelToWorldTransform);
+
+    std::vector<vtkSmartPointer<vtkObject>> inputMeshContent;
+    vtkMTimeType inputMeshContentMTime = 0;
+    vtkCjyxDynamicModelerTool::GetMeshContent(modelNode->GetPolyData(), inputMeshContent, inputMeshContentMTime);
+    if (!cacheEntry.WorldMesh
+      || cacheEntry.InputMeshContent != inputMeshContent
+      || cacheEntry.InputMeshContentMTime != inputMeshContentMTime
+      || cacheEntry.ModelToWorldTransformMTime != cacheEntry.ModelToWorldTransform->GetMTime())
+      {
+      cacheEntry.WorldMesh = vtkSmartPointer<vtkPolyData>::New();
+      if (modelNode->GetPolyData() && identityTransform)
+        {
+        cacheEntry.WorldMesh->ShallowCopy(modelNode->GetPolyData());
+        }
+      else if (modelNode->GetPolyData())
+        {
+        vtkNew<vtkTransformPolyDataFilter> modelToWorldTransformFilter;
+        modelToWorldTransformFilter->SetInputData(modelNode->GetPolyData());
+        modelToWorldTransformFilter->SetTransform(cacheEntry.ModelToWorldTransform);
+        modelToWorldTransformFilter->Update();
+        cacheEntry.WorldMesh->ShallowCopy(modelToWorldTransformFilter->GetOutput());
+        }
+      cacheEntry.InputMeshContent = inputMeshContent;
+      cacheEntry.InputMeshContentMTime = inputMeshContentMTime;
+      cacheEntry.ModelToWorldTransformMTime = cacheEntry.ModelToWorldTransform->GetMTime();
+      }
+    worldMeshes.push_back(cacheEntry.WorldMesh);
     }
 
-  if (outputModelNode->GetParentTransformNode())
+  // Release the meshes of models that are no longer appended
+  for (std::map<std::string, InputMeshCacheEntry>::iterator cacheEntryIt = this->InputMeshCache.begin();
+    cacheEntryIt != this->InputMeshCache.end();)
     {
-    outputModelNode->GetParentTransformNode()->GetTransformFromWorld(this->OutputWorldToModelTransform);
-    }
-  else
-    {
-    this->OutputWorldToModelTransform->Identity();
+    if (inputModelNodeIDs.find(cacheEntryIt->first) == inputModelNodeIDs.end())
+      {
+      this->TransformCache.erase(cacheEntryIt->second.ModelToWorldTransform);
+      cacheEntryIt = this->InputMeshCache.erase(cacheEntryIt);
+      }
+    else
+      {
+      ++cacheEntryIt;
+      }
     }
-  this->OutputWorldToModelTransformFilter->Update();
-
-  vtkNew<vtkPolyData> outputPolyData;
-  outputPolyData->DeepCopy(this->OutputWorldToModelTransformFilter->GetOutput());
-  this->RemoveDuplicateCells(outputPolyData);
-
-  DMMLNodeModifyBlocker blocker(outputModelNode);
-  outputModelNode->SetAndObservePolyData(outputPolyData);
-  outputModelNode->InvokeCustomModifiedEvent(vtkDMMLModelNode::MeshModifiedEvent);
 
-  return true;
+  bool appendedMeshesChanged = (worldMeshes != this->AppendedWorldMeshes);
+  this->AppendedWorldMeshes = worldMeshes;
+  return appendedMeshesChanged;
 }
 
 //----------------------------------------------------------------------------
-bool vtkCjyxDynamicModelerAppendTool::RemoveDuplicateCells(vtkPolyData* input)
+void vtkCjyxDynamicModelerAppendTool::AppendMeshes(const std::vector<vtkSmartPointer<vtkPolyData>>& meshes, vtkPolyData* outputMesh)
 {
-  vtkNew<vtkPolyData> output;
-  if (input->GetNumberOfPolys() == 0)
+  std::vector<vtkPolyData*> inputMeshes;
+  for (vtkPolyData* mesh : meshes)
     {
-    // set up a polyData with same data arrays as input, but
-    // no points, polys or data.
-    output->ShallowCopy(input);
-    return true;
+    if (mesh && mesh->GetNumberOfPoints() > 0)
+      {
+      inputMeshes.push_back(mesh);
+      }
     }
-
-  // Copy over the original points. Assume there are no degenerate points.
-  output->SetPoints(input->GetPoints());
-
-  // Remove duplicate polys.
-  std::map<std::set<int>, vtkIdType> polySet;
-  std::map<std::set<int>, vtkIdType>::iterator polyIter;
-
-  // Now copy the polys.
-  vtkNew<vtkIdList> polyPoints;
-  const vtkIdType numberOfPolys = input->GetNumberOfPolys();
-  vtkIdType progressStep = numberOfPolys / 100;
-  if (progressStep == 0)
+  int numberOfMeshes = static_cast<int>(inputMeshes.size());
+  if (numberOfMeshes == 0)
     {
-    progressStep = 1;
+    return;
     }
 
-  output->Allocate(input->GetNumberOfCells());
-  int ndup = 0;
+  // Compute the range of each mesh in the output arrays. The last element of each list is the total size.
+  std::vector<vtkIdType> pointStarts(numberOfMeshes + 1, 0);
+  std::vector<std::vector<vtkIdType>> cellStarts(NUMBER_OF_CELL_ARRAYS, std::vector<vtkIdType>(numberOfMeshes + 1, 0));
+  std::vector<std::vector<vtkIdType>> connectivityStarts(NUMBER_OF_CELL_ARRAYS, std::vector<vtkIdType>(numberOfMeshes + 1, 0));
+  int pointsDataType = VTK_FLOAT;
+  vtkDataSetAttributes::FieldList pointFieldList(numberOfMeshes);
+  vtkDataSetAttributes::FieldList cellFieldList(numberOfMeshes);
+  for (int meshIndex = 0; meshIndex < numberOfMeshes; ++meshIndex)
+    {
+    vtkPolyData* mesh = inputMeshes[meshIndex];
+    pointStarts[meshIndex + 1] = pointStarts[meshIndex] + mesh->GetNumberOfPoints();
+    for (int cellArrayIndex = 0; cellArrayIndex < NUMBER_OF_CELL_ARRAYS; ++cellArrayIndex)
+      {
+      vtkCellArray* cells = GetCellArray(mesh, cellArrayIndex);
+      cellStarts[cellArrayIndex][meshIndex + 1] = cellStarts[cellArrayIndex][meshIndex] + cells->GetNumberOfCells();
+      connectivityStarts[cellArrayIndex][meshIndex + 1] = connectivityStarts[cellArrayIndex][meshIndex] + cells->GetNumberOfConnectivityIds();
+      }
+    if (mesh->GetPoints()->GetDataType() == VTK_DOUBLE)
+      {
+      pointsDataType = VTK_DOUBLE;
+      }
+    if (meshIndex == 0)
+      {
+      pointFieldList.InitializeFieldList(mesh->GetPointData());
+      cellFieldList.InitializeFieldList(mesh->GetCellData());
+      }
+    else
+      {
+      pointFieldList.IntersectFieldList(mesh->GetPointData());
+      cellFieldList.IntersectFieldList(mesh->GetCellData());
+      }
+    }
 
-  output->GetPointData()->PassData(input->GetPointData());
-  output->GetCellData()->CopyAllocate(input->GetCellData(), numberOfPolys);
+  // Points and cells of each mesh are written into their own range of the preallocated arrays in parallel
+  vtkNew<vtkPoints> outputPoints;
+  outputPoints->SetDataType(pointsDataType);
+  outputPoints->SetNumberOfPoints(pointStarts[numberOfMeshes]);
+  for (int meshIndex = 0; meshIndex < numberOfMeshes; ++meshIndex)
+    {
+    CopyPointsWorker copyPointsWorker;
+    copyPointsWorker.Input = inputMeshes[meshIndex]->GetPoints()->GetData();
+    copyPointsWorker.Output = outputPoints->GetData();
+    copyPointsWorker.OutputStart = pointStarts[meshIndex];
+    vtkSMPTools::For(0, inputMeshes[meshIndex]->GetNumberOfPoints(), copyPointsWorker);
+    }
+  outputMesh->SetPoints(outputPoints);
 
-  for (int id = 0; id < numberOfPolys; ++id)
+  for (int cellArrayIndex = 0; cellArrayIndex < NUMBER_OF_CELL_ARRAYS; ++cellArrayIndex)
     {
-    // duplicate points do not make poly vertices or triangles
-    // strips degenerate so don't remove them
-    int polyType = input->GetCellType(id);
-    if (polyType == VTK_POLY_VERTEX || polyType == VTK_TRIANGLE_STRIP)
+    const std::vector<vtkIdType>& currentCellStarts = cellStarts[cellArrayIndex];
+    const std::vector<vtkIdType>& currentConnectivityStarts = connectivityStarts[cellArrayIndex];
+    vtkNew<vtkIdTypeArray> offsets;
+    offsets->SetNumberOfValues(currentCellStarts[numberOfMeshes] + 1);
+    vtkNew<vtkIdTypeArray> connectivity;
+    connectivity->SetNumberOfValues(currentConnectivityStarts[numberOfMeshes]);
+    for (int meshIndex = 0; meshIndex < numberOfMeshes; ++meshIndex)
       {
-      input->GetCellPoints(id, polyPoints);
-      vtkIdType newId = output->InsertNextCell(polyType, polyPoints);
-      output->GetCellData()->CopyData(input->GetCellData(), id, newId);
-      continue;
+      vtkCellArray* cells = GetCellArray(inputMeshes[meshIndex], cellArrayIndex);
+      if (cells->GetNumberOfCells() == 0)
+        {
+        continue;
+        }
+      CopyCells(cells, offsets->GetPointer(currentCellStarts[meshIndex]), currentConnectivityStarts[meshIndex],
+        connectivity->GetPointer(currentConnectivityStarts[meshIndex]), pointStarts[meshIndex]);
       }
+    offsets->SetValue(currentCellStarts[numberOfMeshes], currentConnectivityStarts[numberOfMeshes]);
+    vtkNew<vtkCellArray> outputCells;
+    outputCells->SetData(offsets, connectivity);
+    SetCellArray(outputMesh, cellArrayIndex, outputCells);
+    }
+
+  // Copy the data arrays that are present in all meshes
+  vtkPointData* outputPointData = outputMesh->GetPointData();
+  outputPointData->CopyAllocate(pointFieldList, pointStarts[numberOfMeshes]);
+  for (int meshIndex = 0; meshIndex < numberOfMeshes; ++meshIndex)
+    {
+    vtkPolyData* mesh = inputMeshes[meshIndex];
+    outputPointData->CopyData(pointFieldList, mesh->GetPointData(), meshIndex, pointStarts[meshIndex], mesh->GetNumberOfPoints(), 0);
+    }
 
-    input->GetCellPoints(id, polyPoints);
-    std::set<int> nn;
-    std::vector<int> ptIds;
-    for (int i = 0; i < polyPoints->GetNumberOfIds(); ++i)
+  // Output cell ids are ordered by cell array first (all verts, then all lines, ...), then by mesh
+  vtkCellData* outputCellData = outputMesh->GetCellData();
+  outputCellData->CopyAllocate(cellFieldList, outputMesh->GetNumberOfCells());
+  vtkIdType outputCellArrayStart = 0;
+  for (int cellArrayIndex = 0; cellArrayIndex < NUMBER_OF_CELL_ARRAYS; ++cellArrayIndex)
+    {
+    for (int meshIndex = 0; meshIndex < numberOfMeshes; ++meshIndex)
       {
-      int polyPtId = polyPoints->GetId(i);
-      nn.insert(polyPtId);
-      ptIds.push_back(polyPtId);
+      vtkPolyData* mesh = inputMeshes[meshIndex];
+      vtkIdType numberOfCells = GetCellArray(mesh, cellArrayIndex)->GetNumberOfCells();
+      if (numberOfCells == 0)
+        {
+        continue;
+        }
+      vtkIdType inputCellArrayStart = 0;
+      for (int previousCellArrayIndex = 0; previousCellArrayIndex < cellArrayIndex; ++previousCellArrayIndex)
+        {
+        inputCellArrayStart += GetCellArray(mesh, previousCellArrayIndex)->GetNumberOfCells();
+        }
+      outputCellData->CopyData(cellFieldList, mesh->GetCellData(), meshIndex,
+        outputCellArrayStart + cellStarts[cellArrayIndex][meshIndex], numberOfCells, inputCellArrayStart);
       }
+    outputCellArrayStart += cellStarts[cellArrayIndex][numberOfMeshes];
+    }
+}
+
+//----------------------------------------------------------------------------
+bool vtkCjyxDynamicModelerAppendTool::RemoveDuplicateCells(vtkPolyData* input, vtkPolyData* output)
+{
+  vtkCellArray* inputPolys = input->GetPolys();
+  vtkIdType numberOfPolys = input->GetNumberOfPolys();
+  if (numberOfPolys == 0)
+    {
+    output->ShallowCopy(input);
+    return true;
+    }
 
-    // this conditional may generate non-referenced nodes
-    polyIter = polySet.find(nn);
+  // Reserve a contiguous range of sorted point ids for each polygon
+  std::vector<vtkIdType> cellOffsets(numberOfPolys + 1);
+  cellOffsets[0] = 0;
+  for (vtkIdType cellId = 0; cellId < numberOfPolys; ++cellId)
+    {
+    cellOffsets[cellId + 1] = cellOffsets[cellId] + inputPolys->GetCellSize(cellId);
+    }
 
-    // only copy a cell to the output if it is neither degenerate nor duplicate
-    if (nn.size() == static_cast<unsigned int>(polyPoints->GetNumberOfIds()) &&
-      polyIter == polySet.end())
+  std::vector<vtkIdType> sortedPointIds(cellOffsets[numberOfPolys]);
+  std::vector<vtkTypeUInt64> cellHashes(numberOfPolys);
+  std::vector<unsigned char> degenerateCells(numberOfPolys);
+  SortCellPointIdsWorker sortCellPointIdsWorker;
+  sortCellPointIdsWorker.Polys = inputPolys;
+  sortCellPointIdsWorker.CellOffsets = cellOffsets.data();
+  sortCellPointIdsWorker.SortedPointIds = sortedPointIds.data();
+  sortCellPointIdsWorker.Hashes = cellHashes.data();
+  sortCellPointIdsWorker.Degenerate = degenerateCells.data();
+  vtkSMPTools::For(0, numberOfPolys, sortCellPointIdsWorker);
+
+  // Sort the non-degenerate polygons so that duplicates are next to each other, lowest cell id first
+  std::vector<vtkIdType> orderedCellIds;
+  orderedCellIds.reserve(numberOfPolys);
+  for (vtkIdType cellId = 0; cellId < numberOfPolys; ++cellId)
+    {
+    if (!degenerateCells[cellId])
       {
-      vtkIdType newId = output->InsertNextCell(input->GetCellType(id), polyPoints);
-      output->GetCellData()->CopyData(input->GetCellData(), id, newId);
-      polySet[nn] = newId;
+      orderedCellIds.push_back(cellId);
       }
-    else if (polyIter != polySet.end())
+    }
+  CellKeys cellKeys;
+  cellKeys.CellOffsets = cellOffsets.data();
+  cellKeys.SortedPointIds = sortedPointIds.data();
+  cellKeys.Hashes = cellHashes.data();
+  vtkSMPTools::Sort(orderedCellIds.begin(), orderedCellIds.end(), CellKeyLess{ &cellKeys });
+
+  // The first polygon of each run of equal keys is kept
+  std::vector<unsigned char> keepCells(numberOfPolys, 0);
+  MarkUniqueCellsWorker markUniqueCellsWorker;
+  markUniqueCellsWorker.Keys = &cellKeys;
+  markUniqueCellsWorker.OrderedCellIds = orderedCellIds.data();
+  markUniqueCellsWorker.Keep = keepCells.data();
+  vtkSMPTools::For(0, static_cast<vtkIdType>(orderedCellIds.size()), markUniqueCellsWorker);
+
+  // Compute the output range of each kept polygon
+  std::vector<vtkIdType> keptCellIds;
+  keptCellIds.reserve(orderedCellIds.size());
+  std::vector<vtkIdType> outputOffsets;
+  outputOffsets.reserve(orderedCellIds.size() + 1);
+  outputOffsets.push_back(0);
+  for (vtkIdType cellId = 0; cellId < numberOfPolys; ++cellId)
+    {
+    if (keepCells[cellId])
       {
-      ++ndup; // cell has duplicate(s)
+      keptCellIds.push_back(cellId);
+      outputOffsets.push_back(outputOffsets.back() + cellOffsets[cellId + 1] - cellOffsets[cellId]);
       }
     }
-
-  if (ndup)
+  vtkIdType numberOfKeptPolys = static_cast<vtkIdType>(keptCellIds.size());
+  if (numberOfKeptPolys == numberOfPolys)
     {
-    vtkDebugMacro(<< "vtkRemoveDuplicatePolys : " << ndup
-      << " duplicate polys (multiple instances of a polygon) have been"
-      << " removed." << endl);
-
-    output->Squeeze();
+    // No degenerate or duplicate polygons
+    output->ShallowCopy(input);
+    return true;
     }
-  input->DeepCopy(output);
+  vtkDebugMacro("RemoveDuplicateCells: " << numberOfPolys - numberOfKeptPolys << " degenerate or duplicate polygons have been removed");
+
+  vtkNew<vtkIdTypeArray> offsets;
+  offsets->SetNumberOfValues(numberOfKeptPolys + 1);
+  std::copy(outputOffsets.begin(), outputOffsets.end(), offsets->GetPointer(0));
+  vtkNew<vtkIdTypeArray> connectivity;
+  connectivity->SetNumberOfValues(outputOffsets.back());
+  CopyKeptCellsWorker copyKeptCellsWorker;
+  copyKeptCellsWorker.Polys = inputPolys;
+  copyKeptCellsWorker.KeptCellIds = keptCellIds.data();
+  copyKeptCellsWorker.OutputOffsets = outputOffsets.data();
+  copyKeptCellsWorker.OutputConnectivity = connectivity->GetPointer(0);
+  vtkSMPTools::For(0, numberOfKeptPolys, copyKeptCellsWorker);
+  vtkNew<vtkCellArray> outputPolys;
+  outputPolys->SetData(offsets, connectivity);
+
+  output->Initialize();
+  output->SetPoints(input->GetPoints());
+  output->GetPointData()->PassData(input->GetPointData());
+  output->SetVerts(input->GetVerts());
+  output->SetLines(input->GetLines());
+  output->SetPolys(outputPolys);
+  output->SetStrips(input->GetStrips());
+
+  // Cell ids are ordered as verts, lines, polys, strips
+  vtkIdType numberOfVertsAndLines = input->GetNumberOfVerts() + input->GetNumberOfLines();
+  vtkIdType numberOfStrips = input->GetNumberOfStrips();
+  vtkIdType numberOfOutputCells = numberOfVertsAndLines + numberOfKeptPolys + numberOfStrips;
+  vtkNew<vtkIdList> inputCellIds;
+  inputCellIds->SetNumberOfIds(numberOfOutputCells);
+  vtkNew<vtkIdList> outputCellIds;
+  outputCellIds->SetNumberOfIds(numberOfOutputCells);
+  vtkIdType outputCellId = 0;
+  for (vtkIdType cellId = 0; cellId < numberOfVertsAndLines; ++cellId, ++outputCellId)
+    {
+    inputCellIds->SetId(outputCellId, cellId);
+    outputCellIds->SetId(outputCellId, outputCellId);
+    }
+  for (vtkIdType keptCellId : keptCellIds)
+    {
+    inputCellIds->SetId(outputCellId, numberOfVertsAndLines + keptCellId);
+    outputCellIds->SetId(outputCellId, outputCellId);
+    ++outputCellId;
+    }
+  for (vtkIdType stripId = 0; stripId < numberOfStrips; ++stripId, ++outputCellId)
+    {
+    inputCellIds->SetId(outputCellId, numberOfVertsAndLines + numberOfPolys + stripId);
+    outputCellIds->SetId(outputCellId, outputCellId);
+    }
+  output->GetCellData()->CopyAllocate(input->GetCellData(), numberOfOutputCells);
+  output->GetCellData()->CopyData(input->GetCellData(), inputCellIds, outputCellIds);
+
   return true;
-}
\ No newline at end of file
+}
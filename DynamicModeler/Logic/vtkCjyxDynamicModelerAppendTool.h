@@ -32,7 +32,6 @@
 #include <string>
 #include <vector>
 
-class vtkAppendPolyData;
 class vtkCleanPolyData;
 class vtkGeneralTransform;
 class vtkPolyData;
@@ -61,12 +60,39 @@ protected:
   ~vtkCjyxDynamicModelerAppendTool() override;
   void operator=(const vtkCjyxDynamicModelerAppendTool&);
 
-  /// Method duplicated from vtkRemoveDuplicatePolys
-  /// TODO: Remove when vtk is updated
-  bool RemoveDuplicateCells(vtkPolyData* polyData);
+  /// Update the cached world coordinate system mesh of each input model.
+  /// Only inputs whose mesh content or parent transform changed since the last run are transformed again.
+  /// Returns true if any of the appended meshes changed.
+  bool UpdateInputMeshCache(vtkDMMLDynamicModelerNode* surfaceEditorNode);
+
+  /// Concatenate the meshes into the output mesh. Output points and cells are allocated once and
+  /// the meshes are copied into their own range in parallel.
+  /// Only point and cell data arrays that exist in all the meshes are kept.
+  static void AppendMeshes(const std::vector<vtkSmartPointer<vtkPolyData>>& meshes, vtkPolyData* outputMesh);
+
+  /// Copy the input mesh to the output mesh without degenerate polygons and without duplicate polygons
+  /// (polygons that have the same set of point ids as a polygon with lower cell id).
+  /// Polygons are compared by their sorted point ids, which are sorted and compared in parallel.
+  /// Points, verts, lines and strips are shared with the input mesh.
+  bool RemoveDuplicateCells(vtkPolyData* input, vtkPolyData* output);
 
 protected:
-  vtkSmartPointer<vtkAppendPolyData>          AppendFilter;
+  /// Input model mesh transformed to world coordinate system, cached between runs
+  struct InputMeshCacheEntry
+  {
+    /// Points, cells and data arrays of the input mesh that the cached mesh was computed from
+    std::vector<vtkSmartPointer<vtkObject>> InputMeshContent;
+    vtkMTimeType InputMeshContentMTime{ 0 };
+    vtkSmartPointer<vtkGeneralTransform> ModelToWorldTransform;
+    vtkMTimeType ModelToWorldTransformMTime{ 0 };
+    vtkSmartPointer<vtkPolyData> WorldMesh;
+  };
+  /// Cached meshes, indexed by input model node ID
+  std::map<std::string, InputMeshCacheEntry> InputMeshCache;
+  /// World meshes that were concatenated in the last run, in input order
+  std::vector<vtkSmartPointer<vtkPolyData>> AppendedWorldMeshes;
+  vtkSmartPointer<vtkPolyData>                AppendedMesh;
+
   vtkSmartPointer<vtkCleanPolyData>           CleanFilter;
 
   vtkSmartPointer<vtkGeneralTransform>        OutputWorldToModelTransform;
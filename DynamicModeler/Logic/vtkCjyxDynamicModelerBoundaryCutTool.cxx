@@ -30,26 +30,35 @@
 // VTK includes
 #include <vtkAppendPolyData.h>
 #include <vtkCellData.h>
-#include <vtkCellLocator.h>
 #include <vtkCleanPolyData.h>
 #include <vtkClipPolyData.h>
 #include <vtkCommand.h>
 #include <vtkConnectivityFilter.h>
-#include <vtkExtractPolyDataGeometry.h>
-#include <vtkFeatureEdges.h>
+#include <vtkDoubleArray.h>
 #include <vtkGeneralTransform.h>
+#include <vtkIdList.h>
+#include <vtkIdTypeArray.h>
 #include <vtkIntArray.h>
 #include <vtkPlane.h>
 #include <vtkPointData.h>
 #include <vtkPointLocator.h>
 #include <vtkPolyDataConnectivityFilter.h>
+#include <vtkSMPThreadLocalObject.h>
+#include <vtkSMPTools.h>
 #include <vtkSmartPointer.h>
 #include <vtkStringArray.h>
-#include <vtkStripper.h>
 #include <vtkTransformPolyDataFilter.h>
 
+// STD includes
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <utility>
+#include <vector>
+
 // DynamicModelerLogic includes
-#include "vtkImplicitPolyDataPointDistance.h"
+#include "vtkImplicitPolyDataSegmentDistance.h"
+#include "vtkParallelPlaneClipper.h"
 
 // DynamicModelerDMML includes
 #include "vtkDMMLDynamicModelerNode.h"
@@ -62,6 +71,152 @@ const char* INPUT_MODEL_REFERENCE_ROLE = "BoundaryCut.InputModel";
 const char* INPUT_SEED_REFERENCE_ROLE = "BoundaryCut.InputSeed";
 const char* OUTPUT_MODEL_REFERENCE_ROLE = "BoundaryCut.OutputModel";
 
+// Point scalar that contains the squared distance from the borders during clipping, removed from the output
+const char* BORDER_DISTANCE_ARRAY_NAME = "BoundaryCut.BorderDistance";
+// Point ids of the clipped mesh, used for finding the region of the seed points, removed from the output
+const char* CLIPPED_POINT_ID_ARRAY_NAME = "BoundaryCut.ClippedPointId";
+
+namespace
+{
+  //----------------------------------------------------------------------------
+  /// Mark the points of the cells that have both points inside the clip band and points outside of the
+  /// maximum distance. The exact distance of these points determines where the cell is cut.
+  struct MarkBandNeighborPointsWorker
+  {
+    vtkCellArray* Cells;
+    const double* Distances;
+    double ClipValue;
+    double MaximumDistance2;
+    unsigned char* ExactPoints;
+    vtkSMPThreadLocalObject<vtkIdList> PointIds;
+
+    void operator()(vtkIdType beginCellId, vtkIdType endCellId)
+    {
+      vtkIdList* pointIds = this->PointIds.Local();
+      for (vtkIdType cellId = beginCellId; cellId < endCellId; ++cellId)
+        {
+        this->Cells->GetCellAtId(cellId, pointIds);
+        bool insideBand = false;
+        bool outsideBand = false;
+        for (vtkIdType i = 0; i < pointIds->GetNumberOfIds(); ++i)
+          {
+          double distance2 = this->Distances[pointIds->GetId(i)];
+          insideBand |= (distance2 < this->ClipValue);
+          outsideBand |= (distance2 >= this->MaximumDistance2);
+          }
+        if (!insideBand || !outsideBand)
+          {
+          continue;
+          }
+        for (vtkIdType i = 0; i < pointIds->GetNumberOfIds(); ++i)
+          {
+          vtkIdType pointId = pointIds->GetId(i);
+          if (this->Distances[pointId] >= this->MaximumDistance2)
+            {
+            this->ExactPoints[pointId] = 1;
+            }
+          }
+        }
+    }
+  };
+
+  //----------------------------------------------------------------------------
+  struct ComputeExactDistancesWorker
+  {
+    vtkImplicitPolyDataSegmentDistance* Distance;
+    vtkPoints* Points;
+    const vtkIdType* PointIds;
+    double* Distances;
+
+    void operator()(vtkIdType begin, vtkIdType end)
+    {
+      double point[3] = { 0.0, 0.0, 0.0 };
+      for (vtkIdType i = begin; i < end; ++i)
+        {
+        this->Points->GetPoint(this->PointIds[i], point);
+        this->Distances[this->PointIds[i]] = this->Distance->EvaluateSquaredDistance(point, -1.0);
+        }
+    }
+  };
+
+  //----------------------------------------------------------------------------
+  /// Find the region of the seed points from the colored points. Seeds are sorted by clipped point id.
+  struct FindSeedRegionsWorker
+  {
+    const vtkIdType* ClippedPointIds;
+    const vtkIdType* PointRegionIds;
+    const std::vector<std::pair<vtkIdType, vtkIdType> >* Seeds;
+    vtkIdType* SeedRegionIds;
+
+    void operator()(vtkIdType beginPointId, vtkIdType endPointId)
+    {
+      for (vtkIdType pointId = beginPointId; pointId < endPointId; ++pointId)
+        {
+        vtkIdType clippedPointId = this->ClippedPointIds[pointId];
+        std::vector<std::pair<vtkIdType, vtkIdType> >::const_iterator seedIt = std::lower_bound(this->Seeds->begin(),
+          this->Seeds->end(), std::make_pair(clippedPointId, static_cast<vtkIdType>(-1)));
+        for (; seedIt != this->Seeds->end() && seedIt->first == clippedPointId; ++seedIt)
+          {
+          this->SeedRegionIds[seedIt->second] = this->PointRegionIds[pointId];
+          }
+        }
+    }
+  };
+
+  //----------------------------------------------------------------------------
+  /// Replace the region id of each cell using a lookup table indexed by region id.
+  struct RelabelRegionsWorker
+  {
+    vtkIdType* RegionIds;
+    const std::vector<vtkIdType>* LookupTable;
+
+    void operator()(vtkIdType beginCellId, vtkIdType endCellId)
+    {
+      vtkIdType numberOfRegions = static_cast<vtkIdType>(this->LookupTable->size());
+      for (vtkIdType cellId = beginCellId; cellId < endCellId; ++cellId)
+        {
+        vtkIdType regionId = this->RegionIds[cellId];
+        this->RegionIds[cellId] = (regionId >= 0 && regionId < numberOfRegions) ? (*this->LookupTable)[regionId] : 0;
+        }
+    }
+  };
+
+  //----------------------------------------------------------------------------
+  /// Returns true if the two polydata have the same points and lines.
+  bool HaveSameLines(vtkPolyData* polyData1, vtkPolyData* polyData2)
+  {
+    if (polyData1->GetNumberOfPoints() != polyData2->GetNumberOfPoints()
+      || polyData1->GetNumberOfLines() != polyData2->GetNumberOfLines())
+      {
+      return false;
+      }
+    double point1[3] = { 0.0, 0.0, 0.0 };
+    double point2[3] = { 0.0, 0.0, 0.0 };
+    for (vtkIdType pointId = 0; pointId < polyData1->GetNumberOfPoints(); ++pointId)
+      {
+      polyData1->GetPoint(pointId, point1);
+      polyData2->GetPoint(pointId, point2);
+      if (point1[0] != point2[0] || point1[1] != point2[1] || point1[2] != point2[2])
+        {
+        return false;
+        }
+      }
+    vtkNew<vtkIdList> line1;
+    vtkNew<vtkIdList> line2;
+    for (vtkIdType lineId = 0; lineId < polyData1->GetNumberOfLines(); ++lineId)
+      {
+      polyData1->GetLines()->GetCellAtId(lineId, line1);
+      polyData2->GetLines()->GetCellAtId(lineId, line2);
+      if (line1->GetNumberOfIds() != line2->GetNumberOfIds()
+        || !std::equal(line1->begin(), line1->end(), line2->begin()))
+        {
+        return false;
+        }
+      }
+    return true;
+  }
+}
+
 //----------------------------------------------------------------------------
 vtkCjyxDynamicModelerBoundaryCutTool::vtkCjyxDynamicModelerBoundaryCutTool()
 {
@@ -137,7 +292,6 @@ vtkCjyxDynamicModelerBoundaryCutTool::vtkCjyxDynamicModelerBoundaryCutTool()
 
   double epsilon = 1e-5;
   this->ClipPolyData = vtkSmartPointer<vtkClipPolyData>::New();
-  this->ClipPolyData->SetInputConnection(this->InputModelToWorldTransformFilter->GetOutputPort());
   this->ClipPolyData->SetValue(epsilon);
   this->ClipPolyData->InsideOutOn();
   this->ClipPolyData->GenerateClippedOutputOn();
@@ -160,6 +314,14 @@ vtkCjyxDynamicModelerBoundaryCutTool::vtkCjyxDynamicModelerBoundaryCutTool()
   this->OutputWorldToModelTransformFilter->SetTransform(this->OutputWorldToModelTransform);
 
   this->ClippedModelPointLocator = vtkSmartPointer<vtkPointLocator>::New();
+
+  this->AddProgressObserver(this->InputCleanFilter, "Clean");
+  this->AddProgressObserver(this->InputModelToWorldTransformFilter, "Input transform");
+  this->AddProgressObserver(this->ClipPolyData, "Clip");
+  this->AddProgressObserver(this->Connectivity, "Connectivity");
+  this->AddProgressObserver(this->ColorConnectivity, "Connectivity");
+  this->AddProgressObserver(this->OutputCleanFilter, "Clean");
+  this->AddProgressObserver(this->OutputWorldToModelTransformFilter, "Output transform");
 }
 
 //----------------------------------------------------------------------------
@@ -202,15 +364,19 @@ bool vtkCjyxDynamicModelerBoundaryCutTool::RunInternal(vtkDMMLDynamicModelerNode
     return true;
     }
 
-  this->InputCleanFilter->SetInputData(inputPolyData);
-  if (inputModelNode->GetParentTransformNode())
+  // Runs on snapshots get a new shallow copy of the same mesh, only replace the input if its content changed
+  std::vector<vtkSmartPointer<vtkObject>> inputMeshContent;
+  vtkMTimeType inputMeshContentMTime = 0;
+  vtkCjyxDynamicModelerTool::GetMeshContent(inputPolyData, inputMeshContent, inputMeshContentMTime);
+  if (inputMeshContent != this->InputMeshContent || inputMeshContentMTime != this->InputMeshContentMTime)
     {
-    inputModelNode->GetParentTransformNode()->GetTransformToWorld(this->InputModelToWorldTransform);
-    }
-  else
-    {
-    this->InputModelToWorldTransform->Identity();
+    this->InputCleanFilter->SetInputData(inputPolyData);
+    this->InputMeshContent = inputMeshContent;
+    this->InputMeshContentMTime = inputMeshContentMTime;
     }
+  this->UpdateTransformBetweenNodes(inputModelNode, nullptr, this->InputModelToWorldTransform);
+  this->InputModelToWorldTransformFilter->Update();
+  vtkPolyData* inputMesh_World = this->InputModelToWorldTransformFilter->GetOutput();
 
   vtkNew<vtkAppendPolyData> appendFilter;
   int numberOfInputNodes = surfaceEditorNode->GetNumberOfNodeReferences(INPUT_BORDER_REFERENCE_ROLE);
@@ -237,25 +403,9 @@ bool vtkCjyxDynamicModelerBoundaryCutTool::RunInternal(vtkDMMLDynamicModelerNode
       plane->SetNormal(normal_World);
       plane->SetOrigin(origin_World);
 
-      vtkNew<vtkExtractPolyDataGeometry> planeExtractor;
-      planeExtractor->SetInputConnection(this->InputModelToWorldTransformFilter->GetOutputPort());
-      planeExtractor->SetImplicitFunction(plane);
-      planeExtractor->ExtractInsideOff();
-      planeExtractor->ExtractBoundaryCellsOff();
-
-      vtkNew<vtkFeatureEdges> boundaryEdges;
-      boundaryEdges->SetInputConnection(planeExtractor->GetOutputPort());
-      boundaryEdges->BoundaryEdgesOn();
-      boundaryEdges->FeatureEdgesOff();
-      boundaryEdges->NonManifoldEdgesOff();
-      boundaryEdges->ManifoldEdgesOff();
-
-      vtkNew<vtkStripper> boundaryStrips;
-      boundaryStrips->SetInputConnection(boundaryEdges->GetOutputPort());
-      boundaryStrips->Update();
-
-      outputLinePolyData->SetPoints(boundaryStrips->GetOutput()->GetPoints());
-      outputLinePolyData->SetLines(boundaryStrips->GetOutput()->GetLines());
+      // Border of the mesh part on the positive side of the plane. The border runs along mesh edges, so that its
+      // points are in the clip band and the mesh is cut there.
+      vtkParallelPlaneClipper::ExtractPlaneBorder(inputMesh_World, plane, outputLinePolyData);
       }
 
     vtkDMMLMarkupsCurveNode* curveNode = vtkDMMLMarkupsCurveNode::SafeDownCast(inputNode);
@@ -290,98 +440,168 @@ bool vtkCjyxDynamicModelerBoundaryCutTool::RunInternal(vtkDMMLDynamicModelerNode
     return false;
     }
 
-  vtkNew<vtkImplicitPolyDataPointDistance> distance;
-  distance->SetInput(curvePointCleanFilter->GetOutput());
-
-  this->ClipPolyData->SetClipFunction(distance);
-  this->ClipPolyData->Update();
-
-  this->ClippedModelPointLocator->SetDataSet(this->ClipPolyData->GetOutput());
-  this->ClippedModelPointLocator->BuildLocator();
+  // The clip and the point locator of the clipped mesh are reused if the mesh and the borders did not change
+  vtkPolyData* borders = curvePointCleanFilter->GetOutput();
+  if (!this->ClippedBorders || this->ClippedInputMeshMTime != inputMesh_World->GetMTime()
+    || !HaveSameLines(borders, this->ClippedBorders))
+    {
+    vtkNew<vtkDoubleArray> borderDistance;
+    borderDistance->SetName(BORDER_DISTANCE_ARRAY_NAME);
+    this->ComputeBorderDistance(borders, inputMesh_World, this->ClipPolyData->GetValue(), borderDistance);
+
+    // The distance is clipped as point scalar of a shallow copy, the other point data of the input is not modified
+    vtkNew<vtkPolyData> inputMeshWithDistance_World;
+    inputMeshWithDistance_World->ShallowCopy(inputMesh_World);
+    vtkPointData* inputPointData = inputMeshWithDistance_World->GetPointData();
+    std::string activeScalarsName = inputPointData->GetScalars() && inputPointData->GetScalars()->GetName()
+      ? inputPointData->GetScalars()->GetName() : "";
+    inputPointData->AddArray(borderDistance);
+    inputPointData->SetActiveScalars(BORDER_DISTANCE_ARRAY_NAME);
+    this->ClipPolyData->SetInputData(inputMeshWithDistance_World);
+    this->ClipPolyData->Update();
+
+    vtkPolyData* clippedPolyData = this->ClipPolyData->GetClippedOutput();
+    vtkPointData* clippedPointData = clippedPolyData->GetPointData();
+    clippedPointData->RemoveArray(BORDER_DISTANCE_ARRAY_NAME);
+    if (!activeScalarsName.empty())
+      {
+      clippedPointData->SetActiveScalars(activeScalarsName.c_str());
+      }
+    vtkNew<vtkIdTypeArray> clippedPointIds;
+    clippedPointIds->SetName(CLIPPED_POINT_ID_ARRAY_NAME);
+    clippedPointIds->SetNumberOfValues(clippedPolyData->GetNumberOfPoints());
+    std::iota(clippedPointIds->GetPointer(0), clippedPointIds->GetPointer(0) + clippedPolyData->GetNumberOfPoints(), 0);
+    clippedPointData->AddArray(clippedPointIds);
+
+    // Both outputs of the clip share the same points
+    this->ClippedModelPointLocator->SetDataSet(this->ClipPolyData->GetOutput());
+    this->ClippedModelPointLocator->BuildLocator();
+    this->ClippedBorders = borders;
+    this->ClippedInputMeshMTime = inputMesh_World->GetMTime();
+    }
 
   vtkNew<vtkPoints> seedPoints;
   this->GetSeedPoints(surfaceEditorNode, seedPoints);
+  vtkNew<vtkIdList> seedPointIds;
   this->Connectivity->InitializeSeedList();
   for (int i = 0; i < seedPoints->GetNumberOfPoints(); ++i)
     {
     double* seedPoint = seedPoints->GetPoint(i);
     vtkIdType pointId = this->ClippedModelPointLocator->FindClosestPoint(seedPoint);
     this->Connectivity->AddSeed(pointId);
+    seedPointIds->InsertNextId(pointId);
     }
 
-  this->ColorOutputRegions(seedPoints);
-  if (outputModelNode && outputModelNode->GetParentTransformNode())
-    {
-    outputModelNode->GetParentTransformNode()->GetTransformFromWorld(this->OutputWorldToModelTransform);
-    }
-  else
-    {
-    this->OutputWorldToModelTransform->Identity();
-    }
+  this->ColorOutputRegions(seedPointIds);
+  this->UpdateTransformBetweenNodes(nullptr, outputModelNode, this->OutputWorldToModelTransform);
   this->OutputWorldToModelTransformFilter->Update();
 
-  vtkNew<vtkPolyData> outputPolyData;
-  outputPolyData->DeepCopy(this->OutputWorldToModelTransformFilter->GetOutput());
-
-  DMMLNodeModifyBlocker blocker(outputModelNode);
-  outputModelNode->SetAndObserveMesh(outputPolyData);
-  outputModelNode->InvokeCustomModifiedEvent(vtkDMMLModelNode::MeshModifiedEvent);
+  vtkCjyxDynamicModelerTool::SetOutputMesh(outputModelNode, this->OutputWorldToModelTransformFilter->GetOutput());
 
   return true;
 }
 
 //----------------------------------------------------------------------------
-void vtkCjyxDynamicModelerBoundaryCutTool::ColorOutputRegions(vtkPoints* seedPoints)
+void vtkCjyxDynamicModelerBoundaryCutTool::ComputeBorderDistance(vtkPolyData* borders, vtkPolyData* mesh, double clipValue,
+  vtkDoubleArray* distances)
+{
+  ProfileStageTimer timer(this, "Border distance");
+  vtkPoints* points = mesh->GetPoints();
+  vtkIdType numberOfPoints = mesh->GetNumberOfPoints();
+  distances->SetNumberOfComponents(1);
+  distances->SetNumberOfTuples(numberOfPoints);
+  if (!points || numberOfPoints < 1)
+    {
+    return;
+    }
+
+  // Only the points in a narrow band around the borders are searched, the rest are classified by bounding box.
+  vtkNew<vtkImplicitPolyDataSegmentDistance> distance;
+  distance->SetInput(borders);
+  double maximumDistance = 2.0 * std::sqrt(clipValue);
+  distance->SetMaximumDistance(maximumDistance);
+  distance->EvaluateFunction(points->GetData(), distances);
+
+  // Cells that are cut by the clip band need the exact value at all of their points, otherwise the cut would be moved.
+  // These are only the cells around the borders.
+  double* distanceValues = distances->GetPointer(0);
+  std::vector<unsigned char> exactPoints(numberOfPoints, 0);
+  vtkCellArray* cellArrays[3] = { mesh->GetPolys(), mesh->GetStrips(), mesh->GetLines() };
+  for (vtkCellArray* cells : cellArrays)
+    {
+    if (!cells || cells->GetNumberOfCells() < 1)
+      {
+      continue;
+      }
+    MarkBandNeighborPointsWorker markBandNeighborPointsWorker;
+    markBandNeighborPointsWorker.Cells = cells;
+    markBandNeighborPointsWorker.Distances = distanceValues;
+    markBandNeighborPointsWorker.ClipValue = clipValue;
+    markBandNeighborPointsWorker.MaximumDistance2 = maximumDistance * maximumDistance;
+    markBandNeighborPointsWorker.ExactPoints = exactPoints.data();
+    vtkSMPTools::For(0, cells->GetNumberOfCells(), markBandNeighborPointsWorker);
+    }
+  std::vector<vtkIdType> exactPointIds;
+  for (vtkIdType pointId = 0; pointId < numberOfPoints; ++pointId)
+    {
+    if (exactPoints[pointId])
+      {
+      exactPointIds.push_back(pointId);
+      }
+    }
+  ComputeExactDistancesWorker computeExactDistancesWorker{ distance, points, exactPointIds.data(), distanceValues };
+  vtkSMPTools::For(0, static_cast<vtkIdType>(exactPointIds.size()), computeExactDistancesWorker);
+}
+
+//----------------------------------------------------------------------------
+void vtkCjyxDynamicModelerBoundaryCutTool::ColorOutputRegions(vtkIdList* seedPointIds)
 {
   this->ColorConnectivity->Update();
 
   vtkPolyData* coloredPolyData = this->ColorConnectivity->GetPolyDataOutput();
-  if (coloredPolyData)
+  if (!coloredPolyData)
     {
-    coloredPolyData->GetPointData()->RemoveArray("RegionId"); // We only want the need the cell data color
+    return;
+    }
 
-    vtkIdTypeArray* regionArray = vtkIdTypeArray::SafeDownCast(coloredPolyData->GetCellData()->GetArray("RegionId"));
-    if (regionArray)
+  vtkPointData* coloredPointData = coloredPolyData->GetPointData();
+  vtkIdTypeArray* pointRegionArray = vtkIdTypeArray::SafeDownCast(coloredPointData->GetArray("RegionId"));
+  vtkIdTypeArray* clippedPointIdArray = vtkIdTypeArray::SafeDownCast(coloredPointData->GetArray(CLIPPED_POINT_ID_ARRAY_NAME));
+  vtkIdTypeArray* regionArray = vtkIdTypeArray::SafeDownCast(coloredPolyData->GetCellData()->GetArray("RegionId"));
+  if (regionArray && pointRegionArray && clippedPointIdArray)
+    {
+    // Determine the region of each seed from the colored point that was created from the seed point.
+    std::vector<std::pair<vtkIdType, vtkIdType> > seeds;
+    for (vtkIdType i = 0; i < seedPointIds->GetNumberOfIds(); ++i)
       {
-      std::map<vtkIdType, vtkIdType> regionMap;
-      vtkNew<vtkCellLocator> cellLocator;
-      cellLocator->SetDataSet(coloredPolyData);
-      cellLocator->BuildLocator();
-
-      // Determine what the scalar value should be for each of the input seed regions.
-      // Scalar values should be fiducial index + 1.
-      for (int i = 0; i < seedPoints->GetNumberOfPoints(); ++i)
-        {
-        double* seedPoint = seedPoints->GetPoint(i);
-        vtkIdType cellId = -1;
-        int subId;
-        double dist2;
-        double closestPoint[3];
-        cellLocator->FindClosestPoint(seedPoint, closestPoint, cellId, subId, dist2);
-        if (cellId > 0)
-          {
-          vtkIdType oldRegionId = regionArray->GetValue(cellId);
-          vtkIdType newRegionId = i + 1;
-          regionMap[oldRegionId] = newRegionId;
-          }
-        }
-
-      // Replace values in the cell data array with the updated region ids
-      long long* pointer = regionArray->GetPointer(0);
-      for (int i = 0; i < regionArray->GetNumberOfValues(); ++i)
+      seeds.emplace_back(seedPointIds->GetId(i), i);
+      }
+    std::sort(seeds.begin(), seeds.end());
+    std::vector<vtkIdType> seedRegionIds(seeds.size(), -1);
+    FindSeedRegionsWorker findSeedRegionsWorker{ clippedPointIdArray->GetPointer(0), pointRegionArray->GetPointer(0),
+      &seeds, seedRegionIds.data() };
+    vtkSMPTools::For(0, coloredPolyData->GetNumberOfPoints(), findSeedRegionsWorker);
+
+    // Scalar values should be fiducial index + 1, regions without seed are set to 0.
+    std::vector<vtkIdType> regionLookupTable(this->ColorConnectivity->GetNumberOfExtractedRegions(), 0);
+    for (size_t seedIndex = 0; seedIndex < seedRegionIds.size(); ++seedIndex)
+      {
+      vtkIdType regionId = seedRegionIds[seedIndex];
+      if (regionId >= 0 && regionId < static_cast<vtkIdType>(regionLookupTable.size()))
         {
-        if (regionMap.find(*pointer) == regionMap.end())
-          {
-          *pointer = 0;
-          }
-        else
-          {
-          *pointer = regionMap[*pointer];
-          }
-        ++pointer;
+        regionLookupTable[regionId] = static_cast<vtkIdType>(seedIndex) + 1;
         }
       }
+
+    // Replace values in the cell data array with the updated region ids
+    RelabelRegionsWorker relabelRegionsWorker{ regionArray->GetPointer(0), &regionLookupTable };
+    vtkSMPTools::For(0, regionArray->GetNumberOfValues(), relabelRegionsWorker);
+    regionArray->Modified();
     }
+
+  // We only want the cell data color
+  coloredPointData->RemoveArray("RegionId");
+  coloredPointData->RemoveArray(CLIPPED_POINT_ID_ARRAY_NAME);
 }
 
 //----------------------------------------------------------------------------
@@ -36,8 +36,10 @@ class vtkCleanPolyData;
 class vtkClipPolyData;
 class vtkConnectivityFilter;
 class vtkDataObject;
+class vtkDoubleArray;
 class vtkGeneralTransform;
 class vtkGeometryFilter;
+class vtkIdList;
 class vtkImplicitBoolean;
 class vtkDMMLDynamicModelerNode;
 class vtkPlane;
@@ -79,9 +81,14 @@ protected:
   /// The default seed point location. Calculated from the center of all input control points
   virtual void GetDefaultSeedPoint(vtkDMMLDynamicModelerNode* surfaceEditorNode, double seedPoint[3]);
 
+  /// Compute the squared distance of each mesh point from the border lines. Points that are farther from the borders
+  /// than the clip band get an approximate value that is above the clip value.
+  virtual void ComputeBorderDistance(vtkPolyData* borders, vtkPolyData* mesh, double clipValue, vtkDoubleArray* distances);
+
   /// Sets the CellData scalars according to which region each cell belongs to.
   /// Seed scalars start at 1 and are incremented by 1 for each seed.
-  virtual void ColorOutputRegions(vtkPoints* seedPoints);
+  /// Seeds are specified by the id of the closest point of the clipped mesh.
+  virtual void ColorOutputRegions(vtkIdList* seedPointIds);
 
 protected:
   vtkSmartPointer<vtkCleanPolyData>              InputCleanFilter;
@@ -100,6 +107,14 @@ protected:
 
   vtkSmartPointer<vtkPointLocator>               ClippedModelPointLocator;
 
+  /// Content of the mesh that is set as input of InputCleanFilter
+  std::vector<vtkSmartPointer<vtkObject>>        InputMeshContent;
+  vtkMTimeType                                   InputMeshContentMTime{ 0 };
+
+  /// Borders and world mesh MTime of the last clip. The clip and ClippedModelPointLocator are reused while they do not change.
+  vtkSmartPointer<vtkPolyData>                   ClippedBorders;
+  vtkMTimeType                                   ClippedInputMeshMTime{ 0 };
+
 private:
   vtkCjyxDynamicModelerBoundaryCutTool(const vtkCjyxDynamicModelerBoundaryCutTool&) = delete;
 };
@@ -161,6 +161,13 @@ vtkCjyxDynamicModelerCurveCutTool::vtkCjyxDynamicModelerCurveCutTool()
   this->OutputWorldToModelTransform = vtkSmartPointer<vtkGeneralTransform>::New();
   this->OutputWorldToModelTransformFilter = vtkSmartPointer<vtkTransformPolyDataFilter>::New();
   this->OutputWorldToModelTransformFilter->SetTransform(this->OutputWorldToModelTransform);
+
+  this->AddProgressObserver(this->CleanFilter, "Clean");
+  this->AddProgressObserver(this->InputModelToWorldTransformFilter, "Input transform");
+  this->AddProgressObserver(this->SelectionFilter, "Select");
+  this->AddProgressObserver(this->ClipFilter, "Clip");
+  this->AddProgressObserver(this->ConnectivityFilter, "Connectivity");
+  this->AddProgressObserver(this->OutputWorldToModelTransformFilter, "Output transform");
 }
 
 //----------------------------------------------------------------------------
@@ -209,14 +216,7 @@ bool vtkCjyxDynamicModelerCurveCutTool::RunInternal(vtkDMMLDynamicModelerNode* s
   inputModelNode->GetRASBounds(bounds_World);
 
   this->CleanFilter->SetInputData(inputModelNode->GetPolyData());
-  if (inputModelNode->GetParentTransformNode())
-    {
-    inputModelNode->GetParentTransformNode()->GetTransformToWorld(this->InputModelToWorldTransform);
-    }
-  else
-    {
-    this->InputModelToWorldTransform->Identity();
-    }
+  this->UpdateTransformBetweenNodes(inputModelNode, nullptr, this->InputModelToWorldTransform);
 
   this->SelectionFilter->SetLoop(curveNode->GetCurvePointsWorld());
 
@@ -250,29 +250,17 @@ bool vtkCjyxDynamicModelerCurveCutTool::RunInternal(vtkDMMLDynamicModelerNode* s
   vtkSmartPointer<vtkPolyData> outputInsideMesh;
   vtkSmartPointer<vtkPolyData> outputOutsideMesh;
 
-  if (outputInsideModelNode)
-    {
-    if (outputInsideModelNode->GetParentTransformNode())
-      {
-      outputInsideModelNode->GetParentTransformNode()->GetTransformFromWorld(this->OutputWorldToModelTransform);
-      }
-    else
-      {
-      this->OutputWorldToModelTransform->Identity();
-      }
-    }
-  if (outputOutsideModelNode)
+  // Both outputs are computed by the same transform filter, which uses the coordinate system of the outside model
+  // if it is specified.
+  vtkDMMLModelNode* outputCoordinateSystemNode = outputOutsideModelNode ? outputOutsideModelNode : outputInsideModelNode;
+  if (outputCoordinateSystemNode)
     {
-    if (outputOutsideModelNode->GetParentTransformNode())
-      {
-      outputOutsideModelNode->GetParentTransformNode()->GetTransformFromWorld(this->OutputWorldToModelTransform);
-      }
-    else
-      {
-      this->OutputWorldToModelTransform->Identity();
-      }
+    this->UpdateTransformBetweenNodes(nullptr, outputCoordinateSystemNode, this->OutputWorldToModelTransform);
     }
 
+  // The same filter computes both outputs, so the inside and outside meshes share the arrays of
+  // two different filter executions. Filters allocate new arrays on each execution, therefore
+  // shallow copies are sufficient.
   if (straightCut)
     {
     // straight cut
@@ -284,14 +272,14 @@ bool vtkCjyxDynamicModelerCurveCutTool::RunInternal(vtkDMMLDynamicModelerNode* s
       this->ConnectivityFilter->SetInputConnection(this->ClipFilter->GetOutputPort());
       this->OutputWorldToModelTransformFilter->Update();
       outputInsideMesh = vtkSmartPointer<vtkPolyData>::New();
-      outputInsideMesh->DeepCopy(this->OutputWorldToModelTransformFilter->GetOutput());
+      outputInsideMesh->ShallowCopy(this->OutputWorldToModelTransformFilter->GetOutput());
       }
     if (outputOutsideModelNode)
       {
       this->ConnectivityFilter->SetInputConnection(this->ClipFilter->GetClippedOutputPort());
       this->OutputWorldToModelTransformFilter->Update();
       outputOutsideMesh = vtkSmartPointer<vtkPolyData>::New();
-      outputOutsideMesh->DeepCopy(this->OutputWorldToModelTransformFilter->GetOutput());
+      outputOutsideMesh->ShallowCopy(this->OutputWorldToModelTransformFilter->GetOutput());
       }
     }
   else
@@ -303,29 +291,25 @@ bool vtkCjyxDynamicModelerCurveCutTool::RunInternal(vtkDMMLDynamicModelerNode* s
       this->OutputWorldToModelTransformFilter->SetInputConnection(this->SelectionFilter->GetOutputPort());
       this->OutputWorldToModelTransformFilter->Update();
       outputInsideMesh = vtkSmartPointer<vtkPolyData>::New();
-      outputInsideMesh->DeepCopy(this->OutputWorldToModelTransformFilter->GetOutput());
+      outputInsideMesh->ShallowCopy(this->OutputWorldToModelTransformFilter->GetOutput());
       }
     if (outputOutsideModelNode)
       {
       this->OutputWorldToModelTransformFilter->SetInputConnection(this->SelectionFilter->GetUnselectedOutputPort());
       this->OutputWorldToModelTransformFilter->Update();
       outputOutsideMesh = vtkSmartPointer<vtkPolyData>::New();
-      outputOutsideMesh->DeepCopy(this->OutputWorldToModelTransformFilter->GetOutput());
+      outputOutsideMesh->ShallowCopy(this->OutputWorldToModelTransformFilter->GetOutput());
       }
     }
 
-  // Write polydata to output nodes
-  if (outputInsideModelNode)
+  if (this->GetAbortRequested())
     {
-    DMMLNodeModifyBlocker blocker(outputInsideModelNode);
-    outputInsideModelNode->SetAndObserveMesh(outputInsideMesh);
-    outputInsideModelNode->InvokeCustomModifiedEvent(vtkDMMLModelNode::MeshModifiedEvent);
-    }
-  if (outputOutsideModelNode)
-    {
-    DMMLNodeModifyBlocker blocker(outputOutsideModelNode);
-    outputOutsideModelNode->SetAndObserveMesh(outputOutsideMesh);
-    outputOutsideModelNode->InvokeCustomModifiedEvent(vtkDMMLModelNode::MeshModifiedEvent);
+    // Outputs of aborted filters are incomplete
+    return false;
     }
+
+  // Write polydata to output nodes
+  this->SetOutputMesh(outputInsideModelNode, outputInsideMesh);
+  this->SetOutputMesh(outputOutsideModelNode, outputOutsideMesh);
   return true;
 }
\ No newline at end of file
@@ -110,6 +110,12 @@ vtkCjyxDynamicModelerHollowTool::vtkCjyxDynamicModelerHollowTool()
   this->OutputWorldToModelTransform = vtkSmartPointer<vtkGeneralTransform>::New();
   this->OutputModelToWorldTransformFilter->SetTransform(this->OutputWorldToModelTransform);
   this->OutputModelToWorldTransformFilter->SetInputConnection(this->NormalsFilter->GetOutputPort());
+
+  this->AddProgressObserver(this->InputModelToWorldTransformFilter, "Input transform");
+  this->AddProgressObserver(this->HollowFilter, "Hollow");
+  this->AddProgressObserver(this->TriangleFilter, "Triangulate");
+  this->AddProgressObserver(this->NormalsFilter, "Normals");
+  this->AddProgressObserver(this->OutputModelToWorldTransformFilter, "Output transform");
 }
 
 //----------------------------------------------------------------------------
@@ -152,22 +158,8 @@ bool vtkCjyxDynamicModelerHollowTool::RunInternal(vtkDMMLDynamicModelerNode* sur
     return true;
     }
 
-  if (inputModelNode->GetParentTransformNode())
-    {
-    inputModelNode->GetParentTransformNode()->GetTransformToWorld(this->InputModelNodeToWorldTransform);
-    }
-  else
-    {
-    this->InputModelNodeToWorldTransform->Identity();
-    }
-  if (outputModelNode && outputModelNode->GetParentTransformNode())
-    {
-    outputModelNode->GetParentTransformNode()->GetTransformFromWorld(this->OutputWorldToModelTransform);
-    }
-  else
-    {
-    this->OutputWorldToModelTransform->Identity();
-    }
+  this->UpdateTransformBetweenNodes(inputModelNode, nullptr, this->InputModelNodeToWorldTransform);
+  this->UpdateTransformBetweenNodes(nullptr, outputModelNode, this->OutputWorldToModelTransform);
 
   double shellThickness = this->GetNthInputParameterValue(0, surfaceEditorNode).ToDouble();
   this->HollowFilter->SetScaleFactor(shellThickness);
@@ -175,12 +167,7 @@ bool vtkCjyxDynamicModelerHollowTool::RunInternal(vtkDMMLDynamicModelerNode* sur
   this->InputModelToWorldTransformFilter->SetInputConnection(inputModelNode->GetMeshConnection());
 
   this->OutputModelToWorldTransformFilter->Update();
-  vtkNew<vtkPolyData> outputMesh;
-  outputMesh->DeepCopy(this->OutputModelToWorldTransformFilter->GetOutput());
-
-  DMMLNodeModifyBlocker blocker(outputModelNode);
-  outputModelNode->SetAndObserveMesh(outputMesh);
-  outputModelNode->InvokeCustomModifiedEvent(vtkDMMLModelNode::MeshModifiedEvent);
+  vtkCjyxDynamicModelerTool::SetOutputMesh(outputModelNode, this->OutputModelToWorldTransformFilter->GetOutput());
 
   return true;
 }
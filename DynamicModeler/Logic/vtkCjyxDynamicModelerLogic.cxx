@@ -22,18 +22,393 @@
 // DynamicModeler Logic includes
 #include "vtkCjyxDynamicModelerLogic.h"
 #include "vtkCjyxDynamicModelerToolFactory.h"
+#include "vtkCjyxDynamicModelerToolSnapshot.h"
 
 // DMML includes
 #include <vtkDMMLScene.h>
 #include <vtkDMMLDynamicModelerNode.h>
+#include <vtkDMMLMarkupsNode.h>
+#include <vtkDMMLModelNode.h>
 
 // VTK includes
+#include <vtkDoubleArray.h>
+#include <vtkIdTypeArray.h>
 #include <vtkIntArray.h>
 #include <vtkNew.h>
 #include <vtkObjectFactory.h>
+#include <vtkPointData.h>
+#include <vtkPolyData.h>
+#include <vtkPolyDataNormals.h>
+#include <vtkQuadricClustering.h>
+#include <vtkStringArray.h>
+#include <vtkTable.h>
+#include <vtkTimerLog.h>
+#include <vtkWeakPointer.h>
 
 // STD includes
+#include <algorithm>
 #include <cassert>
+#include <cmath>
+#include <condition_variable>
+#include <deque>
+#include <fstream>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+//----------------------------------------------------------------------------
+class vtkCjyxDynamicModelerLogic::vtkInternal
+{
+public:
+  ~vtkInternal();
+
+  /// Add a job to the queue of the worker threads. Worker threads are started on the first call.
+  void Submit(std::function<void()> job);
+
+  /// Process jobs until the workers are stopped.
+  void WorkerLoop();
+
+  struct RunState
+  {
+    /// A run of the tool is in progress on a worker thread
+    bool Running{ false };
+    /// A new run was requested while the current run was in progress
+    bool Pending{ false };
+    /// Tool instance of the run that is in progress
+    vtkSmartPointer<vtkCjyxDynamicModelerTool> Tool;
+  };
+  /// Asynchronous run state of each dynamic modeler node. Only accessed from the main thread.
+  std::map<std::string, RunState> RunStates;
+
+  /// Returns true if a tool is running on a worker thread.
+  bool IsRunInProgress();
+
+  /// Dynamic modeler nodes that are updated in the next ProcessPendingUpdates call
+  std::set<std::string> ScheduledNodeIDs;
+  /// True while the scheduled nodes are being updated
+  bool UpdatingScheduledNodes{ false };
+  /// Node that is currently updated by the scheduler. Update requests that the node triggers itself are ignored.
+  std::string UpdatingNodeID;
+
+  /// Map from each dynamic modeler node ID to the IDs of the dynamic modeler nodes that use any of its outputs as input
+  typedef std::map<std::string, std::set<std::string> > DependencyGraph;
+  static void GetDependencyGraph(vtkCjyxDynamicModelerLogic* logic, DependencyGraph& graph);
+
+  /// Sort the nodes of the graph so that each node is preceded by all the nodes that it depends on (Kahn's algorithm).
+  /// Nodes that are part of a cycle or depend on a cycle cannot be sorted and are returned in unsortedNodeIDs.
+  static void GetDependencyOrder(const DependencyGraph& graph, std::vector<std::string>& orderedNodeIDs, std::vector<std::string>& unsortedNodeIDs);
+
+  struct NodeProfile
+  {
+    std::string ToolName;
+    vtkCjyxDynamicModelerTool::RunProfile LastRun;
+    int NumberOfRuns{ 0 };
+    double TotalWallTimeSec{ 0.0 };
+    /// Completion times of the runs in the last RunRateWindowSec seconds
+    std::deque<double> RecentRunTimes;
+  };
+  /// Execution profile of each dynamic modeler node. Only accessed from the main thread.
+  std::map<std::string, NodeProfile> Profiles;
+  /// Length of the time window that is used for computing the number of runs per second
+  static constexpr double RunRateWindowSec = 5.0;
+
+  /// Returns the number of runs per second of the node in the last RunRateWindowSec seconds.
+  static double GetRunsPerSecond(NodeProfile& profile);
+
+  /// IDs of the input nodes of each dynamic modeler node that the user is currently interacting with
+  std::map<std::string, std::set<std::string> > InteractingInputNodeIDs;
+
+  struct InteractionProxy
+  {
+    /// Mesh that the proxy was created from
+    vtkWeakPointer<vtkPolyData> SourceMesh;
+    vtkMTimeType SourceMeshMTime{ 0 };
+    vtkSmartPointer<vtkPolyData> ProxyMesh;
+  };
+  /// Simplified meshes of the input model nodes, used while the user is interacting with the inputs
+  std::map<std::string, InteractionProxy> InteractionProxies;
+
+  /// Returns the simplified mesh of the model node. The mesh is only simplified again if the mesh of the node has changed.
+  /// Returns nullptr if the mesh is small enough to be used without simplification.
+  vtkPolyData* GetInteractionProxyMesh(vtkDMMLModelNode* modelNode, vtkIdType targetNumberOfTriangles);
+
+  struct CompletedRun
+  {
+    std::string NodeID;
+    vtkSmartPointer<vtkCjyxDynamicModelerTool> Tool;
+    vtkSmartPointer<vtkCjyxDynamicModelerToolSnapshot> Snapshot;
+    bool Success{ false };
+  };
+
+  std::mutex Mutex;
+  std::condition_variable JobAvailable;
+  std::condition_variable RunCompleted;
+  // Members below are protected by Mutex
+  std::deque<std::function<void()> > Jobs;
+  std::vector<CompletedRun> CompletedRuns;
+  bool StopWorkers{ false };
+
+  std::vector<std::thread> Workers;
+};
+
+//----------------------------------------------------------------------------
+vtkCjyxDynamicModelerLogic::vtkInternal::~vtkInternal()
+{
+  // Abort the runs that are in progress so that joining the workers does not wait for the tools to complete
+  for (const std::pair<const std::string, RunState>& runState : this->RunStates)
+    {
+    if (runState.second.Running && runState.second.Tool)
+      {
+      runState.second.Tool->RequestAbort();
+      }
+    }
+    {
+    std::lock_guard<std::mutex> lock(this->Mutex);
+    this->StopWorkers = true;
+    this->Jobs.clear();
+    }
+  this->JobAvailable.notify_all();
+  for (std::thread& worker : this->Workers)
+    {
+    worker.join();
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkCjyxDynamicModelerLogic::vtkInternal::Submit(std::function<void()> job)
+{
+  if (this->Workers.empty())
+    {
+    unsigned int numberOfWorkers = std::max(1u, std::thread::hardware_concurrency());
+    for (unsigned int i = 0; i < numberOfWorkers; ++i)
+      {
+      this->Workers.emplace_back(&vtkInternal::WorkerLoop, this);
+      }
+    }
+    {
+    std::lock_guard<std::mutex> lock(this->Mutex);
+    this->Jobs.push_back(std::move(job));
+    }
+  this->JobAvailable.notify_one();
+}
+
+//----------------------------------------------------------------------------
+void vtkCjyxDynamicModelerLogic::vtkInternal::WorkerLoop()
+{
+  while (true)
+    {
+    std::function<void()> job;
+      {
+      std::unique_lock<std::mutex> lock(this->Mutex);
+      this->JobAvailable.wait(lock, [this] { return this->StopWorkers || !this->Jobs.empty(); });
+      if (this->StopWorkers)
+        {
+        return;
+        }
+      job = std::move(this->Jobs.front());
+      this->Jobs.pop_front();
+      }
+    job();
+    }
+}
+
+//----------------------------------------------------------------------------
+bool vtkCjyxDynamicModelerLogic::vtkInternal::IsRunInProgress()
+{
+  for (const std::pair<const std::string, RunState>& runState : this->RunStates)
+    {
+    if (runState.second.Running)
+      {
+      return true;
+      }
+    }
+  return false;
+}
+
+//----------------------------------------------------------------------------
+vtkPolyData* vtkCjyxDynamicModelerLogic::vtkInternal::GetInteractionProxyMesh(vtkDMMLModelNode* modelNode, vtkIdType targetNumberOfTriangles)
+{
+  vtkPolyData* mesh = modelNode ? modelNode->GetPolyData() : nullptr;
+  if (!mesh || !modelNode->GetID() || mesh->GetNumberOfPolys() < 2 * targetNumberOfTriangles)
+    {
+    if (modelNode && modelNode->GetID())
+      {
+      this->InteractionProxies.erase(modelNode->GetID());
+      }
+    return nullptr;
+    }
+
+  InteractionProxy& proxy = this->InteractionProxies[modelNode->GetID()];
+  if (proxy.ProxyMesh && proxy.SourceMesh == mesh && proxy.SourceMeshMTime == mesh->GetMTime())
+    {
+    return proxy.ProxyMesh;
+    }
+
+  // Vertex clustering is fast enough to be computed when the interaction starts.
+  // A closed surface occupies approximately 3*N^2 of the N^3 bins and has two triangles per occupied bin.
+  int numberOfDivisions = std::max(8, static_cast<int>(std::sqrt(targetNumberOfTriangles / 6.0)));
+  vtkNew<vtkQuadricClustering> clustering;
+  clustering->SetInputData(mesh);
+  clustering->AutoAdjustNumberOfDivisionsOn();
+  clustering->SetNumberOfDivisions(numberOfDivisions, numberOfDivisions, numberOfDivisions);
+  clustering->CopyCellDataOff();
+  clustering->Update();
+  vtkSmartPointer<vtkPolyData> proxyMesh = clustering->GetOutput();
+  if (mesh->GetPointData()->GetNormals())
+    {
+    // Normals are not kept by clustering, but some tools require them
+    vtkNew<vtkPolyDataNormals> normals;
+    normals->SetInputData(proxyMesh);
+    normals->SplittingOff();
+    normals->Update();
+    proxyMesh = normals->GetOutput();
+    }
+
+  proxy.SourceMesh = mesh;
+  proxy.SourceMeshMTime = mesh->GetMTime();
+  proxy.ProxyMesh = proxyMesh;
+  return proxy.ProxyMesh;
+}
+
+//----------------------------------------------------------------------------
+double vtkCjyxDynamicModelerLogic::vtkInternal::GetRunsPerSecond(NodeProfile& profile)
+{
+  double windowStartTime = vtkTimerLog::GetUniversalTime() - RunRateWindowSec;
+  while (!profile.RecentRunTimes.empty() && profile.RecentRunTimes.front() < windowStartTime)
+    {
+    profile.RecentRunTimes.pop_front();
+    }
+  return profile.RecentRunTimes.size() / RunRateWindowSec;
+}
+
+//----------------------------------------------------------------------------
+void vtkCjyxDynamicModelerLogic::vtkInternal::GetDependencyGraph(vtkCjyxDynamicModelerLogic* logic, DependencyGraph& graph)
+{
+  graph.clear();
+  if (!logic->GetDMMLScene())
+    {
+    return;
+    }
+
+  // Input node IDs of each dynamic modeler node and dynamic modeler node IDs that write each output node
+  std::map<std::string, std::set<std::string> > inputNodeIDs;
+  std::map<std::string, std::set<std::string> > producerNodeIDs;
+
+  std::vector<vtkDMMLNode*> nodes;
+  logic->GetDMMLScene()->GetNodesByClass("vtkDMMLDynamicModelerNode", nodes);
+  for (vtkDMMLNode* node : nodes)
+    {
+    vtkDMMLDynamicModelerNode* surfaceEditorNode = vtkDMMLDynamicModelerNode::SafeDownCast(node);
+    if (!surfaceEditorNode || !surfaceEditorNode->GetID())
+      {
+      continue;
+      }
+    std::string nodeID = surfaceEditorNode->GetID();
+    graph[nodeID];
+
+    vtkCjyxDynamicModelerTool* tool = logic->GetDynamicModelerTool(surfaceEditorNode);
+    if (!tool)
+      {
+      continue;
+      }
+    for (int i = 0; i < tool->GetNumberOfInputNodes(); ++i)
+      {
+      std::string referenceRole = tool->GetNthInputNodeReferenceRole(i);
+      std::vector<const char*> referenceNodeIds;
+      surfaceEditorNode->GetNodeReferenceIDs(referenceRole.c_str(), referenceNodeIds);
+      for (const char* referenceId : referenceNodeIds)
+        {
+        if (referenceId)
+          {
+          inputNodeIDs[nodeID].insert(referenceId);
+          }
+        }
+      }
+    for (int i = 0; i < tool->GetNumberOfOutputNodes(); ++i)
+      {
+      std::string referenceRole = tool->GetNthOutputNodeReferenceRole(i);
+      const char* referenceId = surfaceEditorNode->GetNodeReferenceID(referenceRole.c_str());
+      if (referenceId)
+        {
+        producerNodeIDs[referenceId].insert(nodeID);
+        }
+      }
+    }
+
+  for (const std::pair<const std::string, std::set<std::string> >& nodeInputs : inputNodeIDs)
+    {
+    for (const std::string& inputNodeID : nodeInputs.second)
+      {
+      std::map<std::string, std::set<std::string> >::iterator producersIt = producerNodeIDs.find(inputNodeID);
+      if (producersIt == producerNodeIDs.end())
+        {
+        continue;
+        }
+      for (const std::string& producerNodeID : producersIt->second)
+        {
+        graph[producerNodeID].insert(nodeInputs.first);
+        }
+      }
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkCjyxDynamicModelerLogic::vtkInternal::GetDependencyOrder(const DependencyGraph& graph,
+  std::vector<std::string>& orderedNodeIDs, std::vector<std::string>& unsortedNodeIDs)
+{
+  orderedNodeIDs.clear();
+  unsortedNodeIDs.clear();
+
+  std::map<std::string, int> numberOfUpstreamNodes;
+  for (const std::pair<const std::string, std::set<std::string> >& node : graph)
+    {
+    numberOfUpstreamNodes[node.first];
+    for (const std::string& downstreamNodeID : node.second)
+      {
+      ++numberOfUpstreamNodes[downstreamNodeID];
+      }
+    }
+
+  std::deque<std::string> readyNodeIDs;
+  for (const std::pair<const std::string, int>& node : numberOfUpstreamNodes)
+    {
+    if (node.second == 0)
+      {
+      readyNodeIDs.push_back(node.first);
+      }
+    }
+
+  while (!readyNodeIDs.empty())
+    {
+    std::string nodeID = readyNodeIDs.front();
+    readyNodeIDs.pop_front();
+    orderedNodeIDs.push_back(nodeID);
+    DependencyGraph::const_iterator nodeIt = graph.find(nodeID);
+    if (nodeIt == graph.end())
+      {
+      continue;
+      }
+    for (const std::string& downstreamNodeID : nodeIt->second)
+      {
+      if (--numberOfUpstreamNodes[downstreamNodeID] == 0)
+        {
+        readyNodeIDs.push_back(downstreamNodeID);
+        }
+      }
+    }
+
+  for (const std::pair<const std::string, int>& node : numberOfUpstreamNodes)
+    {
+    if (node.second > 0)
+      {
+      unsortedNodeIDs.push_back(node.first);
+      }
+    }
+}
 
 //----------------------------------------------------------------------------
 vtkStandardNewMacro(vtkCjyxDynamicModelerLogic);
@@ -41,17 +416,23 @@ vtkStandardNewMacro(vtkCjyxDynamicModelerLogic);
 //----------------------------------------------------------------------------
 vtkCjyxDynamicModelerLogic::vtkCjyxDynamicModelerLogic()
 {
+  this->Internal = new vtkInternal();
 }
 
 //----------------------------------------------------------------------------
 vtkCjyxDynamicModelerLogic::~vtkCjyxDynamicModelerLogic()
 {
+  delete this->Internal;
 }
 
 //----------------------------------------------------------------------------
 void vtkCjyxDynamicModelerLogic::PrintSelf(ostream& os, vtkIndent indent)
 {
   this->Superclass::PrintSelf(os, indent);
+  os << indent << "AsynchronousExecution: " << (this->AsynchronousExecution ? "true" : "false") << std::endl;
+  os << indent << "AbortOutdatedRuns: " << (this->AbortOutdatedRuns ? "true" : "false") << std::endl;
+  os << indent << "InteractiveMode: " << (this->InteractiveMode ? "true" : "false") << std::endl;
+  os << indent << "InteractiveProxyNumberOfTriangles: " << this->InteractiveProxyNumberOfTriangles << std::endl;
 }
 
 //---------------------------------------------------------------------------
@@ -93,6 +474,8 @@ void vtkCjyxDynamicModelerLogic::OnDMMLSceneNodeAdded(vtkDMMLNode* node)
   vtkNew<vtkIntArray> events;
   events->InsertNextValue(vtkCommand::ModifiedEvent);
   events->InsertNextValue(vtkDMMLDynamicModelerNode::InputNodeModifiedEvent);
+  events->InsertNextValue(vtkDMMLDynamicModelerNode::InputNodeStartInteractionEvent);
+  events->InsertNextValue(vtkDMMLDynamicModelerNode::InputNodeEndInteractionEvent);
   vtkObserveDMMLNodeEventsMacro(surfaceEditorNode, events);
   this->UpdateDynamicModelerTool(surfaceEditorNode);
   this->RunDynamicModelerTool(surfaceEditorNode);
@@ -101,12 +484,21 @@ void vtkCjyxDynamicModelerLogic::OnDMMLSceneNodeAdded(vtkDMMLNode* node)
 //---------------------------------------------------------------------------
 void vtkCjyxDynamicModelerLogic::OnDMMLSceneNodeRemoved(vtkDMMLNode* node)
 {
+  if (node && node->GetID())
+    {
+    this->Internal->InteractionProxies.erase(node->GetID());
+    }
+
   vtkDMMLDynamicModelerNode* surfaceEditorNode = vtkDMMLDynamicModelerNode::SafeDownCast(node);
   if (!surfaceEditorNode)
     {
     return;
     }
 
+  this->Internal->ScheduledNodeIDs.erase(surfaceEditorNode->GetID());
+  this->Internal->Profiles.erase(surfaceEditorNode->GetID());
+  this->Internal->InteractingInputNodeIDs.erase(surfaceEditorNode->GetID());
+
   DynamicModelerToolList::iterator tool = this->Tools.find(surfaceEditorNode->GetID());
   if (tool == this->Tools.end())
     {
@@ -138,6 +530,8 @@ void vtkCjyxDynamicModelerLogic::OnDMMLSceneEndImport()
     vtkNew<vtkIntArray> events;
     events->InsertNextValue(vtkCommand::ModifiedEvent);
     events->InsertNextValue(vtkDMMLDynamicModelerNode::InputNodeModifiedEvent);
+    events->InsertNextValue(vtkDMMLDynamicModelerNode::InputNodeStartInteractionEvent);
+    events->InsertNextValue(vtkDMMLDynamicModelerNode::InputNodeEndInteractionEvent);
     vtkObserveDMMLNodeEventsMacro(dynamicModelerNode, events);
     this->UpdateDynamicModelerTool(dynamicModelerNode);
     }
@@ -158,6 +552,33 @@ void vtkCjyxDynamicModelerLogic::ProcessDMMLNodesEvents(vtkObject* caller, unsig
     return;
     }
 
+  if (event == vtkDMMLDynamicModelerNode::InputNodeStartInteractionEvent
+    || event == vtkDMMLDynamicModelerNode::InputNodeEndInteractionEvent)
+    {
+    vtkDMMLNode* inputNode = reinterpret_cast<vtkDMMLNode*>(callData);
+    if (!inputNode || !inputNode->GetID())
+      {
+      return;
+      }
+    std::set<std::string>& interactingInputNodeIDs = this->Internal->InteractingInputNodeIDs[surfaceEditorNode->GetID()];
+    if (event == vtkDMMLDynamicModelerNode::InputNodeStartInteractionEvent)
+      {
+      interactingInputNodeIDs.insert(inputNode->GetID());
+      return;
+      }
+    interactingInputNodeIDs.erase(inputNode->GetID());
+    if (interactingInputNodeIDs.empty())
+      {
+      this->Internal->InteractingInputNodeIDs.erase(surfaceEditorNode->GetID());
+      if (this->InteractiveMode && surfaceEditorNode->GetContinuousUpdate() && this->GetDynamicModelerTool(surfaceEditorNode))
+        {
+        // Outputs were computed from the simplified inputs during the interaction
+        this->RequestDynamicModelerToolUpdate(surfaceEditorNode);
+        }
+      }
+    return;
+    }
+
   if (surfaceEditorNode && event == vtkCommand::ModifiedEvent)
     {
     this->UpdateDynamicModelerTool(surfaceEditorNode);
@@ -169,13 +590,10 @@ void vtkCjyxDynamicModelerLogic::ProcessDMMLNodesEvents(vtkObject* caller, unsig
       }
     }
 
-  if (surfaceEditorNode && surfaceEditorNode->GetContinuousUpdate())
+  if (surfaceEditorNode && surfaceEditorNode->GetContinuousUpdate() && this->GetDynamicModelerTool(surfaceEditorNode))
     {
-    vtkSmartPointer<vtkCjyxDynamicModelerTool> tool = this->GetDynamicModelerTool(surfaceEditorNode);
-    if (tool)
-      {
-      this->RunDynamicModelerTool(surfaceEditorNode);
-      }
+    // Multiple events in the same event loop iteration only trigger a single update
+    this->RequestDynamicModelerToolUpdate(surfaceEditorNode);
     }
 }
 
@@ -193,28 +611,26 @@ bool vtkCjyxDynamicModelerLogic::HasCircularReference(vtkDMMLDynamicModelerNode*
     return false;
     }
 
-  std::vector<vtkDMMLNode*> inputNodes;
-  for (int i = 0; i < tool->GetNumberOfInputNodes(); ++i)
+  // The node is part of a cycle if it can be reached from itself through the nodes that use its outputs
+  vtkInternal::DependencyGraph graph;
+  vtkInternal::GetDependencyGraph(this, graph);
+  std::string nodeID = surfaceEditorNode->GetID();
+  std::vector<std::string> nodeIDsToVisit(graph[nodeID].begin(), graph[nodeID].end());
+  std::set<std::string> visitedNodeIDs;
+  while (!nodeIDsToVisit.empty())
     {
-    vtkDMMLNode* inputNode = tool->GetNthInputNode(i, surfaceEditorNode);
-    if (inputNode)
+    std::string currentNodeID = nodeIDsToVisit.back();
+    nodeIDsToVisit.pop_back();
+    if (currentNodeID == nodeID)
       {
-      inputNodes.push_back(inputNode);
+      return true;
       }
-    }
-
-  for (int i = 0; i < tool->GetNumberOfOutputNodes(); ++i)
-    {
-    vtkDMMLNode* outputNode = tool->GetNthOutputNode(i, surfaceEditorNode);
-    if (!outputNode)
+    if (!visitedNodeIDs.insert(currentNodeID).second)
       {
       continue;
       }
-    std::vector<vtkDMMLNode*>::iterator inputNodeIt = std::find(inputNodes.begin(), inputNodes.end(), outputNode);
-    if (inputNodeIt != inputNodes.end())
-      {
-      return true;
-      }
+    const std::set<std::string>& downstreamNodeIDs = graph[currentNodeID];
+    nodeIDsToVisit.insert(nodeIDsToVisit.end(), downstreamNodeIDs.begin(), downstreamNodeIDs.end());
     }
 
   return false;
@@ -270,7 +686,11 @@ void vtkCjyxDynamicModelerLogic::UpdateDynamicModelerTool(vtkDMMLDynamicModelerN
       std::string referenceRole = tool->GetNthInputNodeReferenceRole(i);
       std::vector<const char*> referenceNodeIds;
       surfaceEditorNode->GetNodeReferenceIDs(referenceRole.c_str(), referenceNodeIds);
-      vtkIntArray* events = tool->GetNthInputNodeEvents(i);
+      // Interaction events are observed for running the tool on simplified inputs during interaction
+      vtkNew<vtkIntArray> events;
+      events->DeepCopy(tool->GetNthInputNodeEvents(i));
+      events->InsertNextValue(vtkDMMLMarkupsNode::PointStartInteractionEvent);
+      events->InsertNextValue(vtkDMMLMarkupsNode::PointEndInteractionEvent);
       int referenceIndex = 0;
       for (const char* referenceId : referenceNodeIds)
         {
@@ -324,5 +744,612 @@ void vtkCjyxDynamicModelerLogic::RunDynamicModelerTool(vtkDMMLDynamicModelerNode
     return;
     }
 
-  tool->Run(surfaceEditorNode);
+  // The tool instance may not be used by multiple runs at the same time
+  std::map<std::string, vtkInternal::RunState>::iterator runStateIt = this->Internal->RunStates.find(surfaceEditorNode->GetID());
+  if (runStateIt != this->Internal->RunStates.end() && runStateIt->second.Running)
+    {
+    runStateIt->second.Pending = false;
+    if (this->AbortOutdatedRuns && runStateIt->second.Tool)
+      {
+      runStateIt->second.Tool->RequestAbort();
+      }
+    this->WaitForAsynchronousRuns();
+    }
+
+  vtkNew<vtkCjyxDynamicModelerToolSnapshot> proxySnapshot;
+  if (this->SetInteractionProxyMeshes(tool, surfaceEditorNode, proxySnapshot)
+    && proxySnapshot->CreateSnapshot(tool, surfaceEditorNode))
+    {
+    // Run on the simplified inputs during interaction
+    tool->CreateOutputDisplayNodes(surfaceEditorNode);
+    tool->ClearAbortRequest();
+    if (tool->RunSnapshot(proxySnapshot) && proxySnapshot->PublishOutputs(tool, surfaceEditorNode))
+      {
+      this->RecordRunProfile(surfaceEditorNode->GetID(), tool, 0.0);
+      }
+    return;
+    }
+
+  if (tool->Run(surfaceEditorNode))
+    {
+    this->RecordRunProfile(surfaceEditorNode->GetID(), tool, 0.0);
+    }
+}
+
+//---------------------------------------------------------------------------
+void vtkCjyxDynamicModelerLogic::RunDynamicModelerToolAsynchronously(vtkDMMLDynamicModelerNode* surfaceEditorNode)
+{
+  if (!surfaceEditorNode)
+    {
+    vtkErrorMacro("Invalid parameter node!");
+    return;
+    }
+  if (!surfaceEditorNode->GetToolName())
+    {
+    return;
+    }
+
+  vtkSmartPointer<vtkCjyxDynamicModelerTool> tool = this->GetDynamicModelerTool(surfaceEditorNode);
+  if (!tool)
+    {
+    vtkErrorMacro("Could not find tool with name: " << surfaceEditorNode->GetToolName());
+    return;
+    }
+  if (!tool->HasRequiredInputs(surfaceEditorNode) || !tool->HasOutput(surfaceEditorNode))
+    {
+    return;
+    }
+
+  vtkInternal::RunState& runState = this->Internal->RunStates[surfaceEditorNode->GetID()];
+  if (runState.Running)
+    {
+    // Inputs are copied when the current run is completed
+    runState.Pending = true;
+    if (this->AbortOutdatedRuns && runState.Tool)
+      {
+      // The result of the current run would be replaced by the next run anyway
+      runState.Tool->RequestAbort();
+      }
+    return;
+    }
+
+  // Display nodes are created in the main scene
+  tool->CreateOutputDisplayNodes(surfaceEditorNode);
+
+  vtkSmartPointer<vtkCjyxDynamicModelerToolSnapshot> snapshot = vtkSmartPointer<vtkCjyxDynamicModelerToolSnapshot>::New();
+  this->SetInteractionProxyMeshes(tool, surfaceEditorNode, snapshot);
+  if (!snapshot->CreateSnapshot(tool, surfaceEditorNode))
+    {
+    if (tool->Run(surfaceEditorNode))
+      {
+      this->RecordRunProfile(surfaceEditorNode->GetID(), tool, 0.0);
+      }
+    return;
+    }
+
+  runState.Running = true;
+  runState.Pending = false;
+  runState.Tool = tool;
+  // Aborts that are requested from now on apply to this run, even if it is not started yet on the worker thread
+  tool->ClearAbortRequest();
+
+  vtkInternal* internal = this->Internal;
+  std::string nodeID = surfaceEditorNode->GetID();
+  this->Internal->Submit([internal, nodeID, tool, snapshot]() mutable
+    {
+    bool success = tool->RunSnapshot(snapshot);
+    std::lock_guard<std::mutex> lock(internal->Mutex);
+    vtkInternal::CompletedRun completedRun;
+    completedRun.NodeID = nodeID;
+    completedRun.Tool = std::move(tool);
+    completedRun.Snapshot = std::move(snapshot);
+    completedRun.Success = success;
+    internal->CompletedRuns.push_back(std::move(completedRun));
+    internal->RunCompleted.notify_all();
+    });
+
+  this->InvokeEvent(UpdateRequestedEvent);
+}
+
+//---------------------------------------------------------------------------
+bool vtkCjyxDynamicModelerLogic::IsInputInteractionInProgress(vtkDMMLDynamicModelerNode* surfaceEditorNode)
+{
+  if (!surfaceEditorNode || !surfaceEditorNode->GetID())
+    {
+    return false;
+    }
+  return this->Internal->InteractingInputNodeIDs.find(surfaceEditorNode->GetID()) != this->Internal->InteractingInputNodeIDs.end();
+}
+
+//---------------------------------------------------------------------------
+bool vtkCjyxDynamicModelerLogic::SetInteractionProxyMeshes(vtkCjyxDynamicModelerTool* tool,
+  vtkDMMLDynamicModelerNode* surfaceEditorNode, vtkCjyxDynamicModelerToolSnapshot* snapshot)
+{
+  if (!this->InteractiveMode || !tool || !snapshot || !this->IsInputInteractionInProgress(surfaceEditorNode))
+    {
+    return false;
+    }
+  bool proxyMeshSet = false;
+  std::vector<vtkDMMLNode*> inputNodes;
+  tool->GetInputNodes(surfaceEditorNode, inputNodes);
+  for (vtkDMMLNode* inputNode : inputNodes)
+    {
+    vtkPolyData* proxyMesh = this->Internal->GetInteractionProxyMesh(
+      vtkDMMLModelNode::SafeDownCast(inputNode), this->InteractiveProxyNumberOfTriangles);
+    if (proxyMesh)
+      {
+      snapshot->SetInputMeshOverride(inputNode->GetID(), proxyMesh);
+      proxyMeshSet = true;
+      }
+    }
+  return proxyMeshSet;
+}
+
+//---------------------------------------------------------------------------
+void vtkCjyxDynamicModelerLogic::RequestDynamicModelerToolUpdate(vtkDMMLDynamicModelerNode* surfaceEditorNode)
+{
+  if (!surfaceEditorNode || !surfaceEditorNode->GetID())
+    {
+    vtkErrorMacro("Invalid parameter node!");
+    return;
+    }
+  if (this->Internal->UpdatingNodeID == surfaceEditorNode->GetID())
+    {
+    // Modified events invoked by the node while its tool is running
+    return;
+    }
+
+  bool updateAlreadyRequested = !this->Internal->ScheduledNodeIDs.empty();
+  this->Internal->ScheduledNodeIDs.insert(surfaceEditorNode->GetID());
+  if (updateAlreadyRequested || this->Internal->UpdatingScheduledNodes)
+    {
+    // Node will be updated in the current or next ProcessPendingUpdates call
+    return;
+    }
+
+  if (this->HasObserver(UpdateRequestedEvent))
+    {
+    this->InvokeEvent(UpdateRequestedEvent);
+    }
+  else
+    {
+    // No event loop is processing the updates, update the nodes now
+    this->ProcessPendingUpdates();
+    }
+}
+
+//---------------------------------------------------------------------------
+void vtkCjyxDynamicModelerLogic::UpdateScheduledNodes()
+{
+  if (this->Internal->ScheduledNodeIDs.empty() || this->Internal->UpdatingScheduledNodes || !this->GetDMMLScene())
+    {
+    return;
+    }
+  this->Internal->UpdatingScheduledNodes = true;
+
+  vtkInternal::DependencyGraph graph;
+  vtkInternal::GetDependencyGraph(this, graph);
+  std::vector<std::string> orderedNodeIDs;
+  std::vector<std::string> unsortedNodeIDs;
+  vtkInternal::GetDependencyOrder(graph, orderedNodeIDs, unsortedNodeIDs);
+  for (const std::string& nodeID : unsortedNodeIDs)
+    {
+    vtkDMMLDynamicModelerNode* surfaceEditorNode = vtkDMMLDynamicModelerNode::SafeDownCast(this->GetDMMLScene()->GetNodeByID(nodeID));
+    if (surfaceEditorNode && this->HasCircularReference(surfaceEditorNode))
+      {
+      this->Internal->ScheduledNodeIDs.erase(nodeID);
+      if (surfaceEditorNode->GetContinuousUpdate())
+        {
+        vtkWarningMacro("Circular reference detected. Disabling continuous update for: " << surfaceEditorNode->GetName());
+        surfaceEditorNode->SetContinuousUpdate(false);
+        }
+      continue;
+      }
+    // Nodes that depend on a cycle are updated after all other nodes
+    orderedNodeIDs.push_back(nodeID);
+    }
+
+  std::map<std::string, std::vector<std::string> > upstreamNodeIDs;
+  for (const std::pair<const std::string, std::set<std::string> >& node : graph)
+    {
+    for (const std::string& downstreamNodeID : node.second)
+      {
+      upstreamNodeIDs[downstreamNodeID].push_back(node.first);
+      }
+    }
+
+  // Nodes are updated in waves. Each wave contains the scheduled nodes that do not depend on a node that
+  // is running or scheduled, so the nodes of a wave are independent and their tools are run concurrently.
+  // Publishing the outputs of a wave schedules the downstream nodes, which are updated in the next waves.
+  // Each node has its own tool instance, and a tool instance is never run by multiple threads at the same time.
+  size_t maximumNumberOfWaves = 2 * (orderedNodeIDs.size() + 1);
+  for (size_t wave = 0; wave < maximumNumberOfWaves && !this->Internal->ScheduledNodeIDs.empty(); ++wave)
+    {
+    std::set<std::string> busyNodeIDs;
+    for (const std::pair<const std::string, vtkInternal::RunState>& runState : this->Internal->RunStates)
+      {
+      if (runState.second.Running)
+        {
+        busyNodeIDs.insert(runState.first);
+        }
+      }
+
+    std::vector<vtkDMMLDynamicModelerNode*> readyNodes;
+    for (const std::string& nodeID : orderedNodeIDs)
+      {
+      bool scheduled = this->Internal->ScheduledNodeIDs.find(nodeID) != this->Internal->ScheduledNodeIDs.end();
+      bool upstreamBusy = false;
+      for (const std::string& upstreamNodeID : upstreamNodeIDs[nodeID])
+        {
+        if (busyNodeIDs.find(upstreamNodeID) != busyNodeIDs.end())
+          {
+          upstreamBusy = true;
+          break;
+          }
+        }
+      if (!scheduled)
+        {
+        if (upstreamBusy)
+          {
+          // Nodes that depend on a busy node through this node
+          busyNodeIDs.insert(nodeID);
+          }
+        continue;
+        }
+      if (upstreamBusy || busyNodeIDs.find(nodeID) != busyNodeIDs.end())
+        {
+        // Inputs are not up-to-date yet, the node is updated in a later wave
+        busyNodeIDs.insert(nodeID);
+        continue;
+        }
+      busyNodeIDs.insert(nodeID);
+      this->Internal->ScheduledNodeIDs.erase(nodeID);
+      vtkDMMLDynamicModelerNode* surfaceEditorNode = vtkDMMLDynamicModelerNode::SafeDownCast(this->GetDMMLScene()->GetNodeByID(nodeID));
+      if (surfaceEditorNode && this->GetDynamicModelerTool(surfaceEditorNode))
+        {
+        readyNodes.push_back(surfaceEditorNode);
+        }
+      }
+    if (readyNodes.empty())
+      {
+      break;
+      }
+
+    bool runConcurrently = this->AsynchronousExecution || readyNodes.size() > 1;
+    for (vtkDMMLDynamicModelerNode* surfaceEditorNode : readyNodes)
+      {
+      this->Internal->UpdatingNodeID = surfaceEditorNode->GetID();
+      if (runConcurrently)
+        {
+        this->RunDynamicModelerToolAsynchronously(surfaceEditorNode);
+        }
+      else
+        {
+        this->RunDynamicModelerTool(surfaceEditorNode);
+        }
+      this->Internal->UpdatingNodeID.clear();
+      }
+
+    if (this->AsynchronousExecution)
+      {
+      // Nodes that are waiting for their inputs are updated in a later ProcessPendingUpdates call
+      break;
+      }
+
+    // Synchronous execution: the wave must be completed before the downstream nodes are updated
+    while (this->Internal->IsRunInProgress())
+      {
+        {
+        std::unique_lock<std::mutex> lock(this->Internal->Mutex);
+        this->Internal->RunCompleted.wait(lock, [this] { return !this->Internal->CompletedRuns.empty(); });
+        }
+      this->PublishCompletedRuns();
+      }
+    }
+
+  // Nodes that are no longer in the scene
+  std::set<std::string> scheduledNodeIDs;
+  for (const std::string& nodeID : this->Internal->ScheduledNodeIDs)
+    {
+    if (graph.find(nodeID) != graph.end())
+      {
+      scheduledNodeIDs.insert(nodeID);
+      }
+    }
+  this->Internal->ScheduledNodeIDs.swap(scheduledNodeIDs);
+
+  this->Internal->UpdatingScheduledNodes = false;
+}
+
+//---------------------------------------------------------------------------
+void vtkCjyxDynamicModelerLogic::ProcessPendingUpdates()
+{
+  this->PublishCompletedRuns();
+  this->UpdateScheduledNodes();
+}
+
+//---------------------------------------------------------------------------
+void vtkCjyxDynamicModelerLogic::PublishCompletedRuns()
+{
+  std::vector<vtkInternal::CompletedRun> completedRuns;
+    {
+    std::lock_guard<std::mutex> lock(this->Internal->Mutex);
+    completedRuns.swap(this->Internal->CompletedRuns);
+    }
+
+  for (vtkInternal::CompletedRun& completedRun : completedRuns)
+    {
+    vtkInternal::RunState& runState = this->Internal->RunStates[completedRun.NodeID];
+    runState.Running = false;
+    runState.Tool = nullptr;
+    bool pending = runState.Pending;
+
+    vtkDMMLDynamicModelerNode* surfaceEditorNode = vtkDMMLDynamicModelerNode::SafeDownCast(
+      this->GetDMMLScene() ? this->GetDMMLScene()->GetNodeByID(completedRun.NodeID) : nullptr);
+    if (!surfaceEditorNode)
+      {
+      // Node was removed while the tool was running
+      this->Internal->RunStates.erase(completedRun.NodeID);
+      continue;
+      }
+
+    // Outputs of a tool that has been replaced since the run was started are ignored.
+    // Aborted runs are not successful, their outputs are incomplete.
+    if (completedRun.Success && completedRun.Tool == this->GetDynamicModelerTool(surfaceEditorNode))
+      {
+      double publishStartTime = vtkTimerLog::GetUniversalTime();
+      completedRun.Snapshot->PublishOutputs(completedRun.Tool, surfaceEditorNode);
+      this->RecordRunProfile(completedRun.NodeID, completedRun.Tool, vtkTimerLog::GetUniversalTime() - publishStartTime);
+      }
+    completedRun.Snapshot = nullptr;
+
+    if (pending)
+      {
+      this->RunDynamicModelerToolAsynchronously(surfaceEditorNode);
+      }
+    }
+}
+
+//---------------------------------------------------------------------------
+double vtkCjyxDynamicModelerLogic::GetDynamicModelerToolProgress(vtkDMMLDynamicModelerNode* surfaceEditorNode)
+{
+  if (!surfaceEditorNode || !surfaceEditorNode->GetID())
+    {
+    return -1.0;
+    }
+  std::map<std::string, vtkInternal::RunState>::iterator runStateIt = this->Internal->RunStates.find(surfaceEditorNode->GetID());
+  if (runStateIt == this->Internal->RunStates.end() || !runStateIt->second.Running || !runStateIt->second.Tool)
+    {
+    return -1.0;
+    }
+  return runStateIt->second.Tool->GetProgress();
+}
+
+//---------------------------------------------------------------------------
+void vtkCjyxDynamicModelerLogic::AbortDynamicModelerTool(vtkDMMLDynamicModelerNode* surfaceEditorNode)
+{
+  if (!surfaceEditorNode || !surfaceEditorNode->GetID())
+    {
+    vtkErrorMacro("Invalid parameter node!");
+    return;
+    }
+  this->Internal->ScheduledNodeIDs.erase(surfaceEditorNode->GetID());
+  std::map<std::string, vtkInternal::RunState>::iterator runStateIt = this->Internal->RunStates.find(surfaceEditorNode->GetID());
+  if (runStateIt == this->Internal->RunStates.end())
+    {
+    return;
+    }
+  runStateIt->second.Pending = false;
+  if (runStateIt->second.Running && runStateIt->second.Tool)
+    {
+    runStateIt->second.Tool->RequestAbort();
+    }
+}
+
+//---------------------------------------------------------------------------
+void vtkCjyxDynamicModelerLogic::RecordRunProfile(const std::string& nodeID, vtkCjyxDynamicModelerTool* tool, double publishWallTimeSec)
+{
+  if (!tool)
+    {
+    return;
+    }
+  vtkInternal::NodeProfile& profile = this->Internal->Profiles[nodeID];
+  profile.ToolName = tool->GetName() ? tool->GetName() : "";
+  profile.LastRun = tool->GetLastRunProfile();
+  if (publishWallTimeSec > 0.0)
+    {
+    // Outputs of asynchronous runs are published by the logic, after the run of the tool
+    profile.LastRun.StageWallTimeSec.emplace_back("Publish", publishWallTimeSec);
+    profile.LastRun.WallTimeSec += publishWallTimeSec;
+    }
+  ++profile.NumberOfRuns;
+  profile.TotalWallTimeSec += profile.LastRun.WallTimeSec;
+  profile.RecentRunTimes.push_back(vtkTimerLog::GetUniversalTime());
+}
+
+//---------------------------------------------------------------------------
+bool vtkCjyxDynamicModelerLogic::GetNodeProfileTable(vtkDMMLDynamicModelerNode* surfaceEditorNode, vtkTable* table)
+{
+  if (!table)
+    {
+    vtkErrorMacro("GetNodeProfileTable: Invalid table");
+    return false;
+    }
+  table->Initialize();
+  vtkNew<vtkStringArray> stageColumn;
+  stageColumn->SetName("Stage");
+  vtkNew<vtkDoubleArray> wallTimeColumn;
+  wallTimeColumn->SetName("WallTimeSec");
+  table->AddColumn(stageColumn);
+  table->AddColumn(wallTimeColumn);
+  if (!surfaceEditorNode || !surfaceEditorNode->GetID())
+    {
+    return false;
+    }
+
+  std::map<std::string, vtkInternal::NodeProfile>::iterator profileIt = this->Internal->Profiles.find(surfaceEditorNode->GetID());
+  if (profileIt == this->Internal->Profiles.end())
+    {
+    return false;
+    }
+  const vtkCjyxDynamicModelerTool::RunProfile& lastRun = profileIt->second.LastRun;
+  for (const std::pair<std::string, double>& stage : lastRun.StageWallTimeSec)
+    {
+    stageColumn->InsertNextValue(stage.first);
+    wallTimeColumn->InsertNextValue(stage.second);
+    }
+  stageColumn->InsertNextValue("Total");
+  wallTimeColumn->InsertNextValue(lastRun.WallTimeSec);
+  return true;
+}
+
+//---------------------------------------------------------------------------
+void vtkCjyxDynamicModelerLogic::GetSceneProfileTable(vtkTable* table)
+{
+  if (!table)
+    {
+    vtkErrorMacro("GetSceneProfileTable: Invalid table");
+    return;
+    }
+  table->Initialize();
+  vtkNew<vtkStringArray> nodeColumn;
+  nodeColumn->SetName("Node");
+  vtkNew<vtkStringArray> toolColumn;
+  toolColumn->SetName("Tool");
+  vtkNew<vtkIntArray> runsColumn;
+  runsColumn->SetName("Runs");
+  vtkNew<vtkDoubleArray> runsPerSecondColumn;
+  runsPerSecondColumn->SetName("RunsPerSec");
+  vtkNew<vtkDoubleArray> lastWallTimeColumn;
+  lastWallTimeColumn->SetName("LastWallTimeSec");
+  vtkNew<vtkDoubleArray> meanWallTimeColumn;
+  meanWallTimeColumn->SetName("MeanWallTimeSec");
+  vtkNew<vtkIdTypeArray> inputPointsColumn;
+  inputPointsColumn->SetName("InputPoints");
+  vtkNew<vtkIdTypeArray> inputCellsColumn;
+  inputCellsColumn->SetName("InputCells");
+  vtkNew<vtkIdTypeArray> outputPointsColumn;
+  outputPointsColumn->SetName("OutputPoints");
+  vtkNew<vtkIdTypeArray> outputCellsColumn;
+  outputCellsColumn->SetName("OutputCells");
+
+  for (std::pair<const std::string, vtkInternal::NodeProfile>& nodeProfile : this->Internal->Profiles)
+    {
+    vtkInternal::NodeProfile& profile = nodeProfile.second;
+    vtkDMMLNode* node = this->GetDMMLScene() ? this->GetDMMLScene()->GetNodeByID(nodeProfile.first) : nullptr;
+    nodeColumn->InsertNextValue(node && node->GetName() ? node->GetName() : nodeProfile.first);
+    toolColumn->InsertNextValue(profile.ToolName);
+    runsColumn->InsertNextValue(profile.NumberOfRuns);
+    runsPerSecondColumn->InsertNextValue(vtkInternal::GetRunsPerSecond(profile));
+    lastWallTimeColumn->InsertNextValue(profile.LastRun.WallTimeSec);
+    meanWallTimeColumn->InsertNextValue(profile.NumberOfRuns > 0 ? profile.TotalWallTimeSec / profile.NumberOfRuns : 0.0);
+    inputPointsColumn->InsertNextValue(profile.LastRun.InputPoints);
+    inputCellsColumn->InsertNextValue(profile.LastRun.InputCells);
+    outputPointsColumn->InsertNextValue(profile.LastRun.OutputPoints);
+    outputCellsColumn->InsertNextValue(profile.LastRun.OutputCells);
+    }
+
+  table->AddColumn(nodeColumn);
+  table->AddColumn(toolColumn);
+  table->AddColumn(runsColumn);
+  table->AddColumn(runsPerSecondColumn);
+  table->AddColumn(lastWallTimeColumn);
+  table->AddColumn(meanWallTimeColumn);
+  table->AddColumn(inputPointsColumn);
+  table->AddColumn(inputCellsColumn);
+  table->AddColumn(outputPointsColumn);
+  table->AddColumn(outputCellsColumn);
+}
+
+//---------------------------------------------------------------------------
+bool vtkCjyxDynamicModelerLogic::SaveProfileToCSV(const char* filePath)
+{
+  if (!filePath)
+    {
+    vtkErrorMacro("SaveProfileToCSV: Invalid file path");
+    return false;
+    }
+  std::ofstream file(filePath);
+  if (!file.is_open())
+    {
+    vtkErrorMacro("SaveProfileToCSV: Cannot write file " << filePath);
+    return false;
+    }
+
+  // Names may contain separators, they are quoted
+  auto quoted = [](const std::string& text)
+    {
+    std::string quotedText = "\"";
+    for (char c : text)
+      {
+      quotedText += c;
+      if (c == '"')
+        {
+        quotedText += c;
+        }
+      }
+    return quotedText + "\"";
+    };
+
+  // One row for each stage of the last run of each node
+  file << "node,nodeID,tool,runs,runsPerSec,lastWallTimeSec,meanWallTimeSec,"
+    << "inputPoints,inputCells,outputPoints,outputCells,stage,stageWallTimeSec" << std::endl;
+  for (std::pair<const std::string, vtkInternal::NodeProfile>& nodeProfile : this->Internal->Profiles)
+    {
+    vtkInternal::NodeProfile& profile = nodeProfile.second;
+    vtkDMMLNode* node = this->GetDMMLScene() ? this->GetDMMLScene()->GetNodeByID(nodeProfile.first) : nullptr;
+    std::string nodeName = node && node->GetName() ? node->GetName() : "";
+    double runsPerSecond = vtkInternal::GetRunsPerSecond(profile);
+    double meanWallTimeSec = profile.NumberOfRuns > 0 ? profile.TotalWallTimeSec / profile.NumberOfRuns : 0.0;
+    std::vector<std::pair<std::string, double> > stages = profile.LastRun.StageWallTimeSec;
+    stages.emplace_back("Total", profile.LastRun.WallTimeSec);
+    for (const std::pair<std::string, double>& stage : stages)
+      {
+      file << quoted(nodeName) << "," << quoted(nodeProfile.first) << "," << quoted(profile.ToolName) << ","
+        << profile.NumberOfRuns << "," << runsPerSecond << ","
+        << profile.LastRun.WallTimeSec << "," << meanWallTimeSec << ","
+        << profile.LastRun.InputPoints << "," << profile.LastRun.InputCells << ","
+        << profile.LastRun.OutputPoints << "," << profile.LastRun.OutputCells << ","
+        << quoted(stage.first) << "," << stage.second << std::endl;
+      }
+    }
+  return file.good();
+}
+
+//---------------------------------------------------------------------------
+void vtkCjyxDynamicModelerLogic::ResetProfile()
+{
+  this->Internal->Profiles.clear();
+}
+
+//---------------------------------------------------------------------------
+bool vtkCjyxDynamicModelerLogic::HasPendingUpdates()
+{
+  if (!this->Internal->ScheduledNodeIDs.empty())
+    {
+    return true;
+    }
+  for (const std::pair<const std::string, vtkInternal::RunState>& runState : this->Internal->RunStates)
+    {
+    if (runState.second.Running || runState.second.Pending)
+      {
+      return true;
+      }
+    }
+  return false;
+}
+
+//---------------------------------------------------------------------------
+void vtkCjyxDynamicModelerLogic::WaitForAsynchronousRuns()
+{
+  this->ProcessPendingUpdates();
+  while (this->HasPendingUpdates())
+    {
+    if (this->Internal->IsRunInProgress())
+      {
+      std::unique_lock<std::mutex> lock(this->Internal->Mutex);
+      this->Internal->RunCompleted.wait(lock, [this] { return !this->Internal->CompletedRuns.empty(); });
+      }
+    this->ProcessPendingUpdates();
+    }
 }
@@ -42,7 +42,9 @@
 // VTK includes
 #include <vtkSmartPointer.h>
 
+class vtkCjyxDynamicModelerToolSnapshot;
 class vtkDMMLDynamicModelerNode;
+class vtkTable;
 
 /// \ingroup Cjyx_QtModules_ExtensionTemplate
 class VTK_CJYX_DYNAMICMODELER_MODULE_LOGIC_EXPORT vtkCjyxDynamicModelerLogic :
@@ -60,7 +62,92 @@ public:
   /// Run the editor tool specified by the surface editor node
   void RunDynamicModelerTool(vtkDMMLDynamicModelerNode* surfaceEditorNode);
 
-  /// Detects circular references in the output nodes that are used as inputs
+  /// Run the editor tool specified by the surface editor node on a worker thread.
+  /// The inputs are copied when the run is started and outputs are updated on the main thread
+  /// in ProcessPendingUpdates. If a run is already in progress for the node then a new run is started
+  /// when that one is completed, with the inputs at that time (latest request wins, intermediate requests are dropped).
+  /// If the inputs cannot be copied (for example, because of a non-linear transform) then the tool is run synchronously.
+  void RunDynamicModelerToolAsynchronously(vtkDMMLDynamicModelerNode* surfaceEditorNode);
+
+  /// Request update of the node. Requests are not processed immediately: all nodes that are requested
+  /// until the next ProcessPendingUpdates call are updated once, in dependency order (nodes that use
+  /// the output of another node as input are updated after that node). Nodes that do not depend on
+  /// each other are updated concurrently, their outputs are published on the main thread.
+  /// If there is no observer of UpdateRequestedEvent then the update is performed immediately.
+  void RequestDynamicModelerToolUpdate(vtkDMMLDynamicModelerNode* surfaceEditorNode);
+
+  /// Update the requested nodes, publish the outputs of completed asynchronous runs to the scene and start pending runs.
+  /// Must be called on the main thread. Applications should call this method from their event loop
+  /// when UpdateRequestedEvent is invoked and then periodically while HasPendingUpdates() returns true.
+  void ProcessPendingUpdates();
+
+  /// Returns the progress (between 0.0 and 1.0) of the asynchronous run of the tool of the node,
+  /// or -1.0 if the tool is not running on a worker thread.
+  double GetDynamicModelerToolProgress(vtkDMMLDynamicModelerNode* surfaceEditorNode);
+
+  /// Interrupt the asynchronous run of the tool of the node, and cancel the pending and requested runs.
+  /// The outputs of the interrupted run are not published.
+  void AbortDynamicModelerTool(vtkDMMLDynamicModelerNode* surfaceEditorNode);
+
+  /// Get the execution profile of the last run of the node.
+  /// The table has a "Stage" and a "WallTimeSec" column and one row for each stage of the run
+  /// (\sa vtkCjyxDynamicModelerTool::RunProfile), followed by a "Total" row.
+  /// Returns false if the tool of the node has not been run since the profile was reset.
+  bool GetNodeProfileTable(vtkDMMLDynamicModelerNode* surfaceEditorNode, vtkTable* table);
+
+  /// Get the execution profile summary of all nodes in the scene, one row per node that has been run.
+  /// Columns: Node, Tool, Runs, RunsPerSec (in the last 5 seconds), LastWallTimeSec, MeanWallTimeSec,
+  /// InputPoints, InputCells, OutputPoints, OutputCells (of the last run).
+  void GetSceneProfileTable(vtkTable* table);
+
+  /// Write the profile of all nodes to a CSV file, one row per stage of the last run of each node.
+  bool SaveProfileToCSV(const char* filePath);
+
+  /// Clear the execution profile of all nodes.
+  void ResetProfile();
+
+  /// Returns true if there are asynchronous runs that are in progress or are waiting to be published.
+  bool HasPendingUpdates();
+
+  /// Wait until all asynchronous runs are completed and publish their outputs.
+  void WaitForAsynchronousRuns();
+
+  /// If enabled, continuous updates run the tools on worker threads \sa RunDynamicModelerToolAsynchronously.
+  /// Disabled by default.
+  vtkGetMacro(AsynchronousExecution, bool);
+  vtkSetMacro(AsynchronousExecution, bool);
+  vtkBooleanMacro(AsynchronousExecution, bool);
+
+  /// If enabled, an asynchronous run is interrupted when a new run of the same node is requested,
+  /// so the outdated outputs are not computed and published \sa vtkCjyxDynamicModelerTool::RequestAbort.
+  /// Enabled by default.
+  vtkGetMacro(AbortOutdatedRuns, bool);
+  vtkSetMacro(AbortOutdatedRuns, bool);
+  vtkBooleanMacro(AbortOutdatedRuns, bool);
+
+  /// If enabled, tools that are run while the user is interacting with one of their input markups
+  /// (for example, dragging a plane or a curve point) process a simplified version of the input models,
+  /// which is cached and only rebuilt when the input mesh changes. A full resolution run is requested
+  /// when the interaction ends. Enabled by default.
+  vtkGetMacro(InteractiveMode, bool);
+  vtkSetMacro(InteractiveMode, bool);
+  vtkBooleanMacro(InteractiveMode, bool);
+
+  /// Approximate number of triangles of the simplified input models that are used during interaction.
+  /// Input models that have less than twice this number of triangles are not simplified. Default is 100000.
+  vtkGetMacro(InteractiveProxyNumberOfTriangles, vtkIdType);
+  vtkSetMacro(InteractiveProxyNumberOfTriangles, vtkIdType);
+
+  /// Returns true if the user is interacting with one of the input markups of the node.
+  bool IsInputInteractionInProgress(vtkDMMLDynamicModelerNode* surfaceEditorNode);
+
+  enum
+  {
+    UpdateRequestedEvent = 18100, // Event that is invoked on the main thread when ProcessPendingUpdates should be called
+  };
+
+  /// Detects circular references in the output nodes that are used as inputs, directly
+  /// or through other dynamic modeler nodes.
   bool HasCircularReference(vtkDMMLDynamicModelerNode* surfaceEditorNode);
 
 protected:
@@ -76,12 +163,38 @@ protected:
   void OnDMMLSceneNodeRemoved(vtkDMMLNode* node) override;
   void OnDMMLSceneEndImport() override;
 
+  /// Run the tools of the nodes that were requested by RequestDynamicModelerToolUpdate, in dependency order.
+  /// Nodes that do not depend on each other are run concurrently on worker threads.
+  /// Nodes that are part of a cycle are not updated and their continuous update is disabled.
+  void UpdateScheduledNodes();
+
+  /// Move the outputs of the completed asynchronous runs to the scene and start pending runs.
+  void PublishCompletedRuns();
+
+  /// Store the profile of the last run of the tool in the profile of the node.
+  /// The time spent publishing the outputs of asynchronous runs is added as a "Publish" stage.
+  void RecordRunProfile(const std::string& nodeID, vtkCjyxDynamicModelerTool* tool, double publishWallTimeSec);
+
+  /// Replace the input meshes of the snapshot by their simplified version if an input of the node
+  /// is being interacted with \sa InteractiveMode.
+  /// Returns true if any of the input meshes are replaced.
+  bool SetInteractionProxyMeshes(vtkCjyxDynamicModelerTool* tool, vtkDMMLDynamicModelerNode* surfaceEditorNode,
+    vtkCjyxDynamicModelerToolSnapshot* snapshot);
+
   /// Ensures that the vtkCjyxDynamicModelerTool for each tool exists, and is up-to-date.
   void UpdateDynamicModelerTool(vtkDMMLDynamicModelerNode* surfaceEditorNode);
 
   typedef std::map<std::string, vtkSmartPointer<vtkCjyxDynamicModelerTool> > DynamicModelerToolList;
   DynamicModelerToolList Tools;
 
+  bool AsynchronousExecution{ false };
+  bool AbortOutdatedRuns{ true };
+  bool InteractiveMode{ true };
+  vtkIdType InteractiveProxyNumberOfTriangles{ 100000 };
+
+  class vtkInternal;
+  vtkInternal* Internal;
+
 private:
   vtkCjyxDynamicModelerLogic(const vtkCjyxDynamicModelerLogic&) = delete;
   void operator=(const vtkCjyxDynamicModelerLogic&) = delete;
@@ -111,6 +111,12 @@ vtkCjyxDynamicModelerMarginTool::vtkCjyxDynamicModelerMarginTool()
   this->OutputWorldToModelTransform = vtkSmartPointer<vtkGeneralTransform>::New();
   this->OutputModelToWorldTransformFilter->SetTransform(this->OutputWorldToModelTransform);
   this->OutputModelToWorldTransformFilter->SetInputConnection(this->NormalsFilter->GetOutputPort());
+
+  this->AddProgressObserver(this->InputModelToWorldTransformFilter, "Input transform");
+  this->AddProgressObserver(this->MarginFilter, "Margin");
+  this->AddProgressObserver(this->TriangleFilter, "Triangulate");
+  this->AddProgressObserver(this->NormalsFilter, "Normals");
+  this->AddProgressObserver(this->OutputModelToWorldTransformFilter, "Output transform");
 }
 
 //----------------------------------------------------------------------------
@@ -153,22 +159,8 @@ bool vtkCjyxDynamicModelerMarginTool::RunInternal(vtkDMMLDynamicModelerNode* sur
     return true;
     }
 
-  if (inputModelNode->GetParentTransformNode())
-    {
-    inputModelNode->GetParentTransformNode()->GetTransformToWorld(this->InputModelNodeToWorldTransform);
-    }
-  else
-    {
-    this->InputModelNodeToWorldTransform->Identity();
-    }
-  if (outputModelNode && outputModelNode->GetParentTransformNode())
-    {
-    outputModelNode->GetParentTransformNode()->GetTransformFromWorld(this->OutputWorldToModelTransform);
-    }
-  else
-    {
-    this->OutputWorldToModelTransform->Identity();
-    }
+  this->UpdateTransformBetweenNodes(inputModelNode, nullptr, this->InputModelNodeToWorldTransform);
+  this->UpdateTransformBetweenNodes(nullptr, outputModelNode, this->OutputWorldToModelTransform);
 
   double margin = this->GetNthInputParameterValue(0, surfaceEditorNode).ToDouble();
   this->MarginFilter->SetScaleFactor(margin);
@@ -176,12 +168,7 @@ bool vtkCjyxDynamicModelerMarginTool::RunInternal(vtkDMMLDynamicModelerNode* sur
   this->InputModelToWorldTransformFilter->SetInputConnection(inputModelNode->GetMeshConnection());
 
   this->OutputModelToWorldTransformFilter->Update();
-  vtkNew<vtkPolyData> outputMesh;
-  outputMesh->DeepCopy(this->OutputModelToWorldTransformFilter->GetOutput());
-
-  DMMLNodeModifyBlocker blocker(outputModelNode);
-  outputModelNode->SetAndObserveMesh(outputMesh);
-  outputModelNode->InvokeCustomModifiedEvent(vtkDMMLModelNode::MeshModifiedEvent);
+  vtkCjyxDynamicModelerTool::SetOutputMesh(outputModelNode, this->OutputModelToWorldTransformFilter->GetOutput());
 
   return true;
 }
@@ -32,6 +32,7 @@
 #include <vtkCommand.h>
 #include <vtkGeneralTransform.h>
 #include <vtkIntArray.h>
+#include <vtkMatrix4x4.h>
 #include <vtkReverseSense.h>
 #include <vtkSmartPointer.h>
 #include <vtkStringArray.h>
@@ -105,8 +106,7 @@ vtkCjyxDynamicModelerMirrorTool::vtkCjyxDynamicModelerMirrorTool()
   this->MirrorTransform->PostMultiply();
 
   this->MirrorFilter = vtkSmartPointer<vtkTransformPolyDataFilter>::New();
-  this->MirrorFilter ->SetInputConnection(this->InputModelToWorldTransformFilter->GetOutputPort());
-  this->MirrorFilter ->SetTransform(this->MirrorTransform);
+  this->MirrorFilter->SetTransform(this->MirrorTransform);
 
   this->ReverseNormalFilter = vtkSmartPointer<vtkReverseSense>::New();
   this->ReverseNormalFilter->SetInputConnection(this->MirrorFilter->GetOutputPort());
@@ -115,6 +115,11 @@ vtkCjyxDynamicModelerMirrorTool::vtkCjyxDynamicModelerMirrorTool()
   this->OutputWorldToModelTransform = vtkSmartPointer<vtkGeneralTransform>::New();
   this->OutputModelToWorldTransformFilter->SetTransform(this->OutputWorldToModelTransform);
   this->OutputModelToWorldTransformFilter->SetInputConnection(this->ReverseNormalFilter->GetOutputPort());
+
+  this->AddProgressObserver(this->InputModelToWorldTransformFilter, "Input transform");
+  this->AddProgressObserver(this->MirrorFilter, "Mirror");
+  this->AddProgressObserver(this->ReverseNormalFilter, "Reverse normals");
+  this->AddProgressObserver(this->OutputModelToWorldTransformFilter, "Output transform");
 }
 
 //----------------------------------------------------------------------------
@@ -166,23 +171,6 @@ bool vtkCjyxDynamicModelerMirrorTool::RunInternal(vtkDMMLDynamicModelerNode* sur
     return true;
     }
 
-  if (inputModelNode->GetParentTransformNode())
-    {
-    inputModelNode->GetParentTransformNode()->GetTransformToWorld(this->InputModelNodeToWorldTransform);
-    }
-  else
-    {
-    this->InputModelNodeToWorldTransform->Identity();
-    }
-  if (outputModelNode && outputModelNode->GetParentTransformNode())
-    {
-    outputModelNode->GetParentTransformNode()->GetTransformFromWorld(this->OutputWorldToModelTransform);
-    }
-  else
-    {
-    this->OutputWorldToModelTransform->Identity();
-    }
-
   double origin_World[3] = { 0.0, 0.0, 0.0 };
   double normal_World[3] = { 0.0, 0.0, 1.0 };
   if (inputPlaneNode)
@@ -199,8 +187,6 @@ bool vtkCjyxDynamicModelerMirrorTool::RunInternal(vtkDMMLDynamicModelerNode* sur
     sliceToRASTransform->TransformVector(normal_World, normal_World);
     }
 
-  this->InputModelToWorldTransformFilter->SetInputConnection(inputModelNode->GetMeshConnection());
-
   double translateWorldOriginToPlaneOrigin[3] = { 0.0 };
   vtkMath::Add(translateWorldOriginToPlaneOrigin, origin_World, translateWorldOriginToPlaneOrigin);
 
@@ -221,18 +207,50 @@ bool vtkCjyxDynamicModelerMirrorTool::RunInternal(vtkDMMLDynamicModelerNode* sur
   mirrorMatrix->SetElement(2, 1, - 2 * normal_World[1] * normal_World[2]);
   mirrorMatrix->SetElement(2, 2, 1 - 2 * normal_World[2] * normal_World[2]);
 
-  this->MirrorTransform->Identity();
-  this->MirrorTransform->Translate(translatePlaneOriginToWorldOrigin);
-  this->MirrorTransform->Concatenate(mirrorMatrix);
-  this->MirrorTransform->Translate(translateWorldOriginToPlaneOrigin);
+  // The mirror transform is computed in a temporary transform and only copied to the pipeline if it changed,
+  // so that the pipeline is not re-executed if the plane and transforms are not modified.
+  vtkNew<vtkTransform> mirrorTransform;
+  mirrorTransform->PostMultiply();
+
+  // If the input and output models are transformed linearly then the transforms are concatenated with the
+  // mirror matrix, so that the mesh points are transformed only once, directly from the input to the output model.
+  vtkNew<vtkMatrix4x4> inputModelToWorldMatrix;
+  vtkNew<vtkMatrix4x4> worldToOutputModelMatrix;
+  if (vtkDMMLTransformNode::GetMatrixTransformBetweenNodes(inputModelNode->GetParentTransformNode(), nullptr, inputModelToWorldMatrix)
+    && vtkDMMLTransformNode::GetMatrixTransformBetweenNodes(nullptr, outputModelNode->GetParentTransformNode(), worldToOutputModelMatrix))
+    {
+    mirrorTransform->Concatenate(inputModelToWorldMatrix);
+    mirrorTransform->Translate(translatePlaneOriginToWorldOrigin);
+    mirrorTransform->Concatenate(mirrorMatrix);
+    mirrorTransform->Translate(translateWorldOriginToPlaneOrigin);
+    mirrorTransform->Concatenate(worldToOutputModelMatrix);
+    if (!vtkCjyxDynamicModelerTool::AreMatricesEqual(mirrorTransform->GetMatrix(), this->MirrorTransform->GetMatrix()))
+      {
+      this->MirrorTransform->SetMatrix(mirrorTransform->GetMatrix());
+      }
+
+    this->MirrorFilter->SetInputConnection(inputModelNode->GetMeshConnection());
+    this->ReverseNormalFilter->Update();
+    vtkCjyxDynamicModelerTool::SetOutputMesh(outputModelNode, this->ReverseNormalFilter->GetOutput());
+    return true;
+    }
 
-  this->OutputModelToWorldTransformFilter->Update();
-  vtkNew<vtkPolyData> outputMesh;
-  outputMesh->DeepCopy(this->OutputModelToWorldTransformFilter->GetOutput());
+  // Non-linear transform: mirror in world coordinate system
+  this->UpdateTransformBetweenNodes(inputModelNode, nullptr, this->InputModelNodeToWorldTransform);
+  this->UpdateTransformBetweenNodes(nullptr, outputModelNode, this->OutputWorldToModelTransform);
 
-  DMMLNodeModifyBlocker blocker(outputModelNode);
-  outputModelNode->SetAndObserveMesh(outputMesh);
-  outputModelNode->InvokeCustomModifiedEvent(vtkDMMLModelNode::MeshModifiedEvent);
+  mirrorTransform->Translate(translatePlaneOriginToWorldOrigin);
+  mirrorTransform->Concatenate(mirrorMatrix);
+  mirrorTransform->Translate(translateWorldOriginToPlaneOrigin);
+  if (!vtkCjyxDynamicModelerTool::AreMatricesEqual(mirrorTransform->GetMatrix(), this->MirrorTransform->GetMatrix()))
+    {
+    this->MirrorTransform->SetMatrix(mirrorTransform->GetMatrix());
+    }
+
+  this->InputModelToWorldTransformFilter->SetInputConnection(inputModelNode->GetMeshConnection());
+  this->MirrorFilter->SetInputConnection(this->InputModelToWorldTransformFilter->GetOutputPort());
+  this->OutputModelToWorldTransformFilter->Update();
+  vtkCjyxDynamicModelerTool::SetOutputMesh(outputModelNode, this->OutputModelToWorldTransformFilter->GetOutput());
 
   return true;
 }
\ No newline at end of file
@@ -21,6 +21,7 @@
 #include "vtkCjyxDynamicModelerPlaneCutTool.h"
 
 #include "vtkDMMLDynamicModelerNode.h"
+#include "vtkParallelPlaneClipper.h"
 
 // DMML includes
 #include <vtkDMMLMarkupsPlaneNode.h>
@@ -31,7 +32,6 @@
 // VTK includes
 #include <vtkAppendPolyData.h>
 #include <vtkClipClosedSurface.h>
-#include <vtkClipPolyData.h>
 #include <vtkCollection.h>
 #include <vtkCommand.h>
 #include <vtkContourTriangulator.h>
@@ -42,6 +42,7 @@
 #include <vtkGeneralTransform.h>
 #include <vtkImplicitBoolean.h>
 #include <vtkIntArray.h>
+#include <vtkMatrix4x4.h>
 #include <vtkPointData.h>
 #include <vtkPolygon.h>
 #include <vtkObjectFactory.h>
@@ -149,13 +150,24 @@ vtkCjyxDynamicModelerPlaneCutTool::vtkCjyxDynamicModelerPlaneCutTool()
   parameterOperationType.PossibleValues->InsertNextValue("Difference");
   this->InputParameterInfo.push_back(parameterOperationType);
 
+  ParameterInfo parameterIncrementalUpdate(
+    "Incremental update",
+    "Only update the part of the output in the volume swept by the planes since the last run. Faster when the planes are"
+    " moved in small steps on a large mesh, but keeps a copy of the input mesh and of the outputs in memory",
+    "IncrementalUpdate",
+    PARAMETER_BOOL,
+    false);
+  this->InputParameterInfo.push_back(parameterIncrementalUpdate);
+
   this->InputModelToWorldTransformFilter = vtkSmartPointer<vtkTransformPolyDataFilter>::New();
   this->InputModelNodeToWorldTransform = vtkSmartPointer<vtkGeneralTransform>::New();
   this->InputModelToWorldTransformFilter->SetTransform(this->InputModelNodeToWorldTransform);
 
-  this->PlaneClipper = vtkSmartPointer<vtkClipPolyData>::New();
-  this->PlaneClipper->SetInputConnection(this->InputModelToWorldTransformFilter->GetOutputPort());
-  this->PlaneClipper->SetValue(0.0);
+  this->ClipPlanes = vtkSmartPointer<vtkPlaneCollection>::New();
+  this->ClipFunction = vtkSmartPointer<vtkImplicitBoolean>::New();
+
+  this->PlaneClipper = vtkSmartPointer<vtkParallelPlaneClipper>::New();
+  this->PlaneClipper->SetClipPlanes(this->ClipPlanes);
 
   this->OutputPositiveWorldToModelTransformFilter = vtkSmartPointer<vtkTransformPolyDataFilter>::New();
   this->OutputPositiveWorldToModelTransform = vtkSmartPointer<vtkGeneralTransform>::New();
@@ -164,6 +176,11 @@ vtkCjyxDynamicModelerPlaneCutTool::vtkCjyxDynamicModelerPlaneCutTool()
   this->OutputNegativeWorldToModelTransformFilter = vtkSmartPointer<vtkTransformPolyDataFilter>::New();
   this->OutputNegativeWorldToModelTransform = vtkSmartPointer<vtkGeneralTransform>::New();
   this->OutputNegativeWorldToModelTransformFilter->SetTransform(this->OutputNegativeWorldToModelTransform);
+
+  this->AddProgressObserver(this->InputModelToWorldTransformFilter, "Input transform");
+  this->AddProgressObserver(this->PlaneClipper, "Clip");
+  this->AddProgressObserver(this->OutputPositiveWorldToModelTransformFilter, "Output transform");
+  this->AddProgressObserver(this->OutputNegativeWorldToModelTransformFilter, "Output transform");
 }
 
 //----------------------------------------------------------------------------
@@ -179,57 +196,73 @@ const char* vtkCjyxDynamicModelerPlaneCutTool::GetName()
 //----------------------------------------------------------------------------
 void vtkCjyxDynamicModelerPlaneCutTool::CreateEndCap(vtkPlaneCollection* planes, vtkPolyData* originalPolyData, vtkImplicitBoolean* cutFunction, vtkPolyData* outputEndCap)
 {
-  int operationType = cutFunction->GetOperationType();
-  vtkNew<vtkAppendPolyData> appendFilter;
+  std::vector<vtkSmartPointer<vtkPolyData> > contours;
   for (int i = 0; i < planes->GetNumberOfItems(); ++i)
     {
-    vtkPlane* plane = planes->GetItem(i);
     vtkNew<vtkCutter> cutter;
-    cutter->SetCutFunction(plane);
+    cutter->SetCutFunction(planes->GetItem(i));
     cutter->SetInputData(originalPolyData);
+    cutter->Update();
+    contours.push_back(cutter->GetOutput());
+    }
+  vtkCjyxDynamicModelerPlaneCutTool::CreateEndCapFromContours(planes, contours, cutFunction->GetOperationType(), outputEndCap);
+}
+
+//----------------------------------------------------------------------------
+void vtkCjyxDynamicModelerPlaneCutTool::CreateEndCapFromContours(vtkPlaneCollection* planes,
+  const std::vector<vtkSmartPointer<vtkPolyData> >& contours, int operationType, vtkPolyData* outputEndCap)
+{
+  vtkNew<vtkAppendPolyData> appendFilter;
+  for (int i = 0; i < planes->GetNumberOfItems() && i < static_cast<int>(contours.size()); ++i)
+    {
+    vtkPlane* plane = planes->GetItem(i);
+    if (!contours[i] || contours[i]->GetNumberOfLines() == 0)
+      {
+      continue;
+      }
 
     vtkNew<vtkContourTriangulator> contourTriangulator;
-    contourTriangulator->SetInputConnection(cutter->GetOutputPort());
+    contourTriangulator->SetInputData(contours[i]);
     contourTriangulator->Update();
-
-    // Create a seam along the intersection of each plane with the triangulated contour
-    // This allows the contour to be split correctly later.
     vtkNew<vtkPolyData> endCapPolyData;
     endCapPolyData->ShallowCopy(contourTriangulator->GetOutput());
-    for (int j = 0; j < planes->GetNumberOfItems(); ++j)
+
+    // Only keep the part of the cross-section that is on the clipped surface: the side of each other plane
+    // where the combined function is determined by this plane.
+    for (int j = 0; j < planes->GetNumberOfItems() && endCapPolyData->GetNumberOfPolys() > 0; ++j)
       {
       if (i == j)
         {
         continue;
         }
       vtkPlane* plane2 = planes->GetItem(j);
-      vtkNew<vtkClipPolyData> clipper;
+      bool keepPositiveSide = true;
+      if (operationType == vtkImplicitBoolean::VTK_INTERSECTION)
+        {
+        keepPositiveSide = false;
+        }
+      else if (operationType == vtkImplicitBoolean::VTK_DIFFERENCE)
+        {
+        keepPositiveSide = (j != 0);
+        }
+      double normal[3] = { 0.0, 0.0, 1.0 };
+      plane2->GetNormal(normal);
+      if (!keepPositiveSide)
+        {
+        vtkMath::MultiplyScalar(normal, -1.0);
+        }
+      vtkNew<vtkPlane> sidePlane;
+      sidePlane->SetOrigin(plane2->GetOrigin());
+      sidePlane->SetNormal(normal);
+      vtkNew<vtkPlaneCollection> sidePlanes;
+      sidePlanes->AddItem(sidePlane);
+      vtkNew<vtkParallelPlaneClipper> clipper;
       clipper->SetInputData(endCapPolyData);
-      clipper->SetClipFunction(plane2);
-      clipper->SetValue(0.0);
-      clipper->GenerateClippedOutputOn();
-      vtkNew<vtkAppendPolyData> appendCut;
-      appendCut->AddInputConnection(clipper->GetOutputPort());
-      appendCut->AddInputConnection(clipper->GetClippedOutputPort());
-      appendCut->Update();
-      endCapPolyData->ShallowCopy(appendCut->GetOutput());
+      clipper->SetClipPlanes(sidePlanes);
+      clipper->Update();
+      endCapPolyData->ShallowCopy(clipper->GetOutput());
       }
 
-    // Remove all triangles that do not lie at 0.0
-    double epsilon = 1e-4;
-    vtkNew<vtkClipPolyData> clipper;
-    clipper->SetInputData(endCapPolyData);
-    clipper->SetClipFunction(cutFunction);
-    clipper->InsideOutOff();
-    clipper->SetValue(-epsilon);
-    vtkNew<vtkClipPolyData> clipper2;
-    clipper2->SetInputConnection(clipper->GetOutputPort());
-    clipper2->SetClipFunction(cutFunction);
-    clipper2->InsideOutOn();
-    clipper2->SetValue(epsilon);
-    clipper2->Update();
-    endCapPolyData->ShallowCopy(clipper2->GetOutput());
-
     double planeNormal[3] = { 0.0 };
     plane->GetNormal(planeNormal);
     if (operationType != vtkImplicitBoolean::VTK_DIFFERENCE || i == 0)
@@ -290,19 +323,21 @@ bool vtkCjyxDynamicModelerPlaneCutTool::RunInternal(vtkDMMLDynamicModelerNode* s
     return true;
     }
 
-  vtkNew<vtkImplicitBoolean> planes;
   std::string operationType = this->GetNthInputParameterValue(1, surfaceEditorNode).ToString();
   if (operationType == "Intersection")
     {
-    planes->SetOperationTypeToIntersection();
+    this->ClipFunction->SetOperationTypeToIntersection();
+    this->PlaneClipper->SetOperationTypeToIntersection();
     }
   else if (operationType == "Difference")
     {
-    planes->SetOperationTypeToDifference();
+    this->ClipFunction->SetOperationTypeToDifference();
+    this->PlaneClipper->SetOperationTypeToDifference();
     }
   else
     {
-    planes->SetOperationTypeToUnion();
+    this->ClipFunction->SetOperationTypeToUnion();
+    this->PlaneClipper->SetOperationTypeToUnion();
     }
 
   std::vector<vtkDMMLNode*> planeNodes;
@@ -339,10 +374,8 @@ bool vtkCjyxDynamicModelerPlaneCutTool::RunInternal(vtkDMMLDynamicModelerNode* s
     currentPlane->SetNormal(normal_World);
     currentPlane->SetOrigin(origin_World);
     planeCollection->AddItem(currentPlane);
-    planes->AddFunction(currentPlane);
     ++planeIndex;
     }
-  this->PlaneClipper->SetClipFunction(planes);
 
   vtkDMMLModelNode* inputModelNode = vtkDMMLModelNode::SafeDownCast(surfaceEditorNode->GetNodeReference(PLANE_CUT_INPUT_MODEL_REFERENCE_ROLE));
   if (!inputModelNode)
@@ -356,36 +389,47 @@ bool vtkCjyxDynamicModelerPlaneCutTool::RunInternal(vtkDMMLDynamicModelerNode* s
     return true;
     }
 
-  if (inputModelNode->GetParentTransformNode())
+  // If the input model is transformed linearly then the planes are transformed into the input model coordinate
+  // system and the mesh is clipped without transforming its points to world and back.
+  // Mesh points are only transformed to world if the input model is under a non-linear transform.
+  vtkDMMLTransformableNode* clipCoordinateSystemNode = nullptr;
+  vtkNew<vtkMatrix4x4> inputModelToWorldMatrix;
+  if (vtkDMMLTransformNode::GetMatrixTransformBetweenNodes(inputModelNode->GetParentTransformNode(), nullptr, inputModelToWorldMatrix))
     {
-    inputModelNode->GetParentTransformNode()->GetTransformToWorld(this->InputModelNodeToWorldTransform);
+    vtkNew<vtkMatrix4x4> worldToInputModelMatrix;
+    vtkMatrix4x4::Invert(inputModelToWorldMatrix, worldToInputModelMatrix);
+    for (int i = 0; i < planeCollection->GetNumberOfItems(); ++i)
+      {
+      vtkCjyxDynamicModelerTool::TransformPlane(worldToInputModelMatrix, planeCollection->GetItem(i));
+      }
+    this->PlaneClipper->SetInputConnection(inputModelNode->GetMeshConnection());
+    clipCoordinateSystemNode = inputModelNode;
     }
   else
     {
-    this->InputModelNodeToWorldTransform->Identity();
-    }
-  if (outputPositiveModelNode && outputPositiveModelNode->GetParentTransformNode())
-    {
-    outputPositiveModelNode->GetParentTransformNode()->GetTransformFromWorld(this->OutputPositiveWorldToModelTransform);
-    }
-  if (outputNegativeModelNode && outputNegativeModelNode->GetParentTransformNode())
-    {
-    outputNegativeModelNode->GetParentTransformNode()->GetTransformFromWorld(this->OutputNegativeWorldToModelTransform);
+    this->UpdateTransformBetweenNodes(inputModelNode, nullptr, this->InputModelNodeToWorldTransform);
+    this->InputModelToWorldTransformFilter->SetInputConnection(inputModelNode->GetMeshConnection());
+    this->PlaneClipper->SetInputConnection(this->InputModelToWorldTransformFilter->GetOutputPort());
     }
+  vtkCjyxDynamicModelerTool::UpdateClipPlanes(planeCollection, this->ClipPlanes, this->ClipFunction);
 
-  this->InputModelToWorldTransformFilter->SetInputConnection(inputModelNode->GetMeshConnection());
-
-  if (outputNegativeModelNode)
-    {
-    this->PlaneClipper->GenerateClippedOutputOn();
-    }
+  // Cut contours are computed by the clipper, so that the mesh is not cut again for creating the end cap
+  bool capSurface = this->GetNthInputParameterValue(0, surfaceEditorNode).ToInt() != 0;
+  this->PlaneClipper->SetGenerateClippedOutput(outputNegativeModelNode != nullptr);
+  this->PlaneClipper->SetGenerateCutContours(capSurface);
+  this->PlaneClipper->SetUseBoundingVolumeHierarchy(this->GetNthInputParameterValue(2, surfaceEditorNode).ToInt() != 0);
   this->PlaneClipper->Update();
 
-  bool capSurface = this->GetNthInputParameterValue(0, surfaceEditorNode).ToInt() != 0;
   vtkNew<vtkPolyData> endCapPolyData;
   if (capSurface)
     {
-    this->CreateEndCap(planeCollection, this->InputModelToWorldTransformFilter->GetOutput(), planes, endCapPolyData);
+    ProfileStageTimer timer(this, "End cap");
+    std::vector<vtkSmartPointer<vtkPolyData> > contours;
+    for (int i = 0; i < this->ClipPlanes->GetNumberOfItems(); ++i)
+      {
+      contours.push_back(this->PlaneClipper->GetCutContour(i));
+      }
+    this->CreateEndCapFromContours(this->ClipPlanes, contours, this->ClipFunction->GetOperationType(), endCapPolyData);
     }
 
   if (outputPositiveModelNode)
@@ -401,13 +445,16 @@ bool vtkCjyxDynamicModelerPlaneCutTool::RunInternal(vtkDMMLDynamicModelerNode* s
       outputMesh->ShallowCopy(appendEndCap->GetOutput());
       }
 
-    this->OutputPositiveWorldToModelTransformFilter->SetInputData(outputMesh);
-    this->OutputPositiveWorldToModelTransformFilter->Update();
-    outputMesh->DeepCopy(this->OutputPositiveWorldToModelTransformFilter->GetOutput());
-
-    DMMLNodeModifyBlocker blocker(outputPositiveModelNode);
-    outputPositiveModelNode->SetAndObserveMesh(outputMesh);
-    outputPositiveModelNode->InvokeCustomModifiedEvent(vtkDMMLModelNode::MeshModifiedEvent);
+    if (this->UpdateTransformBetweenNodes(clipCoordinateSystemNode, outputPositiveModelNode, this->OutputPositiveWorldToModelTransform))
+      {
+      vtkCjyxDynamicModelerTool::SetOutputMesh(outputPositiveModelNode, outputMesh);
+      }
+    else
+      {
+      this->OutputPositiveWorldToModelTransformFilter->SetInputData(outputMesh);
+      this->OutputPositiveWorldToModelTransformFilter->Update();
+      vtkCjyxDynamicModelerTool::SetOutputMesh(outputPositiveModelNode, this->OutputPositiveWorldToModelTransformFilter->GetOutput());
+      }
     }
 
   if (outputNegativeModelNode)
@@ -428,13 +475,16 @@ bool vtkCjyxDynamicModelerPlaneCutTool::RunInternal(vtkDMMLDynamicModelerNode* s
       outputMesh->ShallowCopy(appendEndCap->GetOutput());
       }
 
-    this->OutputNegativeWorldToModelTransformFilter->SetInputData(outputMesh);
-    this->OutputNegativeWorldToModelTransformFilter->Update();
-    outputMesh->DeepCopy(this->OutputNegativeWorldToModelTransformFilter->GetOutput());
-
-    DMMLNodeModifyBlocker blocker(outputNegativeModelNode);
-    outputNegativeModelNode->SetAndObserveMesh(outputMesh);
-    outputNegativeModelNode->InvokeCustomModifiedEvent(vtkDMMLModelNode::MeshModifiedEvent);
+    if (this->UpdateTransformBetweenNodes(clipCoordinateSystemNode, outputNegativeModelNode, this->OutputNegativeWorldToModelTransform))
+      {
+      vtkCjyxDynamicModelerTool::SetOutputMesh(outputNegativeModelNode, outputMesh);
+      }
+    else
+      {
+      this->OutputNegativeWorldToModelTransformFilter->SetInputData(outputMesh);
+      this->OutputNegativeWorldToModelTransformFilter->Update();
+      vtkCjyxDynamicModelerTool::SetOutputMesh(outputNegativeModelNode, this->OutputNegativeWorldToModelTransformFilter->GetOutput());
+      }
     }
 
   return true;
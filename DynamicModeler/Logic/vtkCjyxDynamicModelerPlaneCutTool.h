@@ -32,7 +32,6 @@
 #include <string>
 #include <vector>
 
-class vtkClipPolyData;
 class vtkDataObject;
 class vtkGeneralTransform;
 class vtkGeometryFilter;
@@ -40,6 +39,7 @@ class vtkImplicitBoolean;
 class vtkImplicitFunction;
 class vtkDMMLDynamicModelerNode;
 class vtkPlane;
+class vtkParallelPlaneClipper;
 class vtkPlaneCollection;
 class vtkPolyData;
 class vtkThreshold;
@@ -66,6 +66,13 @@ public:
   /// Create an end cap on the clipped surface
   static void CreateEndCap(vtkPlaneCollection* planes, vtkPolyData* originalPolyData, vtkImplicitBoolean* cutFunction, vtkPolyData* outputEndCap);
 
+  /// Create an end cap on the clipped surface from a contour on each plane: either the border of the end cap on the
+  /// plane (see vtkParallelPlaneClipper::GetCutContour) or the intersection of the plane with the original surface.
+  /// Each contour is triangulated once and clipped by the other planes, the original surface is not used.
+  /// \param operationType vtkImplicitBoolean operation type that is used for combining the planes
+  static void CreateEndCapFromContours(vtkPlaneCollection* planes, const std::vector<vtkSmartPointer<vtkPolyData> >& contours,
+    int operationType, vtkPolyData* outputEndCap);
+
 protected:
   vtkCjyxDynamicModelerPlaneCutTool();
   ~vtkCjyxDynamicModelerPlaneCutTool() override;
@@ -75,8 +82,14 @@ protected:
   vtkSmartPointer<vtkTransformPolyDataFilter> InputModelToWorldTransformFilter;
   vtkSmartPointer<vtkGeneralTransform>        InputModelNodeToWorldTransform;
 
-  vtkSmartPointer<vtkClipPolyData>            PlaneClipper;
+  vtkSmartPointer<vtkParallelPlaneClipper>    PlaneClipper;
+  // Clip planes are reused between runs so that the clipper is only re-executed if a plane is modified
+  vtkSmartPointer<vtkPlaneCollection>         ClipPlanes;
+  // Combined clip planes, used for creating the end cap
+  vtkSmartPointer<vtkImplicitBoolean>         ClipFunction;
 
+  // Output transforms are from the clipping coordinate system (input model coordinate system
+  // if it is linearly transformed, world otherwise) to the output model coordinate system.
   vtkSmartPointer<vtkTransformPolyDataFilter> OutputPositiveWorldToModelTransformFilter;
   vtkSmartPointer<vtkGeneralTransform>        OutputPositiveWorldToModelTransform;
 
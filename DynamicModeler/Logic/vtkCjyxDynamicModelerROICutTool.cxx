@@ -21,6 +21,7 @@
 // DynamicModeler Logic includes
 #include "vtkCjyxDynamicModelerPlaneCutTool.h"
 #include "vtkCjyxDynamicModelerROICutTool.h"
+#include "vtkParallelPlaneClipper.h"
 
 // DynamicModeler DMML includes
 #include "vtkDMMLDynamicModelerNode.h"
@@ -32,10 +33,10 @@
 
 // VTK includes
 #include <vtkAppendPolyData.h>
-#include <vtkClipPolyData.h>
 #include <vtkCommand.h>
 #include <vtkGeneralTransform.h>
 #include <vtkImplicitBoolean.h>
+#include <vtkMatrix4x4.h>
 #include <vtkPlane.h>
 #include <vtkPlanes.h>
 #include <vtkPlaneCollection.h>
@@ -133,18 +134,29 @@ vtkCjyxDynamicModelerROICutTool::vtkCjyxDynamicModelerROICutTool()
   this->InputModelNodeToWorldTransform = vtkSmartPointer<vtkGeneralTransform>::New();
   this->InputModelToWorldTransformFilter->SetTransform(this->InputModelNodeToWorldTransform);
 
-  this->ROIClipper = vtkSmartPointer<vtkClipPolyData>::New();
-  this->ROIClipper->SetInputConnection(this->InputModelToWorldTransformFilter->GetOutputPort());
+  this->ClipPlanes = vtkSmartPointer<vtkPlaneCollection>::New();
+  this->ClipFunction = vtkSmartPointer<vtkImplicitBoolean>::New();
+  this->ClipFunction->SetOperationTypeToUnion();
+
+  // Usually the ROI only intersects a small part of the input mesh, the hierarchy allows passing the polygons
+  // that are far from the ROI boundary without processing them.
+  this->ROIClipper = vtkSmartPointer<vtkParallelPlaneClipper>::New();
+  this->ROIClipper->SetClipPlanes(this->ClipPlanes);
+  this->ROIClipper->SetOperationTypeToUnion();
+  this->ROIClipper->UseBoundingVolumeHierarchyOn();
 
   this->OutputInsideWorldToModelTransformFilter = vtkSmartPointer<vtkTransformPolyDataFilter>::New();
   this->OutputInsideWorldToModelTransform = vtkSmartPointer<vtkGeneralTransform>::New();
-  this->OutputInsideWorldToModelTransformFilter->SetInputConnection(this->ROIClipper->GetOutputPort());
   this->OutputInsideWorldToModelTransformFilter->SetTransform(this->OutputInsideWorldToModelTransform);
 
   this->OutputOutsideWorldToModelTransformFilter = vtkSmartPointer<vtkTransformPolyDataFilter>::New();
   this->OutputOutsideWorldToModelTransform = vtkSmartPointer<vtkGeneralTransform>::New();
-  this->OutputOutsideWorldToModelTransformFilter->SetInputConnection(this->ROIClipper->GetClippedOutputPort());
   this->OutputOutsideWorldToModelTransformFilter->SetTransform(this->OutputOutsideWorldToModelTransform);
+
+  this->AddProgressObserver(this->InputModelToWorldTransformFilter, "Input transform");
+  this->AddProgressObserver(this->ROIClipper, "Clip");
+  this->AddProgressObserver(this->OutputInsideWorldToModelTransformFilter, "Output transform");
+  this->AddProgressObserver(this->OutputOutsideWorldToModelTransformFilter, "Output transform");
 }
 
 //----------------------------------------------------------------------------
@@ -212,13 +224,14 @@ bool vtkCjyxDynamicModelerROICutTool::RunInternal(vtkDMMLDynamicModelerNode* dyn
     }
   if (!inputModelNode->GetMesh() || inputModelNode->GetMesh()->GetNumberOfPoints() == 0)
     {
+    // Published meshes are not modified in place, empty meshes are set instead
     if (outputInsideModelNode && outputInsideModelNode->GetPolyData())
       {
-      outputInsideModelNode->GetPolyData()->Initialize();
+      outputInsideModelNode->SetAndObservePolyData(vtkNew<vtkPolyData>());
       }
     if (outputOutsideModelNode && outputOutsideModelNode->GetPolyData())
       {
-      outputOutsideModelNode->GetPolyData()->Initialize();
+      outputOutsideModelNode->SetAndObservePolyData(vtkNew<vtkPolyData>());
       }
     return true;
     }
@@ -240,9 +253,6 @@ bool vtkCjyxDynamicModelerROICutTool::RunInternal(vtkDMMLDynamicModelerNode* dyn
   vtkNew<vtkPlanes> planes;
   roiNode->GetPlanesWorld(planes);
 
-  vtkNew<vtkImplicitBoolean> planeFunction;
-  planeFunction->SetOperationTypeToUnion();
-
   vtkNew<vtkPlaneCollection> planeCollection;
   for (int i = 0; i < planes->GetNumberOfPlanes(); ++i)
     {
@@ -262,17 +272,34 @@ bool vtkCjyxDynamicModelerROICutTool::RunInternal(vtkDMMLDynamicModelerNode* dyn
     plane->SetNormal(normal);
     plane->SetOrigin(origin);
 
-    planeFunction->AddFunction(plane);
     planeCollection->AddItem(plane);
     }
 
-  this->ROIClipper->SetClipFunction(planeFunction);
   this->ROIClipper->SetGenerateClippedOutput(outputOutsideModelNode != nullptr);
 
-  vtkDMMLTransformNode::GetTransformBetweenNodes(inputModelNode->GetParentTransformNode(), nullptr, this->InputModelNodeToWorldTransform);
-
-  this->InputModelToWorldTransformFilter->SetInputConnection(inputModelNode->GetMeshConnection());
-  this->InputModelToWorldTransformFilter->Update();
+  // If the input model is transformed linearly then the ROI planes are transformed into the input model coordinate
+  // system and the mesh is clipped without transforming its points to world and back.
+  // Mesh points are only transformed to world if the input model is under a non-linear transform.
+  vtkDMMLTransformableNode* clipCoordinateSystemNode = nullptr;
+  vtkNew<vtkMatrix4x4> inputModelToWorldMatrix;
+  if (vtkDMMLTransformNode::GetMatrixTransformBetweenNodes(inputModelNode->GetParentTransformNode(), nullptr, inputModelToWorldMatrix))
+    {
+    vtkNew<vtkMatrix4x4> worldToInputModelMatrix;
+    vtkMatrix4x4::Invert(inputModelToWorldMatrix, worldToInputModelMatrix);
+    for (int i = 0; i < planeCollection->GetNumberOfItems(); ++i)
+      {
+      vtkCjyxDynamicModelerTool::TransformPlane(worldToInputModelMatrix, planeCollection->GetItem(i));
+      }
+    this->ROIClipper->SetInputConnection(inputModelNode->GetMeshConnection());
+    clipCoordinateSystemNode = inputModelNode;
+    }
+  else
+    {
+    this->UpdateTransformBetweenNodes(inputModelNode, nullptr, this->InputModelNodeToWorldTransform);
+    this->InputModelToWorldTransformFilter->SetInputConnection(inputModelNode->GetMeshConnection());
+    this->ROIClipper->SetInputConnection(this->InputModelToWorldTransformFilter->GetOutputPort());
+    }
+  vtkCjyxDynamicModelerTool::UpdateClipPlanes(planeCollection, this->ClipPlanes, this->ClipFunction);
 
   bool capSurface = vtkVariant(dynamicModelerNode->GetAttribute(ROI_CUT_CAP_SURFACE_ATTRIBUTE_NAME)).ToInt() != 0;
   int roiType = roiNode->GetROIType();
@@ -280,50 +307,46 @@ bool vtkCjyxDynamicModelerROICutTool::RunInternal(vtkDMMLDynamicModelerNode* dyn
     {
     capSurface = false;
     }
+  this->ROIClipper->SetGenerateCutContours(capSurface);
+  this->ROIClipper->Update();
 
   vtkNew<vtkPolyData> endCapPolyData;
   if (capSurface)
     {
-    vtkCjyxDynamicModelerPlaneCutTool::CreateEndCap(planeCollection, this->InputModelToWorldTransformFilter->GetOutput(), planeFunction, endCapPolyData);
+    ProfileStageTimer timer(this, "End cap");
+    std::vector<vtkSmartPointer<vtkPolyData> > contours;
+    for (int i = 0; i < this->ClipPlanes->GetNumberOfItems(); ++i)
+      {
+      contours.push_back(this->ROIClipper->GetCutContour(i));
+      }
+    vtkCjyxDynamicModelerPlaneCutTool::CreateEndCapFromContours(this->ClipPlanes, contours, this->ClipFunction->GetOperationType(), endCapPolyData);
     }
 
   if (outputInsideModelNode)
     {
-    vtkDMMLTransformNode::GetTransformBetweenNodes(nullptr, outputInsideModelNode->GetParentTransformNode(), this->OutputInsideWorldToModelTransform);
-    this->OutputInsideWorldToModelTransformFilter->Update();
-
-    DMMLNodeModifyBlocker blocker(outputInsideModelNode);
-    vtkSmartPointer<vtkPolyData> outputMesh = outputInsideModelNode->GetPolyData();
-    if (!outputMesh)
-      {
-      outputMesh = vtkSmartPointer<vtkPolyData>::New();
-      outputInsideModelNode->SetAndObservePolyData(outputMesh);
-      }
-    outputMesh->DeepCopy(this->OutputInsideWorldToModelTransformFilter->GetOutput());
+    vtkPolyData* outputMesh = this->ROIClipper->GetOutput();
+    vtkNew<vtkAppendPolyData> appendEndCap;
     if (capSurface)
       {
-      vtkNew<vtkAppendPolyData> appendEndCap;
       appendEndCap->AddInputData(outputMesh);
       appendEndCap->AddInputData(endCapPolyData);
       appendEndCap->Update();
-      outputMesh->ShallowCopy(appendEndCap->GetOutput());
+      outputMesh = appendEndCap->GetOutput();
+      }
+
+    if (!this->UpdateTransformBetweenNodes(clipCoordinateSystemNode, outputInsideModelNode, this->OutputInsideWorldToModelTransform))
+      {
+      this->OutputInsideWorldToModelTransformFilter->SetInputData(outputMesh);
+      this->OutputInsideWorldToModelTransformFilter->Update();
+      outputMesh = this->OutputInsideWorldToModelTransformFilter->GetOutput();
       }
-    outputInsideModelNode->InvokeCustomModifiedEvent(vtkDMMLModelNode::MeshModifiedEvent);
+    vtkCjyxDynamicModelerTool::SetOutputMesh(outputInsideModelNode, outputMesh);
     }
 
   if (outputOutsideModelNode)
     {
-    vtkDMMLTransformNode::GetTransformBetweenNodes(nullptr, outputOutsideModelNode->GetParentTransformNode(), this->OutputOutsideWorldToModelTransform);
-    this->OutputOutsideWorldToModelTransformFilter->Update();
-
-    DMMLNodeModifyBlocker blocker(outputOutsideModelNode);
-    vtkSmartPointer<vtkPolyData> outputMesh = outputOutsideModelNode->GetPolyData();
-    if (!outputMesh)
-      {
-      outputMesh = vtkSmartPointer<vtkPolyData>::New();
-      outputOutsideModelNode->SetAndObservePolyData(outputMesh);
-      }
-    outputMesh->DeepCopy(this->OutputOutsideWorldToModelTransformFilter->GetOutput());
+    vtkPolyData* outputMesh = this->ROIClipper->GetClippedOutput();
+    vtkNew<vtkAppendPolyData> appendEndCap;
     if (capSurface)
       {
       vtkNew<vtkReverseSense> reverseSense;
@@ -331,13 +354,19 @@ bool vtkCjyxDynamicModelerROICutTool::RunInternal(vtkDMMLDynamicModelerNode* dyn
       reverseSense->ReverseCellsOn();
       reverseSense->ReverseNormalsOn();
 
-      vtkNew<vtkAppendPolyData> appendEndCap;
       appendEndCap->AddInputData(outputMesh);
       appendEndCap->AddInputConnection(reverseSense->GetOutputPort());
       appendEndCap->Update();
-      outputMesh->ShallowCopy(appendEndCap->GetOutput());
+      outputMesh = appendEndCap->GetOutput();
+      }
+
+    if (!this->UpdateTransformBetweenNodes(clipCoordinateSystemNode, outputOutsideModelNode, this->OutputOutsideWorldToModelTransform))
+      {
+      this->OutputOutsideWorldToModelTransformFilter->SetInputData(outputMesh);
+      this->OutputOutsideWorldToModelTransformFilter->Update();
+      outputMesh = this->OutputOutsideWorldToModelTransformFilter->GetOutput();
       }
-    outputOutsideModelNode->InvokeCustomModifiedEvent(vtkDMMLModelNode::MeshModifiedEvent);
+    vtkCjyxDynamicModelerTool::SetOutputMesh(outputOutsideModelNode, outputMesh);
     }
 
   return true;
@@ -26,9 +26,11 @@
 // VTK includes
 #include <vtkSmartPointer.h>
 
-class vtkClipPolyData;
 class vtkGeneralTransform;
+class vtkImplicitBoolean;
 class vtkDMMLDynamicModelerNode;
+class vtkParallelPlaneClipper;
+class vtkPlaneCollection;
 class vtkTransformPolyDataFilter;
 
 #include "vtkCjyxDynamicModelerTool.h"
@@ -80,7 +82,10 @@ protected:
   vtkSmartPointer<vtkTransformPolyDataFilter> InputModelToWorldTransformFilter;
   vtkSmartPointer<vtkGeneralTransform>        InputModelNodeToWorldTransform;
 
-  vtkSmartPointer<vtkClipPolyData>            ROIClipper;
+  vtkSmartPointer<vtkParallelPlaneClipper>    ROIClipper;
+  // Clip planes are reused between runs so that the clipper is only re-executed if the ROI is modified
+  vtkSmartPointer<vtkPlaneCollection>         ClipPlanes;
+  vtkSmartPointer<vtkImplicitBoolean>         ClipFunction;
 
   vtkSmartPointer<vtkTransformPolyDataFilter> OutputInsideWorldToModelTransformFilter;
   vtkSmartPointer<vtkGeneralTransform>        OutputInsideWorldToModelTransform;
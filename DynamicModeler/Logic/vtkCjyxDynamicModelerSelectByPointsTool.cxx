@@ -160,6 +160,11 @@ vtkCjyxDynamicModelerSelectByPointsTool::vtkCjyxDynamicModelerSelectByPointsTool
 
   this->SelectionArray = vtkSmartPointer<vtkUnsignedCharArray>::New();
   this->SelectionArray->SetName(SELECTION_ARRAY_NAME);
+
+  this->AddProgressObserver(this->InputModelToWorldTransformFilter, "Input transform");
+  this->AddProgressObserver(this->GeodesicDistance, "Select");
+  this->AddProgressObserver(this->OutputSelectionScalarsModelTransformFilter, "Output transform");
+  this->AddProgressObserver(this->OutputSelectedFacesModelTransformFilter, "Output transform");
 }
 
 //----------------------------------------------------------------------------
@@ -216,9 +221,8 @@ bool vtkCjyxDynamicModelerSelectByPointsTool::RunInternal(vtkDMMLDynamicModelerN
 
   // Set inputMesh_World
   vtkSmartPointer<vtkPolyData> inputMesh_World;
-  if (inputModelNode->GetParentTransformNode())
+  if (!this->UpdateTransformBetweenNodes(inputModelNode, nullptr, this->InputModelNodeToWorldTransform))
     {
-    inputModelNode->GetParentTransformNode()->GetTransformToWorld(this->InputModelNodeToWorldTransform);
     this->InputModelToWorldTransformFilter->SetInputConnection(inputModelNode->GetMeshConnection());
     this->InputModelToWorldTransformFilter->Update();
     inputMesh_World = this->InputModelToWorldTransformFilter->GetOutput();
@@ -226,8 +230,6 @@ bool vtkCjyxDynamicModelerSelectByPointsTool::RunInternal(vtkDMMLDynamicModelerN
   else
     {
     // Not transformed
-    // Deallocate transform object (it may be a large composite transform)
-    this->InputModelNodeToWorldTransform->Identity();
     // Directly use the input model node's polydata, as this allows reusing the previously initialized locator
     inputMesh_World = vtkPolyData::SafeDownCast(inputModelNode->GetMesh());
     }
@@ -246,6 +248,7 @@ bool vtkCjyxDynamicModelerSelectByPointsTool::RunInternal(vtkDMMLDynamicModelerN
   vtkSmartPointer<vtkPolyData> selectedFacesMesh_World;
   if (selectionAlgorithm == "SphereRadius")
     {
+    ProfileStageTimer timer(this, "Select");
     success = this->UpdateUsingSphereRadius(inputMesh_World, fiducialNode, selectionDistance,
       computeSelectionScalarsModel, computeSelectedFacesModel, this->SelectionArray, selectedFacesMesh_World);
     }
@@ -261,48 +264,51 @@ bool vtkCjyxDynamicModelerSelectByPointsTool::RunInternal(vtkDMMLDynamicModelerN
 
   if (computeSelectionScalarsModel)
     {
-    // Get an independent copy of the input mesh in node coordinate system
-    if (outputSelectionScalarsModelNode->GetParentTransformNode())
+    // Get the input mesh in node coordinate system. The mesh data is shared, only the point data
+    // array list is owned by the output mesh, so adding the selection array does not modify the input.
+    this->SelectionScalarsOutputMesh = vtkSmartPointer<vtkPolyData>::New();
+    if (!this->UpdateTransformBetweenNodes(nullptr, outputSelectionScalarsModelNode, this->OutputSelectionScalarsModelTransform))
       {
-      outputSelectionScalarsModelNode->GetParentTransformNode()->GetTransformFromWorld(this->OutputSelectionScalarsModelTransform);
       this->OutputSelectionScalarsModelTransformFilter->SetInputData(inputMesh_World);
       this->OutputSelectionScalarsModelTransformFilter->Update();
-      this->SelectionScalarsOutputMesh->DeepCopy(this->OutputSelectionScalarsModelTransformFilter->GetOutput());
+      this->SelectionScalarsOutputMesh->ShallowCopy(this->OutputSelectionScalarsModelTransformFilter->GetOutput());
       }
     else
       {
       // Not transformed
-      this->SelectionScalarsOutputMesh->DeepCopy(inputMesh_World);
+      this->SelectionScalarsOutputMesh->ShallowCopy(inputMesh_World);
       }
 
     vtkPointData* pointScalars = vtkPointData::SafeDownCast(this->SelectionScalarsOutputMesh->GetPointData());
     pointScalars->AddArray(this->SelectionArray);
-    
-    outputSelectionScalarsModelNode->SetAndObservePolyData(this->SelectionScalarsOutputMesh);
-    outputSelectionScalarsModelNode->InvokeCustomModifiedEvent(vtkDMMLModelNode::MeshModifiedEvent);
+
+    vtkCjyxDynamicModelerTool::SetOutputMesh(outputSelectionScalarsModelNode, this->SelectionScalarsOutputMesh);
     }
 
   if (computeSelectedFacesModel)
     {
     // Get clipped output mesh
-    if (outputSelectedFacesModelNode->GetParentTransformNode())
+    this->SelectedFacesOutputMesh = vtkSmartPointer<vtkPolyData>::New();
+    if (!this->UpdateTransformBetweenNodes(nullptr, outputSelectedFacesModelNode, this->OutputSelectedFacesModelTransform))
       {
-      outputSelectedFacesModelNode->GetParentTransformNode()->GetTransformFromWorld(this->OutputSelectedFacesModelTransform);
       this->OutputSelectedFacesModelTransformFilter->SetInputData(selectedFacesMesh_World);
       this->OutputSelectedFacesModelTransformFilter->Update();
-      this->SelectedFacesOutputMesh->DeepCopy(this->OutputSelectedFacesModelTransformFilter->GetOutput());
+      this->SelectedFacesOutputMesh->ShallowCopy(this->OutputSelectedFacesModelTransformFilter->GetOutput());
       }
     else
       {
       // Not transformed
-      this->SelectedFacesOutputMesh->DeepCopy(selectedFacesMesh_World);
+      this->SelectedFacesOutputMesh->ShallowCopy(selectedFacesMesh_World);
       }
-  
-    DMMLNodeModifyBlocker blocker(outputSelectedFacesModelNode);
-    outputSelectedFacesModelNode->SetAndObserveMesh(this->SelectedFacesOutputMesh);
-    outputSelectedFacesModelNode->InvokeCustomModifiedEvent(vtkDMMLModelNode::MeshModifiedEvent);
+
+    vtkCjyxDynamicModelerTool::SetOutputMesh(outputSelectedFacesModelNode, this->SelectedFacesOutputMesh);
     }
 
+  // The selection array is now referenced by the published meshes, the next run fills a new array
+  vtkNew<vtkUnsignedCharArray> selectionArray;
+  selectionArray->SetName(SELECTION_ARRAY_NAME);
+  this->SelectionArray = selectionArray;
+
     return true;
 }
 
@@ -397,6 +403,11 @@ bool vtkCjyxDynamicModelerSelectByPointsTool::UpdateUsingGeodesicDistance(vtkPol
   this->GeodesicDistance->SetSeeds(seeds.GetPointer());
   this->GeodesicDistance->SetDistanceStopCriterion(selectionDistance);
   this->GeodesicDistance->Update();
+  if (this->GetAbortRequested())
+    {
+    // Distance field is incomplete
+    return false;
+    }
 
   if (computeSelectionScalarsModel)
     {
@@ -19,10 +19,32 @@
 ==============================================================================*/
 
 #include "vtkCjyxDynamicModelerTool.h"
+#include "vtkCjyxDynamicModelerToolSnapshot.h"
+
+// FastMarching includes
+#include <vtkFastMarchingGeodesicDistance.h>
 
 // VTK includes
+#include <vtkAlgorithm.h>
+#include <vtkCallbackCommand.h>
+#include <vtkCellArray.h>
+#include <vtkCellData.h>
+#include <vtkDataSet.h>
+#include <vtkGeneralTransform.h>
+#include <vtkImplicitBoolean.h>
+#include <vtkImplicitFunctionCollection.h>
+#include <vtkMath.h>
+#include <vtkMatrix4x4.h>
+#include <vtkNew.h>
 #include <vtkObjectFactory.h>
+#include <vtkPlane.h>
+#include <vtkPlaneCollection.h>
+#include <vtkPointData.h>
+#include <vtkPoints.h>
+#include <vtkPointSet.h>
+#include <vtkPolyData.h>
 #include <vtkSmartPointer.h>
+#include <vtkTimerLog.h>
 
 /// DynamicModeler DMML includes
 #include "vtkDMMLDynamicModelerNode.h"
@@ -30,10 +52,19 @@
 /// DMML includes
 #include <vtkDMMLDisplayableNode.h>
 #include <vtkDMMLDisplayNode.h>
+#include <vtkDMMLModelNode.h>
+#include <vtkDMMLTransformNode.h>
+
+// STD includes
+#include <algorithm>
 
 //----------------------------------------------------------------------------
 vtkCjyxDynamicModelerTool::vtkCjyxDynamicModelerTool()
-= default;
+{
+  this->ProgressCallback = vtkSmartPointer<vtkCallbackCommand>::New();
+  this->ProgressCallback->SetClientData(this);
+  this->ProgressCallback->SetCallback(vtkCjyxDynamicModelerTool::OnFilterEvent);
+}
 
 //----------------------------------------------------------------------------
 vtkCjyxDynamicModelerTool::~vtkCjyxDynamicModelerTool()
@@ -190,6 +221,8 @@ void vtkCjyxDynamicModelerTool::PrintSelf(ostream& os, vtkIndent indent)
 {
   Superclass::PrintSelf(os, indent);
   os << indent << "Name:\t" << this->GetName() << std::endl;
+  os << indent << "Progress:\t" << this->GetProgress() << std::endl;
+  os << indent << "AbortRequested:\t" << (this->GetAbortRequested() ? "true" : "false") << std::endl;
 }
 
 //---------------------------------------------------------------------------
@@ -442,5 +475,416 @@ bool vtkCjyxDynamicModelerTool::Run(vtkDMMLDynamicModelerNode* surfaceEditorNode
     }
 
   this->CreateOutputDisplayNodes(surfaceEditorNode);
-  return this->RunInternal(surfaceEditorNode);
+  this->ClearAbortRequest();
+  return this->ExecuteRun(surfaceEditorNode);
+}
+
+//---------------------------------------------------------------------------
+bool vtkCjyxDynamicModelerTool::RunSnapshot(vtkCjyxDynamicModelerToolSnapshot* snapshot)
+{
+  if (!snapshot || !snapshot->GetDynamicModelerNode())
+    {
+    vtkErrorMacro("Invalid snapshot!");
+    return false;
+    }
+  return this->ExecuteRun(snapshot->GetDynamicModelerNode());
+}
+
+//---------------------------------------------------------------------------
+bool vtkCjyxDynamicModelerTool::ExecuteRun(vtkDMMLDynamicModelerNode* surfaceEditorNode)
+{
+  this->Progress = 0.0;
+  this->CurrentRunProfile = RunProfile();
+  this->FilterStartTimes.clear();
+
+  std::vector<vtkDMMLNode*> inputNodes;
+  this->GetInputNodes(surfaceEditorNode, inputNodes);
+  for (vtkDMMLNode* inputNode : inputNodes)
+    {
+    vtkDMMLModelNode* inputModelNode = vtkDMMLModelNode::SafeDownCast(inputNode);
+    vtkPointSet* inputMesh = inputModelNode ? inputModelNode->GetMesh() : nullptr;
+    if (inputMesh)
+      {
+      this->CurrentRunProfile.InputPoints += inputMesh->GetNumberOfPoints();
+      this->CurrentRunProfile.InputCells += inputMesh->GetNumberOfCells();
+      }
+    }
+
+  if (this->AbortRequested)
+    {
+    // Aborted before the run was started
+    return false;
+    }
+
+  double startTime = vtkTimerLog::GetUniversalTime();
+  bool success = this->RunInternal(surfaceEditorNode);
+  this->CurrentRunProfile.WallTimeSec = vtkTimerLog::GetUniversalTime() - startTime;
+  this->ResetAbortedFilters();
+  if (this->AbortRequested)
+    {
+    return false;
+    }
+
+  std::vector<vtkDMMLNode*> outputNodes;
+  this->GetOutputNodes(surfaceEditorNode, outputNodes);
+  for (vtkDMMLNode* outputNode : outputNodes)
+    {
+    vtkDMMLModelNode* outputModelNode = vtkDMMLModelNode::SafeDownCast(outputNode);
+    vtkPointSet* outputMesh = outputModelNode ? outputModelNode->GetMesh() : nullptr;
+    if (outputMesh)
+      {
+      this->CurrentRunProfile.OutputPoints += outputMesh->GetNumberOfPoints();
+      this->CurrentRunProfile.OutputCells += outputMesh->GetNumberOfCells();
+      }
+    }
+  this->LastRunProfile = this->CurrentRunProfile;
+
+  this->Progress = 1.0;
+  return success;
+}
+
+//---------------------------------------------------------------------------
+const vtkCjyxDynamicModelerTool::RunProfile& vtkCjyxDynamicModelerTool::GetLastRunProfile()
+{
+  return this->LastRunProfile;
+}
+
+//---------------------------------------------------------------------------
+void vtkCjyxDynamicModelerTool::AddStageWallTime(const std::string& stageName, double wallTimeSec)
+{
+  std::vector<std::pair<std::string, double> >& stages = this->CurrentRunProfile.StageWallTimeSec;
+  for (std::pair<std::string, double>& stage : stages)
+    {
+    if (stage.first == stageName)
+      {
+      stage.second += wallTimeSec;
+      return;
+      }
+    }
+  stages.emplace_back(stageName, wallTimeSec);
+}
+
+//---------------------------------------------------------------------------
+vtkCjyxDynamicModelerTool::ProfileStageTimer::ProfileStageTimer(vtkCjyxDynamicModelerTool* tool, const std::string& stageName)
+  : Tool(tool)
+  , StageName(stageName)
+  , StartTime(vtkTimerLog::GetUniversalTime())
+{
+}
+
+//---------------------------------------------------------------------------
+vtkCjyxDynamicModelerTool::ProfileStageTimer::~ProfileStageTimer()
+{
+  this->Tool->AddStageWallTime(this->StageName, vtkTimerLog::GetUniversalTime() - this->StartTime);
+}
+
+//---------------------------------------------------------------------------
+double vtkCjyxDynamicModelerTool::GetProgress()
+{
+  return this->Progress;
+}
+
+//---------------------------------------------------------------------------
+void vtkCjyxDynamicModelerTool::RequestAbort()
+{
+  this->AbortRequested = true;
+}
+
+//---------------------------------------------------------------------------
+void vtkCjyxDynamicModelerTool::ClearAbortRequest()
+{
+  this->AbortRequested = false;
+}
+
+//---------------------------------------------------------------------------
+bool vtkCjyxDynamicModelerTool::GetAbortRequested()
+{
+  return this->AbortRequested;
+}
+
+//---------------------------------------------------------------------------
+void vtkCjyxDynamicModelerTool::AddProgressObserver(vtkAlgorithm* filter, const std::string& stageName)
+{
+  if (!filter)
+    {
+    return;
+    }
+  this->ProgressFilters.push_back(filter);
+  this->FilterStageNames[filter] = stageName;
+  filter->AddObserver(vtkCommand::StartEvent, this->ProgressCallback);
+  filter->AddObserver(vtkCommand::EndEvent, this->ProgressCallback);
+  filter->AddObserver(vtkCommand::ProgressEvent, this->ProgressCallback);
+  if (vtkFastMarchingGeodesicDistance::SafeDownCast(filter))
+    {
+    filter->AddObserver(vtkFastMarchingGeodesicDistance::IterationEvent, this->ProgressCallback);
+    }
+}
+
+//---------------------------------------------------------------------------
+void vtkCjyxDynamicModelerTool::OnFilterEvent(vtkObject* caller, unsigned long eventId, void* clientData, void* callData)
+{
+  vtkCjyxDynamicModelerTool* self = reinterpret_cast<vtkCjyxDynamicModelerTool*>(clientData);
+  vtkAlgorithm* filter = vtkAlgorithm::SafeDownCast(caller);
+  if (!self || !filter)
+    {
+    return;
+    }
+
+  if (eventId == vtkCommand::StartEvent)
+    {
+    self->FilterStartTimes[filter] = vtkTimerLog::GetUniversalTime();
+    return;
+    }
+  if (eventId == vtkCommand::EndEvent)
+    {
+    std::map<vtkAlgorithm*, double>::iterator startTimeIt = self->FilterStartTimes.find(filter);
+    if (startTimeIt != self->FilterStartTimes.end())
+      {
+      self->AddStageWallTime(self->FilterStageNames[filter], vtkTimerLog::GetUniversalTime() - startTimeIt->second);
+      self->FilterStartTimes.erase(startTimeIt);
+      }
+    return;
+    }
+
+  if (self->AbortRequested)
+    {
+    if (!filter->GetAbortExecute())
+      {
+      filter->SetAbortExecute(1);
+      self->AbortedFilters.push_back(filter);
+      }
+    return;
+    }
+
+  double filterProgress = 0.0;
+  if (eventId == vtkCommand::ProgressEvent && callData)
+    {
+    filterProgress = *(reinterpret_cast<double*>(callData));
+    }
+  else if (eventId == vtkFastMarchingGeodesicDistance::IterationEvent)
+    {
+    // Each iteration of the fast marching visits one point, so the number of points is an upper bound
+    // of the number of iterations (the distance stop criterion may terminate the fast marching earlier).
+    vtkFastMarchingGeodesicDistance* geodesicDistance = vtkFastMarchingGeodesicDistance::SafeDownCast(filter);
+    vtkDataSet* input = vtkDataSet::SafeDownCast(geodesicDistance->GetInput());
+    vtkIdType numberOfPoints = input ? input->GetNumberOfPoints() : 0;
+    if (numberOfPoints > 0)
+      {
+      filterProgress = std::min(1.0, static_cast<double>(geodesicDistance->GetIterationIndex()) / numberOfPoints);
+      }
+    }
+
+  // Each observed filter is an equal share of the run
+  std::vector<vtkAlgorithm*>::iterator filterIt = std::find(self->ProgressFilters.begin(), self->ProgressFilters.end(), filter);
+  if (filterIt == self->ProgressFilters.end())
+    {
+    return;
+    }
+  double numberOfFilters = static_cast<double>(self->ProgressFilters.size());
+  double filterIndex = static_cast<double>(filterIt - self->ProgressFilters.begin());
+  double progress = (filterIndex + std::max(0.0, std::min(1.0, filterProgress))) / numberOfFilters;
+  if (progress > self->Progress)
+    {
+    self->Progress = progress;
+    }
+}
+
+//---------------------------------------------------------------------------
+void vtkCjyxDynamicModelerTool::ResetAbortedFilters()
+{
+  // The output of an aborted filter is incomplete, but the pipeline considers it up-to-date.
+  for (vtkAlgorithm* filter : this->AbortedFilters)
+    {
+    filter->Modified();
+    }
+  this->AbortedFilters.clear();
+}
+
+//----------------------------------------------------------------------------
+void vtkCjyxDynamicModelerTool::SetOutputMesh(vtkDMMLModelNode* outputModelNode, vtkPointSet* mesh)
+{
+  if (!outputModelNode)
+    {
+    return;
+    }
+  ProfileStageTimer timer(this, "Publish");
+
+  vtkSmartPointer<vtkPointSet> outputMesh;
+  if (mesh)
+    {
+    outputMesh = vtkSmartPointer<vtkPointSet>::Take(mesh->NewInstance());
+    outputMesh->ShallowCopy(mesh);
+    }
+
+  DMMLNodeModifyBlocker blocker(outputModelNode);
+  outputModelNode->SetAndObserveMesh(outputMesh);
+  outputModelNode->InvokeCustomModifiedEvent(vtkDMMLModelNode::MeshModifiedEvent);
+}
+
+//----------------------------------------------------------------------------
+bool vtkCjyxDynamicModelerTool::UpdateTransformBetweenNodes(vtkDMMLTransformableNode* sourceNode, vtkDMMLTransformableNode* targetNode,
+  vtkGeneralTransform* sourceToTarget)
+{
+  if (!sourceToTarget)
+    {
+    vtkErrorMacro("UpdateTransformBetweenNodes: Invalid transform");
+    return false;
+    }
+
+  vtkDMMLTransformNode* sourceTransformNode = sourceNode ? sourceNode->GetParentTransformNode() : nullptr;
+  vtkDMMLTransformNode* targetTransformNode = targetNode ? targetNode->GetParentTransformNode() : nullptr;
+  TransformCacheEntry& cacheEntry = this->TransformCache[sourceToTarget];
+
+  vtkSmartPointer<vtkMatrix4x4> sourceToTargetMatrix = vtkSmartPointer<vtkMatrix4x4>::New();
+  bool linear = sourceTransformNode == targetTransformNode
+    || vtkDMMLTransformNode::GetMatrixTransformBetweenNodes(sourceTransformNode, targetTransformNode, sourceToTargetMatrix);
+  if (linear)
+    {
+    if (!cacheEntry.Valid || !cacheEntry.Linear || !vtkCjyxDynamicModelerTool::AreMatricesEqual(cacheEntry.Matrix, sourceToTargetMatrix))
+      {
+      sourceToTarget->Identity();
+      if (!sourceToTargetMatrix->IsIdentity())
+        {
+        sourceToTarget->Concatenate(sourceToTargetMatrix);
+        }
+      cacheEntry = TransformCacheEntry();
+      cacheEntry.Valid = true;
+      cacheEntry.Linear = true;
+      cacheEntry.Matrix = sourceToTargetMatrix;
+      }
+    return sourceToTargetMatrix->IsIdentity();
+    }
+
+  // Non-linear transforms cannot be compared, check if any transform in the hierarchy has been modified instead.
+  std::string sourceTransformNodeID = sourceTransformNode && sourceTransformNode->GetID() ? sourceTransformNode->GetID() : "";
+  std::string targetTransformNodeID = targetTransformNode && targetTransformNode->GetID() ? targetTransformNode->GetID() : "";
+  vtkMTimeType transformMTime = std::max(sourceTransformNode ? sourceTransformNode->GetTransformToWorldMTime() : 0,
+    targetTransformNode ? targetTransformNode->GetTransformToWorldMTime() : 0);
+  if (!cacheEntry.Valid || cacheEntry.Linear
+    || cacheEntry.SourceTransformNodeID != sourceTransformNodeID
+    || cacheEntry.TargetTransformNodeID != targetTransformNodeID
+    || cacheEntry.TransformMTime != transformMTime)
+    {
+    vtkDMMLTransformNode::GetTransformBetweenNodes(sourceTransformNode, targetTransformNode, sourceToTarget);
+    cacheEntry = TransformCacheEntry();
+    cacheEntry.Valid = true;
+    cacheEntry.SourceTransformNodeID = sourceTransformNodeID;
+    cacheEntry.TargetTransformNodeID = targetTransformNodeID;
+    cacheEntry.TransformMTime = transformMTime;
+    }
+  return false;
+}
+
+//----------------------------------------------------------------------------
+void vtkCjyxDynamicModelerTool::GetMeshContent(vtkPolyData* mesh, std::vector<vtkSmartPointer<vtkObject>>& content,
+  vtkMTimeType& contentMTime)
+{
+  content.clear();
+  contentMTime = 0;
+  if (!mesh)
+    {
+    return;
+    }
+  std::vector<vtkObject*> objects;
+  objects.push_back(mesh->GetPoints());
+  objects.push_back(mesh->GetPoints() ? mesh->GetPoints()->GetData() : nullptr);
+  vtkCellArray* cellArrays[4] = { mesh->GetVerts(), mesh->GetLines(), mesh->GetPolys(), mesh->GetStrips() };
+  for (vtkCellArray* cells : cellArrays)
+    {
+    objects.push_back(cells);
+    objects.push_back(cells ? cells->GetOffsetsArray() : nullptr);
+    objects.push_back(cells ? cells->GetConnectivityArray() : nullptr);
+    }
+  vtkDataSetAttributes* attributes[2] = { mesh->GetPointData(), mesh->GetCellData() };
+  for (vtkDataSetAttributes* attribute : attributes)
+    {
+    for (int i = 0; i < attribute->GetNumberOfArrays(); ++i)
+      {
+      objects.push_back(attribute->GetAbstractArray(i));
+      }
+    }
+  for (vtkObject* object : objects)
+    {
+    content.push_back(object);
+    if (object)
+      {
+      contentMTime = std::max(contentMTime, object->GetMTime());
+      }
+    }
+}
+
+//----------------------------------------------------------------------------
+bool vtkCjyxDynamicModelerTool::AreMatricesEqual(vtkMatrix4x4* matrix1, vtkMatrix4x4* matrix2)
+{
+  if (!matrix1 || !matrix2)
+    {
+    return false;
+    }
+  for (int i = 0; i < 4; ++i)
+    {
+    for (int j = 0; j < 4; ++j)
+      {
+      if (matrix1->GetElement(i, j) != matrix2->GetElement(i, j))
+        {
+        return false;
+        }
+      }
+    }
+  return true;
+}
+
+//----------------------------------------------------------------------------
+void vtkCjyxDynamicModelerTool::TransformPlane(vtkMatrix4x4* transformMatrix, vtkPlane* plane)
+{
+  if (!transformMatrix || !plane)
+    {
+    return;
+    }
+
+  double origin[4] = { 0.0, 0.0, 0.0, 1.0 };
+  plane->GetOrigin(origin);
+  transformMatrix->MultiplyPoint(origin, origin);
+
+  // Normals are transformed by the inverse transpose of the matrix
+  double normal[4] = { 0.0, 0.0, 1.0, 0.0 };
+  plane->GetNormal(normal);
+  vtkNew<vtkMatrix4x4> normalMatrix;
+  vtkMatrix4x4::Invert(transformMatrix, normalMatrix);
+  normalMatrix->Transpose();
+  normalMatrix->MultiplyPoint(normal, normal);
+  vtkMath::Normalize(normal);
+
+  plane->SetOrigin(origin);
+  plane->SetNormal(normal);
+}
+
+//----------------------------------------------------------------------------
+void vtkCjyxDynamicModelerTool::UpdateClipPlanes(vtkPlaneCollection* planes, vtkPlaneCollection* clipPlanes, vtkImplicitBoolean* clipFunction)
+{
+  if (!planes || !clipPlanes || !clipFunction)
+    {
+    return;
+    }
+
+  if (planes->GetNumberOfItems() != clipPlanes->GetNumberOfItems())
+    {
+    clipPlanes->RemoveAllItems();
+    clipFunction->GetFunction()->RemoveAllItems();
+    for (int i = 0; i < planes->GetNumberOfItems(); ++i)
+      {
+      vtkNew<vtkPlane> clipPlane;
+      clipPlanes->AddItem(clipPlane);
+      clipFunction->AddFunction(clipPlane);
+      }
+    clipFunction->Modified();
+    }
+
+  // Set methods do not modify the planes if the values are unchanged
+  for (int i = 0; i < planes->GetNumberOfItems(); ++i)
+    {
+    vtkPlane* plane = planes->GetItem(i);
+    vtkPlane* clipPlane = clipPlanes->GetItem(i);
+    clipPlane->SetOrigin(plane->GetOrigin());
+    clipPlane->SetNormal(plane->GetNormal());
+    }
 }
@@ -25,19 +25,34 @@
 
 // VTK includes
 #include <vtkIntArray.h>
+#include <vtkMatrix4x4.h>
 #include <vtkObject.h>
+#include <vtkSmartPointer.h>
 #include <vtkStringArray.h>
 
 // STD includes
+#include <atomic>
 #include <map>
 #include <string>
+#include <utility>
 #include <vector>
 
+class vtkAlgorithm;
+class vtkCallbackCommand;
 class vtkCollection;
 class vtkDMMLDisplayableNode;
 class vtkDMMLDisplayNode;
 class vtkDMMLDynamicModelerNode;
+class vtkDMMLModelNode;
 class vtkDMMLNode;
+class vtkDMMLTransformableNode;
+class vtkGeneralTransform;
+class vtkImplicitBoolean;
+class vtkPlane;
+class vtkPlaneCollection;
+class vtkPointSet;
+class vtkPolyData;
+class vtkCjyxDynamicModelerToolSnapshot;
 
 /// Helper macro for supporting cloning of tools
 #ifndef vtkToolNewMacro
@@ -162,6 +177,51 @@ public:
   /// Checks to ensure that all of the required inputs have been set.
   bool Run(vtkDMMLDynamicModelerNode* surfaceEditorNode);
 
+  /// Run the surface editor tool on a copy of the inputs and outputs \sa vtkCjyxDynamicModelerToolSnapshot.
+  /// The main scene is not accessed, so this method can be called from a worker thread.
+  /// Only one run of the same tool instance may be in progress at a time.
+  /// The abort request is not cleared, ClearAbortRequest must be called when the run is scheduled.
+  bool RunSnapshot(vtkCjyxDynamicModelerToolSnapshot* snapshot);
+
+  /// Progress of the current run of the tool, between 0.0 and 1.0.
+  /// Computed from the progress events of the filters of the tool, in the order they were added by AddProgressObserver.
+  /// Thread safe, may be called while the tool is running on a worker thread.
+  double GetProgress();
+
+  /// Request the current run of the tool to be interrupted.
+  /// The filter that is currently executing is aborted at its next progress (or iteration) event and the run returns false.
+  /// Filters that do not report progress are completed first. The request is cleared when Run is called
+  /// or by ClearAbortRequest.
+  /// Thread safe, may be called while the tool is running on a worker thread.
+  void RequestAbort();
+
+  /// Clear the abort request before a run of RunSnapshot is scheduled. It must be called by the thread that
+  /// schedules the run and requests aborts, so that an abort that is requested after the run was scheduled
+  /// but before it is started on a worker thread interrupts the run.
+  void ClearAbortRequest();
+
+  /// Returns true if the current run of the tool was requested to be interrupted \sa RequestAbort.
+  bool GetAbortRequested();
+
+  /// Execution time and mesh sizes of a run of the tool.
+  struct RunProfile
+  {
+    /// Wall time of the whole run, in seconds
+    double WallTimeSec{ 0.0 };
+    /// Wall time of each stage of the run (input transform, clean, clip, end cap, output transform, publish, ...)
+    /// in seconds, in the order the stages were first executed. Stages of filters that were up-to-date are not listed.
+    std::vector<std::pair<std::string, double> > StageWallTimeSec;
+    /// Total number of points and cells of the input and output meshes
+    vtkIdType InputPoints{ 0 };
+    vtkIdType InputCells{ 0 };
+    vtkIdType OutputPoints{ 0 };
+    vtkIdType OutputCells{ 0 };
+  };
+
+  /// Returns the profile of the last completed run.
+  /// Must not be called while the tool is running on a worker thread.
+  const RunProfile& GetLastRunProfile();
+
   enum ParameterType
   {
     PARAMETER_STRING,
@@ -181,6 +241,71 @@ protected:
   /// Run the tool on the input nodes and apply the results to the output nodes
   virtual bool RunInternal(vtkDMMLDynamicModelerNode* surfaceEditorNode) = 0;
 
+  /// Reset the progress and profile, call RunInternal and store the profile of the run.
+  bool ExecuteRun(vtkDMMLDynamicModelerNode* surfaceEditorNode);
+
+  /// Set the mesh in the output model node without copying the mesh data.
+  /// A new mesh object is created that shares the points, cells and data arrays of the specified mesh
+  /// (typically the output of the last filter of the tool). VTK filters allocate new arrays each time they
+  /// execute, so updating the tool pipeline later does not modify the published mesh.
+  /// The mesh that was previously set in the output node is released and never modified in place.
+  /// The time spent in this method is added to the "Publish" stage of the run profile.
+  void SetOutputMesh(vtkDMMLModelNode* outputModelNode, vtkPointSet* mesh);
+
+  /// Update the transform from the coordinate system of the source node to the coordinate system of the target node.
+  /// If a node is nullptr then the world coordinate system is used.
+  /// The transform is only modified if it changed since the last update of the same sourceToTarget transform,
+  /// so that the MTime of the transform (and so the filters that use it) is not bumped on each run of the tool.
+  /// Returns true if the transform is identity (for example, both nodes are under the same parent transform),
+  /// in which case meshes do not need to be transformed.
+  bool UpdateTransformBetweenNodes(vtkDMMLTransformableNode* sourceNode, vtkDMMLTransformableNode* targetNode,
+    vtkGeneralTransform* sourceToTarget);
+
+  /// Get the objects that store the content of the mesh and the latest modification time of these objects.
+  /// Shallow copies of a mesh share these objects, so a mesh can be recognized even if it was shallow copied.
+  static void GetMeshContent(vtkPolyData* mesh, std::vector<vtkSmartPointer<vtkObject>>& content, vtkMTimeType& contentMTime);
+
+  /// Returns true if all elements of the two matrices are equal.
+  static bool AreMatricesEqual(vtkMatrix4x4* matrix1, vtkMatrix4x4* matrix2);
+
+  /// Transform the origin and normal of the plane with a linear transform.
+  static void TransformPlane(vtkMatrix4x4* transformMatrix, vtkPlane* plane);
+
+  /// Copy the origin and normal of the planes to the persistent clip planes, which are also the functions of clipFunction.
+  /// Plane objects are only replaced if the number of planes changed, so the MTime of the clip function
+  /// (and so the clip filter that uses it) only changes if a plane is actually modified.
+  static void UpdateClipPlanes(vtkPlaneCollection* planes, vtkPlaneCollection* clipPlanes, vtkImplicitBoolean* clipFunction);
+
+  /// Forward the progress events of the filter to the progress of the tool, and abort the filter when the run
+  /// of the tool is interrupted \sa RequestAbort. Filters should be added in the order they are executed.
+  /// vtkFastMarchingGeodesicDistance does not report progress events, its iteration events are used instead.
+  /// The execution time of the filter is added to the specified stage of the run profile.
+  /// Tools call this in their constructor for each filter of their pipeline, so that the progress and the execution
+  /// time of each stage are reported.
+  void AddProgressObserver(vtkAlgorithm* filter, const std::string& stageName);
+
+  /// Callback for the start, end, progress and iteration events of the observed filters.
+  static void OnFilterEvent(vtkObject* caller, unsigned long eventId, void* clientData, void* callData);
+
+  /// Add wall time to a stage of the profile of the current run.
+  void AddStageWallTime(const std::string& stageName, double wallTimeSec);
+
+  /// Adds the time between its construction and destruction to a stage of the profile of the current run.
+  /// Used for stages that are not computed by an observed filter.
+  class ProfileStageTimer
+  {
+  public:
+    ProfileStageTimer(vtkCjyxDynamicModelerTool* tool, const std::string& stageName);
+    ~ProfileStageTimer();
+  private:
+    vtkCjyxDynamicModelerTool* Tool;
+    std::string StageName;
+    double StartTime;
+  };
+
+  /// Mark the filters that were aborted during the last run as modified, so that they are executed again on the next run.
+  void ResetAbortedFilters();
+
   /// Struct containing all of the relevant info for input and output nodes.
   struct StructNodeInfo
   {
@@ -227,6 +352,32 @@ protected:
   using ParameterInfo = struct StructParameterInfo;
   std::vector<ParameterInfo> InputParameterInfo;
 
+  /// Content of a transform that was last set by UpdateTransformBetweenNodes.
+  struct TransformCacheEntry
+  {
+    bool Valid{ false };
+    bool Linear{ false };
+    vtkSmartPointer<vtkMatrix4x4> Matrix;
+    std::string SourceTransformNodeID;
+    std::string TargetTransformNodeID;
+    vtkMTimeType TransformMTime{ 0 };
+  };
+  std::map<vtkGeneralTransform*, TransformCacheEntry> TransformCache;
+
+  vtkSmartPointer<vtkCallbackCommand> ProgressCallback;
+  /// Filters that report progress, in execution order
+  std::vector<vtkAlgorithm*> ProgressFilters;
+  /// Profile stage of each observed filter
+  std::map<vtkAlgorithm*, std::string> FilterStageNames;
+  /// Start time of the observed filters that are executing. Only accessed from the thread that runs the tool.
+  std::map<vtkAlgorithm*, double> FilterStartTimes;
+  RunProfile CurrentRunProfile;
+  RunProfile LastRunProfile;
+  /// Filters that were aborted in the current run. Only accessed from the thread that runs the tool.
+  std::vector<vtkAlgorithm*> AbortedFilters;
+  std::atomic<double> Progress{ 0.0 };
+  std::atomic<bool> AbortRequested{ false };
+
 private:
   vtkCjyxDynamicModelerTool(const vtkCjyxDynamicModelerTool&) = delete;
 };
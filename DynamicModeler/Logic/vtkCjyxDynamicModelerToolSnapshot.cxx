@@ -0,0 +1,228 @@
+/*==============================================================================
+
+  Copyright (c) Laboratory for Percutaneous Surgery (PerkLab)
+  Queen's University, Kingston, ON, Canada. All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.cjyx.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+  This file was originally developed by Kyle Sunderland, PerkLab, Queen's University
+  and was supported through CANARIE's Research Software Program, Cancer
+  Care Ontario, OpenAnatomy, and Brigham and Women's Hospital through NIH grant R01MH112748.
+
+==============================================================================*/
+
+#include "vtkCjyxDynamicModelerToolSnapshot.h"
+
+// DynamicModeler Logic includes
+#include "vtkCjyxDynamicModelerTool.h"
+
+// DynamicModeler DMML includes
+#include "vtkDMMLDynamicModelerNode.h"
+
+// DMML includes
+#include <vtkDMMLLinearTransformNode.h>
+#include <vtkDMMLModelNode.h>
+#include <vtkDMMLScene.h>
+#include <vtkDMMLTransformNode.h>
+#include <vtkDMMLTransformableNode.h>
+
+// VTK includes
+#include <vtkMatrix4x4.h>
+#include <vtkNew.h>
+#include <vtkObjectFactory.h>
+#include <vtkPointSet.h>
+
+//----------------------------------------------------------------------------
+vtkStandardNewMacro(vtkCjyxDynamicModelerToolSnapshot);
+
+//----------------------------------------------------------------------------
+vtkCjyxDynamicModelerToolSnapshot::vtkCjyxDynamicModelerToolSnapshot()
+= default;
+
+//----------------------------------------------------------------------------
+vtkCjyxDynamicModelerToolSnapshot::~vtkCjyxDynamicModelerToolSnapshot()
+= default;
+
+//----------------------------------------------------------------------------
+void vtkCjyxDynamicModelerToolSnapshot::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+  os << indent << "NumberOfCopiedNodes: " << this->CopiedNodeIDs.size() << std::endl;
+}
+
+//----------------------------------------------------------------------------
+vtkDMMLDynamicModelerNode* vtkCjyxDynamicModelerToolSnapshot::GetDynamicModelerNode()
+{
+  return this->DynamicModelerNode;
+}
+
+//----------------------------------------------------------------------------
+void vtkCjyxDynamicModelerToolSnapshot::SetInputMeshOverride(const std::string& inputNodeID, vtkPointSet* mesh)
+{
+  if (mesh)
+    {
+    this->InputMeshOverrides[inputNodeID] = mesh;
+    }
+  else
+    {
+    this->InputMeshOverrides.erase(inputNodeID);
+    }
+}
+
+//----------------------------------------------------------------------------
+bool vtkCjyxDynamicModelerToolSnapshot::CreateSnapshot(vtkCjyxDynamicModelerTool* tool, vtkDMMLDynamicModelerNode* surfaceEditorNode)
+{
+  if (!tool || !surfaceEditorNode)
+    {
+    vtkErrorMacro("CreateSnapshot: Invalid tool or dynamic modeler node");
+    return false;
+    }
+
+  this->CopiedNodeIDs.clear();
+  this->Scene = vtkSmartPointer<vtkDMMLScene>::New();
+  this->DynamicModelerNode = vtkSmartPointer<vtkDMMLDynamicModelerNode>::New();
+  this->DynamicModelerNode->SetName(surfaceEditorNode->GetName());
+  this->DynamicModelerNode->SetToolName(surfaceEditorNode->GetToolName());
+  // Tool parameters are stored in node attributes
+  for (const std::string& attributeName : surfaceEditorNode->GetAttributeNames())
+    {
+    this->DynamicModelerNode->SetAttribute(attributeName.c_str(), surfaceEditorNode->GetAttribute(attributeName.c_str()));
+    }
+  this->Scene->AddNode(this->DynamicModelerNode);
+
+  for (int inputIndex = 0; inputIndex < tool->GetNumberOfInputNodes(); ++inputIndex)
+    {
+    std::string referenceRole = tool->GetNthInputNodeReferenceRole(inputIndex);
+    int numberOfNodeReferences = surfaceEditorNode->GetNumberOfNodeReferences(referenceRole.c_str());
+    for (int referenceIndex = 0; referenceIndex < numberOfNodeReferences; ++referenceIndex)
+      {
+      vtkDMMLNode* inputNode = surfaceEditorNode->GetNthNodeReference(referenceRole.c_str(), referenceIndex);
+      if (!inputNode)
+        {
+        continue;
+        }
+      vtkDMMLNode* inputNodeCopy = this->AddNodeCopy(inputNode, true);
+      if (!inputNodeCopy)
+        {
+        return false;
+        }
+      this->DynamicModelerNode->SetNthNodeReferenceID(referenceRole.c_str(), referenceIndex, inputNodeCopy->GetID());
+      }
+    }
+
+  for (int outputIndex = 0; outputIndex < tool->GetNumberOfOutputNodes(); ++outputIndex)
+    {
+    std::string referenceRole = tool->GetNthOutputNodeReferenceRole(outputIndex);
+    vtkDMMLNode* outputNode = surfaceEditorNode->GetNodeReference(referenceRole.c_str());
+    if (!outputNode)
+      {
+      continue;
+      }
+    vtkDMMLNode* outputNodeCopy = this->AddNodeCopy(outputNode, false);
+    if (!outputNodeCopy)
+      {
+      return false;
+      }
+    this->DynamicModelerNode->SetNodeReferenceID(referenceRole.c_str(), outputNodeCopy->GetID());
+    }
+
+  return true;
+}
+
+//----------------------------------------------------------------------------
+vtkDMMLNode* vtkCjyxDynamicModelerToolSnapshot::AddNodeCopy(vtkDMMLNode* node, bool copyContent)
+{
+  std::map<std::string, std::string>::iterator copiedNodeIt = this->CopiedNodeIDs.find(node->GetID());
+  if (copiedNodeIt != this->CopiedNodeIDs.end())
+    {
+    return this->Scene->GetNodeByID(copiedNodeIt->second);
+    }
+
+  vtkSmartPointer<vtkDMMLNode> nodeCopy = vtkSmartPointer<vtkDMMLNode>::Take(node->CreateNodeInstance());
+  nodeCopy->SetName(node->GetName());
+  if (copyContent)
+    {
+    vtkDMMLModelNode* modelNode = vtkDMMLModelNode::SafeDownCast(node);
+    if (modelNode)
+      {
+      // Meshes can be large, only share the data arrays.
+      std::map<std::string, vtkSmartPointer<vtkPointSet> >::iterator meshOverrideIt = this->InputMeshOverrides.find(node->GetID());
+      vtkPointSet* mesh = meshOverrideIt != this->InputMeshOverrides.end() ? meshOverrideIt->second.GetPointer() : modelNode->GetMesh();
+      if (mesh)
+        {
+        vtkSmartPointer<vtkPointSet> meshCopy = vtkSmartPointer<vtkPointSet>::Take(mesh->NewInstance());
+        meshCopy->ShallowCopy(mesh);
+        vtkDMMLModelNode::SafeDownCast(nodeCopy)->SetAndObserveMesh(meshCopy);
+        }
+      }
+    else
+      {
+      nodeCopy->CopyContent(node, true);
+      }
+    }
+  this->Scene->AddNode(nodeCopy);
+  this->CopiedNodeIDs[node->GetID()] = nodeCopy->GetID();
+
+  vtkDMMLTransformableNode* transformableNode = vtkDMMLTransformableNode::SafeDownCast(node);
+  vtkDMMLTransformNode* parentTransformNode = transformableNode ? transformableNode->GetParentTransformNode() : nullptr;
+  if (parentTransformNode)
+    {
+    if (!parentTransformNode->IsTransformToWorldLinear())
+      {
+      vtkDebugMacro("AddNodeCopy: Cannot copy node " << node->GetID() << ", it is under a non-linear transform");
+      return nullptr;
+      }
+    vtkNew<vtkMatrix4x4> nodeToWorldMatrix;
+    parentTransformNode->GetMatrixTransformToWorld(nodeToWorldMatrix);
+    vtkNew<vtkDMMLLinearTransformNode> transformNodeCopy;
+    transformNodeCopy->SetMatrixTransformToParent(nodeToWorldMatrix);
+    this->Scene->AddNode(transformNodeCopy);
+    vtkDMMLTransformableNode::SafeDownCast(nodeCopy)->SetAndObserveTransformNodeID(transformNodeCopy->GetID());
+    }
+
+  return nodeCopy;
+}
+
+//----------------------------------------------------------------------------
+bool vtkCjyxDynamicModelerToolSnapshot::PublishOutputs(vtkCjyxDynamicModelerTool* tool, vtkDMMLDynamicModelerNode* surfaceEditorNode)
+{
+  if (!tool || !surfaceEditorNode || !this->DynamicModelerNode)
+    {
+    vtkErrorMacro("PublishOutputs: Invalid tool or dynamic modeler node");
+    return false;
+    }
+
+  for (int outputIndex = 0; outputIndex < tool->GetNumberOfOutputNodes(); ++outputIndex)
+    {
+    std::string referenceRole = tool->GetNthOutputNodeReferenceRole(outputIndex);
+    vtkDMMLNode* outputNode = surfaceEditorNode->GetNodeReference(referenceRole.c_str());
+    vtkDMMLNode* outputNodeCopy = this->DynamicModelerNode->GetNodeReference(referenceRole.c_str());
+    if (!outputNode || !outputNodeCopy)
+      {
+      // Output node was selected after the snapshot was created, it will be updated on the next run.
+      continue;
+      }
+
+    vtkDMMLModelNode* outputModelNode = vtkDMMLModelNode::SafeDownCast(outputNode);
+    vtkDMMLModelNode* outputModelNodeCopy = vtkDMMLModelNode::SafeDownCast(outputNodeCopy);
+    if (outputModelNode && outputModelNodeCopy)
+      {
+      // The snapshot is discarded after publishing, so the mesh can be moved to the output node without copying.
+      DMMLNodeModifyBlocker blocker(outputModelNode);
+      outputModelNode->SetAndObserveMesh(outputModelNodeCopy->GetMesh());
+      outputModelNode->InvokeCustomModifiedEvent(vtkDMMLModelNode::MeshModifiedEvent);
+      }
+    else
+      {
+      outputNode->CopyContent(outputNodeCopy, false);
+      }
+    }
+  return true;
+}
@@ -0,0 +1,96 @@
+/*==============================================================================
+
+  Copyright (c) Laboratory for Percutaneous Surgery (PerkLab)
+  Queen's University, Kingston, ON, Canada. All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.cjyx.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+  This file was originally developed by Kyle Sunderland, PerkLab, Queen's University
+  and was supported through CANARIE's Research Software Program, Cancer
+  Care Ontario, OpenAnatomy, and Brigham and Women's Hospital through NIH grant R01MH112748.
+
+==============================================================================*/
+
+#ifndef __vtkCjyxDynamicModelerToolSnapshot_h
+#define __vtkCjyxDynamicModelerToolSnapshot_h
+
+#include "vtkCjyxDynamicModelerModuleLogicExport.h"
+
+// VTK includes
+#include <vtkObject.h>
+#include <vtkSmartPointer.h>
+
+// STD includes
+#include <map>
+#include <string>
+
+class vtkCjyxDynamicModelerTool;
+class vtkDMMLDynamicModelerNode;
+class vtkDMMLNode;
+class vtkDMMLScene;
+class vtkPointSet;
+
+/// \brief Copy of the inputs and outputs of a dynamic modeler node, for running a tool on a worker thread.
+///
+/// The snapshot contains a copy of the dynamic modeler node and of all of its input and output nodes in a
+/// private scene. Input meshes are shallow copied, all other input nodes are deep copied. Output nodes are
+/// created empty. Parent transforms of the nodes are replaced by linear transforms that contain the current
+/// transform to world.
+///
+/// The tool can be run on the snapshot without accessing the main scene, then the output meshes can be
+/// moved to the output nodes of the original dynamic modeler node on the main thread.
+/// Published meshes must not be modified in place (they may be shared with a snapshot that is being processed),
+/// tools must always set a new mesh object in their output nodes.
+class VTK_CJYX_DYNAMICMODELER_MODULE_LOGIC_EXPORT vtkCjyxDynamicModelerToolSnapshot : public vtkObject
+{
+public:
+  static vtkCjyxDynamicModelerToolSnapshot* New();
+  vtkTypeMacro(vtkCjyxDynamicModelerToolSnapshot, vtkObject);
+  void PrintSelf(ostream& os, vtkIndent indent) override;
+
+  /// Create a copy of the dynamic modeler node and its input and output nodes.
+  /// Must be called on the main thread.
+  /// Returns false if the snapshot cannot be created (for example, because a node is under a non-linear transform).
+  bool CreateSnapshot(vtkCjyxDynamicModelerTool* tool, vtkDMMLDynamicModelerNode* surfaceEditorNode);
+
+  /// Use the specified mesh in the copy of the input model node instead of the mesh of the node.
+  /// Used for running the tool on a simplified version of the input mesh. Must be called before CreateSnapshot.
+  void SetInputMeshOverride(const std::string& inputNodeID, vtkPointSet* mesh);
+
+  /// Get the copy of the dynamic modeler node, which references the copied input and output nodes.
+  vtkDMMLDynamicModelerNode* GetDynamicModelerNode();
+
+  /// Move the output meshes of the snapshot to the output nodes of the original dynamic modeler node.
+  /// Must be called on the main thread, after the tool has been run on the snapshot.
+  bool PublishOutputs(vtkCjyxDynamicModelerTool* tool, vtkDMMLDynamicModelerNode* surfaceEditorNode);
+
+protected:
+  vtkCjyxDynamicModelerToolSnapshot();
+  ~vtkCjyxDynamicModelerToolSnapshot() override;
+
+  /// Add a copy of the node to the private scene. If copyContent is false then only the node name
+  /// and the parent transform is copied.
+  vtkDMMLNode* AddNodeCopy(vtkDMMLNode* node, bool copyContent);
+
+  vtkSmartPointer<vtkDMMLScene> Scene;
+  vtkSmartPointer<vtkDMMLDynamicModelerNode> DynamicModelerNode;
+
+  /// Map from original node ID to the ID of the copy in the private scene
+  std::map<std::string, std::string> CopiedNodeIDs;
+
+  /// Map from original input node ID to the mesh that is used in its copy
+  std::map<std::string, vtkSmartPointer<vtkPointSet> > InputMeshOverrides;
+
+private:
+  vtkCjyxDynamicModelerToolSnapshot(const vtkCjyxDynamicModelerToolSnapshot&) = delete;
+  void operator=(const vtkCjyxDynamicModelerToolSnapshot&) = delete;
+};
+
+#endif // __vtkCjyxDynamicModelerToolSnapshot_h
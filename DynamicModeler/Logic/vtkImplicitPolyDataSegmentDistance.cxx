@@ -0,0 +1,433 @@
+/*==============================================================================
+
+  Copyright (c) Laboratory for Percutaneous Surgery (PerkLab)
+  Queen's University, Kingston, ON, Canada. All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.cjyx.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+  This file was originally developed by Kyle Sunderland, PerkLab, Queen's University
+  and was supported through CANARIE's Research Software Program, Cancer
+  Care Ontario, OpenAnatomy, and Brigham and Women's Hospital through NIH grant R01MH112748.
+
+==============================================================================*/
+
+#include "vtkImplicitPolyDataSegmentDistance.h"
+
+// VTK includes
+#include <vtkCellArray.h>
+#include <vtkDataArray.h>
+#include <vtkDoubleArray.h>
+#include <vtkIdList.h>
+#include <vtkMath.h>
+#include <vtkNew.h>
+#include <vtkObjectFactory.h>
+#include <vtkPoints.h>
+#include <vtkPolyData.h>
+#include <vtkSMPTools.h>
+#include <vtkTimeStamp.h>
+
+// STD includes
+#include <algorithm>
+#include <vector>
+
+vtkStandardNewMacro(vtkImplicitPolyDataSegmentDistance);
+
+namespace
+{
+  /// Maximum number of segments in a leaf node
+  const vtkIdType SegmentLeafSize = 8;
+
+  /// Maximum depth of the search stack, the median split keeps the depth of the tree logarithmic
+  const int MaximumStackSize = 128;
+
+  //----------------------------------------------------------------------------
+  struct Segment
+  {
+    double Point0[3];
+    double Point1[3];
+  };
+
+  //----------------------------------------------------------------------------
+  double GetSquaredDistanceToBox(const double x[3], const double bounds[6])
+  {
+    double distance2 = 0.0;
+    for (int axis = 0; axis < 3; ++axis)
+      {
+      double outside = std::max(std::max(bounds[2 * axis] - x[axis], x[axis] - bounds[2 * axis + 1]), 0.0);
+      distance2 += outside * outside;
+      }
+    return distance2;
+  }
+
+  //----------------------------------------------------------------------------
+  double GetSquaredDistanceToSegment(const double x[3], const Segment& segment, double closestPoint[3])
+  {
+    double direction[3] = { 0.0, 0.0, 0.0 };
+    double toPoint[3] = { 0.0, 0.0, 0.0 };
+    vtkMath::Subtract(segment.Point1, segment.Point0, direction);
+    vtkMath::Subtract(x, segment.Point0, toPoint);
+    double length2 = vtkMath::Dot(direction, direction);
+    double t = length2 > 0.0 ? std::min(std::max(vtkMath::Dot(toPoint, direction) / length2, 0.0), 1.0) : 0.0;
+    for (int i = 0; i < 3; ++i)
+      {
+      closestPoint[i] = segment.Point0[i] + t * direction[i];
+      }
+    return vtkMath::Distance2BetweenPoints(x, closestPoint);
+  }
+
+  //----------------------------------------------------------------------------
+  struct EvaluateFunctionWorker
+  {
+    const vtkImplicitPolyDataSegmentDistance* Function;
+    double MaximumDistance;
+    vtkDataArray* Input;
+    vtkDataArray* Output;
+    double* OutputValues;
+
+    void operator()(vtkIdType begin, vtkIdType end)
+    {
+      double x[3] = { 0.0, 0.0, 0.0 };
+      for (vtkIdType i = begin; i < end; ++i)
+        {
+        this->Input->GetTuple(i, x);
+        double value = this->Function->EvaluateSquaredDistance(x, this->MaximumDistance);
+        if (this->OutputValues)
+          {
+          this->OutputValues[i] = value;
+          }
+        else
+          {
+          this->Output->SetComponent(i, 0, value);
+          }
+        }
+    }
+  };
+}
+
+//-----------------------------------------------------------------------------
+class vtkImplicitPolyDataSegmentDistance::vtkInternal
+{
+public:
+  /// Node of the bounding volume hierarchy, contains the segments [Begin, End)
+  struct Node
+  {
+    double Bounds[6];
+    vtkIdType Begin;
+    vtkIdType End;
+    vtkIdType Children[2];
+  };
+
+  /// Collect the segments of the input lines and build the hierarchy.
+  void Build(vtkPolyData* input);
+
+  /// Split the range of segments at the median of the segment centers along the longest axis, returns the node index.
+  vtkIdType BuildNode(vtkIdType begin, vtkIdType end);
+
+  /// Segments are reordered while building the hierarchy, so that the segments of each node are contiguous
+  std::vector<Segment> Segments;
+  std::vector<Node> Nodes;
+
+  /// Time of the last build, compared with the modification time of the input
+  vtkTimeStamp BuildTime;
+};
+
+//-----------------------------------------------------------------------------
+void vtkImplicitPolyDataSegmentDistance::vtkInternal::Build(vtkPolyData* input)
+{
+  this->BuildTime.Modified();
+  this->Segments.clear();
+  this->Nodes.clear();
+  vtkPoints* points = input ? input->GetPoints() : nullptr;
+  if (!points || points->GetNumberOfPoints() < 1)
+    {
+    return;
+    }
+
+  Segment segment;
+  vtkNew<vtkIdList> pointIds;
+  vtkCellArray* lines = input->GetLines();
+  for (vtkIdType lineId = 0; lines && lineId < lines->GetNumberOfCells(); ++lineId)
+    {
+    lines->GetCellAtId(lineId, pointIds);
+    for (vtkIdType i = 0; i + 1 < pointIds->GetNumberOfIds(); ++i)
+      {
+      points->GetPoint(pointIds->GetId(i), segment.Point0);
+      points->GetPoint(pointIds->GetId(i + 1), segment.Point1);
+      this->Segments.push_back(segment);
+      }
+    if (pointIds->GetNumberOfIds() == 1)
+      {
+      points->GetPoint(pointIds->GetId(0), segment.Point0);
+      points->GetPoint(pointIds->GetId(0), segment.Point1);
+      this->Segments.push_back(segment);
+      }
+    }
+  vtkCellArray* verts = input->GetVerts();
+  for (vtkIdType vertId = 0; verts && vertId < verts->GetNumberOfCells(); ++vertId)
+    {
+    verts->GetCellAtId(vertId, pointIds);
+    for (vtkIdType i = 0; i < pointIds->GetNumberOfIds(); ++i)
+      {
+      points->GetPoint(pointIds->GetId(i), segment.Point0);
+      points->GetPoint(pointIds->GetId(i), segment.Point1);
+      this->Segments.push_back(segment);
+      }
+    }
+  if (this->Segments.empty())
+    {
+    // No cells, use the distance to the points
+    for (vtkIdType pointId = 0; pointId < points->GetNumberOfPoints(); ++pointId)
+      {
+      points->GetPoint(pointId, segment.Point0);
+      points->GetPoint(pointId, segment.Point1);
+      this->Segments.push_back(segment);
+      }
+    }
+
+  this->Nodes.reserve(2 * (this->Segments.size() / SegmentLeafSize) + 1);
+  this->BuildNode(0, static_cast<vtkIdType>(this->Segments.size()));
+}
+
+//-----------------------------------------------------------------------------
+vtkIdType vtkImplicitPolyDataSegmentDistance::vtkInternal::BuildNode(vtkIdType begin, vtkIdType end)
+{
+  vtkIdType nodeIndex = static_cast<vtkIdType>(this->Nodes.size());
+  Node node;
+  node.Begin = begin;
+  node.End = end;
+  node.Children[0] = node.Children[1] = -1;
+  double centerBounds[6] = { 0.0, 0.0, 0.0, 0.0, 0.0, 0.0 };
+  for (vtkIdType i = begin; i < end; ++i)
+    {
+    const Segment& segment = this->Segments[i];
+    for (int axis = 0; axis < 3; ++axis)
+      {
+      double minimum = std::min(segment.Point0[axis], segment.Point1[axis]);
+      double maximum = std::max(segment.Point0[axis], segment.Point1[axis]);
+      double center = 0.5 * (minimum + maximum);
+      node.Bounds[2 * axis] = (i == begin ? minimum : std::min(node.Bounds[2 * axis], minimum));
+      node.Bounds[2 * axis + 1] = (i == begin ? maximum : std::max(node.Bounds[2 * axis + 1], maximum));
+      centerBounds[2 * axis] = (i == begin ? center : std::min(centerBounds[2 * axis], center));
+      centerBounds[2 * axis + 1] = (i == begin ? center : std::max(centerBounds[2 * axis + 1], center));
+      }
+    }
+  this->Nodes.push_back(node);
+  if (end - begin <= SegmentLeafSize)
+    {
+    return nodeIndex;
+    }
+
+  int splitAxis = 0;
+  for (int axis = 1; axis < 3; ++axis)
+    {
+    if (centerBounds[2 * axis + 1] - centerBounds[2 * axis] > centerBounds[2 * splitAxis + 1] - centerBounds[2 * splitAxis])
+      {
+      splitAxis = axis;
+      }
+    }
+  if (centerBounds[2 * splitAxis + 1] <= centerBounds[2 * splitAxis])
+    {
+    // All segments have the same center, the range cannot be split
+    return nodeIndex;
+    }
+
+  vtkIdType middle = begin + (end - begin) / 2;
+  std::nth_element(this->Segments.begin() + begin, this->Segments.begin() + middle, this->Segments.begin() + end,
+    [splitAxis](const Segment& segment0, const Segment& segment1)
+    {
+      return segment0.Point0[splitAxis] + segment0.Point1[splitAxis] < segment1.Point0[splitAxis] + segment1.Point1[splitAxis];
+    });
+  vtkIdType child0 = this->BuildNode(begin, middle);
+  vtkIdType child1 = this->BuildNode(middle, end);
+  this->Nodes[nodeIndex].Children[0] = child0;
+  this->Nodes[nodeIndex].Children[1] = child1;
+  return nodeIndex;
+}
+
+//-----------------------------------------------------------------------------
+vtkImplicitPolyDataSegmentDistance::vtkImplicitPolyDataSegmentDistance()
+{
+  this->Internal = new vtkInternal();
+}
+
+//-----------------------------------------------------------------------------
+vtkImplicitPolyDataSegmentDistance::~vtkImplicitPolyDataSegmentDistance()
+{
+  delete this->Internal;
+}
+
+//-----------------------------------------------------------------------------
+void vtkImplicitPolyDataSegmentDistance::SetInput(vtkPolyData* input)
+{
+  if (this->Input == input)
+    {
+    this->UpdateHierarchy();
+    return;
+    }
+  this->Input = input;
+  this->Internal->Build(input);
+  if (this->Input)
+    {
+    this->NoValue = this->Input->GetLength();
+    }
+  this->Modified();
+}
+
+//-----------------------------------------------------------------------------
+vtkPolyData* vtkImplicitPolyDataSegmentDistance::GetInput()
+{
+  return this->Input;
+}
+
+//-----------------------------------------------------------------------------
+void vtkImplicitPolyDataSegmentDistance::UpdateHierarchy()
+{
+  if (this->Input && this->Input->GetMTime() > this->Internal->BuildTime)
+    {
+    this->Internal->Build(this->Input);
+    }
+}
+
+//-----------------------------------------------------------------------------
+vtkMTimeType vtkImplicitPolyDataSegmentDistance::GetMTime()
+{
+  vtkMTimeType mTime = this->vtkImplicitFunction::GetMTime();
+  if (this->Input != nullptr)
+    {
+    mTime = std::max(mTime, this->Input->GetMTime());
+    }
+  return mTime;
+}
+
+//-----------------------------------------------------------------------------
+double vtkImplicitPolyDataSegmentDistance::EvaluateSquaredDistance(const double x[3], double maximumDistance, double closestPoint[3]) const
+{
+  const std::vector<vtkInternal::Node>& nodes = this->Internal->Nodes;
+  if (nodes.empty())
+    {
+    return this->NoValue;
+    }
+
+  // Points outside the band around the segments are classified by the bounding box of all segments
+  double closestDistance2 = maximumDistance >= 0.0 ? maximumDistance * maximumDistance : VTK_DOUBLE_MAX;
+  if (GetSquaredDistanceToBox(x, nodes[0].Bounds) >= closestDistance2)
+    {
+    return closestDistance2;
+    }
+
+  vtkIdType nodeStack[MaximumStackSize];
+  int stackSize = 0;
+  nodeStack[stackSize++] = 0;
+  double segmentClosestPoint[3] = { 0.0, 0.0, 0.0 };
+  while (stackSize > 0)
+    {
+    const vtkInternal::Node& node = nodes[nodeStack[--stackSize]];
+    if (GetSquaredDistanceToBox(x, node.Bounds) >= closestDistance2)
+      {
+      continue;
+      }
+    if (node.Children[0] < 0)
+      {
+      for (vtkIdType segmentIndex = node.Begin; segmentIndex < node.End; ++segmentIndex)
+        {
+        double distance2 = GetSquaredDistanceToSegment(x, this->Internal->Segments[segmentIndex], segmentClosestPoint);
+        if (distance2 < closestDistance2)
+          {
+          closestDistance2 = distance2;
+          if (closestPoint)
+            {
+            closestPoint[0] = segmentClosestPoint[0];
+            closestPoint[1] = segmentClosestPoint[1];
+            closestPoint[2] = segmentClosestPoint[2];
+            }
+          }
+        }
+      continue;
+      }
+
+    // The closer child is visited first, so that the other one is more likely to be skipped
+    double distance0 = GetSquaredDistanceToBox(x, nodes[node.Children[0]].Bounds);
+    double distance1 = GetSquaredDistanceToBox(x, nodes[node.Children[1]].Bounds);
+    vtkIdType nearChild = distance0 <= distance1 ? node.Children[0] : node.Children[1];
+    vtkIdType farChild = distance0 <= distance1 ? node.Children[1] : node.Children[0];
+    if (stackSize + 2 > MaximumStackSize)
+      {
+      // Cannot happen with the median split, the depth of the tree is logarithmic
+      break;
+      }
+    nodeStack[stackSize++] = farChild;
+    nodeStack[stackSize++] = nearChild;
+    }
+  return closestDistance2;
+}
+
+//-----------------------------------------------------------------------------
+double vtkImplicitPolyDataSegmentDistance::EvaluateFunction(double x[3])
+{
+  this->UpdateHierarchy();
+  return this->EvaluateSquaredDistance(x, this->MaximumDistance);
+}
+
+//-----------------------------------------------------------------------------
+void vtkImplicitPolyDataSegmentDistance::EvaluateFunction(vtkDataArray* input, vtkDataArray* output)
+{
+  // Rebuild before the points are evaluated in parallel, so that the per-point evaluations find it up to date
+  this->UpdateHierarchy();
+  if (this->Transform)
+    {
+    // Points are transformed by FunctionValue
+    this->Superclass::EvaluateFunction(input, output);
+    return;
+    }
+
+  vtkIdType numberOfTuples = input->GetNumberOfTuples();
+  output->SetNumberOfComponents(1);
+  output->SetNumberOfTuples(numberOfTuples);
+  vtkDoubleArray* doubleOutput = vtkDoubleArray::FastDownCast(output);
+  EvaluateFunctionWorker evaluateFunctionWorker{ this, this->MaximumDistance, input, output,
+    doubleOutput ? doubleOutput->GetPointer(0) : nullptr };
+  vtkSMPTools::For(0, numberOfTuples, evaluateFunctionWorker);
+}
+
+//-----------------------------------------------------------------------------
+void vtkImplicitPolyDataSegmentDistance::EvaluateGradient(double x[3], double g[3])
+{
+  this->UpdateHierarchy();
+  if (this->Internal->Nodes.empty())
+    {
+    g[0] = this->NoGradient[0];
+    g[1] = this->NoGradient[1];
+    g[2] = this->NoGradient[2];
+    return;
+    }
+  // If the segments are farther than the maximum distance then the closest point is not computed and the gradient is zero
+  double closestPoint[3] = { x[0], x[1], x[2] };
+  this->EvaluateSquaredDistance(x, this->MaximumDistance, closestPoint);
+  vtkMath::Subtract(x, closestPoint, g);
+}
+
+//-----------------------------------------------------------------------------
+void vtkImplicitPolyDataSegmentDistance::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+  os << indent << "MaximumDistance: " << this->MaximumDistance << "\n";
+  os << indent << "NoValue: " << this->NoValue << "\n";
+  os << indent << "NoGradient: (" << this->NoGradient[0] << ", "
+     << this->NoGradient[1] << ", " << this->NoGradient[2] << ")\n";
+  os << indent << "NumberOfSegments: " << this->Internal->Segments.size() << "\n";
+  if (this->Input)
+    {
+    os << indent << "Input : " << this->Input << "\n";
+    }
+  else
+    {
+    os << indent << "Input : (none)\n";
+    }
+}
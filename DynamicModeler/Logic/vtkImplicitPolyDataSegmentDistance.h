@@ -0,0 +1,111 @@
+/*==============================================================================
+
+  Copyright (c) Laboratory for Percutaneous Surgery (PerkLab)
+  Queen's University, Kingston, ON, Canada. All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.cjyx.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+  This file was originally developed by Kyle Sunderland, PerkLab, Queen's University
+  and was supported through CANARIE's Research Software Program, Cancer
+  Care Ontario, OpenAnatomy, and Brigham and Women's Hospital through NIH grant R01MH112748.
+
+==============================================================================*/
+
+#ifndef vtkImplicitPolyDataSegmentDistance_h
+#define vtkImplicitPolyDataSegmentDistance_h
+
+#include "vtkCjyxDynamicModelerModuleLogicExport.h"
+
+// VTK includes
+#include <vtkImplicitFunction.h>
+#include <vtkSmartPointer.h>
+
+class vtkPolyData;
+
+/// \brief Squared distance to the line segments of a polydata.
+///
+/// The input lines are split into segments (vertices are used as zero length segments), which are stored in a
+/// static bounding volume hierarchy when the input is set. If the input is modified afterwards then the hierarchy
+/// is rebuilt by the next call of EvaluateFunction, EvaluateGradient or UpdateHierarchy. The closest segment is found
+/// by a depth-first search that skips the nodes that are farther than the closest segment found so far.
+///
+/// If MaximumDistance is set then points that are farther from all segments get the squared maximum distance as
+/// value. Points outside the bounds of the segments expanded by the maximum distance are classified by that box
+/// alone, so only the points in a band around the lines are searched.
+///
+/// The hierarchy is only rebuilt before evaluation starts, so the function can be evaluated from several threads at
+/// the same time as long as the input is not modified meanwhile. EvaluateFunction on a data array evaluates the points
+/// in parallel.
+class VTK_CJYX_DYNAMICMODELER_MODULE_LOGIC_EXPORT vtkImplicitPolyDataSegmentDistance : public vtkImplicitFunction
+{
+public:
+  static vtkImplicitPolyDataSegmentDistance* New();
+  vtkTypeMacro(vtkImplicitPolyDataSegmentDistance, vtkImplicitFunction);
+  void PrintSelf(ostream& os, vtkIndent indent) override;
+
+  /// Return the MTime also considering the Input dependency.
+  vtkMTimeType GetMTime() override;
+
+  /// Evaluate the squared distance to the closest segment, limited to the squared MaximumDistance.
+  using vtkImplicitFunction::EvaluateFunction;
+  double EvaluateFunction(double x[3]) override;
+
+  /// Evaluate the function at each tuple of the input array in parallel.
+  void EvaluateFunction(vtkDataArray* input, vtkDataArray* output) override;
+
+  /// Vector from the closest point on the segments to the evaluated point.
+  void EvaluateGradient(double x[3], double g[3]) override;
+
+  /// Squared distance to the closest segment, or maximumDistance squared if all segments are farther than
+  /// maximumDistance (if maximumDistance is negative then the distance is not limited).
+  /// Does not modify the object, safe to call from multiple threads. Does not rebuild the hierarchy either, call
+  /// UpdateHierarchy first if the input may have been modified since the last evaluation.
+  double EvaluateSquaredDistance(const double x[3], double maximumDistance, double closestPoint[3] = nullptr) const;
+
+  /// Set the input lines. The bounding volume hierarchy of the segments is built immediately.
+  void SetInput(vtkPolyData* input);
+  vtkPolyData* GetInput();
+
+  /// Rebuild the bounding volume hierarchy if the input has been modified since it was built.
+  /// Called by the non-const evaluation methods.
+  void UpdateHierarchy();
+
+  /// Set/get the distance above which the distance is not computed exactly.
+  /// If negative (default) then the distance is always computed.
+  vtkSetMacro(MaximumDistance, double);
+  vtkGetMacro(MaximumDistance, double);
+
+  /// Set/get the function value to use if no input vtkPolyData specified.
+  vtkSetMacro(NoValue, double);
+  vtkGetMacro(NoValue, double);
+
+  /// Set/get the function gradient to use if no input vtkPolyData specified.
+  vtkSetVector3Macro(NoGradient, double);
+  vtkGetVector3Macro(NoGradient, double);
+
+protected:
+  vtkImplicitPolyDataSegmentDistance();
+  ~vtkImplicitPolyDataSegmentDistance() override;
+
+  double MaximumDistance{ -1.0 };
+  double NoValue{ 0.0 };
+  double NoGradient[3]{ 0.0, 0.0, 0.0 };
+
+  vtkSmartPointer<vtkPolyData> Input;
+
+  class vtkInternal;
+  vtkInternal* Internal;
+
+private:
+  vtkImplicitPolyDataSegmentDistance(const vtkImplicitPolyDataSegmentDistance&) = delete;
+  void operator=(const vtkImplicitPolyDataSegmentDistance&) = delete;
+};
+
+#endif
@@ -0,0 +1,423 @@
+/*==============================================================================
+
+  Copyright (c) Laboratory for Percutaneous Surgery (PerkLab)
+  Queen's University, Kingston, ON, Canada. All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.cjyx.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+  This file was originally developed by Kyle Sunderland, PerkLab, Queen's University
+  and was supported through CANARIE's Research Software Program, Cancer
+  Care Ontario, OpenAnatomy, and Brigham and Women's Hospital through NIH grant R01MH112748.
+
+==============================================================================*/
+
+#include "vtkParallelFeatureEdges.h"
+
+// VTK includes
+#include <vtkCellArray.h>
+#include <vtkCellData.h>
+#include <vtkIdList.h>
+#include <vtkIdTypeArray.h>
+#include <vtkInformation.h>
+#include <vtkInformationVector.h>
+#include <vtkMath.h>
+#include <vtkNew.h>
+#include <vtkObjectFactory.h>
+#include <vtkPointData.h>
+#include <vtkPoints.h>
+#include <vtkPolyData.h>
+#include <vtkPolygon.h>
+#include <vtkSMPThreadLocalObject.h>
+#include <vtkSMPTools.h>
+#include <vtkUnsignedCharArray.h>
+
+// STD includes
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <vector>
+
+vtkStandardNewMacro(vtkParallelFeatureEdges);
+
+namespace
+{
+  const unsigned char INVALID_EDGE = 255;
+
+  //----------------------------------------------------------------------------
+  /// One polygon edge. Point0 < Point1, so that both polygons sharing an edge produce the same key.
+  struct EdgeEntry
+  {
+    vtkIdType Point0;
+    vtkIdType Point1;
+    vtkIdType CellId;
+
+    bool operator<(const EdgeEntry& other) const
+    {
+      if (this->Point0 != other.Point0)
+        {
+        return this->Point0 < other.Point0;
+        }
+      if (this->Point1 != other.Point1)
+        {
+        return this->Point1 < other.Point1;
+        }
+      return this->CellId < other.CellId;
+    }
+
+    bool IsSameEdge(const EdgeEntry& other) const
+    {
+      return this->Point0 == other.Point0 && this->Point1 == other.Point1;
+    }
+  };
+
+  //----------------------------------------------------------------------------
+  /// Write all edges of each polygon into its preallocated range of the edge table.
+  struct FillEdgeTableWorker
+  {
+    vtkCellArray* Polys;
+    const vtkIdType* CellEdgeOffsets;
+    EdgeEntry* Edges;
+    vtkSMPThreadLocalObject<vtkIdList> PointIds;
+
+    void operator()(vtkIdType beginCellId, vtkIdType endCellId)
+    {
+      vtkIdList* pointIds = this->PointIds.Local();
+      for (vtkIdType cellId = beginCellId; cellId < endCellId; ++cellId)
+        {
+        vtkIdType numberOfEdges = this->CellEdgeOffsets[cellId + 1] - this->CellEdgeOffsets[cellId];
+        if (numberOfEdges == 0)
+          {
+          continue;
+          }
+        this->Polys->GetCellAtId(cellId, pointIds);
+        EdgeEntry* edge = this->Edges + this->CellEdgeOffsets[cellId];
+        for (vtkIdType i = 0; i < numberOfEdges; ++i, ++edge)
+          {
+          vtkIdType point0 = pointIds->GetId(i);
+          vtkIdType point1 = pointIds->GetId((i + 1) % numberOfEdges);
+          edge->CellId = cellId;
+          if (point0 == point1)
+            {
+            // Degenerate edge, sorted to the front of the table and skipped
+            edge->Point0 = -1;
+            edge->Point1 = -1;
+            }
+          else
+            {
+            edge->Point0 = std::min(point0, point1);
+            edge->Point1 = std::max(point0, point1);
+            }
+          }
+        }
+    }
+  };
+
+  //----------------------------------------------------------------------------
+  struct ComputeCellNormalsWorker
+  {
+    vtkCellArray* Polys;
+    vtkPoints* Points;
+    double* Normals;
+    vtkSMPThreadLocalObject<vtkIdList> PointIds;
+
+    void operator()(vtkIdType beginCellId, vtkIdType endCellId)
+    {
+      vtkIdList* pointIds = this->PointIds.Local();
+      for (vtkIdType cellId = beginCellId; cellId < endCellId; ++cellId)
+        {
+        this->Polys->GetCellAtId(cellId, pointIds);
+        double* normal = this->Normals + 3 * cellId;
+        if (pointIds->GetNumberOfIds() < 3)
+          {
+          normal[0] = normal[1] = normal[2] = 0.0;
+          continue;
+          }
+        vtkPolygon::ComputeNormal(this->Points, static_cast<int>(pointIds->GetNumberOfIds()), pointIds->GetPointer(0), normal);
+        }
+    }
+  };
+
+  //----------------------------------------------------------------------------
+  /// Classify each run of equal vertex pairs in the sorted edge table.
+  struct ClassifyEdgesWorker
+  {
+    const EdgeEntry* Edges;
+    const vtkIdType* RunStarts;
+    const double* Normals;
+    double CosFeatureAngle;
+    unsigned char* EdgeTypes;
+
+    void operator()(vtkIdType beginRun, vtkIdType endRun)
+    {
+      for (vtkIdType run = beginRun; run < endRun; ++run)
+        {
+        const EdgeEntry& firstEdge = this->Edges[this->RunStarts[run]];
+        vtkIdType numberOfCells = this->RunStarts[run + 1] - this->RunStarts[run];
+        if (firstEdge.Point0 < 0)
+          {
+          this->EdgeTypes[run] = INVALID_EDGE;
+          }
+        else if (numberOfCells == 1)
+          {
+          this->EdgeTypes[run] = vtkParallelFeatureEdges::BoundaryEdge;
+          }
+        else if (numberOfCells > 2)
+          {
+          this->EdgeTypes[run] = vtkParallelFeatureEdges::NonManifoldEdge;
+          }
+        else if (this->Normals
+          && vtkMath::Dot(this->Normals + 3 * firstEdge.CellId, this->Normals + 3 * this->Edges[this->RunStarts[run] + 1].CellId) <= this->CosFeatureAngle)
+          {
+          this->EdgeTypes[run] = vtkParallelFeatureEdges::FeatureEdge;
+          }
+        else
+          {
+          this->EdgeTypes[run] = vtkParallelFeatureEdges::ManifoldEdge;
+          }
+        }
+    }
+  };
+
+  //----------------------------------------------------------------------------
+  /// Write the output line cells and the edge type of each extracted edge.
+  struct WriteOutputEdgesWorker
+  {
+    const EdgeEntry* Edges;
+    const vtkIdType* RunStarts;
+    const vtkIdType* SelectedRuns;
+    const unsigned char* RunEdgeTypes;
+    const vtkIdType* PointMap;
+    vtkIdType* OutputOffsets;
+    vtkIdType* OutputConnectivity;
+    unsigned char* OutputEdgeTypes;
+
+    void operator()(vtkIdType beginEdge, vtkIdType endEdge)
+    {
+      for (vtkIdType outputEdge = beginEdge; outputEdge < endEdge; ++outputEdge)
+        {
+        vtkIdType run = this->SelectedRuns[outputEdge];
+        const EdgeEntry& edge = this->Edges[this->RunStarts[run]];
+        this->OutputOffsets[outputEdge] = 2 * outputEdge;
+        this->OutputConnectivity[2 * outputEdge] = this->PointMap[edge.Point0];
+        this->OutputConnectivity[2 * outputEdge + 1] = this->PointMap[edge.Point1];
+        this->OutputEdgeTypes[outputEdge] = this->RunEdgeTypes[run];
+        }
+    }
+  };
+}
+
+//----------------------------------------------------------------------------
+vtkParallelFeatureEdges::vtkParallelFeatureEdges() = default;
+
+//----------------------------------------------------------------------------
+vtkParallelFeatureEdges::~vtkParallelFeatureEdges() = default;
+
+//----------------------------------------------------------------------------
+void vtkParallelFeatureEdges::ExtractAllEdgeTypesOn()
+{
+  this->BoundaryEdgesOn();
+  this->FeatureEdgesOn();
+  this->NonManifoldEdgesOn();
+  this->ManifoldEdgesOn();
+}
+
+//----------------------------------------------------------------------------
+void vtkParallelFeatureEdges::ExtractAllEdgeTypesOff()
+{
+  this->BoundaryEdgesOff();
+  this->FeatureEdgesOff();
+  this->NonManifoldEdgesOff();
+  this->ManifoldEdgesOff();
+}
+
+//----------------------------------------------------------------------------
+vtkIdType vtkParallelFeatureEdges::GetNumberOfEdges(int edgeType)
+{
+  if (edgeType < 0 || edgeType >= EdgeType_Last)
+    {
+    vtkErrorMacro("GetNumberOfEdges: Invalid edge type " << edgeType);
+    return 0;
+    }
+  return this->NumberOfEdges[edgeType];
+}
+
+//----------------------------------------------------------------------------
+int vtkParallelFeatureEdges::RequestData(vtkInformation* vtkNotUsed(request),
+  vtkInformationVector** inputVector, vtkInformationVector* outputVector)
+{
+  vtkPolyData* input = vtkPolyData::GetData(inputVector[0], 0);
+  vtkPolyData* output = vtkPolyData::GetData(outputVector, 0);
+
+  for (int edgeType = 0; edgeType < EdgeType_Last; ++edgeType)
+    {
+    this->NumberOfEdges[edgeType] = 0;
+    }
+
+  vtkPoints* inputPoints = input->GetPoints();
+  vtkCellArray* inputPolys = input->GetPolys();
+  if (!inputPoints || !inputPolys || inputPolys->GetNumberOfCells() < 1)
+    {
+    return 1;
+    }
+  if (input->GetNumberOfStrips() > 0)
+    {
+    vtkWarningMacro("RequestData: Triangle strips are ignored. Use vtkTriangleFilter to convert them to polygons.");
+    }
+
+  // Reserve a contiguous range in the edge table for each polygon
+  vtkIdType numberOfPolys = inputPolys->GetNumberOfCells();
+  std::vector<vtkIdType> cellEdgeOffsets(numberOfPolys + 1);
+  cellEdgeOffsets[0] = 0;
+  for (vtkIdType cellId = 0; cellId < numberOfPolys; ++cellId)
+    {
+    vtkIdType cellSize = inputPolys->GetCellSize(cellId);
+    cellEdgeOffsets[cellId + 1] = cellEdgeOffsets[cellId] + (cellSize >= 3 ? cellSize : 0);
+    }
+  vtkIdType numberOfPolyEdges = cellEdgeOffsets[numberOfPolys];
+  if (numberOfPolyEdges == 0)
+    {
+    return 1;
+    }
+
+  std::vector<EdgeEntry> edges(numberOfPolyEdges);
+  FillEdgeTableWorker fillEdgeTableWorker;
+  fillEdgeTableWorker.Polys = inputPolys;
+  fillEdgeTableWorker.CellEdgeOffsets = cellEdgeOffsets.data();
+  fillEdgeTableWorker.Edges = edges.data();
+  vtkSMPTools::For(0, numberOfPolys, fillEdgeTableWorker);
+  this->UpdateProgress(0.2);
+
+  vtkSMPTools::Sort(edges.begin(), edges.end());
+  this->UpdateProgress(0.6);
+
+  // Each run of equal vertex pairs is one unique edge. The last entry is a sentinel.
+  std::vector<vtkIdType> runStarts;
+  runStarts.reserve(numberOfPolyEdges / 2 + 1);
+  runStarts.push_back(0);
+  for (vtkIdType i = 1; i < numberOfPolyEdges; ++i)
+    {
+    if (!edges[i].IsSameEdge(edges[i - 1]))
+      {
+      runStarts.push_back(i);
+      }
+    }
+  vtkIdType numberOfRuns = static_cast<vtkIdType>(runStarts.size());
+  runStarts.push_back(numberOfPolyEdges);
+
+  std::vector<double> cellNormals;
+  if (this->FeatureEdges)
+    {
+    cellNormals.resize(3 * numberOfPolys);
+    ComputeCellNormalsWorker computeCellNormalsWorker;
+    computeCellNormalsWorker.Polys = inputPolys;
+    computeCellNormalsWorker.Points = inputPoints;
+    computeCellNormalsWorker.Normals = cellNormals.data();
+    vtkSMPTools::For(0, numberOfPolys, computeCellNormalsWorker);
+    }
+
+  std::vector<unsigned char> runEdgeTypes(numberOfRuns);
+  ClassifyEdgesWorker classifyEdgesWorker;
+  classifyEdgesWorker.Edges = edges.data();
+  classifyEdgesWorker.RunStarts = runStarts.data();
+  classifyEdgesWorker.Normals = this->FeatureEdges ? cellNormals.data() : nullptr;
+  classifyEdgesWorker.CosFeatureAngle = cos(vtkMath::RadiansFromDegrees(this->FeatureAngle));
+  classifyEdgesWorker.EdgeTypes = runEdgeTypes.data();
+  vtkSMPTools::For(0, numberOfRuns, classifyEdgesWorker);
+  this->UpdateProgress(0.8);
+
+  // Select the requested edge types and collect the points that they use
+  bool extractEdgeType[EdgeType_Last] = { this->BoundaryEdges, this->NonManifoldEdges, this->ManifoldEdges, this->FeatureEdges };
+  std::vector<vtkIdType> selectedRuns;
+  std::vector<vtkIdType> pointMap(input->GetNumberOfPoints(), -1);
+  vtkNew<vtkIdList> outputToInputPointIds;
+  vtkNew<vtkIdList> outputToInputCellIds;
+  vtkIdType polyCellIdOffset = input->GetNumberOfVerts() + input->GetNumberOfLines();
+  for (vtkIdType run = 0; run < numberOfRuns; ++run)
+    {
+    unsigned char edgeType = runEdgeTypes[run];
+    if (edgeType == INVALID_EDGE)
+      {
+      continue;
+      }
+    ++this->NumberOfEdges[edgeType];
+    if (!extractEdgeType[edgeType])
+      {
+      continue;
+      }
+    selectedRuns.push_back(run);
+    const EdgeEntry& edge = edges[runStarts[run]];
+    outputToInputCellIds->InsertNextId(polyCellIdOffset + edge.CellId);
+    for (vtkIdType pointId : { edge.Point0, edge.Point1 })
+      {
+      if (pointMap[pointId] < 0)
+        {
+        pointMap[pointId] = outputToInputPointIds->InsertNextId(pointId);
+        }
+      }
+    }
+
+  vtkIdType numberOfOutputEdges = static_cast<vtkIdType>(selectedRuns.size());
+  vtkIdType numberOfOutputPoints = outputToInputPointIds->GetNumberOfIds();
+
+  vtkNew<vtkPoints> outputPoints;
+  outputPoints->SetDataType(inputPoints->GetDataType());
+  inputPoints->GetPoints(outputToInputPointIds, outputPoints);
+  output->SetPoints(outputPoints);
+
+  vtkNew<vtkIdTypeArray> outputOffsets;
+  outputOffsets->SetNumberOfValues(numberOfOutputEdges + 1);
+  outputOffsets->SetValue(numberOfOutputEdges, 2 * numberOfOutputEdges);
+  vtkNew<vtkIdTypeArray> outputConnectivity;
+  outputConnectivity->SetNumberOfValues(2 * numberOfOutputEdges);
+  vtkNew<vtkUnsignedCharArray> outputEdgeTypes;
+  outputEdgeTypes->SetName("EdgeType");
+  outputEdgeTypes->SetNumberOfValues(numberOfOutputEdges);
+
+  WriteOutputEdgesWorker writeOutputEdgesWorker;
+  writeOutputEdgesWorker.Edges = edges.data();
+  writeOutputEdgesWorker.RunStarts = runStarts.data();
+  writeOutputEdgesWorker.SelectedRuns = selectedRuns.data();
+  writeOutputEdgesWorker.RunEdgeTypes = runEdgeTypes.data();
+  writeOutputEdgesWorker.PointMap = pointMap.data();
+  writeOutputEdgesWorker.OutputOffsets = outputOffsets->GetPointer(0);
+  writeOutputEdgesWorker.OutputConnectivity = outputConnectivity->GetPointer(0);
+  writeOutputEdgesWorker.OutputEdgeTypes = outputEdgeTypes->GetPointer(0);
+  vtkSMPTools::For(0, numberOfOutputEdges, writeOutputEdgesWorker);
+
+  vtkNew<vtkCellArray> outputLines;
+  outputLines->SetData(outputOffsets, outputConnectivity);
+  output->SetLines(outputLines);
+
+  vtkNew<vtkIdList> outputIds;
+  outputIds->SetNumberOfIds(numberOfOutputPoints);
+  std::iota(outputIds->GetPointer(0), outputIds->GetPointer(0) + numberOfOutputPoints, 0);
+  output->GetPointData()->CopyAllocate(input->GetPointData(), numberOfOutputPoints);
+  output->GetPointData()->CopyData(input->GetPointData(), outputToInputPointIds, outputIds);
+
+  outputIds->SetNumberOfIds(numberOfOutputEdges);
+  std::iota(outputIds->GetPointer(0), outputIds->GetPointer(0) + numberOfOutputEdges, 0);
+  output->GetCellData()->CopyAllocate(input->GetCellData(), numberOfOutputEdges);
+  output->GetCellData()->CopyData(input->GetCellData(), outputToInputCellIds, outputIds);
+  output->GetCellData()->AddArray(outputEdgeTypes);
+
+  vtkDebugMacro("Extracted " << numberOfOutputEdges << " edges from " << numberOfRuns << " unique edges");
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+void vtkParallelFeatureEdges::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+  os << indent << "BoundaryEdges: " << (this->BoundaryEdges ? "On" : "Off") << std::endl;
+  os << indent << "FeatureEdges: " << (this->FeatureEdges ? "On" : "Off") << std::endl;
+  os << indent << "FeatureAngle: " << this->FeatureAngle << std::endl;
+  os << indent << "NonManifoldEdges: " << (this->NonManifoldEdges ? "On" : "Off") << std::endl;
+  os << indent << "ManifoldEdges: " << (this->ManifoldEdges ? "On" : "Off") << std::endl;
+}
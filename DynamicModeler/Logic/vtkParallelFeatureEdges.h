@@ -0,0 +1,110 @@
+/*==============================================================================
+
+  Copyright (c) Laboratory for Percutaneous Surgery (PerkLab)
+  Queen's University, Kingston, ON, Canada. All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.cjyx.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+  This file was originally developed by Kyle Sunderland, PerkLab, Queen's University
+  and was supported through CANARIE's Research Software Program, Cancer
+  Care Ontario, OpenAnatomy, and Brigham and Women's Hospital through NIH grant R01MH112748.
+
+==============================================================================*/
+
+#ifndef vtkParallelFeatureEdges_h
+#define vtkParallelFeatureEdges_h
+
+#include "vtkCjyxDynamicModelerModuleLogicExport.h"
+
+// VTK includes
+#include <vtkPolyDataAlgorithm.h>
+
+/// \brief Extract boundary, non-manifold, manifold and feature edges from polygonal data.
+///
+/// Drop-in replacement for vtkFeatureEdges that does not build cell links.
+/// Every polygon edge is written into a table of (sorted vertex pair, cell) entries in parallel,
+/// the table is sorted in parallel, and each run of equal vertex pairs is one unique edge.
+/// The number of cells in a run and the angle between the normals of its two cells determine
+/// the edge class, so all classes are computed from the same single edge table.
+///
+/// The output contains one line per extracted edge, the points that are referenced by these lines
+/// (with point data passed from the input), and an "EdgeType" cell array that stores the
+/// EdgeTypes value of each line.
+/// Only polygons are processed. Triangle strips must be converted using vtkTriangleFilter first.
+class VTK_CJYX_DYNAMICMODELER_MODULE_LOGIC_EXPORT vtkParallelFeatureEdges : public vtkPolyDataAlgorithm
+{
+public:
+  static vtkParallelFeatureEdges* New();
+  vtkTypeMacro(vtkParallelFeatureEdges, vtkPolyDataAlgorithm);
+  void PrintSelf(ostream& os, vtkIndent indent) override;
+
+  enum EdgeTypes
+  {
+    BoundaryEdge,
+    NonManifoldEdge,
+    ManifoldEdge,
+    FeatureEdge,
+    EdgeType_Last
+  };
+
+  /// Turn on/off the extraction of boundary edges (edges used by exactly one polygon).
+  vtkSetMacro(BoundaryEdges, bool);
+  vtkGetMacro(BoundaryEdges, bool);
+  vtkBooleanMacro(BoundaryEdges, bool);
+
+  /// Turn on/off the extraction of feature edges (manifold edges where the angle between
+  /// the normals of the two polygons is larger than FeatureAngle).
+  vtkSetMacro(FeatureEdges, bool);
+  vtkGetMacro(FeatureEdges, bool);
+  vtkBooleanMacro(FeatureEdges, bool);
+
+  /// Set/get the feature angle in degrees.
+  vtkSetClampMacro(FeatureAngle, double, 0.0, 180.0);
+  vtkGetMacro(FeatureAngle, double);
+
+  /// Turn on/off the extraction of non-manifold edges (edges used by more than two polygons).
+  vtkSetMacro(NonManifoldEdges, bool);
+  vtkGetMacro(NonManifoldEdges, bool);
+  vtkBooleanMacro(NonManifoldEdges, bool);
+
+  /// Turn on/off the extraction of manifold edges (edges used by exactly two polygons that are not feature edges).
+  vtkSetMacro(ManifoldEdges, bool);
+  vtkGetMacro(ManifoldEdges, bool);
+  vtkBooleanMacro(ManifoldEdges, bool);
+
+  /// Turn on/off the extraction of all edge types.
+  void ExtractAllEdgeTypesOn();
+  void ExtractAllEdgeTypesOff();
+
+  /// Get the number of edges of each type that were found in the input during the last update,
+  /// regardless of which edge types are extracted.
+  /// Feature edges are only distinguished from manifold edges if FeatureEdges is enabled.
+  vtkIdType GetNumberOfEdges(int edgeType);
+
+protected:
+  vtkParallelFeatureEdges();
+  ~vtkParallelFeatureEdges() override;
+
+  int RequestData(vtkInformation* request, vtkInformationVector** inputVector, vtkInformationVector* outputVector) override;
+
+  bool BoundaryEdges{ true };
+  bool FeatureEdges{ true };
+  double FeatureAngle{ 30.0 };
+  bool NonManifoldEdges{ true };
+  bool ManifoldEdges{ false };
+
+  vtkIdType NumberOfEdges[EdgeType_Last]{ 0, 0, 0, 0 };
+
+private:
+  vtkParallelFeatureEdges(const vtkParallelFeatureEdges&) = delete;
+  void operator=(const vtkParallelFeatureEdges&) = delete;
+};
+
+#endif
@@ -0,0 +1,2621 @@
+/*==============================================================================
+
+  Copyright (c) Laboratory for Percutaneous Surgery (PerkLab)
+  Queen's University, Kingston, ON, Canada. All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.cjyx.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+  This file was originally developed by Kyle Sunderland, PerkLab, Queen's University
+  and was supported through CANARIE's Research Software Program, Cancer
+  Care Ontario, OpenAnatomy, and Brigham and Women's Hospital through NIH grant R01MH112748.
+
+==============================================================================*/
+
+#include "vtkParallelPlaneClipper.h"
+
+// VTK includes
+#include <vtkCellArray.h>
+#include <vtkCellData.h>
+#include <vtkClipPolyData.h>
+#include <vtkCutter.h>
+#include <vtkDoubleArray.h>
+#include <vtkExtractPolyDataGeometry.h>
+#include <vtkFeatureEdges.h>
+#include <vtkFloatArray.h>
+#include <vtkIdList.h>
+#include <vtkIdTypeArray.h>
+#include <vtkImplicitBoolean.h>
+#include <vtkInformation.h>
+#include <vtkInformationVector.h>
+#include <vtkMath.h>
+#include <vtkNew.h>
+#include <vtkObjectFactory.h>
+#include <vtkPlane.h>
+#include <vtkPlaneCollection.h>
+#include <vtkPointData.h>
+#include <vtkPoints.h>
+#include <vtkPolyData.h>
+#include <vtkSMPThreadLocalObject.h>
+#include <vtkSMPTools.h>
+#include <vtkStripper.h>
+#include <vtkWeakPointer.h>
+
+// STD includes
+#include <algorithm>
+#include <array>
+#include <map>
+#include <numeric>
+#include <vector>
+
+vtkStandardNewMacro(vtkParallelPlaneClipper);
+
+namespace
+{
+  /// Maximum number of polygons in a leaf node of the bounding volume hierarchy
+  const vtkIdType HierarchyLeafSize = 32;
+
+  enum CellStates
+  {
+    NegativeCell,
+    PositiveCell,
+    CrossingCell,
+    DiscardedCell
+  };
+
+  /// Plane equation coefficients (a, b, c, d), the signed distance of a point is ax + by + cz + d
+  typedef std::array<double, 4> PlaneCoefficients;
+
+  /// Range [Begin, End) of polygons
+  struct CellRange
+  {
+    vtkIdType Begin;
+    vtkIdType End;
+  };
+
+  //----------------------------------------------------------------------------
+  /// Add a range of polygons, merged with the last range if they are adjacent. Empty ranges are skipped.
+  void AppendCellRange(std::vector<CellRange>& ranges, vtkIdType begin, vtkIdType end)
+  {
+    if (begin >= end)
+      {
+      return;
+      }
+    if (!ranges.empty() && ranges.back().End == begin)
+      {
+      ranges.back().End = end;
+      return;
+      }
+    ranges.push_back(CellRange{ begin, end });
+  }
+
+  /// Range [LeafBegin, LeafEnd) of leaves of the bounding volume hierarchy. Leaves are numbered in the polygon
+  /// order of the hierarchy, so the polygons of a range of leaves are contiguous.
+  struct LeafRange
+  {
+    vtkIdType LeafBegin;
+    vtkIdType LeafEnd;
+    /// PositiveCell or NegativeCell if all polygons of the leaves are on that side, CrossingCell for a single leaf
+    /// whose polygons are classified one by one
+    unsigned char Side;
+    /// The leaves were also entirely on this side with the previous planes, so they are outside of the volume swept
+    /// by the planes and their output polygons are unchanged
+    bool Unchanged;
+  };
+
+  //----------------------------------------------------------------------------
+  /// Add a range of leaves, merged with the last range if they are adjacent and have the same state. Sibling nodes
+  /// are visited in order, so a large part of the mesh on the same side usually ends up in a few long ranges.
+  void AppendLeafRange(std::vector<LeafRange>& ranges, const LeafRange& range)
+  {
+    if (!ranges.empty() && range.Side != CrossingCell && ranges.back().Side == range.Side
+      && ranges.back().Unchanged == range.Unchanged && ranges.back().LeafEnd == range.LeafBegin)
+      {
+      ranges.back().LeafEnd = range.LeafEnd;
+      return;
+      }
+    ranges.push_back(range);
+  }
+
+  //----------------------------------------------------------------------------
+  /// Returns PositiveCell or NegativeCell if the combined function is beyond the tolerance on that side over the
+  /// whole box, CrossingCell otherwise (also for empty boxes). The range of each plane is computed at the box corners.
+  unsigned char GetBoxSide(const double bounds[6], const std::vector<PlaneCoefficients>& planes, bool useMinimum, double tolerance)
+  {
+    if (bounds[0] > bounds[1])
+      {
+      return CrossingCell;
+      }
+    double minimumValue = 0.0;
+    double maximumValue = 0.0;
+    for (size_t planeIndex = 0; planeIndex < planes.size(); ++planeIndex)
+      {
+      const PlaneCoefficients& plane = planes[planeIndex];
+      double planeMinimum = plane[3];
+      double planeMaximum = plane[3];
+      for (int axis = 0; axis < 3; ++axis)
+        {
+        double value0 = plane[axis] * bounds[2 * axis];
+        double value1 = plane[axis] * bounds[2 * axis + 1];
+        planeMinimum += std::min(value0, value1);
+        planeMaximum += std::max(value0, value1);
+        }
+      if (planeIndex == 0)
+        {
+        minimumValue = planeMinimum;
+        maximumValue = planeMaximum;
+        }
+      else if (useMinimum)
+        {
+        minimumValue = std::min(minimumValue, planeMinimum);
+        maximumValue = std::min(maximumValue, planeMaximum);
+        }
+      else
+        {
+        minimumValue = std::max(minimumValue, planeMinimum);
+        maximumValue = std::max(maximumValue, planeMaximum);
+        }
+      }
+    if (minimumValue > tolerance)
+      {
+      return PositiveCell;
+      }
+    if (maximumValue < -tolerance)
+      {
+      return NegativeCell;
+      }
+    return CrossingCell;
+  }
+
+  //----------------------------------------------------------------------------
+  /// Edge of a triangle that crosses the zero level. Point0 < Point1, so that the triangles sharing the
+  /// edge produce the same key.
+  struct CrossingEdge
+  {
+    vtkIdType Point0;
+    vtkIdType Point1;
+
+    bool operator<(const CrossingEdge& other) const
+    {
+      if (this->Point0 != other.Point0)
+        {
+        return this->Point0 < other.Point0;
+        }
+      return this->Point1 < other.Point1;
+    }
+
+    bool operator==(const CrossingEdge& other) const
+    {
+      return this->Point0 == other.Point0 && this->Point1 == other.Point1;
+    }
+  };
+
+  //----------------------------------------------------------------------------
+  CrossingEdge MakeCrossingEdge(vtkIdType point0, vtkIdType point1)
+  {
+    return CrossingEdge{ std::min(point0, point1), std::max(point0, point1) };
+  }
+
+  //----------------------------------------------------------------------------
+  /// Returns the index of the triangle vertex that is alone on its side of the zero level, or -1 if
+  /// all vertices are on the same side. Points with zero value are on the positive side.
+  int GetLoneVertex(const double* scalars, const vtkIdType triangle[3], bool& lonePositive)
+  {
+    bool positive[3] = { scalars[triangle[0]] >= 0.0, scalars[triangle[1]] >= 0.0, scalars[triangle[2]] >= 0.0 };
+    int numberOfPositive = positive[0] + positive[1] + positive[2];
+    if (numberOfPositive == 0 || numberOfPositive == 3)
+      {
+      lonePositive = (numberOfPositive == 3);
+      return -1;
+      }
+    lonePositive = (numberOfPositive == 1);
+    for (int i = 0; i < 3; ++i)
+      {
+      if (positive[i] == lonePositive)
+        {
+        return i;
+        }
+      }
+    return -1;
+  }
+
+  //----------------------------------------------------------------------------
+  /// Store a triangle in an output slot, degenerate triangles are left empty
+  void SetTriangle(vtkIdType* slot, vtkIdType point0, vtkIdType point1, vtkIdType point2)
+  {
+    if (point0 == point1 || point1 == point2 || point2 == point0)
+      {
+      return;
+      }
+    slot[0] = point0;
+    slot[1] = point1;
+    slot[2] = point2;
+  }
+
+  //----------------------------------------------------------------------------
+  /// Compute the combined signed distance of each point. Each plane is evaluated over the whole block
+  /// of points, so that the inner loop is a simple arithmetic loop that the compiler can vectorize.
+  template <typename ValueType>
+  struct ComputeScalarsWorker
+  {
+    const ValueType* Points;
+    const std::vector<PlaneCoefficients>* Planes;
+    bool UseMinimum;
+    double* Scalars;
+
+    void operator()(vtkIdType beginPointId, vtkIdType endPointId)
+    {
+      const ValueType* points = this->Points;
+      double* scalars = this->Scalars;
+      for (size_t planeIndex = 0; planeIndex < this->Planes->size(); ++planeIndex)
+        {
+        const PlaneCoefficients& plane = (*this->Planes)[planeIndex];
+        const double a = plane[0];
+        const double b = plane[1];
+        const double c = plane[2];
+        const double d = plane[3];
+        if (planeIndex == 0)
+          {
+          for (vtkIdType i = beginPointId; i < endPointId; ++i)
+            {
+            scalars[i] = a * points[3 * i] + b * points[3 * i + 1] + c * points[3 * i + 2] + d;
+            }
+          }
+        else if (this->UseMinimum)
+          {
+          for (vtkIdType i = beginPointId; i < endPointId; ++i)
+            {
+            scalars[i] = std::min(scalars[i], a * points[3 * i] + b * points[3 * i + 1] + c * points[3 * i + 2] + d);
+            }
+          }
+        else
+          {
+          for (vtkIdType i = beginPointId; i < endPointId; ++i)
+            {
+            scalars[i] = std::max(scalars[i], a * points[3 * i] + b * points[3 * i + 1] + c * points[3 * i + 2] + d);
+            }
+          }
+        }
+    }
+  };
+
+  //----------------------------------------------------------------------------
+  /// Compute the combined signed distance of the listed points. Used when only a small part of the
+  /// points is needed, other values of the scalar array are not modified.
+  struct ComputePointListScalarsWorker
+  {
+    vtkPoints* Points;
+    const std::vector<PlaneCoefficients>* Planes;
+    bool UseMinimum;
+    const vtkIdType* PointIds;
+    double* Scalars;
+
+    void operator()(vtkIdType begin, vtkIdType end)
+    {
+      double point[3] = { 0.0, 0.0, 0.0 };
+      for (vtkIdType i = begin; i < end; ++i)
+        {
+        vtkIdType pointId = this->PointIds[i];
+        this->Points->GetPoint(pointId, point);
+        double value = 0.0;
+        for (size_t planeIndex = 0; planeIndex < this->Planes->size(); ++planeIndex)
+          {
+          const PlaneCoefficients& plane = (*this->Planes)[planeIndex];
+          double planeValue = plane[0] * point[0] + plane[1] * point[1] + plane[2] * point[2] + plane[3];
+          if (planeIndex == 0)
+            {
+            value = planeValue;
+            }
+          else
+            {
+            value = this->UseMinimum ? std::min(value, planeValue) : std::max(value, planeValue);
+            }
+          }
+        this->Scalars[pointId] = value;
+        }
+    }
+  };
+
+  //----------------------------------------------------------------------------
+  /// Compute the combined signed distance of all points in parallel. Points that are not stored as float
+  /// or double are converted to double first.
+  void ComputeAllPointScalars(vtkPoints* points, const std::vector<PlaneCoefficients>& planes, bool useMinimum,
+    std::vector<double>& scalars)
+  {
+    vtkIdType numberOfPoints = points->GetNumberOfPoints();
+    scalars.resize(numberOfPoints);
+    vtkDataArray* pointArray = points->GetData();
+    vtkFloatArray* floatPoints = vtkFloatArray::FastDownCast(pointArray);
+    if (floatPoints)
+      {
+      ComputeScalarsWorker<float> computeScalarsWorker{ floatPoints->GetPointer(0), &planes, useMinimum, scalars.data() };
+      vtkSMPTools::For(0, numberOfPoints, computeScalarsWorker);
+      return;
+      }
+    vtkDoubleArray* doublePoints = vtkDoubleArray::FastDownCast(pointArray);
+    std::vector<double> convertedPoints;
+    if (!doublePoints)
+      {
+      convertedPoints.resize(3 * numberOfPoints);
+      for (vtkIdType pointId = 0; pointId < numberOfPoints; ++pointId)
+        {
+        points->GetPoint(pointId, convertedPoints.data() + 3 * pointId);
+        }
+      }
+    const double* pointValues = doublePoints ? doublePoints->GetPointer(0) : convertedPoints.data();
+    ComputeScalarsWorker<double> computeScalarsWorker{ pointValues, &planes, useMinimum, scalars.data() };
+    vtkSMPTools::For(0, numberOfPoints, computeScalarsWorker);
+  }
+
+  //----------------------------------------------------------------------------
+  /// Classify the polygons. If CellIds is set then only the listed polygons are classified and the state
+  /// of each is stored at its index in the list.
+  struct ClassifyCellsWorker
+  {
+    vtkCellArray* Polys;
+    const double* Scalars;
+    const vtkIdType* CellIds{ nullptr };
+    unsigned char* CellStates;
+    vtkSMPThreadLocalObject<vtkIdList> PointIds;
+
+    void operator()(vtkIdType beginCell, vtkIdType endCell)
+    {
+      vtkIdList* pointIds = this->PointIds.Local();
+      for (vtkIdType cell = beginCell; cell < endCell; ++cell)
+        {
+        this->Polys->GetCellAtId(this->CellIds ? this->CellIds[cell] : cell, pointIds);
+        vtkIdType numberOfPoints = pointIds->GetNumberOfIds();
+        vtkIdType numberOfPositive = 0;
+        for (vtkIdType i = 0; i < numberOfPoints; ++i)
+          {
+          if (this->Scalars[pointIds->GetId(i)] >= 0.0)
+            {
+            ++numberOfPositive;
+            }
+          }
+        if (numberOfPositive == numberOfPoints)
+          {
+          this->CellStates[cell] = PositiveCell;
+          }
+        else if (numberOfPositive == 0)
+          {
+          this->CellStates[cell] = NegativeCell;
+          }
+        else
+          {
+          this->CellStates[cell] = (numberOfPoints < 3 ? DiscardedCell : CrossingCell);
+          }
+        }
+    }
+  };
+
+  //----------------------------------------------------------------------------
+  /// Write the two crossing edges of each triangle of the crossing polygons into the edge table.
+  /// Triangles that do not cross the zero level write two invalid edges.
+  struct CollectCrossingEdgesWorker
+  {
+    vtkCellArray* Polys;
+    const double* Scalars;
+    const vtkIdType* CrossingCellIds;
+    const vtkIdType* TriangleOffsets;
+    CrossingEdge* Edges;
+    vtkSMPThreadLocalObject<vtkIdList> PointIds;
+
+    void operator()(vtkIdType beginCrossingCell, vtkIdType endCrossingCell)
+    {
+      vtkIdList* pointIds = this->PointIds.Local();
+      for (vtkIdType crossingCell = beginCrossingCell; crossingCell < endCrossingCell; ++crossingCell)
+        {
+        this->Polys->GetCellAtId(this->CrossingCellIds[crossingCell], pointIds);
+        CrossingEdge* edges = this->Edges + 2 * this->TriangleOffsets[crossingCell];
+        for (vtkIdType i = 1; i + 1 < pointIds->GetNumberOfIds(); ++i, edges += 2)
+          {
+          vtkIdType triangle[3] = { pointIds->GetId(0), pointIds->GetId(i), pointIds->GetId(i + 1) };
+          bool lonePositive = false;
+          int loneVertex = GetLoneVertex(this->Scalars, triangle, lonePositive);
+          if (loneVertex < 0)
+            {
+            edges[0] = edges[1] = CrossingEdge{ -1, -1 };
+            continue;
+            }
+          vtkIdType point0 = triangle[loneVertex];
+          edges[0] = MakeCrossingEdge(point0, triangle[(loneVertex + 1) % 3]);
+          edges[1] = MakeCrossingEdge(point0, triangle[(loneVertex + 2) % 3]);
+          }
+        }
+    }
+  };
+
+  //----------------------------------------------------------------------------
+  /// Write the edges of the crossing polygons that have both end points on the positive side. Each polygon
+  /// has one slot per edge, other slots are set to invalid edges.
+  struct CollectPositiveEdgesWorker
+  {
+    vtkCellArray* Polys;
+    const double* Scalars;
+    const vtkIdType* CrossingCellIds;
+    const vtkIdType* EdgeOffsets;
+    CrossingEdge* Edges;
+    vtkSMPThreadLocalObject<vtkIdList> PointIds;
+
+    void operator()(vtkIdType beginCrossingCell, vtkIdType endCrossingCell)
+    {
+      vtkIdList* pointIds = this->PointIds.Local();
+      for (vtkIdType crossingCell = beginCrossingCell; crossingCell < endCrossingCell; ++crossingCell)
+        {
+        this->Polys->GetCellAtId(this->CrossingCellIds[crossingCell], pointIds);
+        CrossingEdge* edges = this->Edges + this->EdgeOffsets[crossingCell];
+        vtkIdType numberOfPoints = pointIds->GetNumberOfIds();
+        for (vtkIdType i = 0; i < numberOfPoints; ++i)
+          {
+          vtkIdType point0 = pointIds->GetId(i);
+          vtkIdType point1 = pointIds->GetId((i + 1) % numberOfPoints);
+          bool positive = (this->Scalars[point0] >= 0.0 && this->Scalars[point1] >= 0.0);
+          edges[i] = positive ? MakeCrossingEdge(point0, point1) : CrossingEdge{ -1, -1 };
+          }
+        }
+    }
+  };
+
+  //----------------------------------------------------------------------------
+  /// Split the triangles of the crossing polygons. Each triangle writes up to two triangles for each side
+  /// and one segment of the zero level, unused slots are marked by -1. Outputs that are not needed may be nullptr.
+  /// Segments are oriented so that the positive side is on their left, viewed from the side where the triangle
+  /// is counter-clockwise.
+  struct SplitCrossingCellsWorker
+  {
+    vtkCellArray* Polys;
+    const double* Scalars;
+    const vtkIdType* CrossingCellIds;
+    const vtkIdType* TriangleOffsets;
+    const std::vector<CrossingEdge>* UniqueEdges;
+    const vtkIdType* EdgePointIds;
+    vtkIdType* PositiveTriangles{ nullptr };
+    vtkIdType* NegativeTriangles{ nullptr };
+    vtkIdType* Segments{ nullptr };
+    vtkSMPThreadLocalObject<vtkIdList> PointIds;
+
+    vtkIdType GetEdgePointId(vtkIdType point0, vtkIdType point1)
+    {
+      CrossingEdge edge = MakeCrossingEdge(point0, point1);
+      std::vector<CrossingEdge>::const_iterator edgeIt = std::lower_bound(this->UniqueEdges->begin(), this->UniqueEdges->end(), edge);
+      return this->EdgePointIds[edgeIt - this->UniqueEdges->begin()];
+    }
+
+    void operator()(vtkIdType beginCrossingCell, vtkIdType endCrossingCell)
+    {
+      vtkIdList* pointIds = this->PointIds.Local();
+      vtkIdType unusedSlots[6] = { -1, -1, -1, -1, -1, -1 };
+      for (vtkIdType crossingCell = beginCrossingCell; crossingCell < endCrossingCell; ++crossingCell)
+        {
+        this->Polys->GetCellAtId(this->CrossingCellIds[crossingCell], pointIds);
+        vtkIdType triangleIndex = this->TriangleOffsets[crossingCell];
+        for (vtkIdType i = 1; i + 1 < pointIds->GetNumberOfIds(); ++i, ++triangleIndex)
+          {
+          vtkIdType* positiveSlots = this->PositiveTriangles ? this->PositiveTriangles + 6 * triangleIndex : unusedSlots;
+          vtkIdType* negativeSlots = this->NegativeTriangles ? this->NegativeTriangles + 6 * triangleIndex : unusedSlots;
+          vtkIdType* segmentSlot = this->Segments ? this->Segments + 2 * triangleIndex : unusedSlots;
+          std::fill(positiveSlots, positiveSlots + 6, -1);
+          std::fill(negativeSlots, negativeSlots + 6, -1);
+          segmentSlot[0] = segmentSlot[1] = -1;
+
+          vtkIdType triangle[3] = { pointIds->GetId(0), pointIds->GetId(i), pointIds->GetId(i + 1) };
+          bool lonePositive = false;
+          int loneVertex = GetLoneVertex(this->Scalars, triangle, lonePositive);
+          if (loneVertex < 0)
+            {
+            SetTriangle(lonePositive ? positiveSlots : negativeSlots, triangle[0], triangle[1], triangle[2]);
+            continue;
+            }
+
+          // Lone vertex is first, the orientation of the triangle is preserved
+          vtkIdType point0 = triangle[loneVertex];
+          vtkIdType point1 = triangle[(loneVertex + 1) % 3];
+          vtkIdType point2 = triangle[(loneVertex + 2) % 3];
+          vtkIdType edgePoint01 = this->GetEdgePointId(point0, point1);
+          vtkIdType edgePoint02 = this->GetEdgePointId(point0, point2);
+          vtkIdType* loneSlots = lonePositive ? positiveSlots : negativeSlots;
+          vtkIdType* otherSlots = lonePositive ? negativeSlots : positiveSlots;
+          SetTriangle(loneSlots, point0, edgePoint01, edgePoint02);
+          SetTriangle(otherSlots, edgePoint01, point1, point2);
+          SetTriangle(otherSlots + 3, edgePoint01, point2, edgePoint02);
+          if (edgePoint01 != edgePoint02)
+            {
+            // The lone vertex is on the left of the edge point 01 -> edge point 02 direction
+            segmentSlot[0] = lonePositive ? edgePoint01 : edgePoint02;
+            segmentSlot[1] = lonePositive ? edgePoint02 : edgePoint01;
+            }
+          }
+        }
+    }
+  };
+
+  //----------------------------------------------------------------------------
+  struct ComputeEdgePointsWorker
+  {
+    vtkPoints* InputPoints;
+    const CrossingEdge* Edges;
+    const vtkIdType* NewPointEdgeIndices;
+    const double* EdgeParameters;
+    vtkPoints* NewPoints;
+
+    void operator()(vtkIdType beginPointId, vtkIdType endPointId)
+    {
+      double point0[3] = { 0.0, 0.0, 0.0 };
+      double point1[3] = { 0.0, 0.0, 0.0 };
+      for (vtkIdType newPointId = beginPointId; newPointId < endPointId; ++newPointId)
+        {
+        const CrossingEdge& edge = this->Edges[this->NewPointEdgeIndices[newPointId]];
+        double t = this->EdgeParameters[newPointId];
+        this->InputPoints->GetPoint(edge.Point0, point0);
+        this->InputPoints->GetPoint(edge.Point1, point1);
+        this->NewPoints->SetPoint(newPointId,
+          point0[0] + t * (point1[0] - point0[0]),
+          point0[1] + t * (point1[1] - point0[1]),
+          point0[2] + t * (point1[2] - point0[2]));
+        }
+    }
+  };
+
+  //----------------------------------------------------------------------------
+  /// Copy the point ids of the polygons that are passed to the output.
+  struct CopyPassedCellsWorker
+  {
+    vtkCellArray* Polys;
+    const vtkIdType* PassedCellIds;
+    const vtkIdType* OutputOffsets;
+    vtkIdType* OutputConnectivity;
+    vtkSMPThreadLocalObject<vtkIdList> PointIds;
+
+    void operator()(vtkIdType beginCell, vtkIdType endCell)
+    {
+      vtkIdList* pointIds = this->PointIds.Local();
+      for (vtkIdType outputCell = beginCell; outputCell < endCell; ++outputCell)
+        {
+        this->Polys->GetCellAtId(this->PassedCellIds[outputCell], pointIds);
+        std::copy(pointIds->GetPointer(0), pointIds->GetPointer(0) + pointIds->GetNumberOfIds(),
+          this->OutputConnectivity + this->OutputOffsets[outputCell]);
+        }
+    }
+  };
+
+  //----------------------------------------------------------------------------
+  /// Replace combined point ids by output point ids, using a dense map or, if PointMap is nullptr,
+  /// a binary search in the sorted list of used combined point ids.
+  struct RenumberPointsWorker
+  {
+    const vtkIdType* PointMap{ nullptr };
+    const std::vector<vtkIdType>* SortedPointIds{ nullptr };
+    vtkIdType* Connectivity;
+
+    void operator()(vtkIdType begin, vtkIdType end)
+    {
+      if (this->PointMap)
+        {
+        for (vtkIdType i = begin; i < end; ++i)
+          {
+          this->Connectivity[i] = this->PointMap[this->Connectivity[i]];
+          }
+        return;
+        }
+      for (vtkIdType i = begin; i < end; ++i)
+        {
+        this->Connectivity[i] = std::lower_bound(this->SortedPointIds->begin(), this->SortedPointIds->end(),
+          this->Connectivity[i]) - this->SortedPointIds->begin();
+        }
+    }
+  };
+
+  //----------------------------------------------------------------------------
+  /// Output of one side of the clipper in the previous run with the bounding volume hierarchy, used for updating
+  /// the output when the planes are moved. The arrays of the output are never modified, as they may still be in use.
+  struct OutputCache
+  {
+    bool Valid{ false };
+    vtkSmartPointer<vtkPolyData> Output;
+    vtkSmartPointer<vtkIdTypeArray> Offsets;
+    vtkSmartPointer<vtkIdTypeArray> Connectivity;
+    /// Output polygons are in leaf order, range of output polygons of each leaf
+    std::vector<vtkIdType> LeafCellOffsets;
+    /// Output point id of each input point, -1 if the point is not used
+    std::vector<vtkIdType> InputToOutputPointIds;
+    /// Input point id of each output point, -1 for points created on crossing edges
+    std::vector<vtkIdType> OutputToInputPointIds;
+    /// Number of times each output point is used by the output polygons
+    std::vector<vtkIdType> PointUseCounts;
+  };
+
+  /// Consecutive output polygons that are copied from the same source
+  struct OutputSegment
+  {
+    enum SourceTypes
+    {
+      PreviousOutput,
+      OrderedInput,
+      NewCells
+    };
+    int SourceType;
+    vtkIdType OutputCellBegin;
+    vtkIdType OutputCellEnd;
+    /// First polygon in the previous output, first position in the hierarchy order or first index in the new polygons
+    vtkIdType SourceBegin;
+    vtkIdType ConnectivityBegin;
+  };
+
+  //----------------------------------------------------------------------------
+  /// Add a segment of output polygons, merged with the last segment if its source continues there.
+  void AppendOutputSegment(std::vector<OutputSegment>& segments, int sourceType, vtkIdType outputCellBegin,
+    vtkIdType numberOfCells, vtkIdType sourceBegin)
+  {
+    if (numberOfCells <= 0)
+      {
+      return;
+      }
+    if (!segments.empty())
+      {
+      OutputSegment& lastSegment = segments.back();
+      if (lastSegment.SourceType == sourceType && lastSegment.OutputCellEnd == outputCellBegin
+        && lastSegment.SourceBegin + lastSegment.OutputCellEnd - lastSegment.OutputCellBegin == sourceBegin)
+        {
+        lastSegment.OutputCellEnd += numberOfCells;
+        return;
+        }
+      }
+    segments.push_back(OutputSegment{ sourceType, outputCellBegin, outputCellBegin + numberOfCells, sourceBegin, 0 });
+  }
+
+  //----------------------------------------------------------------------------
+  /// Write the offsets and point ids of the output polygons from their segments. Point ids of the previous output
+  /// are kept, except for the points that are moved into released point ids. Point ids of the input polygons and
+  /// of the split triangles (combined point ids) are mapped to output point ids.
+  struct WriteOutputCellsWorker
+  {
+    const std::vector<OutputSegment>* Segments;
+    const vtkIdType* PreviousOffsets{ nullptr };
+    const vtkIdType* PreviousConnectivity{ nullptr };
+    /// Previous output points with id >= NumberOfOutputPoints are moved to MovedPointIds[id - NumberOfOutputPoints]
+    vtkIdType NumberOfOutputPoints;
+    const vtkIdType* MovedPointIds{ nullptr };
+    const vtkIdType* OrderedOffsets;
+    const vtkIdType* OrderedConnectivity;
+    const vtkIdType* NewCellPositions;
+    /// Slot of each new triangle in SideTriangles, -1 for polygons that are passed whole
+    const vtkIdType* NewCellTriangleSlots;
+    const vtkIdType* NewCellConnectivityOffsets;
+    const vtkIdType* SideTriangles;
+    vtkIdType NumberOfInputPoints;
+    const vtkIdType* InputToOutputPointIds;
+    const vtkIdType* EdgeOutputPointIds;
+    vtkIdType* Offsets;
+    vtkIdType* Connectivity;
+
+    vtkIdType GetOutputPointId(vtkIdType combinedPointId) const
+    {
+      return combinedPointId < this->NumberOfInputPoints ? this->InputToOutputPointIds[combinedPointId]
+        : this->EdgeOutputPointIds[combinedPointId - this->NumberOfInputPoints];
+    }
+
+    void CopyOrderedCell(vtkIdType position, vtkIdType outputOffset)
+    {
+      for (vtkIdType i = this->OrderedOffsets[position]; i < this->OrderedOffsets[position + 1]; ++i, ++outputOffset)
+        {
+        this->Connectivity[outputOffset] = this->InputToOutputPointIds[this->OrderedConnectivity[i]];
+        }
+    }
+
+    void operator()(vtkIdType beginCell, vtkIdType endCell)
+    {
+      std::vector<OutputSegment>::const_iterator segmentIt = std::upper_bound(this->Segments->begin(), this->Segments->end(), beginCell,
+        [](vtkIdType cell, const OutputSegment& segment) { return cell < segment.OutputCellBegin; }) - 1;
+      for (vtkIdType outputCell = beginCell; outputCell < endCell; ++outputCell)
+        {
+        while (outputCell >= segmentIt->OutputCellEnd)
+          {
+          ++segmentIt;
+          }
+        vtkIdType source = segmentIt->SourceBegin + outputCell - segmentIt->OutputCellBegin;
+        vtkIdType outputOffset = 0;
+        if (segmentIt->SourceType == OutputSegment::PreviousOutput)
+          {
+          outputOffset = segmentIt->ConnectivityBegin + this->PreviousOffsets[source] - this->PreviousOffsets[segmentIt->SourceBegin];
+          this->Offsets[outputCell] = outputOffset;
+          for (vtkIdType i = this->PreviousOffsets[source]; i < this->PreviousOffsets[source + 1]; ++i, ++outputOffset)
+            {
+            vtkIdType pointId = this->PreviousConnectivity[i];
+            this->Connectivity[outputOffset] = (pointId < this->NumberOfOutputPoints ? pointId
+              : this->MovedPointIds[pointId - this->NumberOfOutputPoints]);
+            }
+          }
+        else if (segmentIt->SourceType == OutputSegment::OrderedInput)
+          {
+          outputOffset = segmentIt->ConnectivityBegin + this->OrderedOffsets[source] - this->OrderedOffsets[segmentIt->SourceBegin];
+          this->Offsets[outputCell] = outputOffset;
+          this->CopyOrderedCell(source, outputOffset);
+          }
+        else
+          {
+          outputOffset = segmentIt->ConnectivityBegin + this->NewCellConnectivityOffsets[source]
+            - this->NewCellConnectivityOffsets[segmentIt->SourceBegin];
+          this->Offsets[outputCell] = outputOffset;
+          vtkIdType slot = this->NewCellTriangleSlots[source];
+          if (slot < 0)
+            {
+            this->CopyOrderedCell(this->NewCellPositions[source], outputOffset);
+            continue;
+            }
+          for (int i = 0; i < 3; ++i)
+            {
+            this->Connectivity[outputOffset + i] = this->GetOutputPointId(this->SideTriangles[3 * slot + i]);
+            }
+          }
+        }
+    }
+  };
+
+  //----------------------------------------------------------------------------
+  struct MarkUsedPointsWorker
+  {
+    const vtkIdType* Connectivity;
+    unsigned char* UsedPoints;
+
+    void operator()(vtkIdType begin, vtkIdType end)
+    {
+      for (vtkIdType i = begin; i < end; ++i)
+        {
+        this->UsedPoints[this->Connectivity[i]] = 1;
+        }
+    }
+  };
+
+  //----------------------------------------------------------------------------
+  /// Compute the bounds of each polygon, used for building the bounding volume hierarchy.
+  struct ComputeCellBoundsWorker
+  {
+    vtkCellArray* Polys;
+    vtkPoints* Points;
+    double* CellBounds;
+    vtkSMPThreadLocalObject<vtkIdList> PointIds;
+
+    void operator()(vtkIdType beginCellId, vtkIdType endCellId)
+    {
+      vtkIdList* pointIds = this->PointIds.Local();
+      double point[3] = { 0.0, 0.0, 0.0 };
+      for (vtkIdType cellId = beginCellId; cellId < endCellId; ++cellId)
+        {
+        this->Polys->GetCellAtId(cellId, pointIds);
+        double* bounds = this->CellBounds + 6 * cellId;
+        vtkMath::UninitializeBounds(bounds);
+        for (vtkIdType i = 0; i < pointIds->GetNumberOfIds(); ++i)
+          {
+          this->Points->GetPoint(pointIds->GetId(i), point);
+          for (int axis = 0; axis < 3; ++axis)
+            {
+            bounds[2 * axis] = (i == 0 ? point[axis] : std::min(bounds[2 * axis], point[axis]));
+            bounds[2 * axis + 1] = (i == 0 ? point[axis] : std::max(bounds[2 * axis + 1], point[axis]));
+            }
+          }
+        }
+    }
+  };
+
+  //----------------------------------------------------------------------------
+  /// Copy the coordinates of the listed combined points to the output. If OutputPointIds is nullptr then
+  /// the points are written at their index in the list.
+  struct CopyOutputPointsWorker
+  {
+    vtkPoints* InputPoints;
+    vtkPoints* NewPoints;
+    vtkIdType NumberOfInputPoints;
+    const vtkIdType* OutputToCombinedPointIds;
+    const vtkIdType* OutputPointIds{ nullptr };
+    vtkPoints* OutputPoints;
+
+    void operator()(vtkIdType begin, vtkIdType end)
+    {
+      double point[3] = { 0.0, 0.0, 0.0 };
+      for (vtkIdType i = begin; i < end; ++i)
+        {
+        vtkIdType combinedPointId = this->OutputToCombinedPointIds[i];
+        if (combinedPointId < this->NumberOfInputPoints)
+          {
+          this->InputPoints->GetPoint(combinedPointId, point);
+          }
+        else
+          {
+          this->NewPoints->GetPoint(combinedPointId - this->NumberOfInputPoints, point);
+          }
+        this->OutputPoints->SetPoint(this->OutputPointIds ? this->OutputPointIds[i] : i, point);
+        }
+    }
+  };
+
+  //----------------------------------------------------------------------------
+  /// Polygons and edges of a mesh that cross the zero level of a scalar.
+  /// Points are indexed in a combined point list: input points followed by the new edge points.
+  struct Crossings
+  {
+    vtkPolyData* Input{ nullptr };
+    const double* Scalars{ nullptr };
+    /// Polygons that were classified, nullptr if all polygons of the input were classified
+    const vtkIdType* ClassifiedCellIds{ nullptr };
+    /// State of each classified polygon
+    std::vector<unsigned char> CellStates;
+    std::vector<vtkIdType> CrossingCellIds;
+    /// Each crossing polygon is split into a fan of triangles, range of triangle indices of each crossing polygon
+    std::vector<vtkIdType> TriangleOffsets;
+    std::vector<CrossingEdge> UniqueEdges;
+    /// Combined point id of the point on each unique edge
+    std::vector<vtkIdType> EdgePointIds;
+    std::vector<vtkIdType> NewPointEdgeIndices;
+    std::vector<double> EdgeParameters;
+    vtkSmartPointer<vtkPoints> NewPoints;
+
+    vtkIdType GetNumberOfTriangles() const { return this->TriangleOffsets.back(); }
+
+    void GetCombinedPoint(vtkIdType combinedPointId, double point[3]) const
+    {
+      vtkIdType numberOfInputPoints = this->Input->GetNumberOfPoints();
+      if (combinedPointId < numberOfInputPoints)
+        {
+        this->Input->GetPoints()->GetPoint(combinedPointId, point);
+        }
+      else
+        {
+        this->NewPoints->GetPoint(combinedPointId - numberOfInputPoints, point);
+        }
+    }
+
+    void InitializeSplitCrossingCellsWorker(SplitCrossingCellsWorker& worker) const
+    {
+      worker.Polys = this->Input->GetPolys();
+      worker.Scalars = this->Scalars;
+      worker.CrossingCellIds = this->CrossingCellIds.data();
+      worker.TriangleOffsets = this->TriangleOffsets.data();
+      worker.UniqueEdges = &this->UniqueEdges;
+      worker.EdgePointIds = this->EdgePointIds.data();
+    }
+  };
+
+  //----------------------------------------------------------------------------
+  /// Classify the polygons of the input and create one point on each edge that crosses the zero level of the scalars.
+  /// If cellIds is specified then only the listed polygons are classified, scalars are only accessed at their points.
+  void ComputeCrossings(vtkPolyData* input, const double* scalars, const std::vector<vtkIdType>* cellIds, Crossings& crossings)
+  {
+    vtkCellArray* inputPolys = input->GetPolys();
+    vtkIdType numberOfClassifiedCells = cellIds ? static_cast<vtkIdType>(cellIds->size()) : inputPolys->GetNumberOfCells();
+    crossings.Input = input;
+    crossings.Scalars = scalars;
+    crossings.ClassifiedCellIds = cellIds ? cellIds->data() : nullptr;
+    crossings.CellStates.resize(numberOfClassifiedCells);
+    ClassifyCellsWorker classifyCellsWorker;
+    classifyCellsWorker.Polys = inputPolys;
+    classifyCellsWorker.Scalars = scalars;
+    classifyCellsWorker.CellIds = crossings.ClassifiedCellIds;
+    classifyCellsWorker.CellStates = crossings.CellStates.data();
+    vtkSMPTools::For(0, numberOfClassifiedCells, classifyCellsWorker);
+
+    crossings.CrossingCellIds.clear();
+    crossings.TriangleOffsets.assign(1, 0);
+    for (vtkIdType cell = 0; cell < numberOfClassifiedCells; ++cell)
+      {
+      if (crossings.CellStates[cell] == CrossingCell)
+        {
+        vtkIdType cellId = cellIds ? (*cellIds)[cell] : cell;
+        crossings.CrossingCellIds.push_back(cellId);
+        crossings.TriangleOffsets.push_back(crossings.TriangleOffsets.back() + inputPolys->GetCellSize(cellId) - 2);
+        }
+      }
+    vtkIdType numberOfCrossingCells = static_cast<vtkIdType>(crossings.CrossingCellIds.size());
+
+    // Crossing edges are shared by neighbor triangles, create a single point for each unique edge
+    std::vector<CrossingEdge>& uniqueEdges = crossings.UniqueEdges;
+    uniqueEdges.resize(2 * crossings.GetNumberOfTriangles());
+    CollectCrossingEdgesWorker collectCrossingEdgesWorker;
+    collectCrossingEdgesWorker.Polys = inputPolys;
+    collectCrossingEdgesWorker.Scalars = scalars;
+    collectCrossingEdgesWorker.CrossingCellIds = crossings.CrossingCellIds.data();
+    collectCrossingEdgesWorker.TriangleOffsets = crossings.TriangleOffsets.data();
+    collectCrossingEdgesWorker.Edges = uniqueEdges.data();
+    vtkSMPTools::For(0, numberOfCrossingCells, collectCrossingEdgesWorker);
+    vtkSMPTools::Sort(uniqueEdges.begin(), uniqueEdges.end());
+    uniqueEdges.erase(std::unique(uniqueEdges.begin(), uniqueEdges.end()), uniqueEdges.end());
+    if (!uniqueEdges.empty() && uniqueEdges.front().Point0 < 0)
+      {
+      uniqueEdges.erase(uniqueEdges.begin());
+      }
+
+    // If an end point of the edge is on the zero level then it is used instead of creating a new point
+    vtkIdType numberOfInputPoints = input->GetNumberOfPoints();
+    crossings.EdgePointIds.resize(uniqueEdges.size());
+    crossings.NewPointEdgeIndices.clear();
+    crossings.EdgeParameters.clear();
+    for (size_t edgeIndex = 0; edgeIndex < uniqueEdges.size(); ++edgeIndex)
+      {
+      const CrossingEdge& edge = uniqueEdges[edgeIndex];
+      double scalar0 = scalars[edge.Point0];
+      double scalar1 = scalars[edge.Point1];
+      if (scalar0 == 0.0)
+        {
+        crossings.EdgePointIds[edgeIndex] = edge.Point0;
+        }
+      else if (scalar1 == 0.0)
+        {
+        crossings.EdgePointIds[edgeIndex] = edge.Point1;
+        }
+      else
+        {
+        crossings.EdgePointIds[edgeIndex] = numberOfInputPoints + static_cast<vtkIdType>(crossings.NewPointEdgeIndices.size());
+        crossings.NewPointEdgeIndices.push_back(static_cast<vtkIdType>(edgeIndex));
+        crossings.EdgeParameters.push_back(scalar0 / (scalar0 - scalar1));
+        }
+      }
+    vtkIdType numberOfNewPoints = static_cast<vtkIdType>(crossings.NewPointEdgeIndices.size());
+
+    crossings.NewPoints = vtkSmartPointer<vtkPoints>::New();
+    crossings.NewPoints->SetDataTypeToDouble();
+    crossings.NewPoints->SetNumberOfPoints(numberOfNewPoints);
+    ComputeEdgePointsWorker computeEdgePointsWorker;
+    computeEdgePointsWorker.InputPoints = input->GetPoints();
+    computeEdgePointsWorker.Edges = uniqueEdges.data();
+    computeEdgePointsWorker.NewPointEdgeIndices = crossings.NewPointEdgeIndices.data();
+    computeEdgePointsWorker.EdgeParameters = crossings.EdgeParameters.data();
+    computeEdgePointsWorker.NewPoints = crossings.NewPoints;
+    vtkSMPTools::For(0, numberOfNewPoints, computeEdgePointsWorker);
+  }
+
+  //----------------------------------------------------------------------------
+  double EvaluatePlane(const PlaneCoefficients& plane, const double x[3])
+  {
+    return plane[0] * x[0] + plane[1] * x[1] + plane[2] * x[2] + plane[3];
+  }
+
+  //----------------------------------------------------------------------------
+  /// Index of the plane that determines the combined function at the point: the plane with the smallest value
+  /// if useMinimum is set, the plane with the largest value otherwise.
+  int GetActivePlane(const std::vector<PlaneCoefficients>& planes, bool useMinimum, const double x[3])
+  {
+    int activePlane = 0;
+    double activeValue = 0.0;
+    for (int planeIndex = 0; planeIndex < static_cast<int>(planes.size()); ++planeIndex)
+      {
+      double value = EvaluatePlane(planes[planeIndex], x);
+      if (planeIndex == 0 || (useMinimum ? value < activeValue : value > activeValue))
+        {
+        activePlane = planeIndex;
+        activeValue = value;
+        }
+      }
+    return activePlane;
+  }
+
+  //----------------------------------------------------------------------------
+  /// Vertex of the face of a plane, the part of the plane where the plane determines the combined function.
+  struct FaceVertex
+  {
+    double Point[3];
+    /// The other two planes that intersect at the vertex, -1 for the sides of the initial square
+    int Planes[2];
+    /// Plane that intersects this plane along the edge from this vertex to the next one, -1 for the initial square
+    int EdgePlane;
+  };
+
+  //----------------------------------------------------------------------------
+  /// Compute the face of the plane: a square on the plane that is larger than the mesh, clipped by the half-space
+  /// of each other plane where this plane determines the combined function. Faces are convex, the vertices are in
+  /// counter-clockwise order viewed from the positive side of the plane. Empty if the face is empty.
+  void BuildFacePolygon(const std::vector<PlaneCoefficients>& planes, bool useMinimum, int planeIndex,
+    const double bounds[6], std::vector<FaceVertex>& polygon)
+  {
+    polygon.clear();
+    const PlaneCoefficients& plane = planes[planeIndex];
+    double normal[3] = { plane[0], plane[1], plane[2] };
+    double normalLength2 = vtkMath::Dot(normal, normal);
+    if (normalLength2 <= 0.0)
+      {
+      return;
+      }
+    double center[3] = { 0.5 * (bounds[0] + bounds[1]), 0.5 * (bounds[2] + bounds[3]), 0.5 * (bounds[4] + bounds[5]) };
+    double centerValue = EvaluatePlane(plane, center) / normalLength2;
+    for (int i = 0; i < 3; ++i)
+      {
+      center[i] -= centerValue * normal[i];
+      }
+    vtkMath::Normalize(normal);
+    double u[3] = { 0.0, 0.0, 0.0 };
+    double v[3] = { 0.0, 0.0, 0.0 };
+    vtkMath::Perpendiculars(normal, u, v, 0.0);
+    double halfSize = std::sqrt((bounds[1] - bounds[0]) * (bounds[1] - bounds[0])
+      + (bounds[3] - bounds[2]) * (bounds[3] - bounds[2]) + (bounds[5] - bounds[4]) * (bounds[5] - bounds[4]));
+    halfSize = std::max(halfSize, 1.0);
+    const double squareCorners[4][2] = { { -1.0, -1.0 }, { 1.0, -1.0 }, { 1.0, 1.0 }, { -1.0, 1.0 } };
+    for (int corner = 0; corner < 4; ++corner)
+      {
+      FaceVertex vertex;
+      for (int i = 0; i < 3; ++i)
+        {
+        vertex.Point[i] = center[i] + halfSize * (squareCorners[corner][0] * u[i] + squareCorners[corner][1] * v[i]);
+        }
+      vertex.Planes[0] = vertex.Planes[1] = -1;
+      vertex.EdgePlane = -1;
+      polygon.push_back(vertex);
+      }
+
+    // The plane determines the minimum where the other planes are positive, the maximum where they are negative
+    double sign = useMinimum ? 1.0 : -1.0;
+    std::vector<FaceVertex> clippedPolygon;
+    for (int otherPlaneIndex = 0; otherPlaneIndex < static_cast<int>(planes.size()) && !polygon.empty(); ++otherPlaneIndex)
+      {
+      if (otherPlaneIndex == planeIndex)
+        {
+        continue;
+        }
+      const PlaneCoefficients& otherPlane = planes[otherPlaneIndex];
+      clippedPolygon.clear();
+      for (size_t i = 0; i < polygon.size(); ++i)
+        {
+        const FaceVertex& vertex0 = polygon[i];
+        const FaceVertex& vertex1 = polygon[(i + 1) % polygon.size()];
+        double value0 = sign * EvaluatePlane(otherPlane, vertex0.Point);
+        double value1 = sign * EvaluatePlane(otherPlane, vertex1.Point);
+        if (value0 >= 0.0)
+          {
+          clippedPolygon.push_back(vertex0);
+          }
+        if ((value0 >= 0.0) == (value1 >= 0.0))
+          {
+          continue;
+          }
+        // Leaving the half-space the edge continues along the other plane, entering it continues along this edge
+        FaceVertex crossingVertex;
+        double t = value0 / (value0 - value1);
+        for (int j = 0; j < 3; ++j)
+          {
+          crossingVertex.Point[j] = vertex0.Point[j] + t * (vertex1.Point[j] - vertex0.Point[j]);
+          }
+        crossingVertex.Planes[0] = vertex0.EdgePlane;
+        crossingVertex.Planes[1] = otherPlaneIndex;
+        crossingVertex.EdgePlane = (value0 >= 0.0 ? otherPlaneIndex : vertex0.EdgePlane);
+        clippedPolygon.push_back(crossingVertex);
+        }
+      polygon.swap(clippedPolygon);
+      if (polygon.size() < 3)
+        {
+        polygon.clear();
+        }
+      }
+  }
+
+  //----------------------------------------------------------------------------
+  /// Point where the cut contour passes from one plane to another, on the intersection line of the two planes.
+  struct ContourCorner
+  {
+    double Point[3];
+    int FromPlane;
+    int ToPlane;
+  };
+
+  //----------------------------------------------------------------------------
+  /// Line segments of the cut contour of one plane. Points are identified by a key, so that the segments that
+  /// end at the same mesh point, corner or face vertex share their end point.
+  struct CutContourBuilder
+  {
+    vtkSmartPointer<vtkPoints> Points;
+    vtkSmartPointer<vtkCellArray> Lines;
+    std::map<vtkIdType, vtkIdType> PointMap;
+
+    vtkIdType GetPointId(vtkIdType key, const double point[3])
+    {
+      std::map<vtkIdType, vtkIdType>::iterator pointIt = this->PointMap.find(key);
+      if (pointIt == this->PointMap.end())
+        {
+        pointIt = this->PointMap.insert(std::make_pair(key, this->Points->InsertNextPoint(point))).first;
+        }
+      return pointIt->second;
+    }
+
+    void AddLine(vtkIdType key0, const double point0[3], vtkIdType key1, const double point1[3])
+    {
+      vtkIdType line[2] = { this->GetPointId(key0, point0), this->GetPointId(key1, point1) };
+      if (line[0] != line[1])
+        {
+        this->Lines->InsertNextCell(2, line);
+        }
+    }
+  };
+
+  //----------------------------------------------------------------------------
+  /// Create the cut contour of each plane from the segments of the split triangles, without visiting any other part
+  /// of the mesh. Each segment goes to the contour of the plane that determines the combined function at its end
+  /// points, segments whose end points are on different planes are split where the two planes have the same value.
+  /// The contour of each plane is the border of the end cap on its face (the part of the plane where it determines
+  /// the combined function): the segments on the plane, closed along the edges of the face that are inside the mesh.
+  /// Segments have the positive side on their left, so the end cap is on the left of the segments viewed from the
+  /// positive side of the plane and the part of a face edge after a corner that is inside the mesh is in the
+  /// counter-clockwise direction of the face of the plane before the corner. Face edges without corners are inside
+  /// if their end vertices are, the vertices of the initial squares are outside. The orientation of the polygons
+  /// of the mesh must be consistent, and faces that are entirely inside the mesh get an end cap only if they
+  /// touch another face that is cut by the mesh.
+  void BuildCutContours(const Crossings& crossings, const std::vector<vtkIdType>& segments,
+    const std::vector<PlaneCoefficients>& planes, bool useMinimum, const std::vector<vtkSmartPointer<vtkPolyData> >& contours)
+  {
+    int numberOfPlanes = static_cast<int>(planes.size());
+    vtkIdType numberOfCombinedPoints = crossings.Input->GetNumberOfPoints() + crossings.NewPoints->GetNumberOfPoints();
+    std::vector<CutContourBuilder> builders(numberOfPlanes);
+    for (CutContourBuilder& builder : builders)
+      {
+      builder.Points = vtkSmartPointer<vtkPoints>::New();
+      builder.Points->SetDataType(crossings.Input->GetPoints()->GetDataType());
+      builder.Lines = vtkSmartPointer<vtkCellArray>::New();
+      }
+
+    std::vector<ContourCorner> corners;
+    double point0[3] = { 0.0, 0.0, 0.0 };
+    double point1[3] = { 0.0, 0.0, 0.0 };
+    for (size_t segmentIndex = 0; 2 * segmentIndex < segments.size(); ++segmentIndex)
+      {
+      vtkIdType pointId0 = segments[2 * segmentIndex];
+      vtkIdType pointId1 = segments[2 * segmentIndex + 1];
+      if (pointId0 < 0)
+        {
+        continue;
+        }
+      crossings.GetCombinedPoint(pointId0, point0);
+      crossings.GetCombinedPoint(pointId1, point1);
+      int plane0 = GetActivePlane(planes, useMinimum, point0);
+      int plane1 = GetActivePlane(planes, useMinimum, point1);
+      if (plane0 == plane1)
+        {
+        builders[plane0].AddLine(pointId0, point0, pointId1, point1);
+        continue;
+        }
+      double difference0 = EvaluatePlane(planes[plane0], point0) - EvaluatePlane(planes[plane1], point0);
+      double difference1 = EvaluatePlane(planes[plane0], point1) - EvaluatePlane(planes[plane1], point1);
+      double t = (difference0 != difference1) ? std::min(std::max(difference0 / (difference0 - difference1), 0.0), 1.0) : 0.5;
+      ContourCorner corner;
+      for (int i = 0; i < 3; ++i)
+        {
+        corner.Point[i] = point0[i] + t * (point1[i] - point0[i]);
+        }
+      corner.FromPlane = plane0;
+      corner.ToPlane = plane1;
+      vtkIdType cornerKey = numberOfCombinedPoints + static_cast<vtkIdType>(corners.size());
+      builders[plane0].AddLine(pointId0, point0, cornerKey, corner.Point);
+      builders[plane1].AddLine(cornerKey, corner.Point, pointId1, point1);
+      corners.push_back(corner);
+      }
+
+    if (numberOfPlanes > 1)
+      {
+      std::map<std::pair<int, int>, std::vector<size_t> > edgeCorners;
+      for (size_t cornerIndex = 0; cornerIndex < corners.size(); ++cornerIndex)
+        {
+        const ContourCorner& corner = corners[cornerIndex];
+        edgeCorners[std::make_pair(std::min(corner.FromPlane, corner.ToPlane), std::max(corner.FromPlane, corner.ToPlane))].push_back(cornerIndex);
+        }
+
+      // Corners on each face edge as (parameter along the edge, corner index), sorted by parameter.
+      // The edge is inside the mesh after a corner if the contour passes from the plane of the face to the other one.
+      typedef std::vector<std::pair<double, size_t> > EdgeCorners;
+      std::vector<std::vector<FaceVertex> > faces(numberOfPlanes);
+      std::vector<std::vector<EdgeCorners> > faceEdgeCorners(numberOfPlanes);
+      double bounds[6] = { 0.0, 0.0, 0.0, 0.0, 0.0, 0.0 };
+      crossings.Input->GetBounds(bounds);
+      for (int planeIndex = 0; planeIndex < numberOfPlanes; ++planeIndex)
+        {
+        BuildFacePolygon(planes, useMinimum, planeIndex, bounds, faces[planeIndex]);
+        const std::vector<FaceVertex>& face = faces[planeIndex];
+        faceEdgeCorners[planeIndex].resize(face.size());
+        for (size_t i = 0; i < face.size(); ++i)
+          {
+          int edgePlane = face[i].EdgePlane;
+          if (edgePlane < 0)
+            {
+            continue;
+            }
+          std::map<std::pair<int, int>, std::vector<size_t> >::iterator edgeCornersIt =
+            edgeCorners.find(std::make_pair(std::min(planeIndex, edgePlane), std::max(planeIndex, edgePlane)));
+          if (edgeCornersIt == edgeCorners.end())
+            {
+            continue;
+            }
+          const double* edgePoint0 = face[i].Point;
+          const double* edgePoint1 = face[(i + 1) % face.size()].Point;
+          double edgeVector[3] = { edgePoint1[0] - edgePoint0[0], edgePoint1[1] - edgePoint0[1], edgePoint1[2] - edgePoint0[2] };
+          double edgeLength2 = std::max(vtkMath::Dot(edgeVector, edgeVector), VTK_DBL_MIN);
+          EdgeCorners& sortedCorners = faceEdgeCorners[planeIndex][i];
+          for (size_t cornerIndex : edgeCornersIt->second)
+            {
+            const double* cornerPoint = corners[cornerIndex].Point;
+            double toCorner[3] = { cornerPoint[0] - edgePoint0[0], cornerPoint[1] - edgePoint0[1], cornerPoint[2] - edgePoint0[2] };
+            double t = std::min(std::max(vtkMath::Dot(toCorner, edgeVector) / edgeLength2, 0.0), 1.0);
+            sortedCorners.emplace_back(t, cornerIndex);
+            }
+          std::sort(sortedCorners.begin(), sortedCorners.end());
+          }
+        }
+
+      // Face vertices are identified by their three planes, shared by the faces that meet at the vertex
+      std::map<std::array<int, 3>, bool> vertexInside;
+      std::vector<std::vector<std::array<int, 3> > > faceVertexKeys(numberOfPlanes);
+      for (int planeIndex = 0; planeIndex < numberOfPlanes; ++planeIndex)
+        {
+        for (const FaceVertex& vertex : faces[planeIndex])
+          {
+          std::array<int, 3> key = { planeIndex, vertex.Planes[0], vertex.Planes[1] };
+          std::sort(key.begin(), key.end());
+          faceVertexKeys[planeIndex].push_back(key);
+          if (key[0] < 0)
+            {
+            vertexInside[key] = false;
+            }
+          }
+        }
+      for (int planeIndex = 0; planeIndex < numberOfPlanes; ++planeIndex)
+        {
+        const std::vector<std::array<int, 3> >& keys = faceVertexKeys[planeIndex];
+        for (size_t i = 0; i < keys.size(); ++i)
+          {
+          const EdgeCorners& sortedCorners = faceEdgeCorners[planeIndex][i];
+          if (!sortedCorners.empty())
+            {
+            vertexInside.insert(std::make_pair(keys[i], corners[sortedCorners.front().second].FromPlane != planeIndex));
+            vertexInside.insert(std::make_pair(keys[(i + 1) % keys.size()], corners[sortedCorners.back().second].FromPlane == planeIndex));
+            }
+          }
+        }
+      bool vertexStateAdded = true;
+      while (vertexStateAdded)
+        {
+        vertexStateAdded = false;
+        for (int planeIndex = 0; planeIndex < numberOfPlanes; ++planeIndex)
+          {
+          const std::vector<std::array<int, 3> >& keys = faceVertexKeys[planeIndex];
+          for (size_t i = 0; i < keys.size(); ++i)
+            {
+            if (faces[planeIndex][i].EdgePlane < 0 || !faceEdgeCorners[planeIndex][i].empty())
+              {
+              continue;
+              }
+            std::map<std::array<int, 3>, bool>::iterator vertex0It = vertexInside.find(keys[i]);
+            std::map<std::array<int, 3>, bool>::iterator vertex1It = vertexInside.find(keys[(i + 1) % keys.size()]);
+            if ((vertex0It == vertexInside.end()) != (vertex1It == vertexInside.end()))
+              {
+              bool inside = (vertex0It != vertexInside.end() ? vertex0It->second : vertex1It->second);
+              vertexInside[vertex0It != vertexInside.end() ? keys[(i + 1) % keys.size()] : keys[i]] = inside;
+              vertexStateAdded = true;
+              }
+            }
+          }
+        }
+
+      // Close the contours along the parts of the face edges that are inside the mesh
+      vtkIdType firstVertexKey = numberOfCombinedPoints + static_cast<vtkIdType>(corners.size());
+      for (int planeIndex = 0; planeIndex < numberOfPlanes; ++planeIndex)
+        {
+        const std::vector<FaceVertex>& face = faces[planeIndex];
+        for (size_t i = 0; i < face.size(); ++i)
+          {
+          if (face[i].EdgePlane < 0)
+            {
+            continue;
+            }
+          size_t next = (i + 1) % face.size();
+          const EdgeCorners& sortedCorners = faceEdgeCorners[planeIndex][i];
+          if (sortedCorners.empty())
+            {
+            std::map<std::array<int, 3>, bool>::iterator vertexIt = vertexInside.find(faceVertexKeys[planeIndex][i]);
+            if (vertexIt != vertexInside.end() && vertexIt->second)
+              {
+              builders[planeIndex].AddLine(firstVertexKey + static_cast<vtkIdType>(i), face[i].Point,
+                firstVertexKey + static_cast<vtkIdType>(next), face[next].Point);
+              }
+            continue;
+            }
+          vtkIdType previousKey = firstVertexKey + static_cast<vtkIdType>(i);
+          const double* previousPoint = face[i].Point;
+          bool inside = (corners[sortedCorners.front().second].FromPlane != planeIndex);
+          for (const std::pair<double, size_t>& sortedCorner : sortedCorners)
+            {
+            const ContourCorner& corner = corners[sortedCorner.second];
+            vtkIdType cornerKey = numberOfCombinedPoints + static_cast<vtkIdType>(sortedCorner.second);
+            if (inside)
+              {
+              builders[planeIndex].AddLine(previousKey, previousPoint, cornerKey, corner.Point);
+              }
+            previousKey = cornerKey;
+            previousPoint = corner.Point;
+            inside = (corner.FromPlane == planeIndex);
+            }
+          if (inside)
+            {
+            builders[planeIndex].AddLine(previousKey, previousPoint, firstVertexKey + static_cast<vtkIdType>(next), face[next].Point);
+            }
+          }
+        }
+      }
+
+    for (int planeIndex = 0; planeIndex < numberOfPlanes; ++planeIndex)
+      {
+      contours[planeIndex]->SetPoints(builders[planeIndex].Points);
+      contours[planeIndex]->SetLines(builders[planeIndex].Lines);
+      }
+  }
+
+  //----------------------------------------------------------------------------
+  /// End point of a border segment, (point id, segment index)
+  typedef std::pair<vtkIdType, vtkIdType> SegmentEnd;
+
+  //----------------------------------------------------------------------------
+  /// Returns the index of a segment that ends at the point and is not used yet, or -1 if there is none.
+  vtkIdType FindUnusedSegment(const std::vector<SegmentEnd>& segmentEnds, const std::vector<bool>& usedSegments, vtkIdType pointId)
+  {
+    std::vector<SegmentEnd>::const_iterator endIt = std::lower_bound(segmentEnds.begin(), segmentEnds.end(), SegmentEnd(pointId, -1));
+    for (; endIt != segmentEnds.end() && endIt->first == pointId; ++endIt)
+      {
+      if (!usedSegments[endIt->second])
+        {
+        return endIt->second;
+        }
+      }
+    return -1;
+  }
+
+  //----------------------------------------------------------------------------
+  /// Add a polyline of input point ids to the output, points that are already in the output are reused.
+  void AppendPolyline(vtkPoints* inputPoints, vtkIdList* polyline, std::map<vtkIdType, vtkIdType>& pointMap,
+    vtkPoints* polylinePoints, vtkCellArray* polylineCells)
+  {
+    for (vtkIdType i = 0; i < polyline->GetNumberOfIds(); ++i)
+      {
+      vtkIdType inputPointId = polyline->GetId(i);
+      std::map<vtkIdType, vtkIdType>::iterator pointIt = pointMap.find(inputPointId);
+      if (pointIt == pointMap.end())
+        {
+        pointIt = pointMap.insert(std::make_pair(inputPointId, polylinePoints->InsertNextPoint(inputPoints->GetPoint(inputPointId)))).first;
+        }
+      polyline->SetId(i, pointIt->second);
+      }
+    polylineCells->InsertNextCell(polyline);
+  }
+
+  //----------------------------------------------------------------------------
+  /// Stitch segments into ordered polylines. Segments are pairs of input point ids. Chains start at the points that
+  /// are not shared by exactly two segments (ends of open polylines and non-manifold points), the remaining segments
+  /// form closed loops, which end at their first point. Segments are matched by their end points, so their
+  /// orientation does not matter.
+  void BuildPolylines(vtkPoints* inputPoints, const std::vector<vtkIdType>& segments, vtkPolyData* polylines)
+  {
+    std::vector<SegmentEnd> segmentEnds;
+    for (vtkIdType segmentIndex = 0; 2 * segmentIndex < static_cast<vtkIdType>(segments.size()); ++segmentIndex)
+      {
+      segmentEnds.emplace_back(segments[2 * segmentIndex], segmentIndex);
+      segmentEnds.emplace_back(segments[2 * segmentIndex + 1], segmentIndex);
+      }
+    vtkSMPTools::Sort(segmentEnds.begin(), segmentEnds.end());
+
+    // Start points of the chains, open chains first
+    std::vector<vtkIdType> startPointIds;
+    std::vector<vtkIdType> loopPointIds;
+    for (size_t i = 0; i < segmentEnds.size(); )
+      {
+      size_t next = i + 1;
+      while (next < segmentEnds.size() && segmentEnds[next].first == segmentEnds[i].first)
+        {
+        ++next;
+        }
+      (next - i == 2 ? loopPointIds : startPointIds).push_back(segmentEnds[i].first);
+      i = next;
+      }
+    startPointIds.insert(startPointIds.end(), loopPointIds.begin(), loopPointIds.end());
+
+    std::map<vtkIdType, vtkIdType> pointMap;
+    vtkNew<vtkPoints> polylinePoints;
+    polylinePoints->SetDataType(inputPoints->GetDataType());
+    vtkNew<vtkCellArray> polylineCells;
+    vtkNew<vtkIdList> polyline;
+    std::vector<bool> usedSegments(segments.size() / 2, false);
+    for (vtkIdType startPointId : startPointIds)
+      {
+      // A point with more than two segments may start several chains
+      vtkIdType segmentIndex = -1;
+      while ((segmentIndex = FindUnusedSegment(segmentEnds, usedSegments, startPointId)) >= 0)
+        {
+        polyline->Reset();
+        polyline->InsertNextId(startPointId);
+        vtkIdType pointId = startPointId;
+        while (segmentIndex >= 0)
+          {
+          usedSegments[segmentIndex] = true;
+          pointId = (segments[2 * segmentIndex] == pointId) ? segments[2 * segmentIndex + 1] : segments[2 * segmentIndex];
+          polyline->InsertNextId(pointId);
+          segmentIndex = FindUnusedSegment(segmentEnds, usedSegments, pointId);
+          }
+        AppendPolyline(inputPoints, polyline, pointMap, polylinePoints, polylineCells);
+        }
+      }
+    polylines->SetPoints(polylinePoints);
+    polylines->SetLines(polylineCells);
+  }
+
+  //----------------------------------------------------------------------------
+  /// Append the ids of the classified polygons that are entirely on the specified side.
+  void AppendPassedCells(const Crossings& crossings, unsigned char side, std::vector<vtkIdType>& passedCellIds)
+  {
+    const std::vector<unsigned char>& cellStates = crossings.CellStates;
+    for (vtkIdType cell = 0; cell < static_cast<vtkIdType>(cellStates.size()); ++cell)
+      {
+      if (cellStates[cell] == side)
+        {
+        passedCellIds.push_back(crossings.ClassifiedCellIds ? crossings.ClassifiedCellIds[cell] : cell);
+        }
+      }
+  }
+
+  //----------------------------------------------------------------------------
+  /// Create the output mesh of one side from the passed polygons and the split triangles.
+  /// The time spent is proportional to the size of the output, except for the point compaction of large outputs.
+  void BuildOutput(const Crossings& result, const std::vector<vtkIdType>& passedCellIds, const std::vector<vtkIdType>& sideTriangles,
+    vtkPolyData* output)
+  {
+    vtkPolyData* input = result.Input;
+    vtkCellArray* inputPolys = input->GetPolys();
+    vtkIdType numberOfInputPoints = input->GetNumberOfPoints();
+    vtkIdType numberOfCombinedPoints = numberOfInputPoints + result.NewPoints->GetNumberOfPoints();
+
+    // Output cells are the passed polygons followed by the split triangles
+    std::vector<vtkIdType> outputToInputCellIds(passedCellIds);
+    std::vector<vtkIdType> outputOffsetValues(1, 0);
+    outputOffsetValues.reserve(passedCellIds.size() + 1);
+    for (vtkIdType cellId : passedCellIds)
+      {
+      outputOffsetValues.push_back(outputOffsetValues.back() + inputPolys->GetCellSize(cellId));
+      }
+    vtkIdType numberOfPassedCells = static_cast<vtkIdType>(outputToInputCellIds.size());
+    std::vector<vtkIdType> triangleSlots;
+    for (size_t crossingCell = 0; crossingCell < result.CrossingCellIds.size(); ++crossingCell)
+      {
+      for (vtkIdType slot = 2 * result.TriangleOffsets[crossingCell]; slot < 2 * result.TriangleOffsets[crossingCell + 1]; ++slot)
+        {
+        if (sideTriangles[3 * slot] >= 0)
+          {
+          triangleSlots.push_back(slot);
+          outputToInputCellIds.push_back(result.CrossingCellIds[crossingCell]);
+          outputOffsetValues.push_back(outputOffsetValues.back() + 3);
+          }
+        }
+      }
+    vtkIdType numberOfOutputCells = static_cast<vtkIdType>(outputToInputCellIds.size());
+
+    vtkNew<vtkIdTypeArray> outputOffsets;
+    outputOffsets->SetNumberOfValues(numberOfOutputCells + 1);
+    std::copy(outputOffsetValues.begin(), outputOffsetValues.end(), outputOffsets->GetPointer(0));
+    vtkNew<vtkIdTypeArray> outputConnectivity;
+    outputConnectivity->SetNumberOfValues(outputOffsetValues.back());
+    vtkIdType* connectivity = outputConnectivity->GetPointer(0);
+
+    CopyPassedCellsWorker copyPassedCellsWorker;
+    copyPassedCellsWorker.Polys = inputPolys;
+    copyPassedCellsWorker.PassedCellIds = outputToInputCellIds.data();
+    copyPassedCellsWorker.OutputOffsets = outputOffsetValues.data();
+    copyPassedCellsWorker.OutputConnectivity = connectivity;
+    vtkSMPTools::For(0, numberOfPassedCells, copyPassedCellsWorker);
+    for (size_t i = 0; i < triangleSlots.size(); ++i)
+      {
+      std::copy(sideTriangles.begin() + 3 * triangleSlots[i], sideTriangles.begin() + 3 * triangleSlots[i] + 3,
+        connectivity + outputOffsetValues[numberOfPassedCells + i]);
+      }
+
+    // Only keep the points that are used by the output cells, in the order of the combined point list.
+    // Small outputs of large meshes are compacted by sorting, to avoid a map over all points.
+    vtkIdType numberOfConnectivityValues = outputConnectivity->GetNumberOfValues();
+    std::vector<vtkIdType> pointMap;
+    std::vector<vtkIdType> outputToCombinedPointIds;
+    RenumberPointsWorker renumberPointsWorker;
+    renumberPointsWorker.Connectivity = connectivity;
+    if (numberOfConnectivityValues * 8 < numberOfCombinedPoints)
+      {
+      outputToCombinedPointIds.assign(connectivity, connectivity + numberOfConnectivityValues);
+      vtkSMPTools::Sort(outputToCombinedPointIds.begin(), outputToCombinedPointIds.end());
+      outputToCombinedPointIds.erase(std::unique(outputToCombinedPointIds.begin(), outputToCombinedPointIds.end()),
+        outputToCombinedPointIds.end());
+      renumberPointsWorker.SortedPointIds = &outputToCombinedPointIds;
+      }
+    else
+      {
+      std::vector<unsigned char> usedPoints(numberOfCombinedPoints, 0);
+      MarkUsedPointsWorker markUsedPointsWorker{ connectivity, usedPoints.data() };
+      vtkSMPTools::For(0, numberOfConnectivityValues, markUsedPointsWorker);
+      pointMap.assign(numberOfCombinedPoints, -1);
+      for (vtkIdType combinedPointId = 0; combinedPointId < numberOfCombinedPoints; ++combinedPointId)
+        {
+        if (usedPoints[combinedPointId])
+          {
+          pointMap[combinedPointId] = static_cast<vtkIdType>(outputToCombinedPointIds.size());
+          outputToCombinedPointIds.push_back(combinedPointId);
+          }
+        }
+      renumberPointsWorker.PointMap = pointMap.data();
+      }
+    vtkIdType numberOfOutputPoints = static_cast<vtkIdType>(outputToCombinedPointIds.size());
+    vtkSMPTools::For(0, numberOfConnectivityValues, renumberPointsWorker);
+
+    vtkNew<vtkPoints> outputPoints;
+    outputPoints->SetDataType(input->GetPoints()->GetDataType());
+    outputPoints->SetNumberOfPoints(numberOfOutputPoints);
+    CopyOutputPointsWorker copyOutputPointsWorker;
+    copyOutputPointsWorker.InputPoints = input->GetPoints();
+    copyOutputPointsWorker.NewPoints = result.NewPoints;
+    copyOutputPointsWorker.NumberOfInputPoints = numberOfInputPoints;
+    copyOutputPointsWorker.OutputToCombinedPointIds = outputToCombinedPointIds.data();
+    copyOutputPointsWorker.OutputPoints = outputPoints;
+    vtkSMPTools::For(0, numberOfOutputPoints, copyOutputPointsWorker);
+    output->SetPoints(outputPoints);
+
+    vtkNew<vtkCellArray> outputPolys;
+    outputPolys->SetData(outputOffsets, outputConnectivity);
+    output->SetPolys(outputPolys);
+
+    // Point data of input points is copied, point data of new points is interpolated along the crossing edge
+    vtkNew<vtkIdList> fromIds;
+    vtkNew<vtkIdList> toIds;
+    vtkIdType numberOfCopiedPoints = std::lower_bound(outputToCombinedPointIds.begin(), outputToCombinedPointIds.end(),
+      numberOfInputPoints) - outputToCombinedPointIds.begin();
+    fromIds->SetNumberOfIds(numberOfCopiedPoints);
+    toIds->SetNumberOfIds(numberOfCopiedPoints);
+    std::copy(outputToCombinedPointIds.begin(), outputToCombinedPointIds.begin() + numberOfCopiedPoints, fromIds->GetPointer(0));
+    std::iota(toIds->GetPointer(0), toIds->GetPointer(0) + numberOfCopiedPoints, 0);
+    vtkPointData* inputPointData = input->GetPointData();
+    vtkPointData* outputPointData = output->GetPointData();
+    outputPointData->InterpolateAllocate(inputPointData, numberOfOutputPoints);
+    outputPointData->CopyData(inputPointData, fromIds, toIds);
+    for (vtkIdType outputPointId = numberOfCopiedPoints; outputPointId < numberOfOutputPoints; ++outputPointId)
+      {
+      vtkIdType newPointId = outputToCombinedPointIds[outputPointId] - numberOfInputPoints;
+      const CrossingEdge& edge = result.UniqueEdges[result.NewPointEdgeIndices[newPointId]];
+      outputPointData->InterpolateEdge(inputPointData, outputPointId, edge.Point0, edge.Point1, result.EdgeParameters[newPointId]);
+      }
+
+    fromIds->SetNumberOfIds(numberOfOutputCells);
+    toIds->SetNumberOfIds(numberOfOutputCells);
+    std::copy(outputToInputCellIds.begin(), outputToInputCellIds.end(), fromIds->GetPointer(0));
+    std::iota(toIds->GetPointer(0), toIds->GetPointer(0) + numberOfOutputCells, 0);
+    output->GetCellData()->CopyAllocate(input->GetCellData(), numberOfOutputCells);
+    output->GetCellData()->CopyData(input->GetCellData(), fromIds, toIds);
+  }
+}
+
+//----------------------------------------------------------------------------
+class vtkParallelPlaneClipper::vtkInternal
+{
+public:
+  /// Node of the bounding volume hierarchy, contains the polygons CellOrder[Begin, End) and the leaves [LeafBegin, LeafEnd)
+  struct Node
+  {
+    double Bounds[6];
+    vtkIdType Begin;
+    vtkIdType End;
+    vtkIdType LeafBegin;
+    vtkIdType LeafEnd;
+    vtkIdType Children[2];
+  };
+
+  /// Rebuild the hierarchy if the points or the polygons of the input have changed since the last build.
+  /// The stored outputs are discarded when the hierarchy is rebuilt.
+  void UpdateHierarchy(vtkPolyData* input);
+
+  /// Split the range of polygons at the median of the polygon centers along the longest axis, returns the node index.
+  vtkIdType BuildNode(vtkIdType begin, vtkIdType end, const std::vector<double>& cellBounds);
+
+  /// Discard the stored outputs if the point or cell data arrays of the input have changed since the last run.
+  void UpdateAttributeArrays(vtkPolyData* input);
+
+  /// Classify the nodes of the hierarchy by the bounds of the combined signed distance over the node box.
+  /// Nodes that are entirely on the positive or negative side are appended to leafRanges (if not nullptr), marked as
+  /// unchanged if compareToPreviousPlanes is set and they were on the same side with the previous planes.
+  /// Leaf nodes that may cross the zero level are appended to leafRanges one by one and their polygons are appended
+  /// to candidateCellIds.
+  void ClassifyLeaves(const std::vector<PlaneCoefficients>& planes, bool useMinimum, bool compareToPreviousPlanes,
+    std::vector<LeafRange>* leafRanges, std::vector<vtkIdType>& candidateCellIds);
+
+  /// Create the output mesh of one side from the classified leaves, by updating the stored output of the side.
+  /// Leaves outside of the volume swept by the planes are copied from the previous output, leaves that are now
+  /// entirely on this side are copied from the ordered input polygons and the polygons of the candidate leaves are
+  /// passed or split. Point ids that are released by the removed polygons are reused, so the output has no unused points.
+  /// The time spent is proportional to the number of updated polygons, plus copying the unchanged output into new arrays.
+  void UpdateOutput(const Crossings& crossings, const std::vector<LeafRange>& leafRanges, unsigned char side,
+    const std::vector<vtkIdType>& sideTriangles, vtkPolyData* output);
+
+  /// Compute the combined signed distance of the points of the listed polygons.
+  /// The array is kept between runs, so that it is only allocated for all points once.
+  static void ComputeCellPointScalars(vtkPolyData* input, const std::vector<PlaneCoefficients>& planes, bool useMinimum,
+    const std::vector<vtkIdType>& cellIds, std::vector<double>& scalars);
+
+  std::vector<Node> Nodes;
+  std::vector<vtkIdType> CellOrder;
+  /// First position of each leaf in CellOrder, followed by the number of polygons
+  std::vector<vtkIdType> LeafPositions;
+  /// Point ids of the polygons in CellOrder, leaves that are entirely on one side are copied from here
+  std::vector<vtkIdType> OrderedOffsets;
+  std::vector<vtkIdType> OrderedConnectivity;
+  /// Nodes closer than this to the zero level are split further, to be robust to rounding errors
+  double Tolerance{ 0.0 };
+
+  /// The hierarchy is rebuilt if the point or polygon arrays are replaced or modified.
+  /// Shallow copies of the input share these arrays, so the hierarchy is reused between snapshots of the same mesh.
+  vtkWeakPointer<vtkPoints> HierarchyPoints;
+  vtkMTimeType HierarchyPointsMTime{ 0 };
+  vtkWeakPointer<vtkCellArray> HierarchyPolys;
+  vtkMTimeType HierarchyPolysMTime{ 0 };
+
+  /// Point and cell data arrays of the input in the last run, the point and cell data of the stored outputs are
+  /// copied from them
+  std::vector<vtkWeakPointer<vtkAbstractArray> > AttributeArrays;
+  std::vector<vtkMTimeType> AttributeArrayMTimes;
+  std::vector<int> AttributeIndices;
+
+  /// Outputs of the last run, indexed by NegativeCell and PositiveCell, and the planes they were computed with
+  OutputCache OutputCaches[2];
+  std::vector<PlaneCoefficients> PreviousPlanes;
+  bool PreviousUseMinimum{ false };
+
+  std::vector<double> Scalars;
+};
+
+//----------------------------------------------------------------------------
+void vtkParallelPlaneClipper::vtkInternal::UpdateHierarchy(vtkPolyData* input)
+{
+  vtkPoints* points = input->GetPoints();
+  vtkCellArray* polys = input->GetPolys();
+  if (!this->Nodes.empty() && this->HierarchyPoints == points && this->HierarchyPointsMTime == points->GetMTime()
+    && this->HierarchyPolys == polys && this->HierarchyPolysMTime == polys->GetMTime())
+    {
+    return;
+    }
+
+  vtkIdType numberOfPolys = polys->GetNumberOfCells();
+  std::vector<double> cellBounds(6 * numberOfPolys);
+  ComputeCellBoundsWorker computeCellBoundsWorker;
+  computeCellBoundsWorker.Polys = polys;
+  computeCellBoundsWorker.Points = points;
+  computeCellBoundsWorker.CellBounds = cellBounds.data();
+  vtkSMPTools::For(0, numberOfPolys, computeCellBoundsWorker);
+
+  this->CellOrder.resize(numberOfPolys);
+  std::iota(this->CellOrder.begin(), this->CellOrder.end(), 0);
+  this->Nodes.clear();
+  this->Nodes.reserve(4 * (numberOfPolys / HierarchyLeafSize) + 1);
+  this->LeafPositions.clear();
+  this->BuildNode(0, numberOfPolys, cellBounds);
+  this->LeafPositions.push_back(numberOfPolys);
+
+  this->OrderedOffsets.resize(numberOfPolys + 1);
+  this->OrderedOffsets[0] = 0;
+  for (vtkIdType position = 0; position < numberOfPolys; ++position)
+    {
+    this->OrderedOffsets[position + 1] = this->OrderedOffsets[position] + polys->GetCellSize(this->CellOrder[position]);
+    }
+  this->OrderedConnectivity.resize(this->OrderedOffsets.back());
+  CopyPassedCellsWorker copyOrderedCellsWorker;
+  copyOrderedCellsWorker.Polys = polys;
+  copyOrderedCellsWorker.PassedCellIds = this->CellOrder.data();
+  copyOrderedCellsWorker.OutputOffsets = this->OrderedOffsets.data();
+  copyOrderedCellsWorker.OutputConnectivity = this->OrderedConnectivity.data();
+  vtkSMPTools::For(0, numberOfPolys, copyOrderedCellsWorker);
+
+  const double* rootBounds = this->Nodes[0].Bounds;
+  this->Tolerance = 0.0;
+  if (rootBounds[0] <= rootBounds[1])
+    {
+    double diagonal[3] = { rootBounds[1] - rootBounds[0], rootBounds[3] - rootBounds[2], rootBounds[5] - rootBounds[4] };
+    this->Tolerance = 1e-6 * vtkMath::Norm(diagonal);
+    }
+
+  this->HierarchyPoints = points;
+  this->HierarchyPointsMTime = points->GetMTime();
+  this->HierarchyPolys = polys;
+  this->HierarchyPolysMTime = polys->GetMTime();
+
+  // Stored outputs refer to the leaves of the previous hierarchy
+  this->OutputCaches[NegativeCell] = OutputCache();
+  this->OutputCaches[PositiveCell] = OutputCache();
+}
+
+//----------------------------------------------------------------------------
+vtkIdType vtkParallelPlaneClipper::vtkInternal::BuildNode(vtkIdType begin, vtkIdType end, const std::vector<double>& cellBounds)
+{
+  vtkIdType nodeIndex = static_cast<vtkIdType>(this->Nodes.size());
+  Node node;
+  node.Begin = begin;
+  node.End = end;
+  node.LeafBegin = static_cast<vtkIdType>(this->LeafPositions.size());
+  node.LeafEnd = node.LeafBegin + 1;
+  node.Children[0] = node.Children[1] = -1;
+  vtkMath::UninitializeBounds(node.Bounds);
+  double centerBounds[6] = { 0.0, 0.0, 0.0, 0.0, 0.0, 0.0 };
+  vtkMath::UninitializeBounds(centerBounds);
+  for (vtkIdType i = begin; i < end; ++i)
+    {
+    const double* bounds = cellBounds.data() + 6 * this->CellOrder[i];
+    if (bounds[0] > bounds[1])
+      {
+      // Polygon without points
+      continue;
+      }
+    bool first = (node.Bounds[0] > node.Bounds[1]);
+    for (int axis = 0; axis < 3; ++axis)
+      {
+      double center = 0.5 * (bounds[2 * axis] + bounds[2 * axis + 1]);
+      node.Bounds[2 * axis] = first ? bounds[2 * axis] : std::min(node.Bounds[2 * axis], bounds[2 * axis]);
+      node.Bounds[2 * axis + 1] = first ? bounds[2 * axis + 1] : std::max(node.Bounds[2 * axis + 1], bounds[2 * axis + 1]);
+      centerBounds[2 * axis] = first ? center : std::min(centerBounds[2 * axis], center);
+      centerBounds[2 * axis + 1] = first ? center : std::max(centerBounds[2 * axis + 1], center);
+      }
+    }
+  this->Nodes.push_back(node);
+  if (end - begin <= HierarchyLeafSize || centerBounds[0] > centerBounds[1])
+    {
+    this->LeafPositions.push_back(begin);
+    return nodeIndex;
+    }
+
+  int splitAxis = 0;
+  for (int axis = 1; axis < 3; ++axis)
+    {
+    if (centerBounds[2 * axis + 1] - centerBounds[2 * axis] > centerBounds[2 * splitAxis + 1] - centerBounds[2 * splitAxis])
+      {
+      splitAxis = axis;
+      }
+    }
+  if (centerBounds[2 * splitAxis + 1] <= centerBounds[2 * splitAxis])
+    {
+    // All polygons have the same center, the range cannot be split
+    this->LeafPositions.push_back(begin);
+    return nodeIndex;
+    }
+
+  vtkIdType middle = begin + (end - begin) / 2;
+  const double* bounds = cellBounds.data();
+  std::nth_element(this->CellOrder.begin() + begin, this->CellOrder.begin() + middle, this->CellOrder.begin() + end,
+    [bounds, splitAxis](vtkIdType cellId0, vtkIdType cellId1)
+    {
+      return bounds[6 * cellId0 + 2 * splitAxis] + bounds[6 * cellId0 + 2 * splitAxis + 1]
+        < bounds[6 * cellId1 + 2 * splitAxis] + bounds[6 * cellId1 + 2 * splitAxis + 1];
+    });
+  vtkIdType child0 = this->BuildNode(begin, middle, cellBounds);
+  vtkIdType child1 = this->BuildNode(middle, end, cellBounds);
+  this->Nodes[nodeIndex].Children[0] = child0;
+  this->Nodes[nodeIndex].Children[1] = child1;
+  this->Nodes[nodeIndex].LeafEnd = static_cast<vtkIdType>(this->LeafPositions.size());
+  return nodeIndex;
+}
+
+//----------------------------------------------------------------------------
+void vtkParallelPlaneClipper::vtkInternal::UpdateAttributeArrays(vtkPolyData* input)
+{
+  std::vector<vtkAbstractArray*> arrays;
+  std::vector<int> attributeIndices;
+  vtkDataSetAttributes* attributes[2] = { input->GetPointData(), input->GetCellData() };
+  for (vtkDataSetAttributes* data : attributes)
+    {
+    for (int i = 0; i < data->GetNumberOfArrays(); ++i)
+      {
+      arrays.push_back(data->GetAbstractArray(i));
+      }
+    int indices[vtkDataSetAttributes::NUM_ATTRIBUTES];
+    data->GetAttributeIndices(indices);
+    attributeIndices.insert(attributeIndices.end(), indices, indices + vtkDataSetAttributes::NUM_ATTRIBUTES);
+    }
+
+  bool modified = (arrays.size() != this->AttributeArrays.size() || attributeIndices != this->AttributeIndices);
+  for (size_t i = 0; i < arrays.size() && !modified; ++i)
+    {
+    modified = (this->AttributeArrays[i].GetPointer() != arrays[i] || this->AttributeArrayMTimes[i] != arrays[i]->GetMTime());
+    }
+  if (!modified)
+    {
+    return;
+    }
+
+  this->AttributeArrays.clear();
+  this->AttributeArrayMTimes.clear();
+  for (vtkAbstractArray* array : arrays)
+    {
+    this->AttributeArrays.push_back(array);
+    this->AttributeArrayMTimes.push_back(array->GetMTime());
+    }
+  this->AttributeIndices = attributeIndices;
+  this->OutputCaches[NegativeCell] = OutputCache();
+  this->OutputCaches[PositiveCell] = OutputCache();
+}
+
+//----------------------------------------------------------------------------
+void vtkParallelPlaneClipper::vtkInternal::ClassifyLeaves(const std::vector<PlaneCoefficients>& planes, bool useMinimum,
+  bool compareToPreviousPlanes, std::vector<LeafRange>* leafRanges, std::vector<vtkIdType>& candidateCellIds)
+{
+  if (this->Nodes.empty())
+    {
+    return;
+    }
+  compareToPreviousPlanes = compareToPreviousPlanes && !this->PreviousPlanes.empty();
+  std::vector<vtkIdType> nodeStack(1, 0);
+  while (!nodeStack.empty())
+    {
+    const Node& node = this->Nodes[nodeStack.back()];
+    nodeStack.pop_back();
+
+    unsigned char side = GetBoxSide(node.Bounds, planes, useMinimum, this->Tolerance);
+    if (side != CrossingCell)
+      {
+      if (leafRanges)
+        {
+        bool unchanged = compareToPreviousPlanes
+          && GetBoxSide(node.Bounds, this->PreviousPlanes, this->PreviousUseMinimum, this->Tolerance) == side;
+        AppendLeafRange(*leafRanges, LeafRange{ node.LeafBegin, node.LeafEnd, side, unchanged });
+        }
+      continue;
+      }
+
+    if (node.Children[0] < 0)
+      {
+      if (leafRanges)
+        {
+        leafRanges->push_back(LeafRange{ node.LeafBegin, node.LeafEnd, CrossingCell, false });
+        }
+      candidateCellIds.insert(candidateCellIds.end(), this->CellOrder.begin() + node.Begin, this->CellOrder.begin() + node.End);
+      }
+    else
+      {
+      nodeStack.push_back(node.Children[1]);
+      nodeStack.push_back(node.Children[0]);
+      }
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkParallelPlaneClipper::vtkInternal::UpdateOutput(const Crossings& crossings, const std::vector<LeafRange>& leafRanges,
+  unsigned char side, const std::vector<vtkIdType>& sideTriangles, vtkPolyData* output)
+{
+  OutputCache& cache = this->OutputCaches[side];
+  vtkPolyData* input = crossings.Input;
+  vtkIdType numberOfInputPoints = input->GetNumberOfPoints();
+  vtkIdType numberOfLeaves = static_cast<vtkIdType>(this->LeafPositions.size()) - 1;
+  bool incremental = cache.Valid;
+  if (!incremental)
+    {
+    cache.InputToOutputPointIds.assign(numberOfInputPoints, -1);
+    cache.OutputToInputPointIds.clear();
+    cache.PointUseCounts.clear();
+    }
+  const vtkIdType* previousOffsets = incremental ? cache.Offsets->GetPointer(0) : nullptr;
+  const vtkIdType* previousConnectivity = incremental ? cache.Connectivity->GetPointer(0) : nullptr;
+
+  // Output polygons are in leaf order. The output of the leaves that are not unchanged on this side is removed
+  // from the previous output, the polygons of the leaves that are now entirely on this side are copied from the
+  // ordered input and the polygons of the candidate leaves are passed or split.
+  std::vector<vtkIdType> leafCellOffsets(numberOfLeaves + 1, 0);
+  std::vector<OutputSegment> segments;
+  std::vector<CellRange> removedCellRanges;
+  std::vector<vtkIdType> newCellPositions;
+  std::vector<vtkIdType> newCellTriangleSlots;
+  vtkIdType numberOfOutputCells = 0;
+  vtkIdType candidateCell = 0;
+  vtkIdType crossingCell = 0;
+  for (const LeafRange& range : leafRanges)
+    {
+    bool unchanged = incremental && range.Unchanged && range.Side == side;
+    if (incremental && !unchanged)
+      {
+      AppendCellRange(removedCellRanges, cache.LeafCellOffsets[range.LeafBegin], cache.LeafCellOffsets[range.LeafEnd]);
+      }
+    vtkIdType firstCell = numberOfOutputCells;
+    if (range.Side == CrossingCell)
+      {
+      vtkIdType firstNewCell = static_cast<vtkIdType>(newCellPositions.size());
+      for (vtkIdType position = this->LeafPositions[range.LeafBegin]; position < this->LeafPositions[range.LeafEnd];
+        ++position, ++candidateCell)
+        {
+        unsigned char cellState = crossings.CellStates[candidateCell];
+        if (cellState == side)
+          {
+          newCellPositions.push_back(position);
+          newCellTriangleSlots.push_back(-1);
+          }
+        else if (cellState == CrossingCell)
+          {
+          for (vtkIdType slot = 2 * crossings.TriangleOffsets[crossingCell]; slot < 2 * crossings.TriangleOffsets[crossingCell + 1]; ++slot)
+            {
+            if (sideTriangles[3 * slot] >= 0)
+              {
+              newCellPositions.push_back(position);
+              newCellTriangleSlots.push_back(slot);
+              }
+            }
+          ++crossingCell;
+          }
+        }
+      // Candidate ranges contain a single leaf
+      leafCellOffsets[range.LeafBegin] = firstCell;
+      numberOfOutputCells += static_cast<vtkIdType>(newCellPositions.size()) - firstNewCell;
+      AppendOutputSegment(segments, OutputSegment::NewCells, firstCell, numberOfOutputCells - firstCell, firstNewCell);
+      }
+    else if (unchanged)
+      {
+      vtkIdType previousCellBegin = cache.LeafCellOffsets[range.LeafBegin];
+      for (vtkIdType leaf = range.LeafBegin; leaf < range.LeafEnd; ++leaf)
+        {
+        leafCellOffsets[leaf] = cache.LeafCellOffsets[leaf] - previousCellBegin + firstCell;
+        }
+      numberOfOutputCells += cache.LeafCellOffsets[range.LeafEnd] - previousCellBegin;
+      AppendOutputSegment(segments, OutputSegment::PreviousOutput, firstCell, numberOfOutputCells - firstCell, previousCellBegin);
+      }
+    else if (range.Side == side)
+      {
+      vtkIdType positionBegin = this->LeafPositions[range.LeafBegin];
+      for (vtkIdType leaf = range.LeafBegin; leaf < range.LeafEnd; ++leaf)
+        {
+        leafCellOffsets[leaf] = this->LeafPositions[leaf] - positionBegin + firstCell;
+        }
+      numberOfOutputCells += this->LeafPositions[range.LeafEnd] - positionBegin;
+      AppendOutputSegment(segments, OutputSegment::OrderedInput, firstCell, numberOfOutputCells - firstCell, positionBegin);
+      }
+    else
+      {
+      std::fill(leafCellOffsets.begin() + range.LeafBegin, leafCellOffsets.begin() + range.LeafEnd, firstCell);
+      }
+    }
+  leafCellOffsets[numberOfLeaves] = numberOfOutputCells;
+
+  vtkIdType numberOfNewCells = static_cast<vtkIdType>(newCellPositions.size());
+  std::vector<vtkIdType> newCellConnectivityOffsets(numberOfNewCells + 1, 0);
+  for (vtkIdType newCell = 0; newCell < numberOfNewCells; ++newCell)
+    {
+    vtkIdType position = newCellPositions[newCell];
+    vtkIdType cellSize = (newCellTriangleSlots[newCell] < 0 ? this->OrderedOffsets[position + 1] - this->OrderedOffsets[position] : 3);
+    newCellConnectivityOffsets[newCell + 1] = newCellConnectivityOffsets[newCell] + cellSize;
+    }
+  const vtkIdType* sourceOffsets[3] = { previousOffsets, this->OrderedOffsets.data(), newCellConnectivityOffsets.data() };
+  vtkIdType numberOfConnectivityValues = 0;
+  for (OutputSegment& segment : segments)
+    {
+    segment.ConnectivityBegin = numberOfConnectivityValues;
+    const vtkIdType* offsets = sourceOffsets[segment.SourceType];
+    numberOfConnectivityValues += offsets[segment.SourceBegin + segment.OutputCellEnd - segment.OutputCellBegin] - offsets[segment.SourceBegin];
+    }
+
+  // Release the points of the removed polygons, points that are no longer used get a use count of zero
+  std::vector<vtkIdType>& pointUseCounts = cache.PointUseCounts;
+  std::vector<vtkIdType> releasedPointIds;
+  for (const CellRange& range : removedCellRanges)
+    {
+    for (vtkIdType i = previousOffsets[range.Begin]; i < previousOffsets[range.End]; ++i)
+      {
+      if (--pointUseCounts[previousConnectivity[i]] == 0)
+        {
+        releasedPointIds.push_back(previousConnectivity[i]);
+        }
+      }
+    }
+
+  // Points of the added polygons that are not in the output yet are collected in first use order. Until they get an
+  // output point id, their map entry is -2 - (index in the list of added points).
+  std::vector<vtkIdType>& inputToOutputPointIds = cache.InputToOutputPointIds;
+  std::vector<vtkIdType> edgeOutputPointIds(crossings.NewPoints->GetNumberOfPoints(), -1);
+  std::vector<vtkIdType> addedCombinedPointIds;
+  std::vector<vtkIdType> addedPointUseCounts;
+  auto addPointUse = [&](vtkIdType combinedPointId)
+    {
+    vtkIdType& outputPointId = (combinedPointId < numberOfInputPoints ? inputToOutputPointIds[combinedPointId]
+      : edgeOutputPointIds[combinedPointId - numberOfInputPoints]);
+    if (outputPointId >= 0)
+      {
+      ++pointUseCounts[outputPointId];
+      }
+    else if (outputPointId == -1)
+      {
+      outputPointId = -2 - static_cast<vtkIdType>(addedCombinedPointIds.size());
+      addedCombinedPointIds.push_back(combinedPointId);
+      addedPointUseCounts.push_back(1);
+      }
+    else
+      {
+      ++addedPointUseCounts[-2 - outputPointId];
+      }
+    };
+  for (const OutputSegment& segment : segments)
+    {
+    if (segment.SourceType == OutputSegment::OrderedInput)
+      {
+      vtkIdType positionEnd = segment.SourceBegin + segment.OutputCellEnd - segment.OutputCellBegin;
+      for (vtkIdType i = this->OrderedOffsets[segment.SourceBegin]; i < this->OrderedOffsets[positionEnd]; ++i)
+        {
+        addPointUse(this->OrderedConnectivity[i]);
+        }
+      }
+    }
+  for (vtkIdType newCell = 0; newCell < numberOfNewCells; ++newCell)
+    {
+    vtkIdType slot = newCellTriangleSlots[newCell];
+    if (slot >= 0)
+      {
+      for (int i = 0; i < 3; ++i)
+        {
+        addPointUse(sideTriangles[3 * slot + i]);
+        }
+      continue;
+      }
+    vtkIdType position = newCellPositions[newCell];
+    for (vtkIdType i = this->OrderedOffsets[position]; i < this->OrderedOffsets[position + 1]; ++i)
+      {
+      addPointUse(this->OrderedConnectivity[i]);
+      }
+    }
+
+  std::vector<vtkIdType>& outputToInputPointIds = cache.OutputToInputPointIds;
+  std::vector<vtkIdType> freePointIds;
+  for (vtkIdType pointId : releasedPointIds)
+    {
+    if (pointUseCounts[pointId] == 0)
+      {
+      freePointIds.push_back(pointId);
+      if (outputToInputPointIds[pointId] >= 0)
+        {
+        inputToOutputPointIds[outputToInputPointIds[pointId]] = -1;
+        }
+      }
+    }
+  std::sort(freePointIds.begin(), freePointIds.end());
+
+  // Added points fill the free point ids first. If there are more free point ids than added points, the points at
+  // the end of the previous output are moved into the remaining free point ids below the new number of points.
+  vtkIdType numberOfPreviousPoints = static_cast<vtkIdType>(outputToInputPointIds.size());
+  vtkIdType numberOfAddedPoints = static_cast<vtkIdType>(addedCombinedPointIds.size());
+  vtkIdType numberOfFreePoints = static_cast<vtkIdType>(freePointIds.size());
+  vtkIdType numberOfOutputPoints = numberOfPreviousPoints - numberOfFreePoints + numberOfAddedPoints;
+  std::vector<vtkIdType> addedOutputPointIds(numberOfAddedPoints);
+  for (vtkIdType i = 0; i < numberOfAddedPoints; ++i)
+    {
+    addedOutputPointIds[i] = (i < numberOfFreePoints ? freePointIds[i] : numberOfPreviousPoints + i - numberOfFreePoints);
+    }
+  vtkNew<vtkIdList> movedFromPointIds;
+  vtkNew<vtkIdList> movedToPointIds;
+  std::vector<vtkIdType> movedPointIds(std::max<vtkIdType>(numberOfPreviousPoints - numberOfOutputPoints, 0), -1);
+  std::vector<vtkIdType>::const_iterator freePointIt = freePointIds.begin() + std::min(numberOfAddedPoints, numberOfFreePoints);
+  for (vtkIdType pointId = numberOfOutputPoints; pointId < numberOfPreviousPoints; ++pointId)
+    {
+    if (pointUseCounts[pointId] == 0)
+      {
+      continue;
+      }
+    movedPointIds[pointId - numberOfOutputPoints] = *freePointIt;
+    movedFromPointIds->InsertNextId(pointId);
+    movedToPointIds->InsertNextId(*freePointIt);
+    ++freePointIt;
+    }
+
+  pointUseCounts.resize(std::max(numberOfPreviousPoints, numberOfOutputPoints));
+  outputToInputPointIds.resize(pointUseCounts.size());
+  for (vtkIdType i = 0; i < movedFromPointIds->GetNumberOfIds(); ++i)
+    {
+    vtkIdType fromPointId = movedFromPointIds->GetId(i);
+    vtkIdType toPointId = movedToPointIds->GetId(i);
+    pointUseCounts[toPointId] = pointUseCounts[fromPointId];
+    outputToInputPointIds[toPointId] = outputToInputPointIds[fromPointId];
+    if (outputToInputPointIds[toPointId] >= 0)
+      {
+      inputToOutputPointIds[outputToInputPointIds[toPointId]] = toPointId;
+      }
+    }
+  for (vtkIdType i = 0; i < numberOfAddedPoints; ++i)
+    {
+    vtkIdType combinedPointId = addedCombinedPointIds[i];
+    vtkIdType outputPointId = addedOutputPointIds[i];
+    pointUseCounts[outputPointId] = addedPointUseCounts[i];
+    if (combinedPointId < numberOfInputPoints)
+      {
+      outputToInputPointIds[outputPointId] = combinedPointId;
+      inputToOutputPointIds[combinedPointId] = outputPointId;
+      }
+    else
+      {
+      outputToInputPointIds[outputPointId] = -1;
+      edgeOutputPointIds[combinedPointId - numberOfInputPoints] = outputPointId;
+      }
+    }
+  pointUseCounts.resize(numberOfOutputPoints);
+  outputToInputPointIds.resize(numberOfOutputPoints);
+
+  vtkNew<vtkIdTypeArray> outputOffsets;
+  outputOffsets->SetNumberOfValues(numberOfOutputCells + 1);
+  outputOffsets->SetValue(numberOfOutputCells, numberOfConnectivityValues);
+  vtkNew<vtkIdTypeArray> outputConnectivity;
+  outputConnectivity->SetNumberOfValues(numberOfConnectivityValues);
+  WriteOutputCellsWorker writeOutputCellsWorker;
+  writeOutputCellsWorker.Segments = &segments;
+  writeOutputCellsWorker.PreviousOffsets = previousOffsets;
+  writeOutputCellsWorker.PreviousConnectivity = previousConnectivity;
+  writeOutputCellsWorker.NumberOfOutputPoints = numberOfOutputPoints;
+  writeOutputCellsWorker.MovedPointIds = movedPointIds.data();
+  writeOutputCellsWorker.OrderedOffsets = this->OrderedOffsets.data();
+  writeOutputCellsWorker.OrderedConnectivity = this->OrderedConnectivity.data();
+  writeOutputCellsWorker.NewCellPositions = newCellPositions.data();
+  writeOutputCellsWorker.NewCellTriangleSlots = newCellTriangleSlots.data();
+  writeOutputCellsWorker.NewCellConnectivityOffsets = newCellConnectivityOffsets.data();
+  writeOutputCellsWorker.SideTriangles = sideTriangles.data();
+  writeOutputCellsWorker.NumberOfInputPoints = numberOfInputPoints;
+  writeOutputCellsWorker.InputToOutputPointIds = inputToOutputPointIds.data();
+  writeOutputCellsWorker.EdgeOutputPointIds = edgeOutputPointIds.data();
+  writeOutputCellsWorker.Offsets = outputOffsets->GetPointer(0);
+  writeOutputCellsWorker.Connectivity = outputConnectivity->GetPointer(0);
+  vtkSMPTools::For(0, numberOfOutputCells, writeOutputCellsWorker);
+  vtkNew<vtkCellArray> outputPolys;
+  outputPolys->SetData(outputOffsets, outputConnectivity);
+  output->SetPolys(outputPolys);
+
+  // Points and point data that are kept are copied from the previous output as a block
+  vtkIdType numberOfKeptPoints = std::min(numberOfPreviousPoints, numberOfOutputPoints);
+  vtkPoints* previousPoints = incremental ? cache.Output->GetPoints() : nullptr;
+  vtkNew<vtkPoints> outputPoints;
+  outputPoints->SetDataType(input->GetPoints()->GetDataType());
+  outputPoints->SetNumberOfPoints(numberOfOutputPoints);
+  if (previousPoints && numberOfKeptPoints > 0)
+    {
+    outputPoints->GetData()->InsertTuples(0, numberOfKeptPoints, 0, previousPoints->GetData());
+    }
+  for (vtkIdType i = 0; i < movedFromPointIds->GetNumberOfIds(); ++i)
+    {
+    outputPoints->SetPoint(movedToPointIds->GetId(i), previousPoints->GetPoint(movedFromPointIds->GetId(i)));
+    }
+  CopyOutputPointsWorker copyOutputPointsWorker;
+  copyOutputPointsWorker.InputPoints = input->GetPoints();
+  copyOutputPointsWorker.NewPoints = crossings.NewPoints;
+  copyOutputPointsWorker.NumberOfInputPoints = numberOfInputPoints;
+  copyOutputPointsWorker.OutputToCombinedPointIds = addedCombinedPointIds.data();
+  copyOutputPointsWorker.OutputPointIds = addedOutputPointIds.data();
+  copyOutputPointsWorker.OutputPoints = outputPoints;
+  vtkSMPTools::For(0, numberOfAddedPoints, copyOutputPointsWorker);
+  output->SetPoints(outputPoints);
+
+  // Point data of added input points is copied, point data of new points is interpolated along the crossing edge
+  vtkPointData* inputPointData = input->GetPointData();
+  vtkPointData* outputPointData = output->GetPointData();
+  vtkPointData* previousPointData = incremental ? cache.Output->GetPointData() : nullptr;
+  outputPointData->InterpolateAllocate(inputPointData, numberOfOutputPoints);
+  for (int arrayIndex = 0; previousPointData && arrayIndex < outputPointData->GetNumberOfArrays(); ++arrayIndex)
+    {
+    vtkAbstractArray* outputArray = outputPointData->GetAbstractArray(arrayIndex);
+    vtkAbstractArray* previousArray = previousPointData->GetAbstractArray(arrayIndex);
+    if (numberOfKeptPoints > 0)
+      {
+      outputArray->InsertTuples(0, numberOfKeptPoints, 0, previousArray);
+      }
+    outputArray->InsertTuples(movedToPointIds, movedFromPointIds, previousArray);
+    }
+  vtkNew<vtkIdList> fromIds;
+  vtkNew<vtkIdList> toIds;
+  for (vtkIdType i = 0; i < numberOfAddedPoints; ++i)
+    {
+    vtkIdType combinedPointId = addedCombinedPointIds[i];
+    if (combinedPointId < numberOfInputPoints)
+      {
+      fromIds->InsertNextId(combinedPointId);
+      toIds->InsertNextId(addedOutputPointIds[i]);
+      continue;
+      }
+    vtkIdType newPointId = combinedPointId - numberOfInputPoints;
+    const CrossingEdge& edge = crossings.UniqueEdges[crossings.NewPointEdgeIndices[newPointId]];
+    outputPointData->InterpolateEdge(inputPointData, addedOutputPointIds[i], edge.Point0, edge.Point1,
+      crossings.EdgeParameters[newPointId]);
+    }
+  outputPointData->CopyData(inputPointData, fromIds, toIds);
+
+  // Cell data of unchanged segments is copied from the previous output as blocks
+  vtkCellData* inputCellData = input->GetCellData();
+  vtkCellData* outputCellData = output->GetCellData();
+  vtkCellData* previousCellData = incremental ? cache.Output->GetCellData() : nullptr;
+  outputCellData->CopyAllocate(inputCellData, numberOfOutputCells);
+  fromIds->Reset();
+  toIds->Reset();
+  for (const OutputSegment& segment : segments)
+    {
+    vtkIdType numberOfSegmentCells = segment.OutputCellEnd - segment.OutputCellBegin;
+    if (segment.SourceType == OutputSegment::PreviousOutput)
+      {
+      for (int arrayIndex = 0; arrayIndex < outputCellData->GetNumberOfArrays(); ++arrayIndex)
+        {
+        outputCellData->GetAbstractArray(arrayIndex)->InsertTuples(segment.OutputCellBegin, numberOfSegmentCells, segment.SourceBegin,
+          previousCellData->GetAbstractArray(arrayIndex));
+        }
+      continue;
+      }
+    for (vtkIdType i = 0; i < numberOfSegmentCells; ++i)
+      {
+      vtkIdType source = segment.SourceBegin + i;
+      fromIds->InsertNextId(this->CellOrder[segment.SourceType == OutputSegment::OrderedInput ? source : newCellPositions[source]]);
+      toIds->InsertNextId(segment.OutputCellBegin + i);
+      }
+    }
+  outputCellData->CopyData(inputCellData, fromIds, toIds);
+
+  cache.Output = vtkSmartPointer<vtkPolyData>::New();
+  cache.Output->ShallowCopy(output);
+  cache.Offsets = outputOffsets.GetPointer();
+  cache.Connectivity = outputConnectivity.GetPointer();
+  cache.LeafCellOffsets.swap(leafCellOffsets);
+  cache.Valid = true;
+}
+
+//----------------------------------------------------------------------------
+void vtkParallelPlaneClipper::vtkInternal::ComputeCellPointScalars(vtkPolyData* input, const std::vector<PlaneCoefficients>& planes,
+  bool useMinimum, const std::vector<vtkIdType>& cellIds, std::vector<double>& scalars)
+{
+  vtkCellArray* polys = input->GetPolys();
+  vtkIdType numberOfCells = static_cast<vtkIdType>(cellIds.size());
+  std::vector<vtkIdType> offsets(1, 0);
+  offsets.reserve(numberOfCells + 1);
+  for (vtkIdType cellId : cellIds)
+    {
+    offsets.push_back(offsets.back() + polys->GetCellSize(cellId));
+    }
+  std::vector<vtkIdType> pointIds(offsets.back());
+  CopyPassedCellsWorker copyPointIdsWorker;
+  copyPointIdsWorker.Polys = polys;
+  copyPointIdsWorker.PassedCellIds = cellIds.data();
+  copyPointIdsWorker.OutputOffsets = offsets.data();
+  copyPointIdsWorker.OutputConnectivity = pointIds.data();
+  vtkSMPTools::For(0, numberOfCells, copyPointIdsWorker);
+  vtkSMPTools::Sort(pointIds.begin(), pointIds.end());
+  pointIds.erase(std::unique(pointIds.begin(), pointIds.end()), pointIds.end());
+
+  if (static_cast<vtkIdType>(scalars.size()) < input->GetNumberOfPoints())
+    {
+    scalars.resize(input->GetNumberOfPoints());
+    }
+  ComputePointListScalarsWorker computeScalarsWorker{ input->GetPoints(), &planes, useMinimum, pointIds.data(), scalars.data() };
+  vtkSMPTools::For(0, static_cast<vtkIdType>(pointIds.size()), computeScalarsWorker);
+}
+
+//----------------------------------------------------------------------------
+vtkParallelPlaneClipper::vtkParallelPlaneClipper()
+{
+  this->SetNumberOfOutputPorts(2);
+  this->ClipPlanes = vtkSmartPointer<vtkPlaneCollection>::New();
+  this->Internal = new vtkInternal();
+}
+
+//----------------------------------------------------------------------------
+vtkParallelPlaneClipper::~vtkParallelPlaneClipper()
+{
+  delete this->Internal;
+}
+
+//----------------------------------------------------------------------------
+void vtkParallelPlaneClipper::SetClipPlanes(vtkPlaneCollection* planes)
+{
+  if (this->ClipPlanes == planes)
+    {
+    return;
+    }
+  this->ClipPlanes = planes;
+  this->Modified();
+}
+
+//----------------------------------------------------------------------------
+vtkPlaneCollection* vtkParallelPlaneClipper::GetClipPlanes()
+{
+  return this->ClipPlanes;
+}
+
+//----------------------------------------------------------------------------
+vtkPolyData* vtkParallelPlaneClipper::GetClippedOutput()
+{
+  return vtkPolyData::SafeDownCast(this->GetOutputDataObject(1));
+}
+
+//----------------------------------------------------------------------------
+vtkPolyData* vtkParallelPlaneClipper::GetCutContour(int planeIndex)
+{
+  if (planeIndex < 0 || planeIndex >= static_cast<int>(this->CutContours.size()))
+    {
+    return nullptr;
+    }
+  return this->CutContours[planeIndex];
+}
+
+//----------------------------------------------------------------------------
+vtkMTimeType vtkParallelPlaneClipper::GetMTime()
+{
+  vtkMTimeType mTime = this->Superclass::GetMTime();
+  if (this->ClipPlanes)
+    {
+    mTime = std::max(mTime, this->ClipPlanes->GetMTime());
+    for (int i = 0; i < this->ClipPlanes->GetNumberOfItems(); ++i)
+      {
+      mTime = std::max(mTime, this->ClipPlanes->GetItem(i)->GetMTime());
+      }
+    }
+  return mTime;
+}
+
+//----------------------------------------------------------------------------
+void vtkParallelPlaneClipper::ClipWithImplicitFunction(vtkPolyData* input, vtkPolyData* output, vtkPolyData* clippedOutput)
+{
+  vtkNew<vtkImplicitBoolean> clipFunction;
+  clipFunction->SetOperationType(this->OperationType);
+  for (int i = 0; this->ClipPlanes && i < this->ClipPlanes->GetNumberOfItems(); ++i)
+    {
+    clipFunction->AddFunction(this->ClipPlanes->GetItem(i));
+    }
+  vtkNew<vtkClipPolyData> clipper;
+  clipper->SetInputData(input);
+  clipper->SetClipFunction(clipFunction);
+  clipper->SetValue(0.0);
+  clipper->SetGenerateClippedOutput(this->GenerateClippedOutput);
+  clipper->Update();
+  output->ShallowCopy(clipper->GetOutput());
+  if (this->GenerateClippedOutput)
+    {
+    clippedOutput->ShallowCopy(clipper->GetClippedOutput());
+    }
+
+  for (size_t i = 0; i < this->CutContours.size(); ++i)
+    {
+    vtkNew<vtkCutter> cutter;
+    cutter->SetInputData(input);
+    cutter->SetCutFunction(this->ClipPlanes->GetItem(static_cast<int>(i)));
+    cutter->Update();
+    this->CutContours[i]->ShallowCopy(cutter->GetOutput());
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkParallelPlaneClipper::ExtractPlaneBorder(vtkPolyData* input, vtkPlane* plane, vtkPolyData* polylines)
+{
+  if (!polylines)
+    {
+    return;
+    }
+  polylines->Initialize();
+  if (!input || !plane || !input->GetPoints() || input->GetNumberOfPolys() < 1)
+    {
+    return;
+    }
+  if (input->GetNumberOfStrips() > 0)
+    {
+    vtkNew<vtkExtractPolyDataGeometry> extractor;
+    extractor->SetInputData(input);
+    extractor->SetImplicitFunction(plane);
+    extractor->ExtractInsideOff();
+    extractor->ExtractBoundaryCellsOff();
+    vtkNew<vtkFeatureEdges> boundaryEdges;
+    boundaryEdges->SetInputConnection(extractor->GetOutputPort());
+    boundaryEdges->BoundaryEdgesOn();
+    boundaryEdges->FeatureEdgesOff();
+    boundaryEdges->NonManifoldEdgesOff();
+    boundaryEdges->ManifoldEdgesOff();
+    vtkNew<vtkStripper> stripper;
+    stripper->SetInputConnection(boundaryEdges->GetOutputPort());
+    stripper->Update();
+    polylines->SetPoints(stripper->GetOutput()->GetPoints());
+    polylines->SetLines(stripper->GetOutput()->GetLines());
+    return;
+    }
+
+  double normal[3] = { 0.0, 0.0, 1.0 };
+  double origin[3] = { 0.0, 0.0, 0.0 };
+  plane->GetNormal(normal);
+  plane->GetOrigin(origin);
+  std::vector<PlaneCoefficients> planes(1, PlaneCoefficients{ normal[0], normal[1], normal[2], -vtkMath::Dot(normal, origin) });
+  std::vector<double> scalars;
+  ComputeAllPointScalars(input->GetPoints(), planes, true, scalars);
+
+  // Edges between a positive polygon and a crossing polygon have both end points on the positive side.
+  // Such an edge is used by exactly one crossing polygon, edges used by two crossing polygons are inside
+  // the crossing strip. Negative polygons have no positive points, so only crossing polygons are visited.
+  vtkCellArray* inputPolys = input->GetPolys();
+  vtkIdType numberOfPolys = inputPolys->GetNumberOfCells();
+  std::vector<unsigned char> cellStates(numberOfPolys);
+  ClassifyCellsWorker classifyCellsWorker;
+  classifyCellsWorker.Polys = inputPolys;
+  classifyCellsWorker.Scalars = scalars.data();
+  classifyCellsWorker.CellStates = cellStates.data();
+  vtkSMPTools::For(0, numberOfPolys, classifyCellsWorker);
+
+  std::vector<vtkIdType> crossingCellIds;
+  std::vector<vtkIdType> edgeOffsets(1, 0);
+  for (vtkIdType cellId = 0; cellId < numberOfPolys; ++cellId)
+    {
+    if (cellStates[cellId] == CrossingCell)
+      {
+      crossingCellIds.push_back(cellId);
+      edgeOffsets.push_back(edgeOffsets.back() + inputPolys->GetCellSize(cellId));
+      }
+    }
+  std::vector<CrossingEdge> edges(edgeOffsets.back());
+  CollectPositiveEdgesWorker collectPositiveEdgesWorker;
+  collectPositiveEdgesWorker.Polys = inputPolys;
+  collectPositiveEdgesWorker.Scalars = scalars.data();
+  collectPositiveEdgesWorker.CrossingCellIds = crossingCellIds.data();
+  collectPositiveEdgesWorker.EdgeOffsets = edgeOffsets.data();
+  collectPositiveEdgesWorker.Edges = edges.data();
+  vtkSMPTools::For(0, static_cast<vtkIdType>(crossingCellIds.size()), collectPositiveEdgesWorker);
+  vtkSMPTools::Sort(edges.begin(), edges.end());
+
+  std::vector<vtkIdType> segments;
+  for (size_t i = 0; i < edges.size(); )
+    {
+    size_t next = i + 1;
+    while (next < edges.size() && edges[next] == edges[i])
+      {
+      ++next;
+      }
+    if (edges[i].Point0 >= 0 && next - i == 1)
+      {
+      segments.push_back(edges[i].Point0);
+      segments.push_back(edges[i].Point1);
+      }
+    i = next;
+    }
+  BuildPolylines(input->GetPoints(), segments, polylines);
+}
+
+//----------------------------------------------------------------------------
+int vtkParallelPlaneClipper::RequestData(vtkInformation* vtkNotUsed(request),
+  vtkInformationVector** inputVector, vtkInformationVector* outputVector)
+{
+  vtkPolyData* input = vtkPolyData::GetData(inputVector[0], 0);
+  vtkPolyData* output = vtkPolyData::GetData(outputVector, 0);
+  vtkPolyData* clippedOutput = vtkPolyData::GetData(outputVector, 1);
+
+  int numberOfPlanes = this->ClipPlanes ? this->ClipPlanes->GetNumberOfItems() : 0;
+  this->CutContours.clear();
+  for (int i = 0; this->GenerateCutContours && i < numberOfPlanes; ++i)
+    {
+    this->CutContours.push_back(vtkSmartPointer<vtkPolyData>::New());
+    }
+
+  vtkPoints* inputPoints = input->GetPoints();
+  vtkCellArray* inputPolys = input->GetPolys();
+  if (!inputPoints || !inputPolys || input->GetNumberOfCells() < 1)
+    {
+    return 1;
+    }
+  if (input->GetNumberOfVerts() > 0 || input->GetNumberOfLines() > 0 || input->GetNumberOfStrips() > 0)
+    {
+    vtkDebugMacro("RequestData: Input contains vertices, lines or strips, clipping with vtkClipPolyData");
+    this->ClipWithImplicitFunction(input, output, clippedOutput);
+    return 1;
+    }
+
+  // Plane equations of the combined function, difference is the intersection with the inverted planes.
+  std::vector<PlaneCoefficients> planes;
+  for (int i = 0; this->ClipPlanes && i < this->ClipPlanes->GetNumberOfItems(); ++i)
+    {
+    vtkPlane* plane = this->ClipPlanes->GetItem(i);
+    double normal[3] = { 0.0, 0.0, 1.0 };
+    double origin[3] = { 0.0, 0.0, 0.0 };
+    plane->GetNormal(normal);
+    plane->GetOrigin(origin);
+    double sign = (this->OperationType == Difference && i > 0) ? -1.0 : 1.0;
+    planes.push_back(PlaneCoefficients{ sign * normal[0], sign * normal[1], sign * normal[2], -sign * vtkMath::Dot(normal, origin) });
+    }
+  if (planes.empty())
+    {
+    // Same as vtkImplicitBoolean without functions, all points are on the positive side
+    output->ShallowCopy(input);
+    return 1;
+    }
+
+  // With the bounding volume hierarchy, polygons of nodes that are entirely on one side are passed without
+  // accessing their points, scalars are only computed for the points of the polygons of the other nodes.
+  bool useMinimum = (this->OperationType == Union);
+  bool useHierarchy = this->UseBoundingVolumeHierarchy;
+  std::vector<LeafRange> leafRanges;
+  std::vector<vtkIdType> candidateCellIds;
+  std::vector<double> scalars;
+  if (useHierarchy)
+    {
+    this->Internal->UpdateHierarchy(input);
+    this->Internal->UpdateAttributeArrays(input);
+    this->Internal->ClassifyLeaves(planes, useMinimum, true, &leafRanges, candidateCellIds);
+    vtkInternal::ComputeCellPointScalars(input, planes, useMinimum, candidateCellIds, this->Internal->Scalars);
+    }
+  else
+    {
+    if (!this->Internal->Nodes.empty())
+      {
+      // Release the hierarchy and the stored outputs, their size is in the order of the input mesh
+      *this->Internal = vtkInternal();
+      }
+    ComputeAllPointScalars(inputPoints, planes, useMinimum, scalars);
+    }
+  this->UpdateProgress(0.2);
+  if (this->GetAbortExecute())
+    {
+    return 1;
+    }
+
+  Crossings crossings;
+  ComputeCrossings(input, useHierarchy ? this->Internal->Scalars.data() : scalars.data(), useHierarchy ? &candidateCellIds : nullptr,
+    crossings);
+  vtkIdType numberOfCrossingCells = static_cast<vtkIdType>(crossings.CrossingCellIds.size());
+  vtkIdType numberOfTriangles = crossings.GetNumberOfTriangles();
+  this->UpdateProgress(0.4);
+  if (this->GetAbortExecute())
+    {
+    return 1;
+    }
+
+  // Both sides of the crossing polygons are computed at once. The segments of the split triangles are the border
+  // of the clipped surface, the cut contours are created from them.
+  std::vector<vtkIdType> positiveTriangles(6 * numberOfTriangles);
+  std::vector<vtkIdType> negativeTriangles(6 * numberOfTriangles);
+  std::vector<vtkIdType> segments(this->GenerateCutContours ? 2 * numberOfTriangles : 0);
+  SplitCrossingCellsWorker splitCrossingCellsWorker;
+  crossings.InitializeSplitCrossingCellsWorker(splitCrossingCellsWorker);
+  splitCrossingCellsWorker.PositiveTriangles = positiveTriangles.data();
+  splitCrossingCellsWorker.NegativeTriangles = negativeTriangles.data();
+  splitCrossingCellsWorker.Segments = this->GenerateCutContours ? segments.data() : nullptr;
+  vtkSMPTools::For(0, numberOfCrossingCells, splitCrossingCellsWorker);
+  this->UpdateProgress(0.6);
+  if (this->GetAbortExecute())
+    {
+    return 1;
+    }
+
+  if (useHierarchy)
+    {
+    // The stored outputs are updated with the leaves that are in the volume swept by the planes since the last run
+    this->Internal->UpdateOutput(crossings, leafRanges, PositiveCell, positiveTriangles, output);
+    this->UpdateProgress(0.8);
+    if (this->GenerateClippedOutput && !this->GetAbortExecute())
+      {
+      this->Internal->UpdateOutput(crossings, leafRanges, NegativeCell, negativeTriangles, clippedOutput);
+      }
+    else
+      {
+      this->Internal->OutputCaches[NegativeCell] = OutputCache();
+      }
+    this->Internal->PreviousPlanes = planes;
+    this->Internal->PreviousUseMinimum = useMinimum;
+    }
+  else
+    {
+    std::vector<vtkIdType> positiveCellIds;
+    AppendPassedCells(crossings, PositiveCell, positiveCellIds);
+    BuildOutput(crossings, positiveCellIds, positiveTriangles, output);
+    this->UpdateProgress(0.8);
+    if (this->GenerateClippedOutput && !this->GetAbortExecute())
+      {
+      std::vector<vtkIdType> negativeCellIds;
+      AppendPassedCells(crossings, NegativeCell, negativeCellIds);
+      BuildOutput(crossings, negativeCellIds, negativeTriangles, clippedOutput);
+      }
+    }
+
+  if (this->GenerateCutContours && !this->GetAbortExecute())
+    {
+    BuildCutContours(crossings, segments, planes, useMinimum, this->CutContours);
+    }
+
+  vtkDebugMacro("Split " << numberOfCrossingCells << " of " << input->GetNumberOfPolys() << " polygons ("
+    << (useHierarchy ? static_cast<vtkIdType>(candidateCellIds.size()) : input->GetNumberOfPolys()) << " classified), created "
+    << crossings.NewPoints->GetNumberOfPoints() << " points");
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+void vtkParallelPlaneClipper::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+  os << indent << "NumberOfClipPlanes: " << (this->ClipPlanes ? this->ClipPlanes->GetNumberOfItems() : 0) << std::endl;
+  os << indent << "OperationType: " << this->OperationType << std::endl;
+  os << indent << "GenerateClippedOutput: " << (this->GenerateClippedOutput ? "On" : "Off") << std::endl;
+  os << indent << "GenerateCutContours: " << (this->GenerateCutContours ? "On" : "Off") << std::endl;
+  os << indent << "UseBoundingVolumeHierarchy: " << (this->UseBoundingVolumeHierarchy ? "On" : "Off") << std::endl;
+}
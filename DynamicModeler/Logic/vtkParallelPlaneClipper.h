@@ -0,0 +1,161 @@
+/*==============================================================================
+
+  Copyright (c) Laboratory for Percutaneous Surgery (PerkLab)
+  Queen's University, Kingston, ON, Canada. All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.cjyx.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+  This file was originally developed by Kyle Sunderland, PerkLab, Queen's University
+  and was supported through CANARIE's Research Software Program, Cancer
+  Care Ontario, OpenAnatomy, and Brigham and Women's Hospital through NIH grant R01MH112748.
+
+==============================================================================*/
+
+#ifndef vtkParallelPlaneClipper_h
+#define vtkParallelPlaneClipper_h
+
+#include "vtkCjyxDynamicModelerModuleLogicExport.h"
+
+// VTK includes
+#include <vtkPolyDataAlgorithm.h>
+#include <vtkSmartPointer.h>
+
+// STD includes
+#include <vector>
+
+class vtkPlane;
+class vtkPlaneCollection;
+
+/// \brief Clip polygonal meshes with a set of planes.
+///
+/// Replacement for vtkClipPolyData with a vtkImplicitBoolean of planes as clip function, for meshes that only
+/// contain polygons. The planes are combined the same way as in vtkImplicitBoolean (union, intersection or
+/// difference) and the output contains the part of the mesh where the combined function is positive
+/// (on the side of the plane normals), the clipped output contains the rest.
+///
+/// The signed distance of each point is computed in parallel, one plane at a time over blocks of points.
+/// Polygons that are entirely on one side are passed to the output by index, only the polygons that
+/// cross the zero level are split (in parallel). Points created on crossing edges are shared between the
+/// neighbor polygons and between the two outputs, so both outputs are generated in a single pass.
+/// Crossing polygons are split into triangles, using a fan triangulation of non-triangle polygons.
+///
+/// Optionally, the border of the end cap on each plane is generated as line segments (cut contours), which can be
+/// used for creating end caps without cutting the mesh again. The contours are made of the segments of the split
+/// triangles, each segment goes to the plane that determines the combined function there, so the time spent is
+/// proportional to the length of the cut. With several planes, the contours are closed along the intersection
+/// lines of the planes.
+///
+/// For clipping small parts of large meshes (for example with a small box), a bounding volume hierarchy of the
+/// polygons can be used. Nodes of the hierarchy that are entirely on one side of the combined planes are passed
+/// to the output without evaluating their points, so only the polygons near the planes are processed. The hierarchy
+/// is built on the first run and reused until the points or polygons of the input are modified.
+/// With the hierarchy, the outputs of the last run are stored with the range of output polygons of each leaf node,
+/// and the next run only updates the leaves in the volume swept by the planes: leaves that are on the same side with
+/// the previous and the current planes are copied from the previous output, leaves that are now entirely on one side
+/// are copied from a copy of the polygons in hierarchy order, and only the polygons of the leaves near the planes are
+/// classified and split. The previous output arrays are never modified (they may be shared by downstream meshes),
+/// and point ids released by the removed polygons are reused, so the output has no unused points.
+/// The stored hierarchy, ordered polygons, outputs and point maps take memory in the order of the input mesh size.
+///
+/// Inputs that contain vertices, lines or triangle strips are clipped using vtkClipPolyData.
+class VTK_CJYX_DYNAMICMODELER_MODULE_LOGIC_EXPORT vtkParallelPlaneClipper : public vtkPolyDataAlgorithm
+{
+public:
+  static vtkParallelPlaneClipper* New();
+  vtkTypeMacro(vtkParallelPlaneClipper, vtkPolyDataAlgorithm);
+  void PrintSelf(ostream& os, vtkIndent indent) override;
+
+  /// Operation types have the same values as in vtkImplicitBoolean
+  enum OperationTypes
+  {
+    Union,
+    Intersection,
+    Difference
+  };
+
+  /// Set/get the planes that are used for clipping. Modifying a plane modifies the filter.
+  void SetClipPlanes(vtkPlaneCollection* planes);
+  vtkPlaneCollection* GetClipPlanes();
+
+  /// Set/get the method that is used for combining the planes.
+  vtkSetClampMacro(OperationType, int, Union, Difference);
+  vtkGetMacro(OperationType, int);
+  void SetOperationTypeToUnion() { this->SetOperationType(Union); };
+  void SetOperationTypeToIntersection() { this->SetOperationType(Intersection); };
+  void SetOperationTypeToDifference() { this->SetOperationType(Difference); };
+
+  /// Turn on/off the generation of the clipped output (negative side of the combined planes).
+  vtkSetMacro(GenerateClippedOutput, bool);
+  vtkGetMacro(GenerateClippedOutput, bool);
+  vtkBooleanMacro(GenerateClippedOutput, bool);
+
+  /// Turn on/off the generation of the intersection lines of each plane with the input mesh.
+  vtkSetMacro(GenerateCutContours, bool);
+  vtkGetMacro(GenerateCutContours, bool);
+  vtkBooleanMacro(GenerateCutContours, bool);
+
+  /// Turn on/off the use of a bounding volume hierarchy for skipping the polygons that are far from the planes.
+  /// Recommended if the same mesh is clipped repeatedly and the planes only intersect a small part of it or only
+  /// move slightly between runs. The hierarchy and the stored outputs take memory in the order of the input mesh
+  /// size, they are released at the next run without the hierarchy.
+  vtkSetMacro(UseBoundingVolumeHierarchy, bool);
+  vtkGetMacro(UseBoundingVolumeHierarchy, bool);
+  vtkBooleanMacro(UseBoundingVolumeHierarchy, bool);
+
+  /// Get the border of the end cap on the plane, as line segments that share their end points: the part of the
+  /// clipped surface border where the plane determines the combined function, closed along the parts of the
+  /// intersection lines with the other planes that are inside the mesh. The polygons of the input must be
+  /// consistently oriented. End caps that do not touch the mesh are only closed if they share an edge with an end
+  /// cap that does. Inputs that are clipped with vtkClipPolyData get the intersection of the plane with the whole
+  /// mesh instead.
+  /// Available after update if GenerateCutContours is enabled, returns nullptr otherwise.
+  vtkPolyData* GetCutContour(int planeIndex);
+
+  /// Get the part of the mesh that is on the negative side of the combined planes.
+  vtkPolyData* GetClippedOutput();
+  vtkAlgorithmOutput* GetClippedOutputPort() { return this->GetOutputPort(1); }
+
+  /// Compute the border of the polygons that are entirely on the positive side of the plane, as ordered polylines
+  /// along the edges of the mesh (closed loops end at their first point). The border points are points of the input,
+  /// so the result is the same as the boundary edges of the polygons extracted by vtkExtractPolyDataGeometry,
+  /// except for boundary edges of the input mesh, which are only included next to the plane.
+  /// Only the polygons that cross the plane are visited after the points are classified, all passes are parallel
+  /// except for stitching the edges into polylines. Vertices and lines of the input are ignored, inputs that contain
+  /// triangle strips are processed using vtkExtractPolyDataGeometry, vtkFeatureEdges and vtkStripper.
+  static void ExtractPlaneBorder(vtkPolyData* input, vtkPlane* plane, vtkPolyData* polylines);
+
+  /// Includes the modification time of the clip planes.
+  vtkMTimeType GetMTime() override;
+
+protected:
+  vtkParallelPlaneClipper();
+  ~vtkParallelPlaneClipper() override;
+
+  int RequestData(vtkInformation* request, vtkInformationVector** inputVector, vtkInformationVector* outputVector) override;
+
+  /// Clip using vtkClipPolyData, for inputs that contain other cells than polygons
+  void ClipWithImplicitFunction(vtkPolyData* input, vtkPolyData* output, vtkPolyData* clippedOutput);
+
+  vtkSmartPointer<vtkPlaneCollection> ClipPlanes;
+  int OperationType{ Union };
+  bool GenerateClippedOutput{ false };
+  bool GenerateCutContours{ false };
+  bool UseBoundingVolumeHierarchy{ false };
+  std::vector<vtkSmartPointer<vtkPolyData> > CutContours;
+
+  class vtkInternal;
+  vtkInternal* Internal;
+
+private:
+  vtkParallelPlaneClipper(const vtkParallelPlaneClipper&) = delete;
+  void operator=(const vtkParallelPlaneClipper&) = delete;
+};
+
+#endif
@@ -0,0 +1,677 @@
+/*==============================================================================
+
+  Copyright (c) Laboratory for Percutaneous Surgery (PerkLab)
+  Queen's University, Kingston, ON, Canada. All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.cjyx.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// Measures the computation time of each DynamicModeler tool on synthetic meshes of increasing size,
+// for the first run and for repeated runs after a parameter or markup change.
+// Only built and added to the tests if the DynamicModeler_ENABLE_BENCHMARKS CMake option is enabled.
+//
+// Configuration (environment variables):
+//   DYNAMICMODELER_BENCHMARK_TRIANGLE_COUNTS: comma-separated list of triangle counts of the generated meshes
+//     (default: 10000,100000,1000000,10000000)
+//   DYNAMICMODELER_BENCHMARK_REPEATS: number of repeated runs of each tool (default: 5)
+//   DYNAMICMODELER_BENCHMARK_OUTPUT: output JSON file path (default: DynamicModelerBenchmark.json)
+
+// DynamicModeler Logic includes
+#include "vtkCjyxDynamicModelerTool.h"
+#include "vtkCjyxDynamicModelerToolFactory.h"
+
+// DynamicModeler DMML includes
+#include "vtkDMMLDynamicModelerNode.h"
+
+// DMML includes
+#include <vtkDMMLCoreTestingMacros.h>
+#include <vtkDMMLLinearTransformNode.h>
+#include <vtkDMMLMarkupsClosedCurveNode.h>
+#include <vtkDMMLMarkupsFiducialNode.h>
+#include <vtkDMMLMarkupsPlaneNode.h>
+#include <vtkDMMLMarkupsROINode.h>
+#include <vtkDMMLModelNode.h>
+#include <vtkDMMLScene.h>
+
+// VTK includes
+#include <vtkCellArray.h>
+#include <vtkCleanPolyData.h>
+#include <vtkClipPolyData.h>
+#include <vtkCutter.h>
+#include <vtkDataArray.h>
+#include <vtkIdList.h>
+#include <vtkMatrix4x4.h>
+#include <vtkMinimalStandardRandomSequence.h>
+#include <vtkNew.h>
+#include <vtkParametricEllipsoid.h>
+#include <vtkParametricFunctionSource.h>
+#include <vtkParametricTorus.h>
+#include <vtkPlane.h>
+#include <vtkPointData.h>
+#include <vtkPoints.h>
+#include <vtkPolyData.h>
+#include <vtkPolyDataNormals.h>
+#include <vtkSmartPointer.h>
+#include <vtkStripper.h>
+#include <vtkVersion.h>
+#include <vtksys/SystemTools.hxx>
+
+// STD includes
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <ctime>
+#include <fstream>
+#include <functional>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace
+{
+
+const int BENCHMARK_SCHEMA_VERSION = 1;
+const char* DEFAULT_TRIANGLE_COUNTS = "10000,100000,1000000,10000000";
+const int DEFAULT_NUMBER_OF_REPEATS = 5;
+
+//----------------------------------------------------------------------------
+std::string GetEnvironmentVariable(const char* name, const std::string& defaultValue)
+{
+  std::string value;
+  if (!vtksys::SystemTools::GetEnv(name, value) || value.empty())
+    {
+    return defaultValue;
+    }
+  return value;
+}
+
+//----------------------------------------------------------------------------
+std::string QuoteJSON(const std::string& text)
+{
+  std::string quotedText = "\"";
+  for (char c : text)
+    {
+    if (c == '"' || c == '\\')
+      {
+      quotedText += '\\';
+      }
+    quotedText += c;
+    }
+  return quotedText + "\"";
+}
+
+//----------------------------------------------------------------------------
+vtkSmartPointer<vtkPolyData> ComputeNormals(vtkPolyData* polyData)
+{
+  vtkNew<vtkPolyDataNormals> normals;
+  normals->SetInputData(polyData);
+  normals->SplittingOff();
+  normals->ConsistencyOn();
+  normals->Update();
+  return normals->GetOutput();
+}
+
+//----------------------------------------------------------------------------
+// Sphere that has approximately the requested number of triangles (2 triangles per grid cell,
+// twice as many cells around the equator as from pole to pole). vtkSphereSource is not used because
+// it clamps the resolution at 1024, which limits the sphere to about 2 million triangles.
+// Duplicate points and degenerate triangles at the poles are removed, so that the surface is closed.
+vtkSmartPointer<vtkPolyData> CreateSphereMesh(vtkIdType triangleCount)
+{
+  int resolution = std::max(8, static_cast<int>(std::round(std::sqrt(triangleCount / 4.0))));
+  vtkNew<vtkParametricEllipsoid> sphere;
+  sphere->SetXRadius(50.0);
+  sphere->SetYRadius(50.0);
+  sphere->SetZRadius(50.0);
+  vtkNew<vtkParametricFunctionSource> sphereSource;
+  sphereSource->SetParametricFunction(sphere);
+  sphereSource->SetUResolution(2 * resolution);
+  sphereSource->SetVResolution(resolution);
+  sphereSource->SetScalarModeToNone();
+  sphereSource->GenerateTextureCoordinatesOff();
+  vtkNew<vtkCleanPolyData> cleaner;
+  cleaner->SetInputConnection(sphereSource->GetOutputPort());
+  cleaner->ConvertPolysToLinesOff();
+  cleaner->ConvertLinesToPointsOff();
+  cleaner->ConvertStripsToPolysOff();
+  cleaner->Update();
+  return ComputeNormals(cleaner->GetOutput());
+}
+
+//----------------------------------------------------------------------------
+// Torus that has approximately the requested number of triangles (2 triangles per grid cell,
+// twice as many cells around the ring as around the tube).
+vtkSmartPointer<vtkPolyData> CreateTorusMesh(vtkIdType triangleCount)
+{
+  int tubeResolution = std::max(8, static_cast<int>(std::round(std::sqrt(triangleCount / 4.0))));
+  vtkNew<vtkParametricTorus> torus;
+  torus->SetRingRadius(40.0);
+  torus->SetCrossSectionRadius(15.0);
+  vtkNew<vtkParametricFunctionSource> torusSource;
+  torusSource->SetParametricFunction(torus);
+  torusSource->SetUResolution(2 * tubeResolution);
+  torusSource->SetVResolution(tubeResolution);
+  torusSource->SetScalarModeToNone();
+  torusSource->GenerateTextureCoordinatesOff();
+  torusSource->Update();
+  return ComputeNormals(torusSource->GetOutput());
+}
+
+//----------------------------------------------------------------------------
+// Scan-like surface: noisy sphere that is open at the bottom (as if the back side was not visible to the scanner).
+// Sphere triangles are evenly distributed along the polar angle and the clipped part spans 60 of the 180 degrees,
+// so a sphere with 1.5 times the requested number of triangles is generated.
+vtkSmartPointer<vtkPolyData> CreateScanMesh(vtkIdType triangleCount)
+{
+  vtkSmartPointer<vtkPolyData> sphere = CreateSphereMesh(static_cast<vtkIdType>(triangleCount * 1.5));
+  vtkNew<vtkPoints> noisyPoints;
+  noisyPoints->DeepCopy(sphere->GetPoints());
+  vtkDataArray* normals = sphere->GetPointData()->GetNormals();
+  vtkNew<vtkMinimalStandardRandomSequence> random;
+  random->SetSeed(1);
+  const double noiseAmplitude = 0.1;
+  for (vtkIdType pointIndex = 0; pointIndex < noisyPoints->GetNumberOfPoints(); ++pointIndex)
+    {
+    double offset = random->GetRangeValue(-noiseAmplitude, noiseAmplitude);
+    random->Next();
+    double point[3] = { 0.0, 0.0, 0.0 };
+    noisyPoints->GetPoint(pointIndex, point);
+    double* normal = normals->GetTuple3(pointIndex);
+    noisyPoints->SetPoint(pointIndex, point[0] + offset * normal[0], point[1] + offset * normal[1], point[2] + offset * normal[2]);
+    }
+  vtkNew<vtkPolyData> noisySphere;
+  noisySphere->ShallowCopy(sphere);
+  noisySphere->SetPoints(noisyPoints);
+
+  vtkNew<vtkPlane> bottomPlane;
+  bottomPlane->SetOrigin(0.0, 0.0, -25.0);
+  bottomPlane->SetNormal(0.0, 0.0, 1.0);
+  vtkNew<vtkClipPolyData> clipper;
+  clipper->SetInputData(noisySphere);
+  clipper->SetClipFunction(bottomPlane);
+  clipper->Update();
+  return ComputeNormals(clipper->GetOutput());
+}
+
+//----------------------------------------------------------------------------
+// Longest intersection polyline of the mesh and the plane x = positionX, resampled to the requested number of points.
+// Points are on the surface, so they can be used as curve control points and seed points.
+void GetSurfacePointsOnPlane(vtkPolyData* polyData, double positionX, int numberOfPoints, vtkPoints* surfacePoints)
+{
+  surfacePoints->Reset();
+  vtkNew<vtkPlane> plane;
+  plane->SetOrigin(positionX, 0.0, 0.0);
+  plane->SetNormal(1.0, 0.0, 0.0);
+  vtkNew<vtkCutter> cutter;
+  cutter->SetInputData(polyData);
+  cutter->SetCutFunction(plane);
+  vtkNew<vtkStripper> stripper;
+  stripper->SetInputConnection(cutter->GetOutputPort());
+  stripper->JoinContiguousSegmentsOn();
+  stripper->Update();
+  vtkPolyData* contour = stripper->GetOutput();
+
+  vtkIdType longestLineLength = 0;
+  vtkNew<vtkIdList> longestLine;
+  vtkNew<vtkIdList> line;
+  vtkCellArray* lines = contour->GetLines();
+  for (lines->InitTraversal(); lines->GetNextCell(line);)
+    {
+    if (line->GetNumberOfIds() > longestLineLength)
+      {
+      longestLineLength = line->GetNumberOfIds();
+      longestLine->DeepCopy(line);
+      }
+    }
+  if (longestLineLength < 2)
+    {
+    return;
+    }
+  // Closed polylines repeat the first point at the end
+  if (longestLine->GetId(0) == longestLine->GetId(longestLineLength - 1))
+    {
+    --longestLineLength;
+    }
+  for (int i = 0; i < numberOfPoints; ++i)
+    {
+    vtkIdType lineIndex = (static_cast<vtkIdType>(i) * longestLineLength) / numberOfPoints;
+    surfacePoints->InsertNextPoint(contour->GetPoint(longestLine->GetId(lineIndex)));
+    }
+}
+
+//----------------------------------------------------------------------------
+// Input nodes that are shared by the benchmarked tools
+struct BenchmarkInputs
+{
+  vtkDMMLModelNode* ModelNode{ nullptr };
+  vtkDMMLModelNode* SecondModelNode{ nullptr };
+  vtkDMMLLinearTransformNode* SecondModelTransformNode{ nullptr };
+  vtkDMMLMarkupsPlaneNode* PlaneNode{ nullptr };
+  vtkDMMLMarkupsROINode* ROINode{ nullptr };
+  vtkDMMLMarkupsClosedCurveNode* CurveNode{ nullptr };
+  vtkDMMLMarkupsFiducialNode* SelectionPointsNode{ nullptr };
+  vtkDMMLMarkupsFiducialNode* SeedNode{ nullptr };
+  double Size{ 0.0 };
+};
+
+//----------------------------------------------------------------------------
+bool CreateBenchmarkInputs(vtkDMMLScene* scene, vtkPolyData* polyData, BenchmarkInputs& inputs)
+{
+  double bounds[6] = { 0.0, 0.0, 0.0, 0.0, 0.0, 0.0 };
+  polyData->GetBounds(bounds);
+  double center[3] = { (bounds[0] + bounds[1]) / 2.0, (bounds[2] + bounds[3]) / 2.0, (bounds[4] + bounds[5]) / 2.0 };
+  double halfSizeX = (bounds[1] - bounds[0]) / 2.0;
+  inputs.Size = std::max(bounds[1] - bounds[0], std::max(bounds[3] - bounds[2], bounds[5] - bounds[4]));
+
+  inputs.ModelNode = vtkDMMLModelNode::SafeDownCast(scene->AddNewNodeByClass("vtkDMMLModelNode", "Input"));
+  inputs.ModelNode->SetAndObservePolyData(polyData);
+
+  // Second input of the append tool, placed next to the first one
+  inputs.SecondModelNode = vtkDMMLModelNode::SafeDownCast(scene->AddNewNodeByClass("vtkDMMLModelNode", "SecondInput"));
+  inputs.SecondModelNode->SetAndObservePolyData(polyData);
+  inputs.SecondModelTransformNode = vtkDMMLLinearTransformNode::SafeDownCast(scene->AddNewNodeByClass("vtkDMMLLinearTransformNode"));
+  vtkNew<vtkMatrix4x4> secondModelToWorldMatrix;
+  secondModelToWorldMatrix->SetElement(0, 3, 1.2 * inputs.Size);
+  inputs.SecondModelTransformNode->SetMatrixTransformToParent(secondModelToWorldMatrix);
+  inputs.SecondModelNode->SetAndObserveTransformNodeID(inputs.SecondModelTransformNode->GetID());
+
+  // Plane through the center, cutting the mesh in half
+  vtkNew<vtkDMMLMarkupsPlaneNode> planeNode;
+  scene->AddNode(planeNode);
+  planeNode->SetOriginWorld(center);
+  double normal[3] = { 1.0, 0.0, 0.0 };
+  planeNode->SetNormalWorld(normal);
+  inputs.PlaneNode = planeNode;
+
+  // Box that contains a part of the mesh
+  vtkNew<vtkDMMLMarkupsROINode> roiNode;
+  scene->AddNode(roiNode);
+  double roiCenter[3] = { center[0] + 0.5 * halfSizeX, center[1], center[2] };
+  roiNode->SetXYZ(roiCenter);
+  roiNode->SetRadiusXYZ(0.3 * inputs.Size, 0.3 * inputs.Size, 0.3 * inputs.Size);
+  inputs.ROINode = roiNode;
+
+  // Closed curve on the surface, around the positive end of the mesh along the x axis
+  vtkNew<vtkPoints> curvePoints;
+  GetSurfacePointsOnPlane(polyData, center[0] + 0.5 * halfSizeX, 20, curvePoints);
+  if (curvePoints->GetNumberOfPoints() < 3)
+    {
+    std::cerr << "Failed to create curve on the benchmark mesh" << std::endl;
+    return false;
+    }
+  vtkNew<vtkDMMLMarkupsClosedCurveNode> curveNode;
+  scene->AddNode(curveNode);
+  for (vtkIdType i = 0; i < curvePoints->GetNumberOfPoints(); ++i)
+    {
+    curveNode->AddControlPoint(curvePoints->GetPoint(i));
+    }
+  inputs.CurveNode = curveNode;
+
+  // Points on the surface between the plane and the curve
+  vtkNew<vtkPoints> surfacePoints;
+  GetSurfacePointsOnPlane(polyData, center[0] + 0.25 * halfSizeX, 3, surfacePoints);
+  if (surfacePoints->GetNumberOfPoints() < 3)
+    {
+    std::cerr << "Failed to create points on the benchmark mesh" << std::endl;
+    return false;
+    }
+  vtkNew<vtkDMMLMarkupsFiducialNode> selectionPointsNode;
+  scene->AddNode(selectionPointsNode);
+  for (vtkIdType i = 0; i < surfacePoints->GetNumberOfPoints(); ++i)
+    {
+    selectionPointsNode->AddControlPoint(surfacePoints->GetPoint(i));
+    }
+  inputs.SelectionPointsNode = selectionPointsNode;
+
+  vtkNew<vtkDMMLMarkupsFiducialNode> seedNode;
+  scene->AddNode(seedNode);
+  seedNode->AddControlPoint(surfacePoints->GetPoint(0));
+  inputs.SeedNode = seedNode;
+
+  return true;
+}
+
+//----------------------------------------------------------------------------
+void TranslateCurve(vtkDMMLMarkupsClosedCurveNode* curveNode, double translationX)
+{
+  for (int i = 0; i < curveNode->GetNumberOfControlPoints(); ++i)
+    {
+    double position[3] = { 0.0, 0.0, 0.0 };
+    curveNode->GetNthControlPointPositionWorld(i, position);
+    position[0] += translationX;
+    curveNode->SetNthControlPointPositionWorld(i, position);
+    }
+}
+
+//----------------------------------------------------------------------------
+// Benchmarked configuration of a tool
+struct ToolBenchmark
+{
+  /// Name of the benchmark in the results
+  std::string Name;
+  /// Name of the tool in the tool factory
+  std::string ToolName;
+  /// Description of the change that is made before each repeated run
+  std::string Change;
+  /// Set the inputs and parameters of the dynamic modeler node
+  std::function<void(vtkCjyxDynamicModelerTool*, vtkDMMLDynamicModelerNode*, BenchmarkInputs&)> Setup;
+  /// Modify a parameter or an input before the n-th repeated run
+  std::function<void(vtkCjyxDynamicModelerTool*, vtkDMMLDynamicModelerNode*, BenchmarkInputs&, int)> Modify;
+};
+
+//----------------------------------------------------------------------------
+void SetInput(vtkCjyxDynamicModelerTool* tool, vtkDMMLDynamicModelerNode* node, int inputIndex, vtkDMMLNode* inputNode)
+{
+  node->AddNodeReferenceID(tool->GetNthInputNodeReferenceRole(inputIndex).c_str(), inputNode->GetID());
+}
+
+//----------------------------------------------------------------------------
+void SetParameter(vtkCjyxDynamicModelerTool* tool, vtkDMMLDynamicModelerNode* node, int parameterIndex, const std::string& value)
+{
+  node->SetAttribute(tool->GetNthInputParameterAttributeName(parameterIndex).c_str(), value.c_str());
+}
+
+//----------------------------------------------------------------------------
+std::vector<ToolBenchmark> GetToolBenchmarks()
+{
+  std::vector<ToolBenchmark> benchmarks;
+
+  auto movePlane = [](vtkCjyxDynamicModelerTool*, vtkDMMLDynamicModelerNode*, BenchmarkInputs& inputs, int repeat)
+    {
+    double origin[3] = { 0.0, 0.0, 0.0 };
+    inputs.PlaneNode->GetOriginWorld(origin);
+    origin[0] += (repeat % 2 == 0 ? 0.01 : -0.01) * inputs.Size;
+    inputs.PlaneNode->SetOriginWorld(origin);
+    };
+  auto moveCurve = [](vtkCjyxDynamicModelerTool*, vtkDMMLDynamicModelerNode*, BenchmarkInputs& inputs, int repeat)
+    {
+    TranslateCurve(inputs.CurveNode, (repeat % 2 == 0 ? 0.005 : -0.005) * inputs.Size);
+    };
+  auto selectByPointsSetup = [](const std::string& algorithm)
+    {
+    return [algorithm](vtkCjyxDynamicModelerTool* tool, vtkDMMLDynamicModelerNode* node, BenchmarkInputs& inputs)
+      {
+      SetInput(tool, node, 0, inputs.ModelNode);
+      SetInput(tool, node, 1, inputs.SelectionPointsNode);
+      SetParameter(tool, node, 0, std::to_string(0.1 * inputs.Size));
+      SetParameter(tool, node, 1, algorithm);
+      };
+    };
+  auto moveSelectionPoint = [](vtkCjyxDynamicModelerTool*, vtkDMMLDynamicModelerNode*, BenchmarkInputs& inputs, int repeat)
+    {
+    vtkPolyData* polyData = inputs.ModelNode->GetPolyData();
+    vtkIdType pointIndex = (static_cast<vtkIdType>(repeat + 1) * 7919) % polyData->GetNumberOfPoints();
+    inputs.SelectionPointsNode->SetNthControlPointPositionWorld(0, polyData->GetPoint(pointIndex));
+    };
+
+  benchmarks.push_back({ "PlaneCut", "Plane cut", "plane",
+    [](vtkCjyxDynamicModelerTool* tool, vtkDMMLDynamicModelerNode* node, BenchmarkInputs& inputs)
+      {
+      SetInput(tool, node, 0, inputs.ModelNode);
+      SetInput(tool, node, 1, inputs.PlaneNode);
+      SetParameter(tool, node, 0, "1");
+      },
+    movePlane });
+
+  benchmarks.push_back({ "ROICut", "ROI cut", "roi",
+    [](vtkCjyxDynamicModelerTool* tool, vtkDMMLDynamicModelerNode* node, BenchmarkInputs& inputs)
+      {
+      SetInput(tool, node, 0, inputs.ModelNode);
+      SetInput(tool, node, 1, inputs.ROINode);
+      SetParameter(tool, node, 0, "1");
+      },
+    [](vtkCjyxDynamicModelerTool*, vtkDMMLDynamicModelerNode*, BenchmarkInputs& inputs, int repeat)
+      {
+      double center[3] = { 0.0, 0.0, 0.0 };
+      inputs.ROINode->GetXYZ(center);
+      center[1] += (repeat % 2 == 0 ? 0.01 : -0.01) * inputs.Size;
+      inputs.ROINode->SetXYZ(center);
+      } });
+
+  benchmarks.push_back({ "CurveCut", "Curve cut", "curve",
+    [](vtkCjyxDynamicModelerTool* tool, vtkDMMLDynamicModelerNode* node, BenchmarkInputs& inputs)
+      {
+      SetInput(tool, node, 0, inputs.ModelNode);
+      SetInput(tool, node, 1, inputs.CurveNode);
+      },
+    moveCurve });
+
+  benchmarks.push_back({ "BoundaryCut", "Boundary cut", "curve",
+    [](vtkCjyxDynamicModelerTool* tool, vtkDMMLDynamicModelerNode* node, BenchmarkInputs& inputs)
+      {
+      SetInput(tool, node, 0, inputs.ModelNode);
+      SetInput(tool, node, 1, inputs.PlaneNode);
+      SetInput(tool, node, 1, inputs.CurveNode);
+      SetInput(tool, node, 2, inputs.SeedNode);
+      },
+    moveCurve });
+
+  benchmarks.push_back({ "SelectByPointsSphereRadius", "Select by points", "points",
+    selectByPointsSetup("SphereRadius"), moveSelectionPoint });
+
+  benchmarks.push_back({ "SelectByPointsGeodesicDistance", "Select by points", "points",
+    selectByPointsSetup("GeodesicDistance"), moveSelectionPoint });
+
+  benchmarks.push_back({ "Margin", "Margin", "parameter",
+    [](vtkCjyxDynamicModelerTool* tool, vtkDMMLDynamicModelerNode* node, BenchmarkInputs& inputs)
+      {
+      SetInput(tool, node, 0, inputs.ModelNode);
+      SetParameter(tool, node, 0, "2.0");
+      },
+    [](vtkCjyxDynamicModelerTool* tool, vtkDMMLDynamicModelerNode* node, BenchmarkInputs&, int repeat)
+      {
+      SetParameter(tool, node, 0, repeat % 2 == 0 ? "3.0" : "2.0");
+      } });
+
+  benchmarks.push_back({ "Hollow", "Hollow", "parameter",
+    [](vtkCjyxDynamicModelerTool* tool, vtkDMMLDynamicModelerNode* node, BenchmarkInputs& inputs)
+      {
+      SetInput(tool, node, 0, inputs.ModelNode);
+      SetParameter(tool, node, 0, "1.0");
+      },
+    [](vtkCjyxDynamicModelerTool* tool, vtkDMMLDynamicModelerNode* node, BenchmarkInputs&, int repeat)
+      {
+      SetParameter(tool, node, 0, repeat % 2 == 0 ? "2.0" : "1.0");
+      } });
+
+  benchmarks.push_back({ "Mirror", "Mirror", "plane",
+    [](vtkCjyxDynamicModelerTool* tool, vtkDMMLDynamicModelerNode* node, BenchmarkInputs& inputs)
+      {
+      SetInput(tool, node, 0, inputs.ModelNode);
+      SetInput(tool, node, 1, inputs.PlaneNode);
+      },
+    movePlane });
+
+  benchmarks.push_back({ "Append", "Append", "transform",
+    [](vtkCjyxDynamicModelerTool* tool, vtkDMMLDynamicModelerNode* node, BenchmarkInputs& inputs)
+      {
+      SetInput(tool, node, 0, inputs.ModelNode);
+      SetInput(tool, node, 0, inputs.SecondModelNode);
+      },
+    [](vtkCjyxDynamicModelerTool*, vtkDMMLDynamicModelerNode*, BenchmarkInputs& inputs, int repeat)
+      {
+      vtkNew<vtkMatrix4x4> secondModelToWorldMatrix;
+      inputs.SecondModelTransformNode->GetMatrixTransformToParent(secondModelToWorldMatrix);
+      secondModelToWorldMatrix->SetElement(1, 3, (repeat % 2 == 0 ? 0.01 : 0.0) * inputs.Size);
+      inputs.SecondModelTransformNode->SetMatrixTransformToParent(secondModelToWorldMatrix);
+      } });
+
+  return benchmarks;
+}
+
+//----------------------------------------------------------------------------
+std::string GetRunJSON(vtkCjyxDynamicModelerTool* tool, bool success)
+{
+  const vtkCjyxDynamicModelerTool::RunProfile& profile = tool->GetLastRunProfile();
+  std::stringstream json;
+  json << "{\"success\": " << (success ? "true" : "false")
+    << ", \"wallTimeSec\": " << profile.WallTimeSec
+    << ", \"outputPoints\": " << profile.OutputPoints
+    << ", \"outputCells\": " << profile.OutputCells
+    << ", \"stages\": [";
+  for (size_t stageIndex = 0; stageIndex < profile.StageWallTimeSec.size(); ++stageIndex)
+    {
+    json << (stageIndex > 0 ? ", " : "") << "{\"name\": " << QuoteJSON(profile.StageWallTimeSec[stageIndex].first)
+      << ", \"wallTimeSec\": " << profile.StageWallTimeSec[stageIndex].second << "}";
+    }
+  json << "]}";
+  return json.str();
+}
+
+//----------------------------------------------------------------------------
+std::string RunToolBenchmark(const ToolBenchmark& benchmark, const std::string& meshName, vtkDMMLScene* scene,
+  BenchmarkInputs& inputs, int numberOfRepeats, bool& success)
+{
+  vtkSmartPointer<vtkCjyxDynamicModelerTool> tool = vtkSmartPointer<vtkCjyxDynamicModelerTool>::Take(
+    vtkCjyxDynamicModelerToolFactory::GetInstance()->CreateToolByName(benchmark.ToolName));
+  if (!tool)
+    {
+    std::cerr << "Tool is not registered: " << benchmark.ToolName << std::endl;
+    success = false;
+    return std::string();
+    }
+  vtkNew<vtkDMMLDynamicModelerNode> node;
+  node->SetToolName(tool->GetName());
+  scene->AddNode(node);
+  benchmark.Setup(tool, node, inputs);
+  std::vector<vtkSmartPointer<vtkDMMLNode> > outputNodes;
+  for (int outputIndex = 0; outputIndex < tool->GetNumberOfOutputNodes(); ++outputIndex)
+    {
+    vtkDMMLNode* outputNode = scene->AddNewNodeByClass("vtkDMMLModelNode");
+    node->SetNodeReferenceID(tool->GetNthOutputNodeReferenceRole(outputIndex).c_str(), outputNode->GetID());
+    outputNodes.push_back(outputNode);
+    }
+
+  vtkPolyData* polyData = inputs.ModelNode->GetPolyData();
+  std::stringstream json;
+  json << "{\"mesh\": " << QuoteJSON(meshName)
+    << ", \"tool\": " << QuoteJSON(benchmark.Name)
+    << ", \"inputPoints\": " << polyData->GetNumberOfPoints()
+    << ", \"inputTriangles\": " << polyData->GetNumberOfPolys()
+    << ", \"change\": " << QuoteJSON(benchmark.Change);
+
+  bool firstRunSuccess = tool->Run(node);
+  success = success && firstRunSuccess;
+  double firstRunWallTimeSec = tool->GetLastRunProfile().WallTimeSec;
+  json << ", \"firstRun\": " << GetRunJSON(tool, firstRunSuccess);
+  std::cout << "  " << benchmark.Name << ": first run " << firstRunWallTimeSec << " s";
+
+  std::vector<double> repeatedRunWallTimesSec;
+  json << ", \"repeatedRuns\": [";
+  for (int repeat = 0; repeat < numberOfRepeats; ++repeat)
+    {
+    benchmark.Modify(tool, node, inputs, repeat);
+    bool repeatedRunSuccess = tool->Run(node);
+    success = success && repeatedRunSuccess;
+    repeatedRunWallTimesSec.push_back(tool->GetLastRunProfile().WallTimeSec);
+    json << (repeat > 0 ? ", " : "") << GetRunJSON(tool, repeatedRunSuccess);
+    }
+  json << "]";
+  if (!repeatedRunWallTimesSec.empty())
+    {
+    std::sort(repeatedRunWallTimesSec.begin(), repeatedRunWallTimesSec.end());
+    double medianWallTimeSec = repeatedRunWallTimesSec[repeatedRunWallTimesSec.size() / 2];
+    json << ", \"repeatedRunMedianWallTimeSec\": " << medianWallTimeSec
+      << ", \"repeatedRunMinWallTimeSec\": " << repeatedRunWallTimesSec.front();
+    std::cout << ", repeated run (" << benchmark.Change << " change) " << medianWallTimeSec << " s";
+    }
+  json << ", \"trianglesPerSec\": " << (firstRunWallTimeSec > 0.0 ? polyData->GetNumberOfPolys() / firstRunWallTimeSec : 0.0)
+    << "}";
+  std::cout << std::endl;
+
+  for (vtkDMMLNode* outputNode : outputNodes)
+    {
+    scene->RemoveNode(outputNode);
+    }
+  scene->RemoveNode(node);
+  return json.str();
+}
+
+} // end of anonymous namespace
+
+//----------------------------------------------------------------------------
+int vtkCjyxDynamicModelerBenchmark(int vtkNotUsed(argc), char* vtkNotUsed(argv)[])
+{
+  std::vector<vtkIdType> triangleCounts;
+  std::stringstream triangleCountsStream(GetEnvironmentVariable("DYNAMICMODELER_BENCHMARK_TRIANGLE_COUNTS", DEFAULT_TRIANGLE_COUNTS));
+  std::string triangleCount;
+  while (std::getline(triangleCountsStream, triangleCount, ','))
+    {
+    if (!vtksys::SystemTools::TrimWhitespace(triangleCount).empty())
+      {
+      triangleCounts.push_back(static_cast<vtkIdType>(std::stod(triangleCount)));
+      }
+    }
+  int numberOfRepeats = std::stoi(GetEnvironmentVariable("DYNAMICMODELER_BENCHMARK_REPEATS", std::to_string(DEFAULT_NUMBER_OF_REPEATS)));
+  std::string outputFilePath = GetEnvironmentVariable("DYNAMICMODELER_BENCHMARK_OUTPUT", "DynamicModelerBenchmark.json");
+
+  typedef std::function<vtkSmartPointer<vtkPolyData>(vtkIdType)> MeshGenerator;
+  std::vector<std::pair<std::string, MeshGenerator> > shapes =
+    {
+    { "sphere", CreateSphereMesh },
+    { "torus", CreateTorusMesh },
+    { "scan", CreateScanMesh },
+    };
+  std::vector<ToolBenchmark> toolBenchmarks = GetToolBenchmarks();
+
+  bool success = true;
+  std::vector<std::string> results;
+  for (vtkIdType count : triangleCounts)
+    {
+    for (const std::pair<std::string, MeshGenerator>& shape : shapes)
+      {
+      std::string meshName = shape.first + std::to_string(count);
+      vtkSmartPointer<vtkPolyData> polyData = shape.second(count);
+      std::cout << "Benchmarking " << meshName << " (" << polyData->GetNumberOfPolys() << " triangles)" << std::endl;
+      // Results are named by the requested size, make sure that the generated mesh actually has that size
+      CHECK_BOOL(std::abs(polyData->GetNumberOfPolys() - count) <= count / 10, true);
+
+      vtkNew<vtkDMMLScene> scene;
+      BenchmarkInputs inputs;
+      CHECK_BOOL(CreateBenchmarkInputs(scene, polyData, inputs), true);
+      for (const ToolBenchmark& toolBenchmark : toolBenchmarks)
+        {
+        std::string result = RunToolBenchmark(toolBenchmark, meshName, scene, inputs, numberOfRepeats, success);
+        if (!result.empty())
+          {
+          results.push_back(result);
+          }
+        }
+      }
+    }
+
+  char timestamp[32] = { 0 };
+  std::time_t now = std::time(nullptr);
+  std::strftime(timestamp, sizeof(timestamp), "%Y-%m-%dT%H:%M:%S", std::localtime(&now));
+  std::ofstream outputFile(outputFilePath);
+  CHECK_BOOL(outputFile.is_open(), true);
+  outputFile << "{" << std::endl
+    << "  \"schemaVersion\": " << BENCHMARK_SCHEMA_VERSION << "," << std::endl
+    << "  \"benchmark\": \"DynamicModeler\"," << std::endl
+    << "  \"timestamp\": " << QuoteJSON(timestamp) << "," << std::endl
+    << "  \"system\": {\"vtkVersion\": " << QuoteJSON(vtkVersion::GetVTKVersion())
+    << ", \"numberOfCpus\": " << std::thread::hardware_concurrency() << "}," << std::endl
+    << "  \"numberOfRepeatedRuns\": " << numberOfRepeats << "," << std::endl
+    << "  \"results\": [" << std::endl;
+  for (size_t resultIndex = 0; resultIndex < results.size(); ++resultIndex)
+    {
+    outputFile << "    " << results[resultIndex] << (resultIndex + 1 < results.size() ? "," : "") << std::endl;
+    }
+  outputFile << "  ]" << std::endl << "}" << std::endl;
+  outputFile.close();
+  std::cout << "Benchmark results written to " << outputFilePath << std::endl;
+
+  CHECK_BOOL(results.empty(), false);
+  CHECK_BOOL(success, true);
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,421 @@
+/*==============================================================================
+
+  Copyright (c) Laboratory for Percutaneous Surgery (PerkLab)
+  Queen's University, Kingston, ON, Canada. All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.cjyx.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// DynamicModeler Logic includes
+#include "vtkCjyxDynamicModelerAppendTool.h"
+#include "vtkCjyxDynamicModelerBoundaryCutTool.h"
+#include "vtkCjyxDynamicModelerMarginTool.h"
+#include "vtkCjyxDynamicModelerToolSnapshot.h"
+
+// DynamicModeler DMML includes
+#include "vtkDMMLDynamicModelerNode.h"
+
+// DMML includes
+#include <vtkDMMLCoreTestingMacros.h>
+#include <vtkDMMLLinearTransformNode.h>
+#include <vtkDMMLMarkupsFiducialNode.h>
+#include <vtkDMMLMarkupsPlaneNode.h>
+#include <vtkDMMLModelNode.h>
+#include <vtkDMMLScene.h>
+
+// VTK includes
+#include <vtkAlgorithm.h>
+#include <vtkCallbackCommand.h>
+#include <vtkCellData.h>
+#include <vtkCommand.h>
+#include <vtkDataArray.h>
+#include <vtkMatrix4x4.h>
+#include <vtkNew.h>
+#include <vtkObjectFactory.h>
+#include <vtkPointData.h>
+#include <vtkPolyData.h>
+#include <vtkPolyDataNormals.h>
+#include <vtkSphereSource.h>
+#include <vtkTransformPolyDataFilter.h>
+#include <vtkWarpVector.h>
+
+// STD includes
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace
+{
+
+//----------------------------------------------------------------------------
+// Margin tool that gives access to the filters of its pipeline
+class vtkTestMarginTool : public vtkCjyxDynamicModelerMarginTool
+{
+public:
+  static vtkTestMarginTool* New();
+  vtkTypeMacro(vtkTestMarginTool, vtkCjyxDynamicModelerMarginTool);
+  vtkCjyxDynamicModelerTool* CreateToolInstance() override { return vtkTestMarginTool::New(); }
+
+  vtkAlgorithm* GetInputModelToWorldTransformFilter() { return this->InputModelToWorldTransformFilter; }
+  vtkAlgorithm* GetMarginFilter() { return this->MarginFilter; }
+  vtkAlgorithm* GetNormalsFilter() { return this->NormalsFilter; }
+  vtkAlgorithm* GetOutputModelToWorldTransformFilter() { return this->OutputModelToWorldTransformFilter; }
+};
+vtkStandardNewMacro(vtkTestMarginTool);
+
+//----------------------------------------------------------------------------
+// Append tool that gives access to the cached input meshes
+class vtkTestAppendTool : public vtkCjyxDynamicModelerAppendTool
+{
+public:
+  static vtkTestAppendTool* New();
+  vtkTypeMacro(vtkTestAppendTool, vtkCjyxDynamicModelerAppendTool);
+  vtkCjyxDynamicModelerTool* CreateToolInstance() override { return vtkTestAppendTool::New(); }
+
+  vtkPolyData* GetWorldMesh(vtkDMMLModelNode* inputModelNode)
+  {
+    std::map<std::string, InputMeshCacheEntry>::iterator cacheEntryIt = this->InputMeshCache.find(inputModelNode->GetID());
+    return cacheEntryIt != this->InputMeshCache.end() ? cacheEntryIt->second.WorldMesh.GetPointer() : nullptr;
+  }
+};
+vtkStandardNewMacro(vtkTestAppendTool);
+
+//----------------------------------------------------------------------------
+// Boundary cut tool that gives access to the clip filter
+class vtkTestBoundaryCutTool : public vtkCjyxDynamicModelerBoundaryCutTool
+{
+public:
+  static vtkTestBoundaryCutTool* New();
+  vtkTypeMacro(vtkTestBoundaryCutTool, vtkCjyxDynamicModelerBoundaryCutTool);
+  vtkCjyxDynamicModelerTool* CreateToolInstance() override { return vtkTestBoundaryCutTool::New(); }
+
+  vtkAlgorithm* GetClipFilter() { return this->ClipPolyData; }
+};
+vtkStandardNewMacro(vtkTestBoundaryCutTool);
+
+//----------------------------------------------------------------------------
+std::map<vtkObject*, int> NumberOfExecutions;
+
+//----------------------------------------------------------------------------
+void CountExecution(vtkObject* caller, unsigned long vtkNotUsed(eventId), void* vtkNotUsed(clientData), void* vtkNotUsed(callData))
+{
+  ++NumberOfExecutions[caller];
+}
+
+//----------------------------------------------------------------------------
+void ObserveExecutions(vtkAlgorithm* filter, vtkCallbackCommand* callback)
+{
+  filter->AddObserver(vtkCommand::StartEvent, callback);
+}
+
+//----------------------------------------------------------------------------
+void RequestToolAbort(vtkObject* vtkNotUsed(caller), unsigned long vtkNotUsed(eventId), void* clientData, void* vtkNotUsed(callData))
+{
+  reinterpret_cast<vtkCjyxDynamicModelerTool*>(clientData)->RequestAbort();
+}
+
+//----------------------------------------------------------------------------
+bool HasStage(const vtkCjyxDynamicModelerTool::RunProfile& profile, const std::string& stageName)
+{
+  for (const std::pair<std::string, double>& stage : profile.StageWallTimeSec)
+    {
+    if (stage.first == stageName)
+      {
+      return true;
+      }
+    }
+  return false;
+}
+
+//----------------------------------------------------------------------------
+vtkDMMLModelNode* AddSphereModel(vtkDMMLScene* scene)
+{
+  vtkNew<vtkSphereSource> sphereSource;
+  sphereSource->SetRadius(10.0);
+  sphereSource->Update();
+  vtkDMMLModelNode* modelNode = vtkDMMLModelNode::SafeDownCast(scene->AddNewNodeByClass("vtkDMMLModelNode"));
+  modelNode->SetAndObservePolyData(sphereSource->GetOutput());
+  return modelNode;
+}
+
+//----------------------------------------------------------------------------
+vtkDMMLLinearTransformNode* AddTranslation(vtkDMMLScene* scene, double translationX)
+{
+  vtkNew<vtkMatrix4x4> matrix;
+  matrix->SetElement(0, 3, translationX);
+  vtkDMMLLinearTransformNode* transformNode = vtkDMMLLinearTransformNode::SafeDownCast(
+    scene->AddNewNodeByClass("vtkDMMLLinearTransformNode"));
+  transformNode->SetMatrixTransformToParent(matrix);
+  return transformNode;
+}
+
+//----------------------------------------------------------------------------
+int TestMarginFilterExecution(vtkDMMLScene* scene)
+{
+  vtkDMMLModelNode* inputModelNode = AddSphereModel(scene);
+  vtkDMMLModelNode* outputModelNode = vtkDMMLModelNode::SafeDownCast(scene->AddNewNodeByClass("vtkDMMLModelNode"));
+
+  vtkNew<vtkTestMarginTool> tool;
+  vtkNew<vtkDMMLDynamicModelerNode> dynamicModelerNode;
+  dynamicModelerNode->SetToolName(tool->GetName());
+  scene->AddNode(dynamicModelerNode);
+  dynamicModelerNode->SetNodeReferenceID(tool->GetNthInputNodeReferenceRole(0).c_str(), inputModelNode->GetID());
+  dynamicModelerNode->SetNodeReferenceID(tool->GetNthOutputNodeReferenceRole(0).c_str(), outputModelNode->GetID());
+  dynamicModelerNode->SetAttribute(tool->GetNthInputParameterAttributeName(0).c_str(), "2.0");
+
+  vtkNew<vtkCallbackCommand> countExecutionCallback;
+  countExecutionCallback->SetCallback(CountExecution);
+  vtkAlgorithm* inputTransformFilter = tool->GetInputModelToWorldTransformFilter();
+  vtkAlgorithm* marginFilter = tool->GetMarginFilter();
+  vtkAlgorithm* normalsFilter = tool->GetNormalsFilter();
+  vtkAlgorithm* outputTransformFilter = tool->GetOutputModelToWorldTransformFilter();
+  ObserveExecutions(inputTransformFilter, countExecutionCallback);
+  ObserveExecutions(marginFilter, countExecutionCallback);
+  ObserveExecutions(normalsFilter, countExecutionCallback);
+  ObserveExecutions(outputTransformFilter, countExecutionCallback);
+
+  // First run executes the whole pipeline
+  CHECK_BOOL(tool->Run(dynamicModelerNode), true);
+  CHECK_INT(NumberOfExecutions[inputTransformFilter], 1);
+  CHECK_INT(NumberOfExecutions[marginFilter], 1);
+  CHECK_INT(NumberOfExecutions[normalsFilter], 1);
+  CHECK_INT(NumberOfExecutions[outputTransformFilter], 1);
+  CHECK_BOOL(outputModelNode->GetPolyData()->GetNumberOfPoints() > 0, true);
+
+  // Profile of the run lists the executed stages and the mesh sizes
+  const vtkCjyxDynamicModelerTool::RunProfile& profile = tool->GetLastRunProfile();
+  CHECK_BOOL(HasStage(profile, "Input transform"), true);
+  CHECK_BOOL(HasStage(profile, "Margin"), true);
+  CHECK_BOOL(HasStage(profile, "Output transform"), true);
+  CHECK_BOOL(HasStage(profile, "Publish"), true);
+  CHECK_INT(profile.InputPoints, inputModelNode->GetPolyData()->GetNumberOfPoints());
+  CHECK_INT(profile.OutputPoints, outputModelNode->GetPolyData()->GetNumberOfPoints());
+
+  // Nothing changed, no filter is executed
+  NumberOfExecutions.clear();
+  CHECK_BOOL(tool->Run(dynamicModelerNode), true);
+  CHECK_INT(NumberOfExecutions[inputTransformFilter], 0);
+  CHECK_INT(NumberOfExecutions[marginFilter], 0);
+  CHECK_INT(NumberOfExecutions[normalsFilter], 0);
+  CHECK_INT(NumberOfExecutions[outputTransformFilter], 0);
+  CHECK_BOOL(HasStage(tool->GetLastRunProfile(), "Margin"), false);
+  CHECK_BOOL(HasStage(tool->GetLastRunProfile(), "Publish"), true);
+
+  // Only the filters downstream of the modified parameter are executed
+  NumberOfExecutions.clear();
+  dynamicModelerNode->SetAttribute(tool->GetNthInputParameterAttributeName(0).c_str(), "4.0");
+  CHECK_BOOL(tool->Run(dynamicModelerNode), true);
+  CHECK_INT(NumberOfExecutions[inputTransformFilter], 0);
+  CHECK_INT(NumberOfExecutions[marginFilter], 1);
+  CHECK_INT(NumberOfExecutions[normalsFilter], 1);
+  CHECK_INT(NumberOfExecutions[outputTransformFilter], 1);
+
+  // Modifying the input transform executes the whole pipeline
+  NumberOfExecutions.clear();
+  vtkDMMLLinearTransformNode* transformNode = AddTranslation(scene, 20.0);
+  inputModelNode->SetAndObserveTransformNodeID(transformNode->GetID());
+  CHECK_BOOL(tool->Run(dynamicModelerNode), true);
+  CHECK_INT(NumberOfExecutions[inputTransformFilter], 1);
+  CHECK_INT(NumberOfExecutions[marginFilter], 1);
+  CHECK_INT(NumberOfExecutions[outputTransformFilter], 1);
+
+  // Setting the same matrix again does not execute the pipeline
+  NumberOfExecutions.clear();
+  vtkNew<vtkMatrix4x4> inputModelToWorldMatrix;
+  transformNode->GetMatrixTransformToParent(inputModelToWorldMatrix);
+  transformNode->SetMatrixTransformToParent(inputModelToWorldMatrix);
+  CHECK_BOOL(tool->Run(dynamicModelerNode), true);
+  CHECK_INT(NumberOfExecutions[inputTransformFilter], 0);
+  CHECK_INT(NumberOfExecutions[marginFilter], 0);
+
+  return EXIT_SUCCESS;
+}
+
+//----------------------------------------------------------------------------
+int TestMarginAbort(vtkDMMLScene* scene)
+{
+  vtkDMMLModelNode* inputModelNode = AddSphereModel(scene);
+  vtkDMMLModelNode* outputModelNode = vtkDMMLModelNode::SafeDownCast(scene->AddNewNodeByClass("vtkDMMLModelNode"));
+
+  vtkNew<vtkTestMarginTool> tool;
+  vtkNew<vtkDMMLDynamicModelerNode> dynamicModelerNode;
+  dynamicModelerNode->SetToolName(tool->GetName());
+  scene->AddNode(dynamicModelerNode);
+  dynamicModelerNode->SetNodeReferenceID(tool->GetNthInputNodeReferenceRole(0).c_str(), inputModelNode->GetID());
+  dynamicModelerNode->SetNodeReferenceID(tool->GetNthOutputNodeReferenceRole(0).c_str(), outputModelNode->GetID());
+  dynamicModelerNode->SetAttribute(tool->GetNthInputParameterAttributeName(0).c_str(), "2.0");
+
+  // Abort is requested while the margin filter is executing (its first progress event is invoked after StartEvent)
+  vtkNew<vtkCallbackCommand> requestAbortCallback;
+  requestAbortCallback->SetCallback(RequestToolAbort);
+  requestAbortCallback->SetClientData(tool);
+  vtkAlgorithm* marginFilter = tool->GetMarginFilter();
+  unsigned long requestAbortObserverTag = marginFilter->AddObserver(vtkCommand::StartEvent, requestAbortCallback);
+  CHECK_BOOL(tool->Run(dynamicModelerNode), false);
+  CHECK_BOOL(tool->GetAbortRequested(), true);
+  CHECK_BOOL(tool->GetProgress() < 1.0, true);
+  marginFilter->RemoveObserver(requestAbortObserverTag);
+
+  // The abort request is cleared by the next run and the aborted filter is executed again
+  vtkNew<vtkCallbackCommand> countExecutionCallback;
+  countExecutionCallback->SetCallback(CountExecution);
+  ObserveExecutions(marginFilter, countExecutionCallback);
+  NumberOfExecutions.clear();
+  CHECK_BOOL(tool->Run(dynamicModelerNode), true);
+  CHECK_BOOL(tool->GetAbortRequested(), false);
+  CHECK_INT(NumberOfExecutions[marginFilter], 1);
+  CHECK_DOUBLE(tool->GetProgress(), 1.0);
+  CHECK_BOOL(outputModelNode->GetPolyData()->GetNumberOfPoints() > 0, true);
+
+  // Abort requested after the snapshot run was scheduled, but before it was started, is not lost
+  vtkNew<vtkCjyxDynamicModelerToolSnapshot> snapshot;
+  CHECK_BOOL(snapshot->CreateSnapshot(tool, dynamicModelerNode), true);
+  tool->ClearAbortRequest();
+  tool->RequestAbort();
+  NumberOfExecutions.clear();
+  CHECK_BOOL(tool->RunSnapshot(snapshot), false);
+  CHECK_BOOL(tool->GetAbortRequested(), true);
+  CHECK_INT(NumberOfExecutions[marginFilter], 0);
+
+  return EXIT_SUCCESS;
+}
+
+//----------------------------------------------------------------------------
+int TestAppendInputCache(vtkDMMLScene* scene)
+{
+  const int numberOfInputModels = 3;
+  std::vector<vtkDMMLModelNode*> inputModelNodes;
+  vtkNew<vtkTestAppendTool> tool;
+  vtkNew<vtkDMMLDynamicModelerNode> dynamicModelerNode;
+  dynamicModelerNode->SetToolName(tool->GetName());
+  scene->AddNode(dynamicModelerNode);
+  for (int i = 0; i < numberOfInputModels; ++i)
+    {
+    vtkDMMLModelNode* inputModelNode = AddSphereModel(scene);
+    inputModelNode->SetAndObserveTransformNodeID(AddTranslation(scene, 30.0 * i)->GetID());
+    dynamicModelerNode->AddNodeReferenceID(tool->GetNthInputNodeReferenceRole(0).c_str(), inputModelNode->GetID());
+    inputModelNodes.push_back(inputModelNode);
+    }
+  vtkDMMLModelNode* outputModelNode = vtkDMMLModelNode::SafeDownCast(scene->AddNewNodeByClass("vtkDMMLModelNode"));
+  dynamicModelerNode->SetNodeReferenceID(tool->GetNthOutputNodeReferenceRole(0).c_str(), outputModelNode->GetID());
+
+  CHECK_BOOL(tool->Run(dynamicModelerNode), true);
+  vtkIdType numberOfPolys = outputModelNode->GetPolyData()->GetNumberOfPolys();
+  CHECK_INT(numberOfPolys, numberOfInputModels * inputModelNodes[0]->GetPolyData()->GetNumberOfPolys());
+  std::vector<vtkPolyData*> worldMeshes;
+  for (vtkDMMLModelNode* inputModelNode : inputModelNodes)
+    {
+    CHECK_NOT_NULL(tool->GetWorldMesh(inputModelNode));
+    worldMeshes.push_back(tool->GetWorldMesh(inputModelNode));
+    }
+
+  // Moving one input only transforms that input again
+  vtkDMMLLinearTransformNode* transformNode = vtkDMMLLinearTransformNode::SafeDownCast(inputModelNodes[1]->GetParentTransformNode());
+  vtkNew<vtkMatrix4x4> matrix;
+  matrix->SetElement(0, 3, 100.0);
+  transformNode->SetMatrixTransformToParent(matrix);
+  CHECK_BOOL(tool->Run(dynamicModelerNode), true);
+  CHECK_POINTER(tool->GetWorldMesh(inputModelNodes[0]), worldMeshes[0]);
+  CHECK_POINTER_DIFFERENT(tool->GetWorldMesh(inputModelNodes[1]), worldMeshes[1]);
+  CHECK_POINTER(tool->GetWorldMesh(inputModelNodes[2]), worldMeshes[2]);
+  CHECK_INT(outputModelNode->GetPolyData()->GetNumberOfPolys(), numberOfPolys);
+  double bounds[6] = { 0.0, 0.0, 0.0, 0.0, 0.0, 0.0 };
+  outputModelNode->GetPolyData()->GetBounds(bounds);
+  CHECK_DOUBLE_TOLERANCE(bounds[1], 110.0, 1e-3);
+
+  // Removing an input releases its cached mesh
+  dynamicModelerNode->RemoveNthNodeReferenceID(tool->GetNthInputNodeReferenceRole(0).c_str(), 2);
+  CHECK_BOOL(tool->Run(dynamicModelerNode), true);
+  CHECK_NULL(tool->GetWorldMesh(inputModelNodes[2]));
+  CHECK_POINTER(tool->GetWorldMesh(inputModelNodes[0]), worldMeshes[0]);
+  CHECK_INT(outputModelNode->GetPolyData()->GetNumberOfPolys(), 2 * inputModelNodes[0]->GetPolyData()->GetNumberOfPolys());
+
+  return EXIT_SUCCESS;
+}
+
+
+//----------------------------------------------------------------------------
+int TestBoundaryCutReuse(vtkDMMLScene* scene)
+{
+  vtkDMMLModelNode* inputModelNode = AddSphereModel(scene);
+  vtkDMMLModelNode* outputModelNode = vtkDMMLModelNode::SafeDownCast(scene->AddNewNodeByClass("vtkDMMLModelNode"));
+  vtkDMMLMarkupsPlaneNode* planeNode = vtkDMMLMarkupsPlaneNode::SafeDownCast(scene->AddNewNodeByClass("vtkDMMLMarkupsPlaneNode"));
+  double planeOrigin[3] = { 0.0, 0.0, 2.0 };
+  double planeNormal[3] = { 0.0, 0.0, 1.0 };
+  planeNode->SetOriginWorld(planeOrigin);
+  planeNode->SetNormalWorld(planeNormal);
+  vtkDMMLMarkupsFiducialNode* seedNode = vtkDMMLMarkupsFiducialNode::SafeDownCast(scene->AddNewNodeByClass("vtkDMMLMarkupsFiducialNode"));
+  double topSeed[3] = { 0.0, 0.0, 10.0 };
+  seedNode->AddControlPoint(topSeed);
+
+  vtkNew<vtkTestBoundaryCutTool> tool;
+  vtkNew<vtkDMMLDynamicModelerNode> dynamicModelerNode;
+  dynamicModelerNode->SetToolName(tool->GetName());
+  scene->AddNode(dynamicModelerNode);
+  dynamicModelerNode->SetNodeReferenceID(tool->GetNthInputNodeReferenceRole(0).c_str(), inputModelNode->GetID());
+  dynamicModelerNode->SetNodeReferenceID(tool->GetNthInputNodeReferenceRole(1).c_str(), planeNode->GetID());
+  dynamicModelerNode->SetNodeReferenceID(tool->GetNthInputNodeReferenceRole(2).c_str(), seedNode->GetID());
+  dynamicModelerNode->SetNodeReferenceID(tool->GetNthOutputNodeReferenceRole(0).c_str(), outputModelNode->GetID());
+
+  vtkNew<vtkCallbackCommand> countExecutionCallback;
+  countExecutionCallback->SetCallback(CountExecution);
+  vtkAlgorithm* clipFilter = tool->GetClipFilter();
+  ObserveExecutions(clipFilter, countExecutionCallback);
+
+  // Region of the seed is above the plane and colored by the seed index + 1
+  NumberOfExecutions.clear();
+  CHECK_BOOL(tool->Run(dynamicModelerNode), true);
+  CHECK_INT(NumberOfExecutions[clipFilter], 1);
+  vtkPolyData* outputMesh = outputModelNode->GetPolyData();
+  CHECK_BOOL(outputMesh->GetNumberOfPolys() > 0, true);
+  CHECK_BOOL(outputMesh->GetBounds()[4] > 1.9, true);
+  vtkDataArray* regionArray = outputMesh->GetCellData()->GetArray("RegionId");
+  CHECK_NOT_NULL(regionArray);
+  CHECK_DOUBLE(regionArray->GetRange()[0], 1.0);
+  CHECK_DOUBLE(regionArray->GetRange()[1], 1.0);
+  CHECK_NULL(outputMesh->GetPointData()->GetArray("RegionId"));
+
+  // Borders and mesh did not change, the clipped mesh is reused for new seeds
+  NumberOfExecutions.clear();
+  double bottomSeed[3] = { 0.0, 0.0, -10.0 };
+  seedNode->AddControlPoint(bottomSeed);
+  CHECK_BOOL(tool->Run(dynamicModelerNode), true);
+  CHECK_INT(NumberOfExecutions[clipFilter], 0);
+  outputMesh = outputModelNode->GetPolyData();
+  CHECK_BOOL(outputMesh->GetBounds()[4] < -9.0, true);
+  regionArray = outputMesh->GetCellData()->GetArray("RegionId");
+  CHECK_NOT_NULL(regionArray);
+  CHECK_DOUBLE(regionArray->GetRange()[0], 1.0);
+  CHECK_DOUBLE(regionArray->GetRange()[1], 2.0);
+
+  // Moving the border clips again
+  NumberOfExecutions.clear();
+  planeOrigin[2] = -2.0;
+  planeNode->SetOriginWorld(planeOrigin);
+  CHECK_BOOL(tool->Run(dynamicModelerNode), true);
+  CHECK_INT(NumberOfExecutions[clipFilter], 1);
+
+  return EXIT_SUCCESS;
+}
+
+}
+
+//----------------------------------------------------------------------------
+int vtkCjyxDynamicModelerFilterExecutionTest(int vtkNotUsed(argc), char* vtkNotUsed(argv)[])
+{
+  vtkNew<vtkDMMLScene> scene;
+  CHECK_EXIT_SUCCESS(TestMarginFilterExecution(scene));
+  CHECK_EXIT_SUCCESS(TestMarginAbort(scene));
+  CHECK_EXIT_SUCCESS(TestAppendInputCache(scene));
+  CHECK_EXIT_SUCCESS(TestBoundaryCutReuse(scene));
+  return EXIT_SUCCESS;
+}
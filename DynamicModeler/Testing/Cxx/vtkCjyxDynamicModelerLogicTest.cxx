@@ -0,0 +1,107 @@
+/*==============================================================================
+
+  Copyright (c) Laboratory for Percutaneous Surgery (PerkLab)
+  Queen's University, Kingston, ON, Canada. All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.cjyx.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// DynamicModeler Logic includes
+#include "vtkCjyxDynamicModelerLogic.h"
+#include "vtkCjyxDynamicModelerTool.h"
+
+// DynamicModeler DMML includes
+#include "vtkDMMLDynamicModelerNode.h"
+
+// DMML includes
+#include <vtkDMMLCoreTestingMacros.h>
+#include <vtkDMMLMarkupsPlaneNode.h>
+#include <vtkDMMLModelNode.h>
+#include <vtkDMMLScene.h>
+
+// VTK includes
+#include <vtkNew.h>
+#include <vtkPolyData.h>
+#include <vtkSphereSource.h>
+
+namespace
+{
+
+//----------------------------------------------------------------------------
+vtkDMMLModelNode* AddSphereModel(vtkDMMLScene* scene, double center[3])
+{
+  vtkNew<vtkSphereSource> sphereSource;
+  sphereSource->SetCenter(center);
+  sphereSource->SetRadius(10.0);
+  sphereSource->SetThetaResolution(30);
+  sphereSource->SetPhiResolution(30);
+  sphereSource->Update();
+  vtkDMMLModelNode* modelNode = vtkDMMLModelNode::SafeDownCast(scene->AddNewNodeByClass("vtkDMMLModelNode"));
+  modelNode->SetAndObservePolyData(sphereSource->GetOutput());
+  return modelNode;
+}
+
+//----------------------------------------------------------------------------
+int TestInteractionProxyOutput(vtkDMMLScene* scene, vtkCjyxDynamicModelerLogic* logic)
+{
+  double center[3] = { 0.0, 0.0, 0.0 };
+  vtkDMMLModelNode* inputModelNode = AddSphereModel(scene, center);
+  vtkDMMLModelNode* outputModelNode = vtkDMMLModelNode::SafeDownCast(scene->AddNewNodeByClass("vtkDMMLModelNode"));
+  vtkNew<vtkDMMLMarkupsPlaneNode> planeNode;
+  scene->AddNode(planeNode);
+  planeNode->SetOriginWorld(center);
+  double normal[3] = { 1.0, 0.0, 0.0 };
+  planeNode->SetNormalWorld(normal);
+
+  vtkNew<vtkDMMLDynamicModelerNode> dynamicModelerNode;
+  dynamicModelerNode->SetToolName("Mirror");
+  scene->AddNode(dynamicModelerNode);
+  vtkCjyxDynamicModelerTool* tool = logic->GetDynamicModelerTool(dynamicModelerNode);
+  CHECK_NOT_NULL(tool);
+  dynamicModelerNode->SetNodeReferenceID(tool->GetNthInputNodeReferenceRole(0).c_str(), inputModelNode->GetID());
+  dynamicModelerNode->SetNodeReferenceID(tool->GetNthInputNodeReferenceRole(1).c_str(), planeNode->GetID());
+  dynamicModelerNode->SetNodeReferenceID(tool->GetNthOutputNodeReferenceRole(0).c_str(), outputModelNode->GetID());
+  dynamicModelerNode->SetContinuousUpdate(true);
+
+  vtkIdType inputNumberOfPolys = inputModelNode->GetPolyData()->GetNumberOfPolys();
+  logic->SetInteractiveProxyNumberOfTriangles(inputNumberOfPolys / 8);
+  logic->RunDynamicModelerTool(dynamicModelerNode);
+  CHECK_INT(outputModelNode->GetPolyData()->GetNumberOfPolys(), inputNumberOfPolys);
+
+  // Output is computed from the simplified input while the plane is dragged
+  planeNode->InvokeEvent(vtkDMMLMarkupsNode::PointStartInteractionEvent);
+  CHECK_BOOL(logic->IsInputInteractionInProgress(dynamicModelerNode), true);
+  double origin[3] = { 2.0, 0.0, 0.0 };
+  planeNode->SetOriginWorld(origin);
+  CHECK_BOOL(outputModelNode->GetPolyData()->GetNumberOfPolys() < inputNumberOfPolys, true);
+
+  // Full resolution output is computed when the interaction is completed
+  planeNode->InvokeEvent(vtkDMMLMarkupsNode::PointEndInteractionEvent);
+  CHECK_BOOL(logic->IsInputInteractionInProgress(dynamicModelerNode), false);
+  CHECK_INT(outputModelNode->GetPolyData()->GetNumberOfPolys(), inputNumberOfPolys);
+
+  return EXIT_SUCCESS;
+}
+
+}
+
+//----------------------------------------------------------------------------
+int vtkCjyxDynamicModelerLogicTest(int vtkNotUsed(argc), char* vtkNotUsed(argv)[])
+{
+  vtkNew<vtkDMMLScene> scene;
+  vtkNew<vtkCjyxDynamicModelerLogic> logic;
+  logic->SetDMMLScene(scene);
+
+  CHECK_EXIT_SUCCESS(TestInteractionProxyOutput(scene, logic));
+
+  logic->SetDMMLScene(nullptr);
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,176 @@
+/*==============================================================================
+
+  Copyright (c) Laboratory for Percutaneous Surgery (PerkLab)
+  Queen's University, Kingston, ON, Canada. All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.cjyx.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// DynamicModeler Logic includes
+#include "vtkCjyxDynamicModelerAppendTool.h"
+#include "vtkCjyxDynamicModelerMarginTool.h"
+
+// DynamicModeler DMML includes
+#include "vtkDMMLDynamicModelerNode.h"
+
+// DMML includes
+#include <vtkDMMLCoreTestingMacros.h>
+#include <vtkDMMLModelNode.h>
+#include <vtkDMMLScene.h>
+
+// VTK includes
+#include <vtkCellArray.h>
+#include <vtkNew.h>
+#include <vtkObjectFactory.h>
+#include <vtkPoints.h>
+#include <vtkPolyData.h>
+#include <vtkSmartPointer.h>
+#include <vtkSphereSource.h>
+#include <vtkTransformPolyDataFilter.h>
+
+// STD includes
+#include <string>
+
+namespace
+{
+
+//----------------------------------------------------------------------------
+vtkDMMLModelNode* AddSphereModel(vtkDMMLScene* scene, double center[3])
+{
+  vtkNew<vtkSphereSource> sphereSource;
+  sphereSource->SetCenter(center);
+  sphereSource->SetRadius(10.0);
+  sphereSource->SetThetaResolution(30);
+  sphereSource->SetPhiResolution(30);
+  sphereSource->Update();
+  vtkDMMLModelNode* modelNode = vtkDMMLModelNode::SafeDownCast(scene->AddNewNodeByClass("vtkDMMLModelNode"));
+  modelNode->SetAndObservePolyData(sphereSource->GetOutput());
+  return modelNode;
+}
+
+//----------------------------------------------------------------------------
+/// Margin tool that gives access to the output of the last filter of its pipeline
+class vtkTestMarginTool : public vtkCjyxDynamicModelerMarginTool
+{
+public:
+  static vtkTestMarginTool* New();
+  vtkTypeMacro(vtkTestMarginTool, vtkCjyxDynamicModelerMarginTool);
+  vtkPolyData* GetLastFilterOutput() { return this->OutputModelToWorldTransformFilter->GetOutput(); }
+};
+vtkStandardNewMacro(vtkTestMarginTool);
+
+//----------------------------------------------------------------------------
+/// Append tool that gives access to the output of the last filter of its pipeline
+class vtkTestAppendTool : public vtkCjyxDynamicModelerAppendTool
+{
+public:
+  static vtkTestAppendTool* New();
+  vtkTypeMacro(vtkTestAppendTool, vtkCjyxDynamicModelerAppendTool);
+  vtkPolyData* GetLastFilterOutput() { return this->OutputWorldToModelTransformFilter->GetOutput(); }
+};
+vtkStandardNewMacro(vtkTestAppendTool);
+
+//----------------------------------------------------------------------------
+// Output mesh must be a new mesh object that shares the points and polygon arrays of the output of the last filter
+bool IsOutputMeshShared(vtkPolyData* outputMesh, vtkPolyData* filterOutput)
+{
+  return outputMesh && filterOutput && outputMesh != filterOutput
+    && outputMesh->GetPoints() && filterOutput->GetPoints()
+    && outputMesh->GetPoints()->GetData() == filterOutput->GetPoints()->GetData()
+    && outputMesh->GetPolys()->GetOffsetsArray() == filterOutput->GetPolys()->GetOffsetsArray()
+    && outputMesh->GetPolys()->GetConnectivityArray() == filterOutput->GetPolys()->GetConnectivityArray();
+}
+
+//----------------------------------------------------------------------------
+int TestMarginOutput(vtkDMMLScene* scene)
+{
+  double center[3] = { 0.0, 0.0, 0.0 };
+  vtkDMMLModelNode* inputModelNode = AddSphereModel(scene, center);
+  vtkDMMLModelNode* outputModelNode = vtkDMMLModelNode::SafeDownCast(scene->AddNewNodeByClass("vtkDMMLModelNode"));
+
+  vtkNew<vtkDMMLDynamicModelerNode> dynamicModelerNode;
+  dynamicModelerNode->SetToolName("Margin");
+  scene->AddNode(dynamicModelerNode);
+  vtkNew<vtkTestMarginTool> tool;
+  dynamicModelerNode->SetNodeReferenceID(tool->GetNthInputNodeReferenceRole(0).c_str(), inputModelNode->GetID());
+  dynamicModelerNode->SetNodeReferenceID(tool->GetNthOutputNodeReferenceRole(0).c_str(), outputModelNode->GetID());
+  dynamicModelerNode->SetAttribute(tool->GetNthInputParameterAttributeName(0).c_str(), "2.0");
+
+  CHECK_BOOL(tool->Run(dynamicModelerNode), true);
+  vtkSmartPointer<vtkPolyData> firstOutputMesh = outputModelNode->GetPolyData();
+  CHECK_BOOL(IsOutputMeshShared(firstOutputMesh, tool->GetLastFilterOutput()), true);
+  vtkIdType firstNumberOfPoints = firstOutputMesh->GetNumberOfPoints();
+  CHECK_BOOL(firstNumberOfPoints > 0, true);
+  double firstPoint[3] = { 0.0, 0.0, 0.0 };
+  firstOutputMesh->GetPoint(0, firstPoint);
+
+  // Running the tool again must publish a new mesh and leave the previously published mesh unchanged
+  dynamicModelerNode->SetAttribute(tool->GetNthInputParameterAttributeName(0).c_str(), "4.0");
+  CHECK_BOOL(tool->Run(dynamicModelerNode), true);
+  vtkPolyData* secondOutputMesh = outputModelNode->GetPolyData();
+  CHECK_POINTER_DIFFERENT(secondOutputMesh, firstOutputMesh.GetPointer());
+  CHECK_BOOL(IsOutputMeshShared(secondOutputMesh, tool->GetLastFilterOutput()), true);
+  CHECK_POINTER_DIFFERENT(secondOutputMesh->GetPoints()->GetData(), firstOutputMesh->GetPoints()->GetData());
+  CHECK_INT(firstOutputMesh->GetNumberOfPoints(), firstNumberOfPoints);
+  double firstPointAfterSecondRun[3] = { 0.0, 0.0, 0.0 };
+  firstOutputMesh->GetPoint(0, firstPointAfterSecondRun);
+  CHECK_DOUBLE(firstPointAfterSecondRun[0], firstPoint[0]);
+  CHECK_DOUBLE(firstPointAfterSecondRun[1], firstPoint[1]);
+  CHECK_DOUBLE(firstPointAfterSecondRun[2], firstPoint[2]);
+
+  return EXIT_SUCCESS;
+}
+
+//----------------------------------------------------------------------------
+int TestAppendOutput(vtkDMMLScene* scene)
+{
+  double center1[3] = { 0.0, 0.0, 0.0 };
+  double center2[3] = { 30.0, 0.0, 0.0 };
+  vtkDMMLModelNode* inputModelNode1 = AddSphereModel(scene, center1);
+  vtkDMMLModelNode* inputModelNode2 = AddSphereModel(scene, center2);
+  vtkDMMLModelNode* outputModelNode = vtkDMMLModelNode::SafeDownCast(scene->AddNewNodeByClass("vtkDMMLModelNode"));
+
+  vtkNew<vtkDMMLDynamicModelerNode> dynamicModelerNode;
+  dynamicModelerNode->SetToolName("Append");
+  scene->AddNode(dynamicModelerNode);
+  vtkNew<vtkTestAppendTool> tool;
+  std::string inputReferenceRole = tool->GetNthInputNodeReferenceRole(0);
+  dynamicModelerNode->AddNodeReferenceID(inputReferenceRole.c_str(), inputModelNode1->GetID());
+  dynamicModelerNode->AddNodeReferenceID(inputReferenceRole.c_str(), inputModelNode2->GetID());
+  dynamicModelerNode->SetNodeReferenceID(tool->GetNthOutputNodeReferenceRole(0).c_str(), outputModelNode->GetID());
+
+  CHECK_BOOL(tool->Run(dynamicModelerNode), true);
+  vtkPolyData* outputMesh = outputModelNode->GetPolyData();
+  CHECK_BOOL(IsOutputMeshShared(outputMesh, tool->GetLastFilterOutput()), true);
+  CHECK_INT(outputMesh->GetNumberOfPolys(),
+    inputModelNode1->GetPolyData()->GetNumberOfPolys() + inputModelNode2->GetPolyData()->GetNumberOfPolys());
+
+  // Appending the same model twice creates duplicate polygons, which are removed
+  dynamicModelerNode->AddNodeReferenceID(inputReferenceRole.c_str(), inputModelNode1->GetID());
+  CHECK_BOOL(tool->Run(dynamicModelerNode), true);
+  outputMesh = outputModelNode->GetPolyData();
+  CHECK_POINTER(outputMesh->GetPoints()->GetData(), tool->GetLastFilterOutput()->GetPoints()->GetData());
+  CHECK_INT(outputMesh->GetNumberOfPolys(),
+    inputModelNode1->GetPolyData()->GetNumberOfPolys() + inputModelNode2->GetPolyData()->GetNumberOfPolys());
+
+  return EXIT_SUCCESS;
+}
+
+}
+
+//----------------------------------------------------------------------------
+int vtkCjyxDynamicModelerOutputMeshTest(int vtkNotUsed(argc), char* vtkNotUsed(argv)[])
+{
+  vtkNew<vtkDMMLScene> scene;
+  CHECK_EXIT_SUCCESS(TestMarginOutput(scene));
+  CHECK_EXIT_SUCCESS(TestAppendOutput(scene));
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,121 @@
+/*==============================================================================
+
+  Copyright (c) Laboratory for Percutaneous Surgery (PerkLab)
+  Queen's University, Kingston, ON, Canada. All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.cjyx.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// DynamicModeler Logic includes
+#include "vtkImplicitPolyDataSegmentDistance.h"
+
+// DMML includes
+#include <vtkDMMLCoreTestingMacros.h>
+
+// VTK includes
+#include <vtkCellArray.h>
+#include <vtkDoubleArray.h>
+#include <vtkLine.h>
+#include <vtkMath.h>
+#include <vtkNew.h>
+#include <vtkPoints.h>
+#include <vtkPolyData.h>
+#include <vtkSphereSource.h>
+
+// STD includes
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+
+//----------------------------------------------------------------------------
+int TestSegmentDistance()
+{
+  // Closed polyline on a circle of radius 5, evaluated at the points of a sphere of radius 6
+  vtkNew<vtkPoints> curvePoints;
+  vtkNew<vtkCellArray> curveLines;
+  int numberOfCurvePoints = 40;
+  curveLines->InsertNextCell(numberOfCurvePoints + 1);
+  for (int i = 0; i < numberOfCurvePoints; ++i)
+    {
+    double angle = 2.0 * vtkMath::Pi() * i / numberOfCurvePoints;
+    curveLines->InsertCellPoint(curvePoints->InsertNextPoint(5.0 * cos(angle), 5.0 * sin(angle), 0.0));
+    }
+  curveLines->InsertCellPoint(0);
+  vtkNew<vtkPolyData> curve;
+  curve->SetPoints(curvePoints);
+  curve->SetLines(curveLines);
+
+  vtkNew<vtkSphereSource> sphereSource;
+  sphereSource->SetRadius(6.0);
+  sphereSource->SetThetaResolution(30);
+  sphereSource->SetPhiResolution(30);
+  sphereSource->Update();
+  vtkPoints* queryPoints = sphereSource->GetOutput()->GetPoints();
+
+  vtkNew<vtkImplicitPolyDataSegmentDistance> distance;
+  distance->SetInput(curve);
+  for (vtkIdType pointId = 0; pointId < queryPoints->GetNumberOfPoints(); ++pointId)
+    {
+    double x[3] = { 0.0, 0.0, 0.0 };
+    queryPoints->GetPoint(pointId, x);
+    double expectedDistance2 = VTK_DOUBLE_MAX;
+    for (int i = 0; i < numberOfCurvePoints; ++i)
+      {
+      double t = 0.0;
+      expectedDistance2 = std::min(expectedDistance2, vtkLine::DistanceToLine(x,
+        curvePoints->GetPoint(i), curvePoints->GetPoint((i + 1) % numberOfCurvePoints), t));
+      }
+    CHECK_DOUBLE_TOLERANCE(distance->EvaluateFunction(x), expectedDistance2, 1e-9);
+    }
+
+  // Parallel evaluation with a limited band matches the point by point evaluation
+  distance->SetMaximumDistance(1.5);
+  vtkNew<vtkDoubleArray> distances;
+  distance->EvaluateFunction(queryPoints->GetData(), distances);
+  CHECK_INT(distances->GetNumberOfTuples(), queryPoints->GetNumberOfPoints());
+  bool farPointFound = false;
+  for (vtkIdType pointId = 0; pointId < queryPoints->GetNumberOfPoints(); ++pointId)
+    {
+    double x[3] = { 0.0, 0.0, 0.0 };
+    queryPoints->GetPoint(pointId, x);
+    double exactDistance2 = distance->EvaluateSquaredDistance(x, -1.0);
+    CHECK_DOUBLE_TOLERANCE(distances->GetValue(pointId), std::min(exactDistance2, 1.5 * 1.5), 1e-9);
+    farPointFound |= (exactDistance2 > 1.5 * 1.5);
+    }
+  CHECK_BOOL(farPointFound, true);
+
+  // Modifying the input rebuilds the hierarchy at the next evaluation, without setting the input again
+  double origin[3] = { 0.0, 0.0, 0.0 };
+  CHECK_DOUBLE_TOLERANCE(distance->EvaluateFunction(origin), 1.5 * 1.5, 1e-9);
+  for (vtkIdType pointId = 0; pointId < curvePoints->GetNumberOfPoints(); ++pointId)
+    {
+    double x[3] = { 0.0, 0.0, 0.0 };
+    curvePoints->GetPoint(pointId, x);
+    curvePoints->SetPoint(pointId, 0.2 * x[0], 0.2 * x[1], x[2]);
+    }
+  curvePoints->Modified();
+  distance->SetMaximumDistance(-1.0);
+  double chordDistance = cos(vtkMath::Pi() / numberOfCurvePoints);
+  CHECK_DOUBLE_TOLERANCE(distance->EvaluateFunction(origin), chordDistance * chordDistance, 1e-9);
+
+  return EXIT_SUCCESS;
+}
+
+}
+
+//----------------------------------------------------------------------------
+int vtkImplicitPolyDataSegmentDistanceTest(int vtkNotUsed(argc), char* vtkNotUsed(argv)[])
+{
+  CHECK_EXIT_SUCCESS(TestSegmentDistance());
+  return EXIT_SUCCESS;
+}
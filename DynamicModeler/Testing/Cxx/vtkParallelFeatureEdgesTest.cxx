@@ -0,0 +1,144 @@
+/*==============================================================================
+
+  Copyright (c) Laboratory for Percutaneous Surgery (PerkLab)
+  Queen's University, Kingston, ON, Canada. All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.cjyx.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// DynamicModeler Logic includes
+#include "vtkParallelFeatureEdges.h"
+
+// DMML includes
+#include <vtkDMMLCoreTestingMacros.h>
+
+// VTK includes
+#include <vtkCellArray.h>
+#include <vtkCellData.h>
+#include <vtkCleanPolyData.h>
+#include <vtkCubeSource.h>
+#include <vtkDataArray.h>
+#include <vtkFeatureEdges.h>
+#include <vtkMath.h>
+#include <vtkNew.h>
+#include <vtkPlaneSource.h>
+#include <vtkPoints.h>
+#include <vtkPolyData.h>
+#include <vtkSphereSource.h>
+
+// STD includes
+#include <cmath>
+
+namespace
+{
+
+//----------------------------------------------------------------------------
+// Parallel feature edges must extract the same number of edges of each type as vtkFeatureEdges.
+// Edge types are compared one at a time, because vtkFeatureEdges skips manifold edges that are not
+// feature edges if both feature and manifold edges are enabled.
+int TestParallelFeatureEdges()
+{
+  // Open mesh: quads of a plane, and a half sphere
+  vtkNew<vtkPlaneSource> planeSource;
+  planeSource->SetResolution(5, 4);
+  planeSource->Update();
+  vtkNew<vtkSphereSource> sphereSource;
+  sphereSource->SetThetaResolution(30);
+  sphereSource->SetPhiResolution(30);
+  sphereSource->SetEndPhi(90.0);
+  sphereSource->Update();
+
+  // Closed mesh with sharp edges: the faces of the cube source do not share points until they are merged
+  vtkNew<vtkCubeSource> cubeSource;
+  vtkNew<vtkCleanPolyData> cubeCleaner;
+  cubeCleaner->SetInputConnection(cubeSource->GetOutputPort());
+  cubeCleaner->Update();
+
+  // Non-manifold mesh: three quads sharing the same edge
+  vtkNew<vtkPolyData> fins;
+  vtkNew<vtkPoints> finPoints;
+  finPoints->InsertNextPoint(0.0, 0.0, 0.0);
+  finPoints->InsertNextPoint(0.0, 0.0, 1.0);
+  vtkNew<vtkCellArray> finPolys;
+  for (int fin = 0; fin < 3; ++fin)
+    {
+    double angle = vtkMath::RadiansFromDegrees(120.0 * fin);
+    vtkIdType pointId2 = finPoints->InsertNextPoint(cos(angle), sin(angle), 1.0);
+    vtkIdType pointId3 = finPoints->InsertNextPoint(cos(angle), sin(angle), 0.0);
+    vtkIdType quad[4] = { 0, 1, pointId2, pointId3 };
+    finPolys->InsertNextCell(4, quad);
+    }
+  fins->SetPoints(finPoints);
+  fins->SetPolys(finPolys);
+
+  vtkPolyData* meshes[4] = { planeSource->GetOutput(), sphereSource->GetOutput(), cubeCleaner->GetOutput(), fins };
+  for (vtkPolyData* mesh : meshes)
+    {
+    for (int edgeType = 0; edgeType < vtkParallelFeatureEdges::EdgeType_Last; ++edgeType)
+      {
+      vtkNew<vtkFeatureEdges> referenceEdges;
+      referenceEdges->SetInputData(mesh);
+      referenceEdges->ColoringOff();
+      referenceEdges->SetBoundaryEdges(edgeType == vtkParallelFeatureEdges::BoundaryEdge);
+      referenceEdges->SetNonManifoldEdges(edgeType == vtkParallelFeatureEdges::NonManifoldEdge);
+      referenceEdges->SetManifoldEdges(edgeType == vtkParallelFeatureEdges::ManifoldEdge);
+      referenceEdges->SetFeatureEdges(edgeType == vtkParallelFeatureEdges::FeatureEdge);
+      referenceEdges->SetFeatureAngle(30.0);
+      referenceEdges->Update();
+
+      vtkNew<vtkParallelFeatureEdges> edges;
+      edges->SetInputData(mesh);
+      edges->SetBoundaryEdges(edgeType == vtkParallelFeatureEdges::BoundaryEdge);
+      edges->SetNonManifoldEdges(edgeType == vtkParallelFeatureEdges::NonManifoldEdge);
+      edges->SetManifoldEdges(edgeType == vtkParallelFeatureEdges::ManifoldEdge);
+      edges->SetFeatureEdges(edgeType == vtkParallelFeatureEdges::FeatureEdge);
+      edges->SetFeatureAngle(30.0);
+      edges->Update();
+
+      vtkIdType numberOfLines = edges->GetOutput()->GetNumberOfLines();
+      CHECK_INT(numberOfLines, referenceEdges->GetOutput()->GetNumberOfLines());
+      CHECK_INT(edges->GetNumberOfEdges(edgeType), numberOfLines);
+      vtkDataArray* edgeTypeArray = edges->GetOutput()->GetCellData()->GetArray("EdgeType");
+      CHECK_NOT_NULL(edgeTypeArray);
+      for (vtkIdType lineId = 0; lineId < numberOfLines; ++lineId)
+        {
+        CHECK_INT(static_cast<int>(edgeTypeArray->GetTuple1(lineId)), edgeType);
+        }
+      }
+    }
+
+  // Expected counts, to make sure that the meshes cover each edge type
+  vtkNew<vtkParallelFeatureEdges> edges;
+  edges->SetInputData(cubeCleaner->GetOutput());
+  edges->ExtractAllEdgeTypesOn();
+  edges->Update();
+  CHECK_INT(edges->GetNumberOfEdges(vtkParallelFeatureEdges::FeatureEdge), 12);
+  CHECK_INT(edges->GetNumberOfEdges(vtkParallelFeatureEdges::BoundaryEdge), 0);
+  edges->SetInputData(fins);
+  edges->Update();
+  CHECK_INT(edges->GetNumberOfEdges(vtkParallelFeatureEdges::NonManifoldEdge), 1);
+  CHECK_INT(edges->GetNumberOfEdges(vtkParallelFeatureEdges::BoundaryEdge), 9);
+  edges->SetInputData(planeSource->GetOutput());
+  edges->Update();
+  CHECK_INT(edges->GetNumberOfEdges(vtkParallelFeatureEdges::BoundaryEdge), 18);
+  CHECK_INT(edges->GetNumberOfEdges(vtkParallelFeatureEdges::ManifoldEdge), 31);
+
+  return EXIT_SUCCESS;
+}
+
+}
+
+//----------------------------------------------------------------------------
+int vtkParallelFeatureEdgesTest(int vtkNotUsed(argc), char* vtkNotUsed(argv)[])
+{
+  CHECK_EXIT_SUCCESS(TestParallelFeatureEdges());
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,454 @@
+/*==============================================================================
+
+  Copyright (c) Laboratory for Percutaneous Surgery (PerkLab)
+  Queen's University, Kingston, ON, Canada. All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.cjyx.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// DynamicModeler Logic includes
+#include "vtkParallelPlaneClipper.h"
+
+// DMML includes
+#include <vtkDMMLCoreTestingMacros.h>
+
+// VTK includes
+#include <vtkCellArray.h>
+#include <vtkCellData.h>
+#include <vtkClipPolyData.h>
+#include <vtkDataArray.h>
+#include <vtkDoubleArray.h>
+#include <vtkExtractPolyDataGeometry.h>
+#include <vtkFeatureEdges.h>
+#include <vtkIdList.h>
+#include <vtkIdTypeArray.h>
+#include <vtkImplicitBoolean.h>
+#include <vtkMassProperties.h>
+#include <vtkMath.h>
+#include <vtkNew.h>
+#include <vtkPlane.h>
+#include <vtkPlaneCollection.h>
+#include <vtkPointData.h>
+#include <vtkPolyData.h>
+#include <vtkSmartPointer.h>
+#include <vtkSphereSource.h>
+
+// STD includes
+#include <algorithm>
+#include <vector>
+
+namespace
+{
+
+//----------------------------------------------------------------------------
+vtkSmartPointer<vtkPolyData> CreateSphere()
+{
+  vtkNew<vtkSphereSource> sphereSource;
+  sphereSource->SetRadius(10.0);
+  sphereSource->SetThetaResolution(30);
+  sphereSource->SetPhiResolution(30);
+  sphereSource->Update();
+  return sphereSource->GetOutput();
+}
+
+//----------------------------------------------------------------------------
+double GetSurfaceArea(vtkPolyData* polyData)
+{
+  vtkNew<vtkMassProperties> massProperties;
+  massProperties->SetInputData(polyData);
+  massProperties->Update();
+  return massProperties->GetSurfaceArea();
+}
+
+//----------------------------------------------------------------------------
+// Parallel plane clipper must produce the same mesh as vtkClipPolyData with the combined planes
+int TestParallelPlaneClipper()
+{
+  vtkSmartPointer<vtkPolyData> sphere = CreateSphere();
+
+  vtkNew<vtkPlane> plane1;
+  plane1->SetOrigin(1.3, 0.0, 0.0);
+  plane1->SetNormal(1.0, 0.2, 0.0);
+  vtkNew<vtkPlane> plane2;
+  plane2->SetOrigin(0.0, -2.1, 0.0);
+  plane2->SetNormal(0.0, 1.0, 0.3);
+  vtkNew<vtkPlaneCollection> planes;
+  planes->AddItem(plane1);
+  planes->AddItem(plane2);
+
+  for (int operationType = vtkImplicitBoolean::VTK_UNION; operationType <= vtkImplicitBoolean::VTK_DIFFERENCE; ++operationType)
+    {
+    vtkNew<vtkImplicitBoolean> clipFunction;
+    clipFunction->SetOperationType(operationType);
+    clipFunction->AddFunction(plane1);
+    clipFunction->AddFunction(plane2);
+    vtkNew<vtkClipPolyData> referenceClipper;
+    referenceClipper->SetInputData(sphere);
+    referenceClipper->SetClipFunction(clipFunction);
+    referenceClipper->GenerateClippedOutputOn();
+    referenceClipper->Update();
+
+    vtkNew<vtkParallelPlaneClipper> clipper;
+    clipper->SetInputData(sphere);
+    clipper->SetClipPlanes(planes);
+    clipper->SetOperationType(operationType);
+    clipper->GenerateClippedOutputOn();
+    clipper->Update();
+
+    CHECK_INT(clipper->GetOutput()->GetNumberOfPolys(), referenceClipper->GetOutput()->GetNumberOfPolys());
+    CHECK_INT(clipper->GetOutput()->GetNumberOfPoints(), referenceClipper->GetOutput()->GetNumberOfPoints());
+    CHECK_INT(clipper->GetClippedOutput()->GetNumberOfPolys(), referenceClipper->GetClippedOutput()->GetNumberOfPolys());
+    CHECK_INT(clipper->GetClippedOutput()->GetNumberOfPoints(), referenceClipper->GetClippedOutput()->GetNumberOfPoints());
+    CHECK_DOUBLE_TOLERANCE(GetSurfaceArea(clipper->GetOutput()), GetSurfaceArea(referenceClipper->GetOutput()), 1e-3);
+    CHECK_DOUBLE_TOLERANCE(GetSurfaceArea(clipper->GetClippedOutput()), GetSurfaceArea(referenceClipper->GetClippedOutput()), 1e-3);
+
+    // Passing the polygons of whole hierarchy nodes must not change the result
+    vtkNew<vtkParallelPlaneClipper> hierarchyClipper;
+    hierarchyClipper->SetInputData(sphere);
+    hierarchyClipper->SetClipPlanes(planes);
+    hierarchyClipper->SetOperationType(operationType);
+    hierarchyClipper->GenerateClippedOutputOn();
+    hierarchyClipper->UseBoundingVolumeHierarchyOn();
+    hierarchyClipper->Update();
+    CHECK_INT(hierarchyClipper->GetOutput()->GetNumberOfPolys(), clipper->GetOutput()->GetNumberOfPolys());
+    CHECK_INT(hierarchyClipper->GetOutput()->GetNumberOfPoints(), clipper->GetOutput()->GetNumberOfPoints());
+    CHECK_INT(hierarchyClipper->GetClippedOutput()->GetNumberOfPolys(), clipper->GetClippedOutput()->GetNumberOfPolys());
+    CHECK_DOUBLE_TOLERANCE(GetSurfaceArea(hierarchyClipper->GetOutput()), GetSurfaceArea(clipper->GetOutput()), 1e-6);
+    CHECK_DOUBLE_TOLERANCE(GetSurfaceArea(hierarchyClipper->GetClippedOutput()), GetSurfaceArea(clipper->GetClippedOutput()), 1e-6);
+    }
+
+  // Small box on the surface of the sphere, as in ROI cut: normals point inside, the inside of the box is positive
+  vtkNew<vtkPlaneCollection> boxPlanes;
+  double boxCenter[3] = { 10.0, 0.0, 0.0 };
+  for (int axis = 0; axis < 3; ++axis)
+    {
+    for (int side = -1; side <= 1; side += 2)
+      {
+      double origin[3] = { boxCenter[0], boxCenter[1], boxCenter[2] };
+      origin[axis] += side * 1.5;
+      double normal[3] = { 0.0, 0.0, 0.0 };
+      normal[axis] = -side;
+      vtkNew<vtkPlane> boxPlane;
+      boxPlane->SetOrigin(origin);
+      boxPlane->SetNormal(normal);
+      boxPlanes->AddItem(boxPlane);
+      }
+    }
+  vtkNew<vtkParallelPlaneClipper> boxClipper;
+  boxClipper->SetInputData(sphere);
+  boxClipper->SetClipPlanes(boxPlanes);
+  boxClipper->GenerateClippedOutputOn();
+  boxClipper->GenerateCutContoursOn();
+  boxClipper->Update();
+  vtkNew<vtkParallelPlaneClipper> boxHierarchyClipper;
+  boxHierarchyClipper->SetInputData(sphere);
+  boxHierarchyClipper->SetClipPlanes(boxPlanes);
+  boxHierarchyClipper->GenerateClippedOutputOn();
+  boxHierarchyClipper->GenerateCutContoursOn();
+  boxHierarchyClipper->UseBoundingVolumeHierarchyOn();
+  boxHierarchyClipper->Update();
+  CHECK_BOOL(boxClipper->GetOutput()->GetNumberOfPolys() > 0, true);
+  CHECK_INT(boxHierarchyClipper->GetOutput()->GetNumberOfPolys(), boxClipper->GetOutput()->GetNumberOfPolys());
+  CHECK_INT(boxHierarchyClipper->GetOutput()->GetNumberOfPoints(), boxClipper->GetOutput()->GetNumberOfPoints());
+  CHECK_DOUBLE_TOLERANCE(GetSurfaceArea(boxHierarchyClipper->GetOutput()), GetSurfaceArea(boxClipper->GetOutput()), 1e-6);
+  CHECK_INT(boxHierarchyClipper->GetClippedOutput()->GetNumberOfPolys(), boxClipper->GetClippedOutput()->GetNumberOfPolys());
+  CHECK_INT(boxHierarchyClipper->GetClippedOutput()->GetNumberOfPoints(), boxClipper->GetClippedOutput()->GetNumberOfPoints());
+  CHECK_DOUBLE_TOLERANCE(GetSurfaceArea(boxHierarchyClipper->GetClippedOutput()), GetSurfaceArea(boxClipper->GetClippedOutput()), 1e-6);
+  for (int i = 0; i < boxPlanes->GetNumberOfItems(); ++i)
+    {
+    CHECK_INT(boxHierarchyClipper->GetCutContour(i)->GetNumberOfLines(), boxClipper->GetCutContour(i)->GetNumberOfLines());
+    // Cut contours are closed loops, each point is shared by two segments
+    CHECK_INT(boxClipper->GetCutContour(i)->GetNumberOfLines(), boxClipper->GetCutContour(i)->GetNumberOfPoints());
+    }
+  // The face of the box inside the sphere is not touched by the mesh, its contour is made of the four box edges.
+  // The face outside of the sphere has no end cap, the side faces are cut by the sphere.
+  CHECK_INT(boxClipper->GetCutContour(0)->GetNumberOfLines(), 4);
+  CHECK_INT(boxClipper->GetCutContour(1)->GetNumberOfLines(), 0);
+  CHECK_BOOL(boxClipper->GetCutContour(2)->GetNumberOfLines() > 4, true);
+
+  // Cut contour of a single plane is a closed loop on the sphere, each point is shared by two segments
+  vtkNew<vtkPlaneCollection> singlePlane;
+  singlePlane->AddItem(plane1);
+  vtkNew<vtkParallelPlaneClipper> contourClipper;
+  contourClipper->SetInputData(sphere);
+  contourClipper->SetClipPlanes(singlePlane);
+  contourClipper->GenerateCutContoursOn();
+  contourClipper->Update();
+  vtkPolyData* contour = contourClipper->GetCutContour(0);
+  CHECK_NOT_NULL(contour);
+  CHECK_BOOL(contour->GetNumberOfLines() > 0, true);
+  CHECK_INT(contour->GetNumberOfLines(), contour->GetNumberOfPoints());
+
+  // Moving the box in small steps reuses the hierarchy, the spliced output must match clipping from scratch
+  for (int step = 1; step <= 3; ++step)
+    {
+    for (int i = 0; i < boxPlanes->GetNumberOfItems(); ++i)
+      {
+      double origin[3] = { 0.0, 0.0, 0.0 };
+      boxPlanes->GetItem(i)->GetOrigin(origin);
+      boxPlanes->GetItem(i)->SetOrigin(origin[0] - 0.2, origin[1] + 0.1, origin[2]);
+      }
+    boxClipper->Update();
+    boxHierarchyClipper->Update();
+    CHECK_INT(boxHierarchyClipper->GetOutput()->GetNumberOfPolys(), boxClipper->GetOutput()->GetNumberOfPolys());
+    CHECK_INT(boxHierarchyClipper->GetOutput()->GetNumberOfPoints(), boxClipper->GetOutput()->GetNumberOfPoints());
+    CHECK_INT(boxHierarchyClipper->GetClippedOutput()->GetNumberOfPolys(), boxClipper->GetClippedOutput()->GetNumberOfPolys());
+    CHECK_INT(boxHierarchyClipper->GetClippedOutput()->GetNumberOfPoints(), boxClipper->GetClippedOutput()->GetNumberOfPoints());
+    CHECK_DOUBLE_TOLERANCE(GetSurfaceArea(boxHierarchyClipper->GetClippedOutput()), GetSurfaceArea(boxClipper->GetClippedOutput()), 1e-6);
+    }
+
+  // Moving a plane must re-execute the filter
+  vtkNew<vtkParallelPlaneClipper> clipper;
+  clipper->SetInputData(sphere);
+  clipper->SetClipPlanes(planes);
+  clipper->Update();
+  vtkIdType numberOfPolys = clipper->GetOutput()->GetNumberOfPolys();
+  plane1->SetOrigin(-5.0, 0.0, 0.0);
+  clipper->Update();
+  CHECK_BOOL(clipper->GetOutput()->GetNumberOfPolys() != numberOfPolys, true);
+
+  return EXIT_SUCCESS;
+}
+
+//----------------------------------------------------------------------------
+vtkIdType GetNumberOfUnusedPoints(vtkPolyData* polyData)
+{
+  std::vector<bool> usedPoints(polyData->GetNumberOfPoints(), false);
+  vtkNew<vtkIdList> pointIds;
+  for (vtkIdType cellId = 0; cellId < polyData->GetNumberOfCells(); ++cellId)
+    {
+    polyData->GetCellPoints(cellId, pointIds);
+    for (vtkIdType i = 0; i < pointIds->GetNumberOfIds(); ++i)
+      {
+      usedPoints[pointIds->GetId(i)] = true;
+      }
+    }
+  return static_cast<vtkIdType>(std::count(usedPoints.begin(), usedPoints.end(), false));
+}
+
+//----------------------------------------------------------------------------
+// Check that the "X" point data is the x coordinate of each point and that each polygon has a point of the input
+// polygon that is stored in its "InputCellId" cell data
+int CheckClipperAttributes(vtkPolyData* input, vtkPolyData* output)
+{
+  vtkDataArray* xArray = output->GetPointData()->GetArray("X");
+  vtkDataArray* inputCellIdArray = output->GetCellData()->GetArray("InputCellId");
+  CHECK_NOT_NULL(xArray);
+  CHECK_NOT_NULL(inputCellIdArray);
+  CHECK_INT(xArray->GetNumberOfTuples(), output->GetNumberOfPoints());
+  CHECK_INT(inputCellIdArray->GetNumberOfTuples(), output->GetNumberOfCells());
+  double point[3] = { 0.0, 0.0, 0.0 };
+  for (vtkIdType pointId = 0; pointId < output->GetNumberOfPoints(); ++pointId)
+    {
+    output->GetPoint(pointId, point);
+    CHECK_DOUBLE_TOLERANCE(xArray->GetTuple1(pointId), point[0], 1e-6);
+    }
+  vtkNew<vtkIdList> pointIds;
+  vtkNew<vtkIdList> inputPointIds;
+  double inputPoint[3] = { 0.0, 0.0, 0.0 };
+  for (vtkIdType cellId = 0; cellId < output->GetNumberOfCells(); ++cellId)
+    {
+    output->GetCellPoints(cellId, pointIds);
+    input->GetCellPoints(static_cast<vtkIdType>(inputCellIdArray->GetTuple1(cellId)), inputPointIds);
+    bool sharedPoint = false;
+    for (vtkIdType i = 0; i < pointIds->GetNumberOfIds() && !sharedPoint; ++i)
+      {
+      output->GetPoint(pointIds->GetId(i), point);
+      for (vtkIdType j = 0; j < inputPointIds->GetNumberOfIds() && !sharedPoint; ++j)
+        {
+        input->GetPoint(inputPointIds->GetId(j), inputPoint);
+        sharedPoint = (vtkMath::Distance2BetweenPoints(point, inputPoint) < 1e-12);
+        }
+      }
+    CHECK_BOOL(sharedPoint, true);
+    }
+  return EXIT_SUCCESS;
+}
+
+//----------------------------------------------------------------------------
+// With the hierarchy, the outputs are updated from the previous run. They must match clipping from scratch, have no
+// unused points, keep the point and cell data of the input and leave the previously returned meshes unchanged.
+int TestParallelPlaneClipperIncrementalUpdate()
+{
+  vtkSmartPointer<vtkPolyData> sphere = CreateSphere();
+  vtkNew<vtkDoubleArray> xArray;
+  xArray->SetName("X");
+  xArray->SetNumberOfValues(sphere->GetNumberOfPoints());
+  for (vtkIdType pointId = 0; pointId < sphere->GetNumberOfPoints(); ++pointId)
+    {
+    xArray->SetValue(pointId, sphere->GetPoint(pointId)[0]);
+    }
+  sphere->GetPointData()->AddArray(xArray);
+  vtkNew<vtkIdTypeArray> inputCellIdArray;
+  inputCellIdArray->SetName("InputCellId");
+  inputCellIdArray->SetNumberOfValues(sphere->GetNumberOfCells());
+  for (vtkIdType cellId = 0; cellId < sphere->GetNumberOfCells(); ++cellId)
+    {
+    inputCellIdArray->SetValue(cellId, cellId);
+    }
+  sphere->GetCellData()->AddArray(inputCellIdArray);
+
+  vtkNew<vtkPlaneCollection> boxPlanes;
+  for (int axis = 0; axis < 3; ++axis)
+    {
+    for (int side = -1; side <= 1; side += 2)
+      {
+      double origin[3] = { 10.0, 0.0, 0.0 };
+      origin[axis] += side * 2.5;
+      double normal[3] = { 0.0, 0.0, 0.0 };
+      normal[axis] = -side;
+      vtkNew<vtkPlane> boxPlane;
+      boxPlane->SetOrigin(origin);
+      boxPlane->SetNormal(normal);
+      boxPlanes->AddItem(boxPlane);
+      }
+    }
+  vtkNew<vtkParallelPlaneClipper> hierarchyClipper;
+  hierarchyClipper->SetInputData(sphere);
+  hierarchyClipper->SetClipPlanes(boxPlanes);
+  hierarchyClipper->SetOperationTypeToIntersection();
+  hierarchyClipper->GenerateClippedOutputOn();
+  hierarchyClipper->UseBoundingVolumeHierarchyOn();
+  hierarchyClipper->Update();
+
+  // Small steps, a jump to another part of the sphere, then small steps again
+  const double steps[6][3] = { { -0.3, 0.2, 0.0 }, { -0.3, 0.2, 0.1 }, { -0.2, 0.3, 0.0 }, { -9.0, 9.0, 0.0 },
+    { 0.2, -0.3, 0.0 }, { 0.0, 0.4, -0.3 } };
+  for (int step = 0; step < 6; ++step)
+    {
+    vtkNew<vtkPolyData> previousOutput;
+    previousOutput->ShallowCopy(hierarchyClipper->GetClippedOutput());
+    vtkNew<vtkPolyData> previousOutputCopy;
+    previousOutputCopy->DeepCopy(previousOutput);
+
+    for (int i = 0; i < boxPlanes->GetNumberOfItems(); ++i)
+      {
+      double origin[3] = { 0.0, 0.0, 0.0 };
+      boxPlanes->GetItem(i)->GetOrigin(origin);
+      boxPlanes->GetItem(i)->SetOrigin(origin[0] + steps[step][0], origin[1] + steps[step][1], origin[2] + steps[step][2]);
+      }
+    hierarchyClipper->Update();
+
+    vtkNew<vtkParallelPlaneClipper> clipper;
+    clipper->SetInputData(sphere);
+    clipper->SetClipPlanes(boxPlanes);
+    clipper->SetOperationTypeToIntersection();
+    clipper->GenerateClippedOutputOn();
+    clipper->Update();
+    vtkPolyData* outputs[2] = { hierarchyClipper->GetOutput(), hierarchyClipper->GetClippedOutput() };
+    vtkPolyData* referenceOutputs[2] = { clipper->GetOutput(), clipper->GetClippedOutput() };
+    for (int i = 0; i < 2; ++i)
+      {
+      CHECK_INT(outputs[i]->GetNumberOfPolys(), referenceOutputs[i]->GetNumberOfPolys());
+      CHECK_INT(outputs[i]->GetNumberOfPoints(), referenceOutputs[i]->GetNumberOfPoints());
+      CHECK_DOUBLE_TOLERANCE(GetSurfaceArea(outputs[i]), GetSurfaceArea(referenceOutputs[i]), 1e-6);
+      CHECK_INT(GetNumberOfUnusedPoints(outputs[i]), 0);
+      CHECK_EXIT_SUCCESS(CheckClipperAttributes(sphere, outputs[i]));
+      }
+    CHECK_BOOL(hierarchyClipper->GetOutput()->GetNumberOfPolys() > 0, true);
+
+    // The previous output shares its arrays with the filter, they must not be modified by the update
+    CHECK_INT(previousOutput->GetNumberOfPoints(), previousOutputCopy->GetNumberOfPoints());
+    CHECK_INT(previousOutput->GetNumberOfPolys(), previousOutputCopy->GetNumberOfPolys());
+    vtkNew<vtkIdList> pointIds;
+    vtkNew<vtkIdList> copyPointIds;
+    for (vtkIdType cellId = 0; cellId < previousOutput->GetNumberOfCells(); ++cellId)
+      {
+      previousOutput->GetCellPoints(cellId, pointIds);
+      previousOutputCopy->GetCellPoints(cellId, copyPointIds);
+      CHECK_INT(pointIds->GetNumberOfIds(), copyPointIds->GetNumberOfIds());
+      for (vtkIdType i = 0; i < pointIds->GetNumberOfIds(); ++i)
+        {
+        CHECK_INT(pointIds->GetId(i), copyPointIds->GetId(i));
+        }
+      }
+    for (vtkIdType pointId = 0; pointId < previousOutput->GetNumberOfPoints(); ++pointId)
+      {
+      CHECK_DOUBLE(vtkMath::Distance2BetweenPoints(previousOutput->GetPoint(pointId), previousOutputCopy->GetPoint(pointId)), 0.0);
+      }
+    CHECK_EXIT_SUCCESS(CheckClipperAttributes(sphere, previousOutput));
+    }
+
+  return EXIT_SUCCESS;
+}
+
+//----------------------------------------------------------------------------
+int TestPlaneBorderPolylines()
+{
+  vtkNew<vtkSphereSource> sphereSource;
+  sphereSource->SetRadius(6.0);
+  sphereSource->SetThetaResolution(30);
+  sphereSource->SetPhiResolution(30);
+  sphereSource->Update();
+  vtkPolyData* sphere = sphereSource->GetOutput();
+
+  // Closed sphere, the border is a single closed loop of mesh points on the positive side
+  vtkNew<vtkPlane> plane;
+  plane->SetOrigin(0.0, 0.0, 1.3);
+  plane->SetNormal(0.0, 0.3, 1.0);
+  vtkNew<vtkPolyData> polylines;
+  vtkParallelPlaneClipper::ExtractPlaneBorder(sphere, plane, polylines);
+  CHECK_INT(polylines->GetNumberOfLines(), 1);
+  vtkNew<vtkIdList> polyline;
+  polylines->GetLines()->GetCellAtId(0, polyline);
+  CHECK_INT(polyline->GetNumberOfIds(), polylines->GetNumberOfPoints() + 1);
+  CHECK_INT(polyline->GetId(0), polyline->GetId(polyline->GetNumberOfIds() - 1));
+  for (vtkIdType pointId = 0; pointId < polylines->GetNumberOfPoints(); ++pointId)
+    {
+    CHECK_BOOL(plane->EvaluateFunction(polylines->GetPoint(pointId)) > 0.0, true);
+    }
+
+  // Same edges as the boundary of the extracted polygons
+  vtkNew<vtkExtractPolyDataGeometry> extractor;
+  extractor->SetInputData(sphere);
+  extractor->SetImplicitFunction(plane);
+  extractor->ExtractInsideOff();
+  extractor->ExtractBoundaryCellsOff();
+  vtkNew<vtkFeatureEdges> boundaryEdges;
+  boundaryEdges->SetInputConnection(extractor->GetOutputPort());
+  boundaryEdges->BoundaryEdgesOn();
+  boundaryEdges->FeatureEdgesOff();
+  boundaryEdges->NonManifoldEdgesOff();
+  boundaryEdges->ManifoldEdgesOff();
+  boundaryEdges->Update();
+  CHECK_INT(polyline->GetNumberOfIds() - 1, boundaryEdges->GetOutput()->GetNumberOfLines());
+
+  // Open half sphere, the border is a single open polyline
+  vtkNew<vtkPlaneCollection> clipPlanes;
+  vtkNew<vtkPlane> clipPlane;
+  clipPlane->SetNormal(0.0, 1.0, 0.0);
+  clipPlanes->AddItem(clipPlane);
+  vtkNew<vtkParallelPlaneClipper> clipper;
+  clipper->SetInputData(sphere);
+  clipper->SetClipPlanes(clipPlanes);
+  clipper->Update();
+  vtkNew<vtkPlane> cutPlane;
+  cutPlane->SetOrigin(0.1, 0.0, 0.0);
+  cutPlane->SetNormal(1.0, 0.0, 0.0);
+  vtkParallelPlaneClipper::ExtractPlaneBorder(clipper->GetOutput(), cutPlane, polylines);
+  CHECK_INT(polylines->GetNumberOfLines(), 1);
+  polylines->GetLines()->GetCellAtId(0, polyline);
+  CHECK_INT(polyline->GetNumberOfIds(), polylines->GetNumberOfPoints());
+  CHECK_BOOL(polyline->GetId(0) != polyline->GetId(polyline->GetNumberOfIds() - 1), true);
+
+  return EXIT_SUCCESS;
+}
+
+}
+
+//----------------------------------------------------------------------------
+int vtkParallelPlaneClipperTest(int vtkNotUsed(argc), char* vtkNotUsed(argv)[])
+{
+  CHECK_EXIT_SUCCESS(TestParallelPlaneClipper());
+  CHECK_EXIT_SUCCESS(TestParallelPlaneClipperIncrementalUpdate());
+  CHECK_EXIT_SUCCESS(TestPlaneBorderPolylines());
+  return EXIT_SUCCESS;
+}
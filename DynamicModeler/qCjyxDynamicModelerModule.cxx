@@ -32,12 +32,18 @@
 // Subject hierarchy includes
 #include <qCjyxSubjectHierarchyPluginHandler.h>
 
+// Qt includes
+#include <QTimer>
+
 //-----------------------------------------------------------------------------
 /// \ingroup Cjyx_QtModules_ExtensionTemplate
 class qCjyxDynamicModelerModulePrivate
 {
 public:
   qCjyxDynamicModelerModulePrivate();
+
+  /// Timer that is used for processing the results of asynchronous tool runs on the main thread
+  QTimer PendingUpdatesTimer;
 };
 
 //-----------------------------------------------------------------------------
@@ -55,6 +61,9 @@ qCjyxDynamicModelerModule::qCjyxDynamicModelerModule(QObject* _parent)
   : Superclass(_parent)
   , d_ptr(new qCjyxDynamicModelerModulePrivate)
 {
+  Q_D(qCjyxDynamicModelerModule);
+  d->PendingUpdatesTimer.setSingleShot(true);
+  connect(&d->PendingUpdatesTimer, SIGNAL(timeout()), this, SLOT(onProcessPendingUpdates()));
 }
 
 //-----------------------------------------------------------------------------
@@ -107,12 +116,41 @@ void qCjyxDynamicModelerModule::setup()
 
   vtkCjyxDynamicModelerLogic* dynamicModelerLogic = vtkCjyxDynamicModelerLogic::SafeDownCast(this->logic());
 
+  // Continuous updates are computed on worker threads so that the application remains responsive
+  dynamicModelerLogic->SetAsynchronousExecution(true);
+  qvtkConnect(dynamicModelerLogic, vtkCjyxDynamicModelerLogic::UpdateRequestedEvent, this, SLOT(onUpdateRequested()));
+
   // Register Subject Hierarchy core plugins
   qCjyxSubjectHierarchyDynamicModelerPlugin* dynamicModelerPlugin = new qCjyxSubjectHierarchyDynamicModelerPlugin();
   dynamicModelerPlugin->setDynamicModelerLogic(dynamicModelerLogic);
   qCjyxSubjectHierarchyPluginHandler::instance()->registerPlugin(dynamicModelerPlugin);
 }
 
+//-----------------------------------------------------------------------------
+void qCjyxDynamicModelerModule::onUpdateRequested()
+{
+  Q_D(qCjyxDynamicModelerModule);
+  // All update requests until the timer is triggered are processed together
+  d->PendingUpdatesTimer.start(0);
+}
+
+//-----------------------------------------------------------------------------
+void qCjyxDynamicModelerModule::onProcessPendingUpdates()
+{
+  Q_D(qCjyxDynamicModelerModule);
+  vtkCjyxDynamicModelerLogic* dynamicModelerLogic = vtkCjyxDynamicModelerLogic::SafeDownCast(this->logic());
+  if (!dynamicModelerLogic)
+    {
+    return;
+    }
+  dynamicModelerLogic->ProcessPendingUpdates();
+  if (dynamicModelerLogic->HasPendingUpdates())
+    {
+    // Check for completed runs again shortly, without blocking the event loop
+    d->PendingUpdatesTimer.start(15);
+    }
+}
+
 //-----------------------------------------------------------------------------
 qCjyxAbstractModuleRepresentation* qCjyxDynamicModelerModule
 ::createWidgetRepresentation()
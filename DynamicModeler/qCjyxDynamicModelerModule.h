@@ -27,6 +27,9 @@
 
 #include "qCjyxDynamicModelerModuleExport.h"
 
+// CTK includes
+#include <ctkVTKObject.h>
+
 class qCjyxDynamicModelerModulePrivate;
 
 /// \ingroup Cjyx_QtModules_ExtensionTemplate
@@ -35,6 +38,7 @@ qCjyxDynamicModelerModule
   : public qCjyxLoadableModule
 {
   Q_OBJECT
+  QVTK_OBJECT
   Q_PLUGIN_METADATA(IID "org.cjyx.modules.loadable.qCjyxLoadableModule/1.0");
   Q_INTERFACES(qCjyxLoadableModule);
 
@@ -59,6 +63,13 @@ public:
   /// Specify editable node types
   QStringList associatedNodeTypes() const override;
 
+protected slots:
+  /// Schedule processing of pending updates in the next event loop iteration
+  void onUpdateRequested();
+
+  /// Publish the results of tools that were run asynchronously and start the next requested runs
+  void onProcessPendingUpdates();
+
 protected:
 
   /// Initialize the module. Register the volumes reader/writer
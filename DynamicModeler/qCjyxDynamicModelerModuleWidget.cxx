@@ -22,10 +22,13 @@
 // Qt includes
 #include <QCheckBox>
 #include <QDebug>
+#include <QFileDialog>
 #include <QFormLayout>
 #include <QLabel>
 #include <QLineEdit>
 #include <QSpinBox>
+#include <QTableWidget>
+#include <QTimer>
 
 // ctk includes
 #include <ctkDoubleSpinBox.h>
@@ -42,7 +45,10 @@
 #include <vtkDMMLNode.h>
 
 // VTK includes
+#include <vtkNew.h>
 #include <vtkStringArray.h>
+#include <vtkTable.h>
+#include <vtkVariant.h>
 
 // DynamicModeler Logic includes
 #include <vtkCjyxDynamicModelerAppendTool.h>
@@ -72,6 +78,14 @@ public:
   vtkWeakPointer<vtkDMMLDynamicModelerNode> DynamicModelerNode{ nullptr };
 
   std::string CurrentToolName;
+
+  /// Polls the progress of the tool while the module is active
+  QTimer ProgressTimer;
+  /// Refreshes the profile tables while the module is active
+  QTimer ProfileTimer;
+
+  /// Fill the table widget with the content of the table
+  static void updateTableWidget(QTableWidget* tableWidget, vtkTable* table);
 };
 
 //-----------------------------------------------------------------------------
@@ -81,6 +95,30 @@ public:
 qCjyxDynamicModelerModuleWidgetPrivate::qCjyxDynamicModelerModuleWidgetPrivate()
 = default;
 
+//-----------------------------------------------------------------------------
+void qCjyxDynamicModelerModuleWidgetPrivate::updateTableWidget(QTableWidget* tableWidget, vtkTable* table)
+{
+  tableWidget->clear();
+  tableWidget->setColumnCount(table->GetNumberOfColumns());
+  tableWidget->setRowCount(table->GetNumberOfRows());
+  QStringList columnNames;
+  for (vtkIdType column = 0; column < table->GetNumberOfColumns(); ++column)
+    {
+    columnNames << QString::fromStdString(table->GetColumnName(column) ? table->GetColumnName(column) : "");
+    }
+  tableWidget->setHorizontalHeaderLabels(columnNames);
+  for (vtkIdType row = 0; row < table->GetNumberOfRows(); ++row)
+    {
+    for (vtkIdType column = 0; column < table->GetNumberOfColumns(); ++column)
+      {
+      vtkVariant value = table->GetValue(row, column);
+      QString text = value.IsDouble() ? QString::number(value.ToDouble(), 'g', 4) : QString::fromStdString(value.ToString());
+      tableWidget->setItem(row, column, new QTableWidgetItem(text));
+      }
+    }
+  tableWidget->resizeColumnsToContents();
+}
+
 //-----------------------------------------------------------------------------
 // qCjyxDynamicModelerModuleWidget methods
 
@@ -144,6 +182,43 @@ void qCjyxDynamicModelerModuleWidget::setup()
     this, SLOT(onApplyButtonClicked()));
   connect(d->ApplyButton, SIGNAL(clicked()),
     this, SLOT(onApplyButtonClicked()));
+
+  d->ProgressBar->hide();
+  d->CancelButton->hide();
+  connect(d->CancelButton, SIGNAL(clicked()),
+    this, SLOT(onCancelButtonClicked()));
+  d->ProgressTimer.setInterval(100);
+  connect(&d->ProgressTimer, SIGNAL(timeout()),
+    this, SLOT(updateProgress()));
+
+  connect(d->ProfileCollapsibleButton, SIGNAL(contentsCollapsed(bool)),
+    this, SLOT(updateProfileTables()));
+  connect(d->ExportProfileCsvButton, SIGNAL(clicked()),
+    this, SLOT(onExportProfileClicked()));
+  connect(d->ResetProfileButton, SIGNAL(clicked()),
+    this, SLOT(onResetProfileClicked()));
+  d->ProfileTimer.setInterval(1000);
+  connect(&d->ProfileTimer, SIGNAL(timeout()),
+    this, SLOT(updateProfileTables()));
+}
+
+//-----------------------------------------------------------------------------
+void qCjyxDynamicModelerModuleWidget::enter()
+{
+  Q_D(qCjyxDynamicModelerModuleWidget);
+  this->Superclass::enter();
+  d->ProgressTimer.start();
+  d->ProfileTimer.start();
+  this->updateProfileTables();
+}
+
+//-----------------------------------------------------------------------------
+void qCjyxDynamicModelerModuleWidget::exit()
+{
+  Q_D(qCjyxDynamicModelerModuleWidget);
+  d->ProgressTimer.stop();
+  d->ProfileTimer.stop();
+  this->Superclass::exit();
 }
 
 //-----------------------------------------------------------------------------
@@ -788,5 +863,93 @@ void qCjyxDynamicModelerModuleWidget::onApplyButtonClicked()
 
   /// Continuous update is off, trigger manual update.
   vtkCjyxDynamicModelerLogic* meshModifyLogic = vtkCjyxDynamicModelerLogic::SafeDownCast(this->logic());
-  meshModifyLogic->RunDynamicModelerTool(d->DynamicModelerNode);
+  if (meshModifyLogic->GetAsynchronousExecution())
+    {
+    // Keep the application responsive and show the progress while the tool is running
+    meshModifyLogic->RunDynamicModelerToolAsynchronously(d->DynamicModelerNode);
+    }
+  else
+    {
+    meshModifyLogic->RunDynamicModelerTool(d->DynamicModelerNode);
+    }
+  this->updateProgress();
+}
+
+//-----------------------------------------------------------------------------
+void qCjyxDynamicModelerModuleWidget::onCancelButtonClicked()
+{
+  Q_D(qCjyxDynamicModelerModuleWidget);
+  if (!d->DynamicModelerNode)
+    {
+    return;
+    }
+  vtkCjyxDynamicModelerLogic* meshModifyLogic = vtkCjyxDynamicModelerLogic::SafeDownCast(this->logic());
+  meshModifyLogic->AbortDynamicModelerTool(d->DynamicModelerNode);
+  this->updateProgress();
+}
+
+//-----------------------------------------------------------------------------
+void qCjyxDynamicModelerModuleWidget::updateProgress()
+{
+  Q_D(qCjyxDynamicModelerModuleWidget);
+  vtkCjyxDynamicModelerLogic* meshModifyLogic = vtkCjyxDynamicModelerLogic::SafeDownCast(this->logic());
+  double progress = -1.0;
+  if (d->DynamicModelerNode && meshModifyLogic)
+    {
+    progress = meshModifyLogic->GetDynamicModelerToolProgress(d->DynamicModelerNode);
+    }
+  bool running = progress >= 0.0;
+  d->ProgressBar->setVisible(running);
+  d->CancelButton->setVisible(running);
+  if (running)
+    {
+    d->ProgressBar->setValue(static_cast<int>(progress * 100.0));
+    }
+}
+
+//-----------------------------------------------------------------------------
+void qCjyxDynamicModelerModuleWidget::updateProfileTables()
+{
+  Q_D(qCjyxDynamicModelerModuleWidget);
+  if (d->ProfileCollapsibleButton->collapsed())
+    {
+    return;
+    }
+  vtkCjyxDynamicModelerLogic* meshModifyLogic = vtkCjyxDynamicModelerLogic::SafeDownCast(this->logic());
+  if (!meshModifyLogic)
+    {
+    return;
+    }
+
+  vtkNew<vtkTable> nodeProfileTable;
+  meshModifyLogic->GetNodeProfileTable(d->DynamicModelerNode, nodeProfileTable);
+  d->updateTableWidget(d->NodeProfileTable, nodeProfileTable);
+
+  vtkNew<vtkTable> sceneProfileTable;
+  meshModifyLogic->GetSceneProfileTable(sceneProfileTable);
+  d->updateTableWidget(d->SceneProfileTable, sceneProfileTable);
+  d->ExportProfileCsvButton->setEnabled(sceneProfileTable->GetNumberOfRows() > 0);
+}
+
+//-----------------------------------------------------------------------------
+void qCjyxDynamicModelerModuleWidget::onExportProfileClicked()
+{
+  QString filePath = QFileDialog::getSaveFileName(this, "Export profile", "DynamicModelerProfile.csv", "CSV files (*.csv)");
+  if (filePath.isEmpty())
+    {
+    return;
+    }
+  vtkCjyxDynamicModelerLogic* meshModifyLogic = vtkCjyxDynamicModelerLogic::SafeDownCast(this->logic());
+  if (!meshModifyLogic->SaveProfileToCSV(filePath.toUtf8().constData()))
+    {
+    qCritical() << Q_FUNC_INFO << ": Failed to export profile to " << filePath;
+    }
+}
+
+//-----------------------------------------------------------------------------
+void qCjyxDynamicModelerModuleWidget::onResetProfileClicked()
+{
+  vtkCjyxDynamicModelerLogic* meshModifyLogic = vtkCjyxDynamicModelerLogic::SafeDownCast(this->logic());
+  meshModifyLogic->ResetProfile();
+  this->updateProfileTables();
 }
@@ -47,6 +47,9 @@ public:
   /// The button will create a new node using the tool when clicked.
   void addToolButton(QIcon icon, vtkCjyxDynamicModelerTool* tool, int row, int column);
 
+  void enter() override;
+  void exit() override;
+
 protected:
   QScopedPointer<qCjyxDynamicModelerModuleWidgetPrivate> d_ptr;
 
@@ -68,6 +71,13 @@ protected slots:
   void updateWidgetFromDMML();
   void updateDMMLFromWidget();
   void onApplyButtonClicked();
+  void onCancelButtonClicked();
+  /// Show the progress of the tool of the current node while it is running on a worker thread.
+  void updateProgress();
+  /// Update the profile tables, if the profile section is expanded.
+  void updateProfileTables();
+  void onExportProfileClicked();
+  void onResetProfileClicked();
 
 private:
   Q_DECLARE_PRIVATE(qCjyxDynamicModelerModuleWidget);
@@ -0,0 +1,185 @@
+#include "DynamicModelerBatchCLP.h"
+
+// DynamicModeler Logic includes
+#include "vtkCjyxDynamicModelerLogic.h"
+#include "vtkCjyxDynamicModelerTool.h"
+#include "vtkCjyxDynamicModelerToolFactory.h"
+
+// DynamicModeler DMML includes
+#include "vtkDMMLDynamicModelerNode.h"
+
+// Markups Logic includes
+#include "vtkCjyxMarkupsLogic.h"
+
+// DMML includes
+#include "vtkDMMLModelNode.h"
+#include "vtkDMMLModelStorageNode.h"
+#include "vtkDMMLScene.h"
+
+// VTK includes
+#include "vtkCallbackCommand.h"
+#include "vtkNew.h"
+#include "vtkPointSet.h"
+#include "vtkSmartPointer.h"
+#include "vtkTable.h"
+#include "vtkTimerLog.h"
+#include <vtksys/SystemTools.hxx>
+
+// STD includes
+#include <cctype>
+#include <iomanip>
+#include <set>
+
+namespace
+{
+
+//----------------------------------------------------------------------------
+// Node names may contain characters that are not allowed in file names
+std::string GetSafeFileName(const std::string& name)
+{
+  std::string safeName;
+  for (char c : name)
+    {
+    safeName += (std::isalnum(static_cast<unsigned char>(c)) || c == '-' || c == '_' || c == '.') ? c : '_';
+    }
+  return safeName.empty() ? std::string("Model") : safeName;
+}
+
+} // end of anonymous namespace
+
+int main(int argc, char* argv[])
+{
+  PARSE_ARGS;
+
+  if (!vtksys::SystemTools::FileExists(inputScene, true))
+    {
+    std::cerr << "Input scene file not found: " << inputScene << std::endl;
+    return EXIT_FAILURE;
+    }
+  if (!vtksys::SystemTools::MakeDirectory(outputDirectory))
+    {
+    std::cerr << "Unable to create output directory: " << outputDirectory << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // Logic classes register the node classes of the scene.
+  // Markups nodes are the inputs of most tools (planes, curves, ROIs, points).
+  vtkNew<vtkDMMLScene> scene;
+  vtkNew<vtkCjyxMarkupsLogic> markupsLogic;
+  markupsLogic->SetDMMLScene(scene);
+  vtkNew<vtkCjyxDynamicModelerLogic> dynamicModelerLogic;
+  dynamicModelerLogic->SetDMMLScene(scene);
+  dynamicModelerLogic->SetAsynchronousExecution(true);
+
+  // Requested updates are processed below, after all nodes are scheduled, so that the logic
+  // can update them in dependency order and run the independent nodes concurrently.
+  vtkNew<vtkCallbackCommand> updateRequestedCallback;
+  dynamicModelerLogic->AddObserver(vtkCjyxDynamicModelerLogic::UpdateRequestedEvent, updateRequestedCallback);
+
+  double loadStartTime = vtkTimerLog::GetUniversalTime();
+  std::string inputScenePath = vtksys::SystemTools::CollapseFullPath(inputScene);
+  scene->SetURL(inputScenePath.c_str());
+  scene->SetRootDirectory(vtksys::SystemTools::GetFilenamePath(inputScenePath).c_str());
+  if (!scene->Import())
+    {
+    std::cerr << "Unable to load scene: " << inputScene << std::endl;
+    return EXIT_FAILURE;
+    }
+  std::cout << "Scene loaded in " << vtkTimerLog::GetUniversalTime() - loadStartTime << " s" << std::endl;
+
+  // Tools are instantiated by the logic, using the tool factory
+  std::vector<vtkDMMLNode*> nodes;
+  scene->GetNodesByClass("vtkDMMLDynamicModelerNode", nodes);
+  std::vector<vtkDMMLDynamicModelerNode*> scheduledNodes;
+  bool success = true;
+  for (vtkDMMLNode* node : nodes)
+    {
+    vtkDMMLDynamicModelerNode* dynamicModelerNode = vtkDMMLDynamicModelerNode::SafeDownCast(node);
+    vtkCjyxDynamicModelerTool* tool = dynamicModelerLogic->GetDynamicModelerTool(dynamicModelerNode);
+    if (!tool)
+      {
+      std::cerr << "Node " << dynamicModelerNode->GetName() << ": unknown tool '"
+        << (dynamicModelerNode->GetToolName() ? dynamicModelerNode->GetToolName() : "") << "'. Available tools:";
+      for (const std::string& toolName : vtkCjyxDynamicModelerToolFactory::GetInstance()->GetDynamicModelerToolNames())
+        {
+        std::cerr << " '" << toolName << "'";
+        }
+      std::cerr << std::endl;
+      success = false;
+      continue;
+      }
+    if (!tool->HasRequiredInputs(dynamicModelerNode) || !tool->HasOutput(dynamicModelerNode))
+      {
+      std::cout << "Node " << dynamicModelerNode->GetName() << ": skipped, required inputs or outputs are not set" << std::endl;
+      continue;
+      }
+    scheduledNodes.push_back(dynamicModelerNode);
+    dynamicModelerLogic->RequestDynamicModelerToolUpdate(dynamicModelerNode);
+    }
+
+  double updateStartTime = vtkTimerLog::GetUniversalTime();
+  dynamicModelerLogic->WaitForAsynchronousRuns();
+  double updateWallTimeSec = vtkTimerLog::GetUniversalTime() - updateStartTime;
+
+  // Per-node timings
+  std::string outputFileExtension = "." + outputFileFormat;
+  std::set<std::string> writtenFileNames;
+  vtkNew<vtkTable> profileTable;
+  for (vtkDMMLDynamicModelerNode* dynamicModelerNode : scheduledNodes)
+    {
+    vtkCjyxDynamicModelerTool* tool = dynamicModelerLogic->GetDynamicModelerTool(dynamicModelerNode);
+    if (!dynamicModelerLogic->GetNodeProfileTable(dynamicModelerNode, profileTable))
+      {
+      std::cerr << "Node " << dynamicModelerNode->GetName() << " (" << tool->GetName() << "): failed" << std::endl;
+      success = false;
+      continue;
+      }
+    const vtkCjyxDynamicModelerTool::RunProfile& runProfile = tool->GetLastRunProfile();
+    std::cout << "Node " << dynamicModelerNode->GetName() << " (" << tool->GetName() << "): "
+      << runProfile.WallTimeSec << " s, " << runProfile.InputPoints << " input points, "
+      << runProfile.OutputPoints << " output points" << std::endl;
+    for (vtkIdType row = 0; row < profileTable->GetNumberOfRows(); ++row)
+      {
+      std::cout << "  " << std::left << std::setw(20) << profileTable->GetValue(row, 0).ToString()
+        << profileTable->GetValue(row, 1).ToDouble() << " s" << std::endl;
+      }
+
+    // Write the output models
+    for (int outputIndex = 0; outputIndex < tool->GetNumberOfOutputNodes(); ++outputIndex)
+      {
+      vtkDMMLModelNode* outputModelNode = vtkDMMLModelNode::SafeDownCast(tool->GetNthOutputNode(outputIndex, dynamicModelerNode));
+      if (!outputModelNode || !outputModelNode->GetMesh())
+        {
+        continue;
+        }
+      std::string fileName = GetSafeFileName(outputModelNode->GetName() ? outputModelNode->GetName() : "");
+      if (writtenFileNames.find(fileName) != writtenFileNames.end())
+        {
+        // Node names are not unique, node IDs are
+        fileName += "_" + GetSafeFileName(outputModelNode->GetID());
+        }
+      writtenFileNames.insert(fileName);
+      std::string filePath = outputDirectory + "/" + fileName + outputFileExtension;
+      vtkNew<vtkDMMLModelStorageNode> storageNode;
+      storageNode->SetFileName(filePath.c_str());
+      if (!storageNode->WriteData(outputModelNode))
+        {
+        std::cerr << "Unable to write output model: " << filePath << std::endl;
+        success = false;
+        continue;
+        }
+      std::cout << "  Output written to " << filePath << std::endl;
+      }
+    }
+  std::cout << "Updated " << scheduledNodes.size() << " nodes in " << updateWallTimeSec << " s" << std::endl;
+
+  if (!timingReport.empty() && !dynamicModelerLogic->SaveProfileToCSV(timingReport.c_str()))
+    {
+    std::cerr << "Unable to write timing report: " << timingReport << std::endl;
+    success = false;
+    }
+
+  dynamicModelerLogic->SetDMMLScene(nullptr);
+  markupsLogic->SetDMMLScene(nullptr);
+  return success ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -51,6 +51,8 @@ class SurfaceToolboxWidget(ScriptedLoadableModuleWidget, VTKObservationMixin):
     self.logic = None
     self._parameterNode = None
     self._updatingGUIFromParameterNode = False
+    self._previewRoiNode = None
+    self._lastPreviewRequest = None
 
   def setup(self):
     """
@@ -124,6 +126,9 @@ class SurfaceToolboxWidget(ScriptedLoadableModuleWidget, VTKObservationMixin):
       (self.ui.extractEdgesFeatureAngleSlider, "extractEdgesFeatureAngle"),
       (self.ui.extractEdgesNonManifoldCheckBox, "extractEdgesNonManifold"),
       (self.ui.extractEdgesManifoldCheckBox, "extractEdgesManifold"),
+      (self.ui.previewCheckBox, "preview"),
+      (self.ui.previewTargetTrianglesSlider, "previewTargetTriangles"),
+      (self.ui.previewRoiSelector, "previewRoi"),
     ]
 
     cjyx.util.addParameterEditWidgetConnections(self.parameterEditWidgets, self.updateParameterNodeFromGUI)
@@ -132,6 +137,15 @@ class SurfaceToolboxWidget(ScriptedLoadableModuleWidget, VTKObservationMixin):
     self.ui.applyButton.connect('clicked(bool)', self.onApplyButton)
     self.ui.toggleModelsButton.connect('clicked()', self.onToggleModels)
 
+    # Preview is updated with a short delay to not recompute it on each small change while a slider is dragged
+    self.previewTimer = qt.QTimer()
+    self.previewTimer.setSingleShot(True)
+    self.previewTimer.setInterval(300)
+    self.previewTimer.connect('timeout()', self.updatePreview)
+
+    self.ui.exportProfileCsvButton.connect('clicked()', lambda: self.onExportProfile("CSV files (*.csv)", ".csv"))
+    self.ui.exportProfileJsonButton.connect('clicked()', lambda: self.onExportProfile("JSON files (*.json)", ".json"))
+
     # Make sure parameter node is initialized (needed for module reload)
     self.initializeParameterNode()
 
@@ -147,6 +161,7 @@ class SurfaceToolboxWidget(ScriptedLoadableModuleWidget, VTKObservationMixin):
     """
     Called when the application closes and the module widget is destroyed.
     """
+    self.previewTimer.stop()
     self.removeObservers()
 
   def enter(self):
@@ -244,6 +259,32 @@ class SurfaceToolboxWidget(ScriptedLoadableModuleWidget, VTKObservationMixin):
     self.ui.toggleModelsButton.enabled = modelsSelected
     self.ui.applyButton.enabled = modelsSelected
 
+    # Observe the preview ROI so that the preview is updated when the ROI is moved or resized
+    previewRoiNode = self._parameterNode.GetNodeReference("previewRoi")
+    if previewRoiNode != self._previewRoiNode:
+      if self._previewRoiNode:
+        self.removeObserver(self._previewRoiNode, vtk.vtkCommand.ModifiedEvent, self.onPreviewRoiModified)
+      self._previewRoiNode = previewRoiNode
+      if self._previewRoiNode:
+        self.addObserver(self._previewRoiNode, vtk.vtkCommand.ModifiedEvent, self.onPreviewRoiModified)
+
+    # Only recompute the preview if inputs or processing parameters changed
+    # (parameter node is also modified by processing, for example when the profile is updated)
+    if self._parameterNode.GetParameter("preview") == "true":
+      if self.getPreviewRequest() != self._lastPreviewRequest:
+        self.previewTimer.start()
+    else:
+      self.previewTimer.stop()
+      self._lastPreviewRequest = None
+      previewModelNode = self._parameterNode.GetNodeReference("previewModel")
+      if previewModelNode and previewModelNode.GetDisplayNode() and previewModelNode.GetDisplayNode().GetVisibility():
+        previewModelNode.GetDisplayNode().VisibilityOff()
+        inputModelNode = self._parameterNode.GetNodeReference("inputModel")
+        if inputModelNode and inputModelNode.GetDisplayNode():
+          inputModelNode.GetDisplayNode().VisibilityOn()
+
+    self.updateProfileTable()
+
     # All the GUI updates are done
     self._updatingGUIFromParameterNode = False
 
@@ -276,6 +317,9 @@ class SurfaceToolboxWidget(ScriptedLoadableModuleWidget, VTKObservationMixin):
       cjyx.app.processEvents()
       inputModelNode.GetModelDisplayNode().VisibilityOff()
       outputModelNode.GetModelDisplayNode().VisibilityOn()
+      previewModelNode = self._parameterNode.GetNodeReference("previewModel")
+      if previewModelNode and previewModelNode.GetDisplayNode():
+        previewModelNode.GetDisplayNode().VisibilityOff()
       #cjyx.updateGUIFromParameterNode()
       self.ui.applyButton.text = "Apply"
     except Exception as e:
@@ -288,6 +332,75 @@ class SurfaceToolboxWidget(ScriptedLoadableModuleWidget, VTKObservationMixin):
       cjyx.app.resumeRender()
       qt.QApplication.restoreOverrideCursor()
 
+  def updateProfileTable(self):
+    profile = self.logic.getProfile(self._parameterNode)
+    columnNames = ["Step", "Cached", "Wall time [s]", "CPU time [s]", "Peak memory delta [MB]",
+      "Input points", "Input cells", "Output points", "Output cells"]
+    self.ui.profileTable.setColumnCount(len(columnNames))
+    self.ui.profileTable.setHorizontalHeaderLabels(columnNames)
+    self.ui.profileTable.setRowCount(len(profile))
+    for row, stepProfile in enumerate(profile):
+      for column, key in enumerate(SurfaceToolboxLogic.profileColumns):
+        value = stepProfile.get(key)
+        if value is None:
+          text = ""
+        elif isinstance(value, bool):
+          text = "yes" if value else ""
+        elif isinstance(value, float):
+          text = "{0:.3f}".format(value)
+        else:
+          text = str(value)
+        self.ui.profileTable.setItem(row, column, qt.QTableWidgetItem(text))
+    self.ui.profileTable.resizeColumnsToContents()
+    self.ui.exportProfileCsvButton.enabled = len(profile) > 0
+    self.ui.exportProfileJsonButton.enabled = len(profile) > 0
+
+  def onExportProfile(self, fileFilter, extension):
+    filePath = qt.QFileDialog.getSaveFileName(self.parent, "Export profile", "SurfaceToolboxProfile" + extension, fileFilter)
+    if not filePath:
+      return
+    try:
+      SurfaceToolboxLogic.saveProfile(self.logic.getProfile(self._parameterNode), filePath)
+    except Exception as e:
+      cjyx.util.errorDisplay("Failed to export profile: "+str(e))
+
+  def getPreviewRequest(self):
+    """Get all inputs of the preview computation, for detecting when the preview has to be updated.
+    """
+    inputModelNode = self._parameterNode.GetNodeReference("inputModel")
+    previewRoiNode = self._parameterNode.GetNodeReference("previewRoi")
+    steps = self.logic.getProcessingSteps(self._parameterNode)
+    return (inputModelNode.GetID() if inputModelNode else None, previewRoiNode.GetID() if previewRoiNode else None,
+      self._parameterNode.GetParameter("previewTargetTriangles"), [(step[0], step[3]) for step in steps])
+
+  def onPreviewRoiModified(self, caller=None, event=None):
+    if self._parameterNode and self._parameterNode.GetParameter("preview") == "true":
+      self.previewTimer.start()
+
+  def updatePreview(self):
+    """
+    Run processing on the preview proxy. Called when a parameter is changed while live preview is enabled.
+    """
+    if not self._parameterNode or self._parameterNode.GetParameter("preview") != "true":
+      return
+    inputModelNode = self._parameterNode.GetNodeReference("inputModel")
+    if not inputModelNode or not inputModelNode.GetPolyData():
+      return
+    self._lastPreviewRequest = self.getPreviewRequest()
+    qt.QApplication.setOverrideCursor(qt.Qt.WaitCursor)
+    try:
+      previewModelNode = self.logic.applyFiltersToPreview(self._parameterNode)
+      inputModelNode.GetDisplayNode().VisibilityOff()
+      outputModelNode = self._parameterNode.GetNodeReference("outputModel")
+      if outputModelNode and outputModelNode.GetDisplayNode():
+        outputModelNode.GetDisplayNode().VisibilityOff()
+      previewModelNode.GetDisplayNode().VisibilityOn()
+    except Exception as e:
+      logging.error("Failed to compute preview: "+str(e))
+    finally:
+      self.ui.applyButton.text = "Apply"
+      qt.QApplication.restoreOverrideCursor()
+
   def onToggleModels(self):
     inputModelNode = self._parameterNode.GetNodeReference("inputModel")
     outputModelNode = self._parameterNode.GetNodeReference("outputModel")
@@ -314,12 +427,20 @@ class SurfaceToolboxLogic(ScriptedLoadableModuleLogic):
   https://github.com/Cjyx/Cjyx/blob/master/Base/Python/cjyx/ScriptedLoadableModule.py
   """
 
+  profileColumns = ["step", "cached", "wallTimeSec", "cpuTimeSec", "peakMemoryDeltaMB",
+    "inputPoints", "inputCells", "outputPoints", "outputCells"]
+
   def __init__(self):
     """
     Called when the logic class is instantiated. Can be used for initializing member variables.
     """
     ScriptedLoadableModuleLogic.__init__(self)
     self.updateProcessCallback = None
+    self.stepCache = SurfaceToolboxStepCache()
+    self.profile = []
+    self.previewProfile = []
+    self.previewProxyKey = None
+    self.previewProxyPolyData = None
 
   def setDefaultParameters(self, parameterNode):
     """
@@ -364,6 +485,9 @@ class SurfaceToolboxLogic(ScriptedLoadableModuleLogic):
       ("extractEdgesFeatureAngle", "20"),
       ("extractEdgesNonManifold", "false"),
       ("extractEdgesManifold", "false"),
+      ("stepCacheMemoryLimitMB", "1024"),
+      ("preview", "false"),
+      ("previewTargetTriangles", "100000"),
     ]
     for parameterName, defaultValue in defaultValues:
       if not parameterNode.GetParameter(parameterName):
@@ -451,6 +575,17 @@ class SurfaceToolboxLogic(ScriptedLoadableModuleLogic):
       reverse.Update()
       outputModel.SetAndObservePolyData(reverse.GetOutput())
 
+  @staticmethod
+  def translate(inputModel, outputModel, toOrigin=False, translateX=0.0, translateY=0.0, translateZ=0.0):
+    """Translate the mesh. If toOrigin is enabled then the center of the mesh bounding box is moved
+    to the origin before translation.
+    """
+    if toOrigin:
+      SurfaceToolboxLogic.translateCenterToOrigin(inputModel, outputModel)
+      inputModel = outputModel
+    SurfaceToolboxLogic.transform(inputModel, outputModel,
+      translateX=translateX, translateY=translateY, translateZ=translateZ)
+
   @staticmethod
   def translateCenterToOrigin(inputModel, outputModel):
     """Translate center of the mesh bounding box to the origin.
@@ -471,8 +606,16 @@ class SurfaceToolboxLogic(ScriptedLoadableModuleLogic):
   @staticmethod
   def extractBoundaryEdges(inputModel, outputModel, boundary=False, feature=False, nonManifold=False, manifold=False, featureAngle=20):
     """Extract edges of a model.
+    Uses the sorted edge table based vtkParallelFeatureEdges filter (provided by the Dynamic Modeler module logic)
+    if it is available, as it is much faster on large meshes than vtkFeatureEdges. It only processes polygons,
+    so models that contain triangle strips are processed with vtkFeatureEdges.
+    The type of each extracted edge is stored in the "EdgeType" cell array (values of vtkParallelFeatureEdges.EdgeTypes)
+    instead of the "Edge Types" coloring scalars of vtkFeatureEdges.
     """
-    boundaryEdges = vtk.vtkFeatureEdges()
+    if hasattr(cjyx, "vtkParallelFeatureEdges") and inputModel.GetPolyData().GetNumberOfStrips() == 0:
+      boundaryEdges = cjyx.vtkParallelFeatureEdges()
+    else:
+      boundaryEdges = vtk.vtkFeatureEdges()
     boundaryEdges.SetInputData(inputModel.GetPolyData())
     boundaryEdges.ExtractAllEdgeTypesOff()
     boundaryEdges.SetBoundaryEdges(boundary)
@@ -510,96 +653,460 @@ class SurfaceToolboxLogic(ScriptedLoadableModuleLogic):
     connect.Update()
     outputModel.SetAndObservePolyData(connect.GetOutput())
 
-  def applyFilters(self, parameterNode):
-    import time
-    startTime = time.time()
-    logging.info('Processing started')
-
-    inputModel = parameterNode.GetNodeReference("inputModel")
-    outputModel = parameterNode.GetNodeReference("outputModel")
-
-    if outputModel != inputModel:
-      if outputModel.GetPolyData() is None:
-        outputModel.SetAndObserveMesh(vtk.vtkPolyData())
-      outputModel.GetPolyData().DeepCopy(inputModel.GetPolyData())
-
-    outputModel.CreateDefaultDisplayNodes()
-    outputModel.AddDefaultStorageNode()
+  def getProcessingSteps(self, parameterNode):
+    """Get the list of enabled processing steps, in the order of execution.
+    Each step is a (name, progress message, function, keyword arguments) tuple.
+    The function is called as function(inputModel, outputModel, **keywordArguments).
+    """
+    steps = []
 
     if parameterNode.GetParameter("cleaner") == "true":
-      self.updateProcess("Clean...")
-      SurfaceToolboxLogic.clean(outputModel, outputModel)
+      steps.append(("cleaner", "Clean...", SurfaceToolboxLogic.clean, {}))
 
     if parameterNode.GetParameter("decimation") == "true":
-      self.updateProcess("Decimation...")
-      SurfaceToolboxLogic.decimate(outputModel, outputModel,
-        reductionFactor=float(parameterNode.GetParameter("decimationReduction")),
-        decimateBoundary=parameterNode.GetParameter("decimationBoundaryDeletion") == "true")
+      steps.append(("decimation", "Decimation...", SurfaceToolboxLogic.decimate, {
+        "reductionFactor": float(parameterNode.GetParameter("decimationReduction")),
+        "decimateBoundary": parameterNode.GetParameter("decimationBoundaryDeletion") == "true"}))
 
     if parameterNode.GetParameter("smoothing") == "true":
-      self.updateProcess("Smoothing...")
       method = parameterNode.GetParameter("smoothingMethod")
-      SurfaceToolboxLogic.smooth(outputModel, outputModel,
-        method=parameterNode.GetParameter("smoothingMethod"),
-        iterations=int(float(parameterNode.GetParameter("smoothingLaplaceIterations" if method=='Laplace' else "smoothingTaubinIterations"))),
-        laplaceRelaxationFactor=float(parameterNode.GetParameter("smoothingLaplaceRelaxation")),
-        taubinPassBand=float(parameterNode.GetParameter("smoothingTaubinPassBand")),
-        boundarySmoothing=parameterNode.GetParameter("smoothingBoundarySmoothing") == "true")
+      steps.append(("smoothing", "Smoothing...", SurfaceToolboxLogic.smooth, {
+        "method": method,
+        "iterations": int(float(parameterNode.GetParameter("smoothingLaplaceIterations" if method=='Laplace' else "smoothingTaubinIterations"))),
+        "laplaceRelaxationFactor": float(parameterNode.GetParameter("smoothingLaplaceRelaxation")),
+        "taubinPassBand": float(parameterNode.GetParameter("smoothingTaubinPassBand")),
+        "boundarySmoothing": parameterNode.GetParameter("smoothingBoundarySmoothing") == "true"}))
 
     if parameterNode.GetParameter("fillHoles") == "true":
-      self.updateProcess("Fill Holes...")
-      SurfaceToolboxLogic.fillHoles(outputModel, outputModel,
-        float(parameterNode.GetParameter("fillHolesSize")))
+      steps.append(("fillHoles", "Fill Holes...", SurfaceToolboxLogic.fillHoles, {
+        "maximumHoleSize": float(parameterNode.GetParameter("fillHolesSize"))}))
 
     if parameterNode.GetParameter("normals") == "true":
-      self.updateProcess("Normals...")
-      SurfaceToolboxLogic.computeNormals(outputModel, outputModel,
-        autoOrient = parameterNode.GetParameter("normalsOrient") == "true",
-        flip=parameterNode.GetParameter("normalsFlip") == "true",
-        split=parameterNode.GetParameter("normalsSplitting") == "true",
-        splitAngle=float(parameterNode.GetParameter("normalsFeatureAngle")))
+      steps.append(("normals", "Normals...", SurfaceToolboxLogic.computeNormals, {
+        "autoOrient": parameterNode.GetParameter("normalsOrient") == "true",
+        "flip": parameterNode.GetParameter("normalsFlip") == "true",
+        "split": parameterNode.GetParameter("normalsSplitting") == "true",
+        "splitAngle": float(parameterNode.GetParameter("normalsFeatureAngle"))}))
 
     if parameterNode.GetParameter("mirror") == "true":
-      self.updateProcess("Mirror...")
-      SurfaceToolboxLogic.transform(outputModel, outputModel,
-        scaleX = -1.0 if parameterNode.GetParameter("mirrorX") == "true" else 1.0,
-        scaleY = -1.0 if parameterNode.GetParameter("mirrorY") == "true" else 1.0,
-        scaleZ = -1.0 if parameterNode.GetParameter("mirrorZ") == "true" else 1.0)
+      steps.append(("mirror", "Mirror...", SurfaceToolboxLogic.transform, {
+        "scaleX": -1.0 if parameterNode.GetParameter("mirrorX") == "true" else 1.0,
+        "scaleY": -1.0 if parameterNode.GetParameter("mirrorY") == "true" else 1.0,
+        "scaleZ": -1.0 if parameterNode.GetParameter("mirrorZ") == "true" else 1.0}))
 
     if parameterNode.GetParameter("scale") == "true":
-      self.updateProcess("Scale...")
-      SurfaceToolboxLogic.transform(outputModel, outputModel,
-        scaleX = float(parameterNode.GetParameter("scaleX")),
-        scaleY = float(parameterNode.GetParameter("scaleY")),
-        scaleZ = float(parameterNode.GetParameter("scaleZ")))
+      steps.append(("scale", "Scale...", SurfaceToolboxLogic.transform, {
+        "scaleX": float(parameterNode.GetParameter("scaleX")),
+        "scaleY": float(parameterNode.GetParameter("scaleY")),
+        "scaleZ": float(parameterNode.GetParameter("scaleZ"))}))
 
     if parameterNode.GetParameter("translate") == "true":
-      self.updateProcess("Translating...")
-      if parameterNode.GetParameter("translateToOrigin") == "true":
-        SurfaceToolboxLogic.translateCenterToOrigin(outputModel, outputModel)
-      SurfaceToolboxLogic.transform(outputModel, outputModel,
-        translateX = float(parameterNode.GetParameter("translateX")),
-        translateY = float(parameterNode.GetParameter("translateY")),
-        translateZ = float(parameterNode.GetParameter("translateZ")))
+      steps.append(("translate", "Translating...", SurfaceToolboxLogic.translate, {
+        "toOrigin": parameterNode.GetParameter("translateToOrigin") == "true",
+        "translateX": float(parameterNode.GetParameter("translateX")),
+        "translateY": float(parameterNode.GetParameter("translateY")),
+        "translateZ": float(parameterNode.GetParameter("translateZ"))}))
 
     if parameterNode.GetParameter("extractEdges") == "true":
-      self.updateProcess("Extracting boundary edges...")
-      SurfaceToolboxLogic.extractBoundaryEdges(outputModel, outputModel,
-        boundary = parameterNode.GetParameter("extractEdgesBoundary") == "true",
-        feature = parameterNode.GetParameter("extractEdgesFeature") == "true",
-        nonManifold = parameterNode.GetParameter("extractEdgesNonManifold") == "true",
-        manifold = parameterNode.GetParameter("extractEdgesManifold") == "true",
-        featureAngle = float(parameterNode.GetParameter("extractEdgesFeatureAngle")))
+      steps.append(("extractEdges", "Extracting boundary edges...", SurfaceToolboxLogic.extractBoundaryEdges, {
+        "boundary": parameterNode.GetParameter("extractEdgesBoundary") == "true",
+        "feature": parameterNode.GetParameter("extractEdgesFeature") == "true",
+        "nonManifold": parameterNode.GetParameter("extractEdgesNonManifold") == "true",
+        "manifold": parameterNode.GetParameter("extractEdgesManifold") == "true",
+        "featureAngle": float(parameterNode.GetParameter("extractEdgesFeatureAngle"))}))
 
     if parameterNode.GetParameter("connectivity") == "true":
-      self.updateProcess("Extract largest connected component...")
-      SurfaceToolboxLogic.extractLargestConnectedComponent(outputModel, outputModel)
+      steps.append(("connectivity", "Extract largest connected component...", SurfaceToolboxLogic.extractLargestConnectedComponent, {}))
+
+    return steps
+
+  def applyFilters(self, parameterNode):
+    """Run all enabled processing steps on the full resolution input model and store the result in the output model.
+    """
+    inputModel = parameterNode.GetNodeReference("inputModel")
+    outputModel = parameterNode.GetNodeReference("outputModel")
+    self.runProcessingSteps(inputModel.GetPolyData(), outputModel, parameterNode)
+
+  def applyFiltersToPreview(self, parameterNode):
+    """Run all enabled processing steps on a reduced size proxy of the input model and store the result
+    in the preview model. The proxy is a decimated copy of the input model (or of the part of the input model
+    inside the selected ROI), it is only recomputed when the input model, ROI, or proxy size changes.
+    """
+    inputModel = parameterNode.GetNodeReference("inputModel")
+    previewModel = self.getPreviewModel(parameterNode)
+    # Proxy points are in the coordinate system of the input model
+    previewModel.SetAndObserveTransformNodeID(inputModel.GetTransformNodeID())
+    proxyPolyData = self.getPreviewProxy(inputModel, parameterNode.GetNodeReference("previewRoi"),
+      int(float(parameterNode.GetParameter("previewTargetTriangles"))))
+    self.runProcessingSteps(proxyPolyData, previewModel, parameterNode, preview=True)
+    return previewModel
+
+  def getPreviewModel(self, parameterNode):
+    """Get the model node that displays the preview result. The node is created if it does not exist yet.
+    """
+    previewModel = parameterNode.GetNodeReference("previewModel")
+    if not previewModel:
+      previewModel = cjyx.dmmlScene.AddNewNodeByClass("vtkDMMLModelNode", cjyx.dmmlScene.GetUniqueNameByString("SurfaceToolbox preview"))
+      previewModel.SetHideFromEditors(True)
+      previewModel.SetSaveWithScene(False)
+      parameterNode.SetNodeReferenceID("previewModel", previewModel.GetID())
+    return previewModel
+
+  def getPreviewProxy(self, inputModel, roiNode=None, targetNumberOfTriangles=100000):
+    """Get a reduced size copy of the input mesh, optionally restricted to the cells that are inside the ROI.
+    """
+    # The transform of the input model only changes the proxy through the cells selected by the ROI
+    proxyKey = (inputModel.GetID(), inputModel.GetPolyData().GetMTime(),
+      SurfaceToolboxLogic.getTransformToWorldKey(inputModel.GetParentTransformNode()) if roiNode else None,
+      roiNode.GetID() if roiNode else None, roiNode.GetMTime() if roiNode else 0, targetNumberOfTriangles)
+    if self.previewProxyKey == proxyKey:
+      return self.previewProxyPolyData
+
+    triangulator = vtk.vtkTriangleFilter()
+    if roiNode:
+      # ROI planes are in world coordinate system, the mesh points are transformed to world before evaluation
+      roiPlanes = vtk.vtkPlanes()
+      roiNode.GetPlanesWorld(roiPlanes)
+      modelToWorldTransform = vtk.vtkGeneralTransform()
+      cjyx.vtkDMMLTransformNode.GetTransformBetweenNodes(inputModel.GetParentTransformNode(), None, modelToWorldTransform)
+      roiPlanes.SetTransform(modelToWorldTransform)
+      roiExtractor = vtk.vtkExtractPolyDataGeometry()
+      roiExtractor.SetInputData(inputModel.GetPolyData())
+      roiExtractor.SetImplicitFunction(roiPlanes)
+      roiExtractor.ExtractInsideOn()
+      roiExtractor.ExtractBoundaryCellsOn()
+      triangulator.SetInputConnection(roiExtractor.GetOutputPort())
+    else:
+      triangulator.SetInputData(inputModel.GetPolyData())
+    triangulator.Update()
+    proxyPolyData = triangulator.GetOutput()
+
+    numberOfTriangles = proxyPolyData.GetNumberOfPolys()
+    if numberOfTriangles > targetNumberOfTriangles > 0:
+      decimation = vtk.vtkQuadricDecimation()
+      decimation.SetInputData(proxyPolyData)
+      decimation.SetTargetReduction(1.0 - float(targetNumberOfTriangles) / numberOfTriangles)
+      decimation.Update()
+      proxyPolyData = decimation.GetOutput()
+
+    logging.info('Preview proxy created with {0} triangles'.format(proxyPolyData.GetNumberOfPolys()))
+    self.previewProxyKey = proxyKey
+    self.previewProxyPolyData = proxyPolyData
+    return proxyPolyData
+
+  @staticmethod
+  def getTransformToWorldKey(transformNode):
+    """Get a value that changes when the transform from the node to world changes.
+    Linear transforms are identified by their matrix, others by the modification time of the nodes of the transform chain.
+    """
+    if not transformNode:
+      return None
+    if transformNode.IsTransformToWorldLinear():
+      transformToWorld = vtk.vtkMatrix4x4()
+      transformNode.GetMatrixTransformToWorld(transformToWorld)
+      return tuple(transformToWorld.GetElement(row, column) for row in range(4) for column in range(4))
+    transformNodeKeys = []
+    while transformNode:
+      transformNodeKeys.append((transformNode.GetID(), transformNode.GetMTime()))
+      transformNode = transformNode.GetParentTransformNode()
+    return tuple(transformNodeKeys)
+
+  def runProcessingSteps(self, inputPolyData, outputModel, parameterNode, preview=False):
+    """Run all enabled processing steps on the input mesh and store the result in the output model.
+    If preview is True then the output model is not saved with the scene, its results are not added to the step cache
+    and the profile is stored as preview profile, so that it does not replace the profile of the last full resolution run.
+    """
+    import time
+    startTime = time.time()
+    logging.info('Processing started')
+
+    steps = self.getProcessingSteps(parameterNode)
+
+    # Each step result is identified by the content of the input mesh and the parameters of all steps up to that step.
+    # Results of the longest unchanged prefix of the recipe are retrieved from the cache instead of recomputing them.
+    self.stepCache.memoryLimitMB = float(parameterNode.GetParameter("stepCacheMemoryLimitMB"))
+    # Preview results are computed on the proxy, they would only evict full resolution results from the cache
+    useStepCache = self.stepCache.memoryLimitMB > 0 and not preview
+    stepKeys = []
+    firstStepIndex = 0
+    cachedPolyData = None
+    if useStepCache:
+      stepKey = SurfaceToolboxStepCache.getMeshKey(inputPolyData)
+      for stepName, message, function, kwargs in steps:
+        stepKey = SurfaceToolboxStepCache.getStepKey(stepKey, stepName, kwargs)
+        stepKeys.append(stepKey)
+      for stepIndex in reversed(range(len(steps))):
+        cachedPolyData = self.stepCache.get(stepKeys[stepIndex])
+        if cachedPolyData is not None:
+          firstStepIndex = stepIndex + 1
+          logging.info('Reusing cached results of the first {0} processing steps'.format(firstStepIndex))
+          break
+    elif not preview:
+      self.stepCache.clear()
+
+    profile = []
+    for stepIndex in range(firstStepIndex):
+      profile.append(SurfaceToolboxLogic._createStepProfile(steps[stepIndex][0], cached=True))
+
+    if cachedPolyData is not None:
+      outputPolyData = vtk.vtkPolyData()
+      outputPolyData.DeepCopy(cachedPolyData)
+      outputModel.SetAndObservePolyData(outputPolyData)
+    elif outputModel.GetPolyData() is not inputPolyData:
+      if outputModel.GetPolyData() is None:
+        outputModel.SetAndObserveMesh(vtk.vtkPolyData())
+      outputModel.GetPolyData().DeepCopy(inputPolyData)
+
+    outputModel.CreateDefaultDisplayNodes()
+    if not preview:
+      outputModel.AddDefaultStorageNode()
+
+    for stepIndex in range(firstStepIndex, len(steps)):
+      stepName, message, function, kwargs = steps[stepIndex]
+      self.updateProcess(message)
+      stepProfile = SurfaceToolboxLogic._createStepProfile(stepName, inputPolyData=outputModel.GetPolyData())
+      memoryMonitor = SurfaceToolboxPeakMemoryMonitor()
+      memoryMonitor.start()
+      wallStartTime = time.perf_counter()
+      cpuStartTime = time.process_time()
+      function(outputModel, outputModel, **kwargs)
+      stepProfile["wallTimeSec"] = time.perf_counter() - wallStartTime
+      stepProfile["cpuTimeSec"] = time.process_time() - cpuStartTime
+      stepProfile["peakMemoryDeltaMB"] = memoryMonitor.stop()
+      stepProfile["outputPoints"] = outputModel.GetPolyData().GetNumberOfPoints()
+      stepProfile["outputCells"] = outputModel.GetPolyData().GetNumberOfCells()
+      profile.append(stepProfile)
+      logging.info('{0} completed in {1:.2f} seconds'.format(stepName, stepProfile["wallTimeSec"]))
+      if useStepCache:
+        self.stepCache.add(stepKeys[stepIndex], outputModel.GetPolyData())
+
+    import json
+    if preview:
+      self.previewProfile = profile
+      parameterNode.SetParameter("previewProfile", json.dumps(profile))
+    else:
+      self.profile = profile
+      parameterNode.SetParameter("processingProfile", json.dumps(profile))
 
     self.updateProcess("Done.")
 
     stopTime = time.time()
     logging.info('Processing completed in {0:.2f} seconds'.format(stopTime-startTime))
 
+  @staticmethod
+  def _createStepProfile(stepName, inputPolyData=None, cached=False):
+    return {
+      "step": stepName,
+      "cached": cached,
+      "wallTimeSec": 0.0,
+      "cpuTimeSec": 0.0,
+      "peakMemoryDeltaMB": None if not cached else 0.0,
+      "inputPoints": inputPolyData.GetNumberOfPoints() if inputPolyData else None,
+      "inputCells": inputPolyData.GetNumberOfCells() if inputPolyData else None,
+      "outputPoints": None,
+      "outputCells": None,
+      }
+
+  def getProfile(self, parameterNode=None, preview=False):
+    """Get per-step timing and memory usage of the last processing run.
+    If parameter node is specified then the profile stored in the parameter node is returned.
+    If preview is True then the profile of the last preview run is returned instead of the last full resolution run.
+    Each step is described by a dictionary, see profileColumns for the list of keys.
+    Steps that were retrieved from the step cache have the "cached" value set to True.
+    """
+    if parameterNode is None:
+      return self.previewProfile if preview else self.profile
+    import json
+    profileStr = parameterNode.GetParameter("previewProfile" if preview else "processingProfile")
+    return json.loads(profileStr) if profileStr else []
+
+  @staticmethod
+  def saveProfile(profile, filePath):
+    """Save processing profile to file. File format is JSON if the file extension is .json, CSV otherwise.
+    """
+    if filePath.lower().endswith(".json"):
+      import json
+      with open(filePath, "w") as f:
+        json.dump({"steps": profile}, f, indent=2)
+    else:
+      import csv
+      with open(filePath, "w", newline="") as f:
+        writer = csv.DictWriter(f, fieldnames=SurfaceToolboxLogic.profileColumns)
+        writer.writeheader()
+        for stepProfile in profile:
+          writer.writerow(stepProfile)
+
+#
+# SurfaceToolboxStepCache
+#
+
+class SurfaceToolboxStepCache:
+  """Least recently used cache of processing step results.
+  Keys identify the input mesh content and the parameters of all processing steps that led to the result,
+  values are copies of the output meshes. Least recently used results are evicted when the total size
+  of the cached meshes exceeds the memory limit.
+  """
+
+  def __init__(self, memoryLimitMB=1024.0):
+    import collections
+    self.memoryLimitMB = memoryLimitMB
+    self._entries = collections.OrderedDict()
+    self._memorySizeKB = 0
+
+  @staticmethod
+  def getMeshKey(polyData):
+    """Compute a hash of the points, cells, and numeric point and cell data of a mesh.
+    """
+    import hashlib
+    import numpy as np
+    from vtk.util.numpy_support import vtk_to_numpy
+    meshHash = hashlib.sha1()
+    if polyData is None:
+      return meshHash.hexdigest()
+    arrays = []
+    if polyData.GetPoints():
+      arrays.append(polyData.GetPoints().GetData())
+    for cells in [polyData.GetVerts(), polyData.GetLines(), polyData.GetPolys(), polyData.GetStrips()]:
+      arrays.append(cells.GetOffsetsArray())
+      arrays.append(cells.GetConnectivityArray())
+    for attributes in [polyData.GetPointData(), polyData.GetCellData()]:
+      for arrayIndex in range(attributes.GetNumberOfArrays()):
+        # non-numeric arrays are returned as None
+        if attributes.GetArray(arrayIndex):
+          arrays.append(attributes.GetArray(arrayIndex))
+    for array in arrays:
+      values = np.ascontiguousarray(vtk_to_numpy(array))
+      meshHash.update(str((array.GetName(), values.dtype.str, values.shape)).encode())
+      meshHash.update(values)
+    return meshHash.hexdigest()
+
+  @staticmethod
+  def getStepKey(inputKey, stepName, parameters):
+    """Compute the key of a step result from the key of its input and the step parameters.
+    """
+    import hashlib
+    return hashlib.sha1(str((inputKey, stepName, sorted(parameters.items()))).encode()).hexdigest()
+
+  def get(self, key):
+    """Get cached mesh. Returns None if the key is not found in the cache.
+    """
+    polyData = self._entries.get(key)
+    if polyData is not None:
+      self._entries.move_to_end(key)
+    return polyData
+
+  def add(self, key, polyData):
+    """Store a copy of the mesh in the cache and evict least recently used items to stay within the memory limit.
+    """
+    if key in self._entries:
+      self._memorySizeKB -= self._entries.pop(key).GetActualMemorySize()
+    polyDataCopy = vtk.vtkPolyData()
+    polyDataCopy.DeepCopy(polyData)
+    memorySizeKB = polyDataCopy.GetActualMemorySize()
+    if memorySizeKB > self.memoryLimitMB * 1024:
+      return
+    self._entries[key] = polyDataCopy
+    self._memorySizeKB += memorySizeKB
+    while self._memorySizeKB > self.memoryLimitMB * 1024:
+      evictedKey, evictedPolyData = self._entries.popitem(last=False)
+      self._memorySizeKB -= evictedPolyData.GetActualMemorySize()
+
+  def clear(self):
+    self._entries.clear()
+    self._memorySizeKB = 0
+
+  def getMemorySizeMB(self):
+    return self._memorySizeKB / 1024.0
+
+  def getNumberOfItems(self):
+    return len(self._entries)
+
+#
+# SurfaceToolboxPeakMemoryMonitor
+#
+
+class SurfaceToolboxPeakMemoryMonitor:
+  """Measure how much the resident memory of the application process increases at its peak while an operation runs,
+  relative to the resident memory at the start of the operation.
+  On Linux the peak resident memory of the process (VmHWM) is reset at the start, so the peak of the operation is exact.
+  Otherwise the resident memory is sampled in a background thread using psutil. Sampling may miss short peaks,
+  and it cannot run while a filter holds the Python global interpreter lock, in that case only the memory that is
+  still in use at the end of the operation is measured.
+  """
+
+  def __init__(self, samplingIntervalSec=0.01):
+    self.samplingIntervalSec = samplingIntervalSec
+    self._useProcStatus = False
+    self._process = None
+    self._startMB = None
+    self._peakMB = None
+    self._stopEvent = None
+    self._samplingThread = None
+
+  def start(self):
+    self._startMB = None
+    self._useProcStatus = SurfaceToolboxPeakMemoryMonitor._resetProcPeakMemory()
+    if self._useProcStatus:
+      self._startMB = SurfaceToolboxPeakMemoryMonitor._readProcStatusMB("VmRSS")
+      return
+    try:
+      import psutil
+    except ImportError:
+      return
+    import threading
+    self._process = psutil.Process()
+    self._startMB = self._getProcessMemoryMB()
+    self._peakMB = self._startMB
+    self._stopEvent = threading.Event()
+    self._samplingThread = threading.Thread(target=self._sampleMemory)
+    self._samplingThread.daemon = True
+    self._samplingThread.start()
+
+  def stop(self):
+    """Stop measuring and return the peak increase of resident memory in MB.
+    Returns None if it cannot be measured on this platform.
+    """
+    if self._startMB is None:
+      return None
+    if self._useProcStatus:
+      self._peakMB = SurfaceToolboxPeakMemoryMonitor._readProcStatusMB("VmHWM")
+    else:
+      self._stopEvent.set()
+      self._samplingThread.join()
+      self._peakMB = max(self._peakMB, self._getProcessMemoryMB())
+    return max(self._peakMB - self._startMB, 0.0)
+
+  def _sampleMemory(self):
+    while not self._stopEvent.wait(self.samplingIntervalSec):
+      self._peakMB = max(self._peakMB, self._getProcessMemoryMB())
+
+  def _getProcessMemoryMB(self):
+    return self._process.memory_info().rss / (1024.0 * 1024.0)
+
+  @staticmethod
+  def _resetProcPeakMemory():
+    """Reset the peak resident memory of the process, returns False if it is not supported on this platform.
+    """
+    try:
+      # Writing 5 to clear_refs resets VmHWM to the current resident memory (Linux 4.0 and later)
+      with open("/proc/self/clear_refs", "w") as clearRefsFile:
+        clearRefsFile.write("5")
+    except (IOError, OSError):
+      return False
+    return SurfaceToolboxPeakMemoryMonitor._readProcStatusMB("VmHWM") is not None
+
+  @staticmethod
+  def _readProcStatusMB(key):
+    try:
+      with open("/proc/self/status") as statusFile:
+        for line in statusFile:
+          if line.startswith(key + ":"):
+            # Values are in kB
+            return int(line.split()[1]) / 1024.0
+    except (IOError, OSError, ValueError):
+      pass
+    return None
+
 #
 # SurfaceToolboxTest
 #
@@ -621,6 +1128,10 @@ class SurfaceToolboxTest(ScriptedLoadableModuleTest):
     """
     self.setUp()
     self.test_AllProcessing()
+    self.setUp()
+    self.test_StepCache()
+    self.setUp()
+    self.test_Preview()
 
   def test_AllProcessing(self):
     """ Ideally you should have several levels of tests.  At the lowest level
@@ -678,3 +1189,92 @@ class SurfaceToolboxTest(ScriptedLoadableModuleTest):
     logic.applyFilters(parameterNode)
 
     self.delayDisplay('Test passed!')
+
+  def test_StepCache(self):
+    """Verify that re-applying the filters after changing the last step reuses results of the unchanged steps.
+    """
+    self.delayDisplay("Starting the test")
+
+    sphere = vtk.vtkSphereSource()
+    sphere.SetThetaResolution(60)
+    sphere.SetPhiResolution(60)
+    sphere.Update()
+    inputModelNode = cjyx.modules.models.logic().AddModel(sphere.GetOutput())
+    outputModelNode = cjyx.dmmlScene.AddNewNodeByClass("vtkDMMLModelNode", "output")
+
+    logic = SurfaceToolboxLogic()
+    parameterNode = cjyx.dmmlScene.AddNewNodeByClass("vtkDMMLScriptedModuleNode")
+    logic.setDefaultParameters(parameterNode)
+    parameterNode.SetNodeReferenceID("inputModel", inputModelNode.GetID())
+    parameterNode.SetNodeReferenceID("outputModel", outputModelNode.GetID())
+    parameterNode.SetParameter("cleaner", "true")
+    parameterNode.SetParameter("smoothing", "true")
+    parameterNode.SetParameter("translate", "true")
+
+    logic.applyFilters(parameterNode)
+    self.assertEqual(logic.stepCache.getNumberOfItems(), 3)
+    firstBounds = outputModelNode.GetPolyData().GetBounds()
+
+    # Only the translation is recomputed, from the cached smoothing result
+    parameterNode.SetParameter("translateX", "10.0")
+    logic.applyFilters(parameterNode)
+    self.assertEqual(logic.stepCache.getNumberOfItems(), 4)
+    secondBounds = outputModelNode.GetPolyData().GetBounds()
+    self.assertAlmostEqual(secondBounds[0], firstBounds[0] + 10.0)
+
+    # Profile lists all steps, only the last one is computed
+    profile = logic.getProfile(parameterNode)
+    self.assertEqual([stepProfile["step"] for stepProfile in profile], ["cleaner", "smoothing", "translate"])
+    self.assertEqual([stepProfile["cached"] for stepProfile in profile], [True, True, False])
+    self.assertEqual(profile[2]["outputPoints"], outputModelNode.GetPolyData().GetNumberOfPoints())
+
+    # Nothing is cached if the cache is disabled
+    parameterNode.SetParameter("stepCacheMemoryLimitMB", "0")
+    logic.applyFilters(parameterNode)
+    self.assertEqual(logic.stepCache.getNumberOfItems(), 0)
+
+    self.delayDisplay('Test passed!')
+
+  def test_Preview(self):
+    """Verify that preview is computed on a reduced size proxy and the output model is not modified.
+    """
+    self.delayDisplay("Starting the test")
+
+    sphere = vtk.vtkSphereSource()
+    sphere.SetThetaResolution(100)
+    sphere.SetPhiResolution(100)
+    sphere.Update()
+    inputModelNode = cjyx.modules.models.logic().AddModel(sphere.GetOutput())
+    outputModelNode = cjyx.dmmlScene.AddNewNodeByClass("vtkDMMLModelNode", "output")
+
+    logic = SurfaceToolboxLogic()
+    parameterNode = cjyx.dmmlScene.AddNewNodeByClass("vtkDMMLScriptedModuleNode")
+    logic.setDefaultParameters(parameterNode)
+    parameterNode.SetNodeReferenceID("inputModel", inputModelNode.GetID())
+    parameterNode.SetNodeReferenceID("outputModel", outputModelNode.GetID())
+    parameterNode.SetParameter("smoothing", "true")
+    parameterNode.SetParameter("previewTargetTriangles", "2000")
+
+    previewModelNode = logic.applyFiltersToPreview(parameterNode)
+    self.assertLess(previewModelNode.GetPolyData().GetNumberOfPolys(), inputModelNode.GetPolyData().GetNumberOfPolys())
+    self.assertIsNone(outputModelNode.GetPolyData())
+
+    # Proxy is reused if the input did not change
+    proxyPolyData = logic.previewProxyPolyData
+    parameterNode.SetParameter("smoothingTaubinPassBand", "0.05")
+    logic.applyFiltersToPreview(parameterNode)
+    self.assertIs(logic.previewProxyPolyData, proxyPolyData)
+
+    # Preview model is displayed in the same coordinate system as the input model, it is not cached or saved
+    self.assertEqual(logic.stepCache.getNumberOfItems(), 0)
+    self.assertIsNone(previewModelNode.GetStorageNode())
+    transformNode = cjyx.dmmlScene.AddNewNodeByClass("vtkDMMLLinearTransformNode")
+    inputModelNode.SetAndObserveTransformNodeID(transformNode.GetID())
+    logic.applyFiltersToPreview(parameterNode)
+    self.assertEqual(previewModelNode.GetTransformNodeID(), transformNode.GetID())
+
+    # Preview runs have their own profile, the profile of the full resolution run is not replaced
+    self.assertEqual([stepProfile["step"] for stepProfile in logic.getProfile(parameterNode, preview=True)], ["smoothing"])
+    self.assertEqual(logic.getProfile(parameterNode), [])
+
+    self.delayDisplay('Test passed!')
@@ -0,0 +1,207 @@
+import json
+import logging
+import os
+import platform
+import time
+
+import vtk, cjyx
+from cjyx.ScriptedLoadableModule import *
+
+from SurfaceToolbox import SurfaceToolboxLogic, SurfaceToolboxPeakMemoryMonitor
+
+#
+# SurfaceToolboxBenchmark
+#
+# Measures computation time and memory usage of each SurfaceToolbox operation and of a few
+# standard processing recipes on meshes of increasing size.
+# Only added to the tests if the SurfaceToolbox_ENABLE_BENCHMARKS CMake option is enabled.
+#
+# Configuration (environment variables):
+#   SURFACETOOLBOX_BENCHMARK_TRIANGLE_COUNTS: comma-separated list of triangle counts of the generated meshes
+#     (default: 100000,1000000,5000000,20000000)
+#   SURFACETOOLBOX_BENCHMARK_MESH_DIR: optional folder of reference meshes (.vtk, .vtp, .stl, .ply, .obj)
+#     that are benchmarked in addition to the generated meshes
+#   SURFACETOOLBOX_BENCHMARK_OUTPUT: output JSON file path
+#     (default: SurfaceToolboxBenchmark.json in the application temporary folder)
+#
+
+BENCHMARK_SCHEMA_VERSION = 1
+
+DEFAULT_TRIANGLE_COUNTS = [100000, 1000000, 5000000, 20000000]
+
+# Name, list of enabled steps, additional parameter values
+RECIPES = [
+  ("cleanup", ["cleaner", "fillHoles", "normals"], {}),
+  ("reduce", ["cleaner", "decimation", "smoothing"], {}),
+  ("all", ["cleaner", "decimation", "smoothing", "fillHoles", "normals", "mirror", "scale", "translate", "extractEdges", "connectivity"],
+    {"mirrorX": "true", "translateX": "5.0"}),
+  ]
+
+
+class SurfaceToolboxBenchmarkTest(ScriptedLoadableModuleTest):
+  """Benchmark of SurfaceToolbox operations. Results are written to a JSON file.
+  """
+
+  def setUp(self):
+    cjyx.dmmlScene.Clear(0)
+
+  def runTest(self):
+    self.setUp()
+    self.test_Benchmark()
+
+  def test_Benchmark(self):
+    triangleCounts = DEFAULT_TRIANGLE_COUNTS
+    if os.environ.get("SURFACETOOLBOX_BENCHMARK_TRIANGLE_COUNTS"):
+      triangleCounts = [int(float(count)) for count in os.environ["SURFACETOOLBOX_BENCHMARK_TRIANGLE_COUNTS"].split(",") if count.strip()]
+    outputFilePath = os.environ.get("SURFACETOOLBOX_BENCHMARK_OUTPUT",
+      os.path.join(cjyx.app.temporaryPath, "SurfaceToolboxBenchmark.json"))
+
+    results = []
+    for triangleCount in triangleCounts:
+      polyData = self.createSphereMesh(triangleCount)
+      # Results are named by the requested size, make sure that the generated mesh actually has that size
+      self.assertLess(abs(polyData.GetNumberOfPolys() - triangleCount), 0.1 * triangleCount)
+      results.extend(self.benchmarkMesh("sphere{0}".format(triangleCount), polyData))
+
+    meshDir = os.environ.get("SURFACETOOLBOX_BENCHMARK_MESH_DIR")
+    if meshDir:
+      for fileName in sorted(os.listdir(meshDir)):
+        if os.path.splitext(fileName)[1].lower() not in [".vtk", ".vtp", ".stl", ".ply", ".obj"]:
+          continue
+        modelNode = cjyx.util.loadModel(os.path.join(meshDir, fileName))
+        results.extend(self.benchmarkMesh(fileName, modelNode.GetPolyData()))
+        cjyx.dmmlScene.RemoveNode(modelNode)
+
+    report = {
+      "schemaVersion": BENCHMARK_SCHEMA_VERSION,
+      "benchmark": "SurfaceToolbox",
+      "timestamp": time.strftime("%Y-%m-%dT%H:%M:%S"),
+      "application": {
+        "name": cjyx.app.applicationName,
+        "version": cjyx.app.applicationVersion,
+        "revision": cjyx.app.repositoryRevision,
+        },
+      "system": {
+        "platform": platform.platform(),
+        "processor": platform.processor(),
+        "numberOfCpus": os.cpu_count(),
+        },
+      "results": results,
+      }
+    with open(outputFilePath, "w") as f:
+      json.dump(report, f, indent=2)
+    logging.info("Benchmark results written to " + outputFilePath)
+
+    self.assertTrue(len(results) > 0)
+
+  @staticmethod
+  def createSphereMesh(triangleCount):
+    """Create a sphere mesh that has approximately the requested number of triangles.
+    """
+    # A sphere with resolution r in both directions has 2*r*(r-2) + 2*r triangles.
+    # vtkSphereSource clamps the resolution at 1024 (about 2 million triangles), so larger
+    # spheres are created by subdividing a coarser sphere (each level splits a triangle into 4)
+    # and projecting the new points onto the sphere.
+    radius = 50.0
+    maximumResolution = 1024
+    numberOfSubdivisions = 0
+    baseTriangleCount = float(triangleCount)
+    while int(round((baseTriangleCount / 2.0) ** 0.5)) + 1 > maximumResolution:
+      baseTriangleCount /= 4.0
+      numberOfSubdivisions += 1
+    resolution = max(8, int(round((baseTriangleCount / 2.0) ** 0.5)) + 1)
+    sphere = vtk.vtkSphereSource()
+    sphere.SetRadius(radius)
+    sphere.SetThetaResolution(resolution)
+    sphere.SetPhiResolution(resolution)
+    sphere.LatLongTessellationOff()
+    sphere.Update()
+    if numberOfSubdivisions == 0:
+      return sphere.GetOutput()
+
+    subdivision = vtk.vtkLinearSubdivisionFilter()
+    subdivision.SetInputData(sphere.GetOutput())
+    subdivision.SetNumberOfSubdivisions(numberOfSubdivisions)
+    subdivision.Update()
+    polyData = subdivision.GetOutput()
+    # Interpolated normals are not unit length anymore, they are recomputed by the operations that need them
+    polyData.GetPointData().SetNormals(None)
+    import numpy as np
+    from vtk.util.numpy_support import vtk_to_numpy
+    points = vtk_to_numpy(polyData.GetPoints().GetData())
+    points *= (radius / np.linalg.norm(points, axis=1))[:, np.newaxis]
+    polyData.GetPoints().Modified()
+    return polyData
+
+  def benchmarkMesh(self, meshName, polyData):
+    logging.info("Benchmarking {0} ({1} triangles)".format(meshName, polyData.GetNumberOfPolys()))
+    inputModel = cjyx.modules.models.logic().AddModel(polyData)
+    outputModel = cjyx.dmmlScene.AddNewNodeByClass("vtkDMMLModelNode", "BenchmarkOutput")
+
+    operations = [
+      ("clean", SurfaceToolboxLogic.clean, {}),
+      ("decimate", SurfaceToolboxLogic.decimate, {"reductionFactor": 0.8}),
+      ("smoothTaubin", SurfaceToolboxLogic.smooth, {"method": "Taubin", "iterations": 30}),
+      ("smoothLaplace", SurfaceToolboxLogic.smooth, {"method": "Laplace", "iterations": 100}),
+      ("fillHoles", SurfaceToolboxLogic.fillHoles, {}),
+      ("computeNormals", SurfaceToolboxLogic.computeNormals, {"autoOrient": True}),
+      ("transform", SurfaceToolboxLogic.transform, {"scaleX": -1.0}),
+      ("translateCenterToOrigin", SurfaceToolboxLogic.translateCenterToOrigin, {}),
+      ("extractBoundaryEdges", SurfaceToolboxLogic.extractBoundaryEdges, {"boundary": True, "feature": True, "nonManifold": True}),
+      ("extractLargestConnectedComponent", SurfaceToolboxLogic.extractLargestConnectedComponent, {}),
+      ]
+
+    results = []
+    for operationName, function, kwargs in operations:
+      results.append(self.measure(meshName, inputModel, "operation", operationName,
+        lambda: function(inputModel, outputModel, **kwargs), outputModel))
+
+    logic = SurfaceToolboxLogic()
+    for recipeName, steps, parameters in RECIPES:
+      parameterNode = cjyx.dmmlScene.AddNewNodeByClass("vtkDMMLScriptedModuleNode")
+      logic.setDefaultParameters(parameterNode)
+      parameterNode.SetNodeReferenceID("inputModel", inputModel.GetID())
+      parameterNode.SetNodeReferenceID("outputModel", outputModel.GetID())
+      # Measure complete computation, without reusing results of earlier runs
+      parameterNode.SetParameter("stepCacheMemoryLimitMB", "0")
+      for step in steps:
+        parameterNode.SetParameter(step, "true")
+      for name, value in parameters.items():
+        parameterNode.SetParameter(name, value)
+      result = self.measure(meshName, inputModel, "recipe", recipeName,
+        lambda: logic.applyFilters(parameterNode), outputModel)
+      result["steps"] = logic.getProfile()
+      results.append(result)
+      cjyx.dmmlScene.RemoveNode(parameterNode)
+
+    cjyx.dmmlScene.RemoveNode(outputModel)
+    cjyx.dmmlScene.RemoveNode(inputModel)
+    return results
+
+  @staticmethod
+  def measure(meshName, inputModel, operationType, operationName, function, outputModel):
+    inputTriangles = inputModel.GetPolyData().GetNumberOfPolys()
+    memoryMonitor = SurfaceToolboxPeakMemoryMonitor()
+    memoryMonitor.start()
+    wallStartTime = time.perf_counter()
+    cpuStartTime = time.process_time()
+    function()
+    wallTimeSec = time.perf_counter() - wallStartTime
+    cpuTimeSec = time.process_time() - cpuStartTime
+    peakMemoryDeltaMB = memoryMonitor.stop()
+    outputPolyData = outputModel.GetPolyData()
+    result = {
+      "mesh": meshName,
+      "type": operationType,
+      "operation": operationName,
+      "inputPoints": inputModel.GetPolyData().GetNumberOfPoints(),
+      "inputTriangles": inputTriangles,
+      "outputPoints": outputPolyData.GetNumberOfPoints() if outputPolyData else 0,
+      "outputCells": outputPolyData.GetNumberOfCells() if outputPolyData else 0,
+      "wallTimeSec": wallTimeSec,
+      "cpuTimeSec": cpuTimeSec,
+      "peakMemoryDeltaMB": peakMemoryDeltaMB,
+      "trianglesPerSec": inputTriangles / wallTimeSec if wallTimeSec > 0 else None,
+      }
+    logging.info("  {0} {1}: {2:.3f} s".format(operationType, operationName, wallTimeSec))
+    return result